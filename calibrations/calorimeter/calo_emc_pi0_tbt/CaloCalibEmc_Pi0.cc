@@ -8,6 +8,11 @@
 #include <calobase/RawTowerDefs.h>
 #include <calobase/RawTowerGeomContainer.h>
 #include <calobase/TowerInfoContainer.h>
+#include <calobase/TowerInfoDefs.h>
+
+#include <calo_fit/CaloHistFitter.h>
+
+#include <cdbobjects/CDBTTree.h>
 
 #include <globalvertex/GlobalVertex.h>
 #include <globalvertex/GlobalVertexMap.h>
@@ -902,106 +907,141 @@ void CaloCalibEmc_Pi0::Fit_Histos(const std::string &incorrFile)
 
   cal_output->cd();
 
-  TF1 *f1[25000];
-  TF1 *f2[25000];
-  TF1 *total[25000];
-  TF1 *fit_fn[25000];
-  int kj = 0;
-
   // arrays to hold the fit results (cemc)
   fitp1_eta_phi2d = new TH2F("fitp1_eta_phi2d", "fit p1 eta phi", 96, 0, 96, 256, 0, 256);
 
   double cemc_par1_values[96][256] = {{0.0}};  // mising braces Werror w/o double braces
-  // double cemc_par0_values[96][256] = {0.0};
-  // double cemc_par0_errors[96][256] = {0.0};
   double cemc_par1_errors[96][256] = {{0.0}};
-  // double cemc_par2_values[96][256] = {0.0};
-  // double cemc_par2_errors[96][256] = {0.0};
 
   // create Ntuple object of the fit result from the data
   TNtuple *nt_corrVals = new TNtuple("nt_corrVals", "Ntuple of the corrections", "tower_eta:tower_phi:corr_val:agg_cv");
 
-  for (int ieta = 0; ieta < 96; ieta++)  // eta loop
+  // the histograms are copied serially (ROOT is not thread safe), the
+  // gaus, side band pol2 and gaus+pol2 fits of all towers run on the CaloHistFitter threads
+  std::vector<CaloHistFitter::Histo> towers(96 * 256);
+  for (int ieta = 0; ieta < 96; ieta++)
   {
     for (int iphi = 0; iphi < 256; iphi++)
     {
-      // for(int ithirds=0; ithirds<3; ithirds++)
-      //{
-      //	for (int ieta=0+ithirds*32; ieta<(ithirds*32+16); ieta++)
-      //	{
-      //		for (int iphi=0; iphi<16; iphi++)
-      //		{
-      //		}
-      //	}
-      // }
-      //  find max bin around peak
-      float pkloc = 0.0;
-      float bsavloc = 0.0;
-      for (int kfi = 1; kfi < 20; kfi++)  // old kfi<25
-      {
-        float locbv = cemc_hist_eta_phi.at(ieta).at(iphi)->GetBinContent(kfi);
-        if (locbv > bsavloc)
-        {
-          pkloc = cemc_hist_eta_phi.at(ieta).at(iphi)->GetBinCenter(kfi);
-          bsavloc = locbv;
-        }
-      }
+      towers[ieta * 256 + iphi] = CaloHistFitter::Histo(cemc_hist_eta_phi.at(ieta).at(iphi));
+    }
+  }
+  std::vector<CaloHistFitter::Result> results(towers.size());
+  CaloHistFitter fitter(m_nThreads);
+  std::cout << "Fitting " << towers.size() << " towers with " << fitter.getNThreads() << " threads" << std::endl;
+  fitter.run(towers.size(), [&towers, &results](size_t itow)
+             { results[itow] = CaloHistFitter::FitPi0(towers[itow]); });
+  towers.clear();
+
+  /// relative difference of the tower p1 to the TH1::Fit result (set_rootFitCheck)
+  TH1F *h_rootFitDiff = new TH1F("h_rootFitDiff", "CaloHistFitter - ROOT fit", 2000, -0.01, 0.01);
+  h_rootFitDiff->SetXTitle("(p1 - p1_{ROOT})/p1_{ROOT}");
+
+  CDBTTree *cdbttree = nullptr;
+  if (!m_cdbFileName.empty())
+  {
+    cdbttree = new CDBTTree(m_cdbFileName);
+  }
 
-      f1[kj] = new TF1("f1", "gaus", 0.06, 0.20);  //"gaus",pkloc-0.03,pkloc+0.03
-      f2[kj] = new TF1("f2", "pol2", 0.01, 0.4);
+  TF1 *total = new TF1("total", "gaus(0)+pol2(3)", 0.06, 0.25);  // 0.3*fpkloc2/0.145
+  total->SetParLimits(2, 0.01, 0.027);
 
-      cemc_hist_eta_phi.at(ieta).at(iphi)->Fit(f1[kj], "", "", pkloc - 0.04, pkloc + 0.04);
-      float fpkloc2 = f1[kj]->GetParameter(1);
+  for (int ieta = 0; ieta < 96; ieta++)  // eta loop
+  {
+    for (int iphi = 0; iphi < 256; iphi++)
+    {
+      TH1 *htow = cemc_hist_eta_phi.at(ieta).at(iphi);
+      const CaloHistFitter::Result &result = results[ieta * 256 + iphi];
+      // mean of the first gaus fit
+      float fpkloc2 = result.start[1];
 
       TGraphErrors *grtemp = new TGraphErrors();
       std::string bkgNm = std::string("grBkgEta_phi_") + std::to_string(ieta) + std::string("_") + std::to_string(iphi);
 
-      std::cout << " getting " << bkgNm << " mean was " << fpkloc2
-                << " " << pkloc << std::endl;
+      std::cout << " getting " << bkgNm << " mean was " << fpkloc2 << std::endl;
 
       grtemp->SetName(bkgNm.c_str());
       int ingr = 0;
-      for (int gj = 1; gj < cemc_hist_eta_phi.at(ieta).at(iphi)->GetNbinsX() + 1; gj++)
+      for (int gj = 1; gj < htow->GetNbinsX() + 1; gj++)
       {
-        float binc = cemc_hist_eta_phi.at(ieta).at(iphi)->GetBinCenter(gj);
-        float cntc = cemc_hist_eta_phi.at(ieta).at(iphi)->GetBinContent(gj);
+        float binc = htow->GetBinCenter(gj);
+        float cntc = htow->GetBinContent(gj);
         if ((binc > 0.06 * fpkloc2 / 0.145 && binc < 0.09 * fpkloc2 / 0.145) || (binc > 0.22 * fpkloc2 / 0.145 && binc < 0.35 * fpkloc2 / 0.145))
         {
           grtemp->SetPoint(ingr, binc, cntc);
           grtemp->SetPointError(ingr++, 0.001, sqrt(cntc));
         }
       }
+      grtemp->Write();
 
-      grtemp->Fit(f2[kj]);
-
-      total[kj] = new TF1("total", "gaus(0)+pol2(3)", 0.06, 0.25);  // 0.3*fpkloc2/0.145
-
-      double par[6];
-
-      f1[kj]->GetParameters(&par[0]);
-      f2[kj]->GetParameters(&par[3]);
-
-      total[kj]->SetParameters(par);
-      total[kj]->SetParLimits(2, 0.01, 0.027);
+      if (m_rootFitCheck > 0 && (ieta * 256 + iphi) % m_rootFitCheck == 0)
+      {
+        // the staged gaus, side band pol2 and gaus+pol2 fits done with ROOT alone
+        float pkloc = 0.0;
+        float bsavloc = 0.0;
+        for (int kfi = 1; kfi < 20; kfi++)
+        {
+          float locbv = htow->GetBinContent(kfi);
+          if (locbv > bsavloc)
+          {
+            pkloc = htow->GetBinCenter(kfi);
+            bsavloc = locbv;
+          }
+        }
+        TF1 f1root("f1root", "gaus", 0.06, 0.20);
+        htow->Fit(&f1root, "QN0", "", pkloc - 0.04, pkloc + 0.04);
+        const double rootpkloc2 = f1root.GetParameter(1);
 
-      cemc_hist_eta_phi.at(ieta).at(iphi)->Fit(total[kj], "R");
-      fit_fn[kj] = cemc_hist_eta_phi.at(ieta).at(iphi)->GetFunction("total");
+        TGraphErrors grroot;
+        int ingrroot = 0;
+        for (int gj = 1; gj < htow->GetNbinsX() + 1; gj++)
+        {
+          float binc = htow->GetBinCenter(gj);
+          float cntc = htow->GetBinContent(gj);
+          if ((binc > 0.06 * rootpkloc2 / 0.145 && binc < 0.09 * rootpkloc2 / 0.145) || (binc > 0.22 * rootpkloc2 / 0.145 && binc < 0.35 * rootpkloc2 / 0.145))
+          {
+            grroot.SetPoint(ingrroot, binc, cntc);
+            grroot.SetPointError(ingrroot++, 0.001, sqrt(cntc));
+          }
+        }
+        TF1 f2root("f2root", "pol2", 0.01, 0.4);
+        grroot.Fit(&f2root, "QN0");
 
-      grtemp->Write();
+        double par[6];
+        f1root.GetParameters(&par[0]);
+        f2root.GetParameters(&par[3]);
+        total->SetParameters(par);
+        htow->Fit(total, "QRN0");
+        const double rootp1 = total->GetParameter(1);
+        const double reldiff = (result.par[1] - rootp1) / rootp1;
+        h_rootFitDiff->Fill(reldiff);
+        if (Verbosity() > 0 || std::abs(reldiff) > 1e-3)
+        {
+          std::cout << "ROOT fit check (" << ieta << "," << iphi << "): p1 CaloHistFitter " << result.par[1]
+                    << " +- " << result.err[1] << ", ROOT " << rootp1 << " +- " << total->GetParError(1) << std::endl;
+        }
+      }
 
-      if (fit_fn[kj])
+      if (result.ok)
       {
-        // cemc_hist_eta_phi.at(ieta).at(iphi) = i;
-        cemc_par1_values[ieta][iphi] = fit_fn[kj]->GetParameter(1);
+        // attach the fit function to the tower like TH1::Fit does
+        TF1 *fit_fn = new TF1();
+        total->Copy(*fit_fn);
+        fit_fn->SetParameters(result.par.data());
+        fit_fn->SetParErrors(result.err.data());
+        fit_fn->SetChisquare(result.chi2);
+        fit_fn->SetNDF(result.ndf);
+        fit_fn->SetParent(htow);
+        TObject *oldfunc = htow->GetListOfFunctions()->FindObject("total");
+        if (oldfunc)
+        {
+          htow->GetListOfFunctions()->Remove(oldfunc);
+          delete oldfunc;
+        }
+        htow->GetListOfFunctions()->Add(fit_fn);
 
-        //	if (!(cemc_par1_values[ieta][iphi]>0.0))
-        //	{
-        //		cemc_par1_values[ieta][iphi] = 0.5;
-        //	}
-        // cemc_par0_values[ieta][iphi]	= cemc_eta_phi_result->GetParameter(0);
-        cemc_par1_errors[ieta][iphi] = fit_fn[kj]->GetParError(1);
-        // cemc_par2_values[ieta][iphi]  = cemc_eta_phi_result->GetParameter(2);
-        // cemc_par2_errors[ieta][iphi] = cemc_eta_phi_result->GetParError(2);
+        cemc_par1_values[ieta][iphi] = result.par[1];
+        cemc_par1_errors[ieta][iphi] = result.err[1];
       }
       else
       {
@@ -1011,17 +1051,37 @@ void CaloCalibEmc_Pi0::Fit_Histos(const std::string &incorrFile)
       }
 
       nt_corrVals->Fill(ieta, iphi, 0.135 / cemc_par1_values[ieta][iphi], 0.135 / cemc_par1_values[ieta][iphi] * myaggcorr.at(ieta).at(iphi));
-      //}
 
-      // cemc_p1_eta_phi->Fill(cemc_par1_values[ieta][iphi],ieta,iphi);
+      if (cdbttree)
+      {
+        // failed fits keep the previous correction
+        float aggcorr = myaggcorr.at(ieta).at(iphi);
+        if (result.ok)
+        {
+          aggcorr *= 0.135 / cemc_par1_values[ieta][iphi];
+        }
+        cdbttree->SetFloatValue(TowerInfoDefs::encode_emcal(ieta, iphi), m_cdbFieldName, aggcorr);
+      }
 
-      // fitp0_eta_phi2d->SetBinContent(ieta+1,iphi+1,cemc_par0_values[ieta][iphi]);
       fitp1_eta_phi2d->SetBinContent(ieta + 1, iphi + 1, cemc_par1_values[ieta][iphi]);
       fitp1_eta_phi2d->SetBinError(ieta + 1, iphi + 1, cemc_par1_errors[ieta][iphi]);
-
-      kj++;
     }
   }
+  delete total;
+
+  if (m_rootFitCheck > 0)
+  {
+    std::cout << "ROOT fit check of " << h_rootFitDiff->GetEntries() << " towers: mean relative p1 difference "
+              << h_rootFitDiff->GetMean() << ", rms " << h_rootFitDiff->GetRMS() << std::endl;
+    h_rootFitDiff->Write();
+  }
+
+  if (cdbttree)
+  {
+    cdbttree->Commit();
+    cdbttree->WriteCDBTTree();
+    delete cdbttree;
+  }
 
   // nt_corrVals->Fill(ieta,259,0.135/cemc_par1_values[ieta][iphi],0.135/cemc_par1_values[ieta][iphi]*myaggcorr[ieta][259]);
 
@@ -73,6 +73,19 @@ class CaloCalibEmc_Pi0 : public SubsysReco
     _setMassVal = insetval;
   }
 
+  // number of threads for the tower fits in Fit_Histos (default 1), 0 = all cores
+  void set_nThreads(unsigned int n) { m_nThreads = n; }
+
+  // refit every n-th tower in Fit_Histos with TH1::Fit and compare the mean, 0 = off
+  void set_rootFitCheck(int every) { m_rootFitCheck = every; }
+
+  // write the aggregated tower corrections of Fit_Histos to a CDBTTree
+  void set_cdbOutput(const std::string &fname, const std::string &fieldname = "pi0_tbt_correction")
+  {
+    m_cdbFileName = fname;
+    m_cdbFieldName = fieldname;
+  }
+
  private:
   //  float setMassVal = 0.135;
   float _setMassVal{0.152};
@@ -126,6 +139,11 @@ class CaloCalibEmc_Pi0 : public SubsysReco
   TFile *f_temp{nullptr};
 
   int m_UseTowerInfo{0};  // 0 only old tower, 1 only new (TowerInfo based),
+
+  unsigned int m_nThreads{1};
+  int m_rootFitCheck{0};
+  std::string m_cdbFileName;
+  std::string m_cdbFieldName{"pi0_tbt_correction"};
 };
 
 #endif  //   CALOEMCPI0TBT_CALOCALIBEMC_PI0_H
@@ -0,0 +1,554 @@
+#include "CaloHistFitter.h"
+
+#include <TH1.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+  struct Point
+  {
+    double x;
+    double y;
+    double err;
+  };
+
+  using Model = std::function<double(double, const double *)>;
+
+  // solve a*x = b (n x n, row major) with partial pivoting, returns false if singular
+  bool solve(std::vector<double> a, std::vector<double> &b, const int n)
+  {
+    for (int col = 0; col < n; col++)
+    {
+      int pivot = col;
+      for (int row = col + 1; row < n; row++)
+      {
+        if (std::abs(a[row * n + col]) > std::abs(a[pivot * n + col]))
+        {
+          pivot = row;
+        }
+      }
+      if (a[pivot * n + col] == 0)
+      {
+        return false;
+      }
+      if (pivot != col)
+      {
+        for (int k = 0; k < n; k++)
+        {
+          std::swap(a[col * n + k], a[pivot * n + k]);
+        }
+        std::swap(b[col], b[pivot]);
+      }
+      for (int row = col + 1; row < n; row++)
+      {
+        const double factor = a[row * n + col] / a[col * n + col];
+        for (int k = col; k < n; k++)
+        {
+          a[row * n + k] -= factor * a[col * n + k];
+        }
+        b[row] -= factor * b[col];
+      }
+    }
+    for (int row = n - 1; row >= 0; row--)
+    {
+      for (int k = row + 1; k < n; k++)
+      {
+        b[row] -= a[row * n + k] * b[k];
+      }
+      b[row] /= a[row * n + row];
+    }
+    return true;
+  }
+
+  double chisquare(const Model &f, const std::vector<Point> &points, const double *par)
+  {
+    double chi2 = 0;
+    for (const auto &p : points)
+    {
+      const double r = (p.y - f(p.x, par)) / p.err;
+      chi2 += r * r;
+    }
+    return chi2;
+  }
+
+  // jacobian of the normalized residuals, central differences
+  void jacobian(const Model &f, const std::vector<Point> &points, const std::array<double, CaloHistFitter::MAXPAR> &par, const int npar, std::vector<double> &jac)
+  {
+    jac.assign(points.size() * npar, 0);
+    std::array<double, CaloHistFitter::MAXPAR> pp = par;
+    for (int j = 0; j < npar; j++)
+    {
+      const double h = 1e-6 * std::max(std::abs(par[j]), 1e-3);
+      pp[j] = par[j] + h;
+      for (size_t i = 0; i < points.size(); i++)
+      {
+        jac[i * npar + j] = f(points[i].x, pp.data());
+      }
+      pp[j] = par[j] - h;
+      for (size_t i = 0; i < points.size(); i++)
+      {
+        jac[i * npar + j] = (jac[i * npar + j] - f(points[i].x, pp.data())) / (2 * h * points[i].err);
+      }
+      pp[j] = par[j];
+    }
+  }
+
+  // Levenberg-Marquardt minimization of the chi2, parameters are kept within [lo, hi].
+  // The errors are sqrt(diag(cov)) with cov the inverse of J^T J at the minimum,
+  // the same as the HESSE errors of a ROOT chi2 fit
+  CaloHistFitter::Result levmar(const Model &f, const std::vector<Point> &points, const int npar,
+                                const std::array<double, CaloHistFitter::MAXPAR> &start,
+                                const std::array<double, CaloHistFitter::MAXPAR> &lo,
+                                const std::array<double, CaloHistFitter::MAXPAR> &hi)
+  {
+    CaloHistFitter::Result result;
+    result.start = start;
+    result.par = start;
+    for (int j = 0; j < npar; j++)
+    {
+      result.par[j] = std::clamp(result.par[j], lo[j], hi[j]);
+    }
+    result.ndf = static_cast<int>(points.size()) - npar;
+    if (result.ndf < 0)
+    {
+      return result;
+    }
+    double chi2 = chisquare(f, points, result.par.data());
+    double lambda = 1e-3;
+    std::vector<double> jac;
+    std::vector<double> alpha(npar * npar);
+    std::vector<double> beta(npar);
+    bool converged = false;
+    for (int iter = 0; iter < 500 && !converged; iter++)
+    {
+      jacobian(f, points, result.par, npar, jac);
+      std::fill(alpha.begin(), alpha.end(), 0);
+      std::fill(beta.begin(), beta.end(), 0);
+      for (size_t i = 0; i < points.size(); i++)
+      {
+        const double r = (points[i].y - f(points[i].x, result.par.data())) / points[i].err;
+        for (int j = 0; j < npar; j++)
+        {
+          beta[j] += jac[i * npar + j] * r;
+          for (int k = 0; k <= j; k++)
+          {
+            alpha[j * npar + k] += jac[i * npar + j] * jac[i * npar + k];
+          }
+        }
+      }
+      for (int j = 0; j < npar; j++)
+      {
+        for (int k = 0; k < j; k++)
+        {
+          alpha[k * npar + j] = alpha[j * npar + k];
+        }
+      }
+      // increase lambda until the chi2 goes down
+      while (true)
+      {
+        std::vector<double> a = alpha;
+        std::vector<double> delta = beta;
+        for (int j = 0; j < npar; j++)
+        {
+          a[j * npar + j] *= (1 + lambda);
+          if (a[j * npar + j] == 0)
+          {
+            a[j * npar + j] = lambda;
+          }
+        }
+        std::array<double, CaloHistFitter::MAXPAR> trial = result.par;
+        if (solve(a, delta, npar))
+        {
+          for (int j = 0; j < npar; j++)
+          {
+            trial[j] = std::clamp(result.par[j] + delta[j], lo[j], hi[j]);
+          }
+        }
+        const double trial_chi2 = chisquare(f, points, trial.data());
+        if (std::isfinite(trial_chi2) && trial_chi2 <= chi2)
+        {
+          converged = (chi2 - trial_chi2) < 1e-9 * std::max(chi2, 1.);
+          result.par = trial;
+          chi2 = trial_chi2;
+          lambda = std::max(lambda / 10, 1e-12);
+          break;
+        }
+        lambda *= 10;
+        if (lambda > 1e12)
+        {
+          converged = true;
+          break;
+        }
+      }
+    }
+    result.chi2 = chi2;
+
+    // covariance at the minimum
+    jacobian(f, points, result.par, npar, jac);
+    std::fill(alpha.begin(), alpha.end(), 0);
+    for (size_t i = 0; i < points.size(); i++)
+    {
+      for (int j = 0; j < npar; j++)
+      {
+        for (int k = 0; k < npar; k++)
+        {
+          alpha[j * npar + k] += jac[i * npar + j] * jac[i * npar + k];
+        }
+      }
+    }
+    result.ok = std::isfinite(chi2);
+    for (int j = 0; j < npar; j++)
+    {
+      std::vector<double> unit(npar, 0);
+      unit[j] = 1;
+      if (!solve(alpha, unit, npar) || unit[j] < 0)
+      {
+        result.ok = false;
+        continue;
+      }
+      result.err[j] = std::sqrt(unit[j]);
+    }
+    return result;
+  }
+
+  // bins from FindBin(xmin) to FindBin(xmax) with non zero error (like TH1::Fit)
+  std::vector<Point> select_bins(const CaloHistFitter::Histo &h, const double xmin, const double xmax)
+  {
+    std::vector<Point> points;
+    const int first = std::max(h.FindBin(xmin), 1);
+    const int last = std::min(h.FindBin(xmax), h.nbins);
+    for (int bin = first; bin <= last; bin++)
+    {
+      if (h.error[bin - 1] > 0)
+      {
+        points.push_back({h.BinCenter(bin), h.content[bin - 1], h.error[bin - 1]});
+      }
+    }
+    return points;
+  }
+
+  double gaus(const double x, const double *par)
+  {
+    const double arg = (x - par[1]) / par[2];
+    return par[0] * std::exp(-0.5 * arg * arg);
+  }
+
+  // starting values of a "gaus" fit in [first, last] as ROOT computes them (H1InitGaus)
+  std::array<double, CaloHistFitter::MAXPAR> init_gaus(const CaloHistFitter::Histo &h, const int first, const int last)
+  {
+    double allcha = 0;
+    double sumx = 0;
+    double sumx2 = 0;
+    double valmax = 0;
+    for (int bin = first; bin <= last; bin++)
+    {
+      const double x = h.BinCenter(bin);
+      const double val = std::abs(h.content[bin - 1]);
+      valmax = std::max(valmax, val);
+      sumx += val * x;
+      sumx2 += val * x * x;
+      allcha += val;
+    }
+    std::array<double, CaloHistFitter::MAXPAR> par{};
+    if (allcha <= 0)
+    {
+      return par;
+    }
+    const double mean = sumx / allcha;
+    double rms = sumx2 / allcha - mean * mean;
+    rms = (rms > 0) ? std::sqrt(rms) : h.binwidth * (last - first + 1) / 4.;
+    par[0] = 0.5 * (valmax + h.binwidth * allcha / (std::sqrt(2 * M_PI) * rms));
+    par[1] = mean;
+    par[2] = rms;
+    return par;
+  }
+}  // namespace
+
+//____________________________________________________________________________..
+CaloHistFitter::Histo::Histo(const TH1 *h)
+  : nbins(h->GetNbinsX())
+  , xlow(h->GetXaxis()->GetXmin())
+  , xhigh(h->GetXaxis()->GetXmax())
+  , binwidth((xhigh - xlow) / nbins)
+  , content(nbins)
+  , error(nbins)
+{
+  for (int bin = 1; bin <= nbins; bin++)
+  {
+    content[bin - 1] = h->GetBinContent(bin);
+    error[bin - 1] = h->GetBinError(bin);
+  }
+}
+
+int CaloHistFitter::Histo::FindBin(const double xval) const
+{
+  if (xval < xlow)
+  {
+    return 0;
+  }
+  if (xval >= xhigh)
+  {
+    return nbins + 1;
+  }
+  return 1 + static_cast<int>(nbins * (xval - xlow) / (xhigh - xlow));
+}
+
+double CaloHistFitter::Histo::Integral(const int binlow, const int binhigh) const
+{
+  double sum = 0;
+  for (int bin = std::max(binlow, 1); bin <= std::min(binhigh, nbins); bin++)
+  {
+    sum += content[bin - 1];
+  }
+  return sum;
+}
+
+//____________________________________________________________________________..
+CaloHistFitter::Spline::Spline(const std::vector<double> &x, const std::vector<double> &y)
+  : m_x(x)
+  , m_y(y)
+  , m_b(x.size(), 0)
+  , m_c(x.size(), 0)
+  , m_d(x.size(), 0)
+{
+  const int n = x.size();
+  if (n < 2)
+  {
+    return;
+  }
+  std::vector<double> h(n - 1);
+  std::vector<double> slope(n - 1);
+  for (int i = 0; i < n - 1; i++)
+  {
+    h[i] = x[i + 1] - x[i];
+    slope[i] = (y[i + 1] - y[i]) / h[i];
+  }
+  // second derivatives m, m[0] and m[n-1] follow from the not-a-knot
+  // conditions (continuous third derivative at x[1] and x[n-2])
+  std::vector<double> m(n, 0);
+  if (n == 3)
+  {
+    // a single parabola
+    m[0] = m[1] = m[2] = 2 * (slope[1] - slope[0]) / (h[0] + h[1]);
+  }
+  else if (n > 3)
+  {
+    const int nin = n - 2;  // m[1] ... m[n-2]
+    std::vector<double> sub(nin, 0);
+    std::vector<double> diag(nin, 0);
+    std::vector<double> sup(nin, 0);
+    std::vector<double> rhs(nin, 0);
+    for (int k = 0; k < nin; k++)
+    {
+      const int i = k + 1;
+      sub[k] = h[i - 1];
+      diag[k] = 2 * (h[i - 1] + h[i]);
+      sup[k] = h[i];
+      rhs[k] = 6 * (slope[i] - slope[i - 1]);
+    }
+    // m[0] = ((h0+h1) m[1] - h0 m[2]) / h1
+    diag[0] += h[0] * (h[0] + h[1]) / h[1];
+    sup[0] -= h[0] * h[0] / h[1];
+    // m[n-1] = ((h[n-2]+h[n-3]) m[n-2] - h[n-2] m[n-3]) / h[n-3]
+    diag[nin - 1] += h[n - 2] * (h[n - 2] + h[n - 3]) / h[n - 3];
+    sub[nin - 1] -= h[n - 2] * h[n - 2] / h[n - 3];
+    // tridiagonal solve
+    for (int k = 1; k < nin; k++)
+    {
+      const double factor = sub[k] / diag[k - 1];
+      diag[k] -= factor * sup[k - 1];
+      rhs[k] -= factor * rhs[k - 1];
+    }
+    m[nin] = rhs[nin - 1] / diag[nin - 1];
+    for (int k = nin - 2; k >= 0; k--)
+    {
+      m[k + 1] = (rhs[k] - sup[k] * m[k + 2]) / diag[k];
+    }
+    m[0] = ((h[0] + h[1]) * m[1] - h[0] * m[2]) / h[1];
+    m[n - 1] = ((h[n - 2] + h[n - 3]) * m[n - 2] - h[n - 2] * m[n - 3]) / h[n - 3];
+  }
+  for (int i = 0; i < n - 1; i++)
+  {
+    m_b[i] = slope[i] - h[i] * (2 * m[i] + m[i + 1]) / 6;
+    m_c[i] = m[i] / 2;
+    m_d[i] = (m[i + 1] - m[i]) / (6 * h[i]);
+  }
+}
+
+double CaloHistFitter::Spline::Eval(const double xval) const
+{
+  if (m_x.empty())
+  {
+    return 0;
+  }
+  if (m_x.size() == 1)
+  {
+    return m_y[0];
+  }
+  // the first and last polynomial are used outside of the points
+  int k = std::upper_bound(m_x.begin(), m_x.end(), xval) - m_x.begin() - 1;
+  k = std::clamp<int>(k, 0, m_x.size() - 2);
+  const double dx = xval - m_x[k];
+  return m_y[k] + dx * (m_b[k] + dx * (m_c[k] + dx * m_d[k]));
+}
+
+//____________________________________________________________________________..
+CaloHistFitter::CaloHistFitter(const unsigned int nthreads)
+{
+  setNThreads(nthreads);
+}
+
+void CaloHistFitter::setNThreads(const unsigned int nthreads)
+{
+  m_NThreads = nthreads;
+  if (m_NThreads == 0)
+  {
+    m_NThreads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+}
+
+void CaloHistFitter::run(const size_t njobs, const std::function<void(size_t)> &func) const
+{
+  std::atomic<size_t> next{0};
+  auto worker = [&]()
+  {
+    for (size_t i = next++; i < njobs; i = next++)
+    {
+      func(i);
+    }
+  };
+  const unsigned int nthreads = std::min<size_t>(m_NThreads, njobs);
+  if (nthreads <= 1)
+  {
+    worker();
+    return;
+  }
+  std::vector<std::thread> threads;
+  threads.reserve(nthreads - 1);
+  for (unsigned int i = 1; i < nthreads; i++)
+  {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+}
+
+//____________________________________________________________________________..
+CaloHistFitter::Result CaloHistFitter::FitShift(const Histo &h, const Histo &ref, const double p0, const double p1, const double xmin, const double xmax)
+{
+  std::vector<double> x(ref.nbins);
+  for (int bin = 1; bin <= ref.nbins; bin++)
+  {
+    x[bin - 1] = ref.BinCenter(bin);
+  }
+  const Spline spline(x, ref.content);
+  const Model f = [&spline](double xval, const double *par)
+  { return par[0] * spline.Eval(xval * par[1]); };
+
+  std::array<double, MAXPAR> start{};
+  start[0] = p0;
+  start[1] = p1;
+  std::array<double, MAXPAR> lo;
+  std::array<double, MAXPAR> hi;
+  lo.fill(-HUGE_VAL);
+  hi.fill(HUGE_VAL);
+  return levmar(f, select_bins(h, xmin, xmax), 2, start, lo, hi);
+}
+
+CaloHistFitter::Result CaloHistFitter::FitPi0(const Histo &h, const double xmin, const double xmax, const double sigmin, const double sigmax)
+{
+  std::array<double, MAXPAR> lo;
+  std::array<double, MAXPAR> hi;
+  lo.fill(-HUGE_VAL);
+  hi.fill(HUGE_VAL);
+
+  // find max bin around peak
+  double pkloc = 0;
+  double bsavloc = 0;
+  for (int bin = 1; bin < std::min(20, h.nbins + 1); bin++)
+  {
+    if (h.content[bin - 1] > bsavloc)
+    {
+      pkloc = h.BinCenter(bin);
+      bsavloc = h.content[bin - 1];
+    }
+  }
+
+  // gaus around the peak
+  const double gmin = pkloc - 0.04;
+  const double gmax = pkloc + 0.04;
+  const Model fgaus = gaus;
+  Result gausfit = levmar(fgaus, select_bins(h, gmin, gmax), 3,
+                          init_gaus(h, std::max(h.FindBin(gmin), 1), std::min(h.FindBin(gmax), h.nbins)), lo, hi);
+  const double fpkloc2 = gausfit.par[1];
+
+  // pol2 to the side bands. Like the TGraphErrors fit this replaces, the
+  // points have errors of 0.001 on x and sqrt(content) on y, and the chi2 uses
+  // the effective variance ey^2 + (ex * pol2'(x))^2. Empty bins are kept, they
+  // only carry the x error. The variances are iterated from the fit of the
+  // previous pass; the first pass has no slope yet, so the empty bins have zero
+  // variance and do not enter it.
+  std::vector<Point> sideband;
+  for (int bin = 1; bin <= h.nbins; bin++)
+  {
+    const double binc = h.BinCenter(bin);
+    const double scale = fpkloc2 / 0.145;
+    if ((binc > 0.06 * scale && binc < 0.09 * scale) || (binc > 0.22 * scale && binc < 0.35 * scale))
+    {
+      sideband.push_back({binc, h.content[bin - 1], std::sqrt(std::max(h.content[bin - 1], 0.))});
+    }
+  }
+  std::array<double, 3> pol{};
+  for (int iter = 0; iter < 20; iter++)
+  {
+    std::vector<double> a(9, 0);
+    std::vector<double> b(3, 0);
+    for (const auto &p : sideband)
+    {
+      const double deriv = pol[1] + 2 * pol[2] * p.x;
+      const double var = p.err * p.err + 1e-6 * deriv * deriv;
+      if (!(var > 0))
+      {
+        continue;
+      }
+      const std::array<double, 3> basis = {1, p.x, p.x * p.x};
+      for (int j = 0; j < 3; j++)
+      {
+        b[j] += basis[j] * p.y / var;
+        for (int k = 0; k < 3; k++)
+        {
+          a[j * 3 + k] += basis[j] * basis[k] / var;
+        }
+      }
+    }
+    if (!solve(a, b, 3))
+    {
+      break;
+    }
+    bool converged = true;
+    for (int j = 0; j < 3; j++)
+    {
+      converged &= std::abs(b[j] - pol[j]) <= 1e-9 * std::max(std::abs(b[j]), 1e-12);
+    }
+    std::copy(b.begin(), b.end(), pol.begin());
+    if (converged)
+    {
+      break;
+    }
+  }
+
+  // gaus + pol2
+  const Model ftotal = [](double x, const double *par)
+  { return gaus(x, par) + par[3] + x * (par[4] + x * par[5]); };
+  std::array<double, MAXPAR> start = {gausfit.par[0], gausfit.par[1], gausfit.par[2], pol[0], pol[1], pol[2]};
+  lo[2] = sigmin;
+  hi[2] = sigmax;
+  return levmar(ftotal, select_bins(h, xmin, xmax), 6, start, lo, hi);
+}
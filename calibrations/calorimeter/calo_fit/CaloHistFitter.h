@@ -0,0 +1,94 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef CALOFIT_CALOHISTFITTER_H
+#define CALOFIT_CALOHISTFITTER_H
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+class TH1;
+
+// Fits of the per tower calibration histograms outside of ROOT. The histogram
+// contents are copied into flat arrays (serially, ROOT is not thread safe),
+// the fits themselves only use these arrays and can run on many threads:
+//
+//   CaloHistFitter fitter(8);
+//   std::vector<CaloHistFitter::Histo> data;  // one per tower
+//   std::vector<CaloHistFitter::Result> res(data.size());
+//   fitter.run(data.size(), [&](size_t i) { res[i] = CaloHistFitter::FitPi0(data[i]); });
+//
+// The minimizer is a Levenberg-Marquardt chi2 fit with the bin selection,
+// empty bin treatment and parameter errors of a default ROOT histogram fit
+class CaloHistFitter
+{
+ public:
+  static constexpr int MAXPAR = 6;
+
+  // flat copy of a TH1, bins 1 to nbins
+  struct Histo
+  {
+    Histo() = default;
+    explicit Histo(const TH1 *h);
+    int FindBin(const double xval) const;  // same as TH1::FindBin, 0/nbins+1 for under/overflow
+    double Integral(const int binlow, const int binhigh) const;
+    double BinCenter(const int bin) const { return xlow + (bin - 0.5) * binwidth; }
+    int nbins{0};
+    double xlow{0};
+    double xhigh{1};
+    double binwidth{1};
+    std::vector<double> content;  // index bin-1
+    std::vector<double> error;
+  };
+
+  struct Result
+  {
+    std::array<double, MAXPAR> par{};
+    std::array<double, MAXPAR> err{};
+    std::array<double, MAXPAR> start{};  // parameters the final minimization started from
+    double chi2{0};
+    int ndf{0};
+    bool ok{false};
+  };
+
+  // cubic spline through the points, identical to TGraph::Eval(x, nullptr, "S")
+  // (TSpline3 without end point conditions, i.e. not-a-knot)
+  class Spline
+  {
+   public:
+    Spline(const std::vector<double> &x, const std::vector<double> &y);
+    double Eval(const double xval) const;
+
+   private:
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_b;
+    std::vector<double> m_c;
+    std::vector<double> m_d;
+  };
+
+  explicit CaloHistFitter(const unsigned int nthreads = 0);
+
+  void setNThreads(const unsigned int nthreads);
+  unsigned int getNThreads() const { return m_NThreads; }
+
+  // calls func(i) for i = 0 ... njobs-1 on the threads
+  void run(const size_t njobs, const std::function<void(size_t)> &func) const;
+
+  // LiteCaloEval relative shift fit: h(x) = p0 * ref(p1*x) in [xmin, xmax]
+  // with ref the spline through the bin centers/contents of the reference
+  static Result FitShift(const Histo &h, const Histo &ref, const double p0, const double p1, const double xmin, const double xmax);
+
+  // CaloCalibEmc_Pi0 peak fit:
+  // - gaus around the maximum of the first 19 bins (+-0.04)
+  // - pol2 to the side bands 0.06-0.09 and 0.22-0.35 (scaled to the gaus mean/0.145),
+  //   empty bins included, with x errors of 0.001 like the TGraphErrors fit
+  // - gaus(0)+pol2(3) in [xmin, xmax] with the width limited to [sigmin, sigmax]
+  static Result FitPi0(const Histo &h, const double xmin = 0.06, const double xmax = 0.25, const double sigmin = 0.01, const double sigmax = 0.027);
+
+ private:
+  unsigned int m_NThreads{1};
+};
+
+#endif
@@ -5,6 +5,11 @@
 #include <calobase/RawTowerGeomContainer.h>
 #include <calobase/TowerInfo.h>
 #include <calobase/TowerInfoContainer.h>
+#include <calobase/TowerInfoDefs.h>
+
+#include <calo_fit/CaloHistFitter.h>
+
+#include <cdbobjects/CDBTTree.h>
 
 #include <ffarawobjects/Gl1Packet.h>
 #include <calotrigger/TriggerAnalyzer.h>
@@ -33,16 +38,32 @@
 
 #include <boost/format.hpp>
 
+#include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <map>      // for _Rb_tree_const_iterator
 #include <utility>  // for pair
+#include <vector>
 
 class RawTowerGeom;
 
 /// This function is used for the histo fitting process. x is a 1d array that holds xaxis values.
 /// par is an array of 1d array of parameters we set our fit function to. So p[0] = p[1] = 1 unless otherwise noted
+namespace
+{
+  // one tower of FitRelativeShifts
+  struct TowerFitJob
+  {
+    int iphi{0};
+    bool subtract{false};  // ring mode: remove the tower from the eta slice reference
+    double scaleP0{0};
+    CaloHistFitter::Histo tower;
+    CaloHistFitter::Histo ref;
+    CaloHistFitter::Result result;
+  };
+}  // namespace
+
 double LCE_fitf(Double_t *x, Double_t *par)
 {
   return par[0] * LCE_grff->Eval(x[0] * par[1], nullptr, "S");
@@ -669,6 +690,29 @@ void LiteCaloEval::FitRelativeShifts(LiteCaloEval *ref_lce, int modeFitShifts)
     maxbin = m_mymaxbin;
   }
 
+  /// relative difference of the tower p1 to the TH1::Fit result (set_rootFitCheck)
+  TH1F *h_rootFitDiff = new TH1F("h_rootFitDiff", "CaloHistFitter - ROOT fit", 2000, -0.01, 0.01);
+  h_rootFitDiff->SetXTitle("(p1 - p1_{ROOT})/p1_{ROOT}");
+
+  std::string caloname = "EMCAL";
+  if (calotype == LiteCaloEval::HCALOUT)
+  {
+    caloname = "OHCAL";
+  }
+  else if (calotype == LiteCaloEval::HCALIN)
+  {
+    caloname = "IHCAL";
+  }
+
+  CaloHistFitter fitter(m_nThreads);
+  std::cout << "Fitting towers with " << fitter.getNThreads() << " threads" << std::endl;
+
+  CDBTTree *cdbttree = nullptr;
+  if (!m_cdbFileName.empty())
+  {
+    cdbttree = new CDBTTree(m_cdbFileName);
+  }
+
   /// assign hnewf the eta slice histos when running in Gain Trace mode
   TH1F *hnewf = nullptr;
 
@@ -851,185 +895,139 @@ void LiteCaloEval::FitRelativeShifts(LiteCaloEval *ref_lce, int modeFitShifts)
       }
     }
     /****************************************************
-    This is the nested forloop to start tower material
+    This is the nested forloop to start tower material.
+    The histograms are copied serially (ROOT is not thread safe),
+    the fits run on the CaloHistFitter threads
     ****************************************************/
 
-    for (int j = 0; j < max_iphi; j++)
+    /// flat copy of the (smoothed) eta slice reference, the tower is subtracted per job
+    CaloHistFitter::Histo ringRef;
+    if (flag_fit_rings == true)
     {
-      /// names of tower histo for cloning. used in gain trace mode
-      std::string myClnmp = "newhc_eta" + std::to_string(1000 * (i + 2) + j);
-
-      /// histo to hold tower clone
-      TH1F *hnewfp = nullptr;
-
-      // check to see if tower in question is part of the chimney/high eta support ring
+      ringRef = CaloHistFitter::Histo(cleanEtaRef);
+    }
 
-      bool _isChimney = chk_isChimney(i, j);
+    std::vector<TowerFitJob> jobs;
+    for (int j = 0; j < max_iphi; j++)
+    {
+      TH1 *htow = tower_hist(i, j);
 
-      if (calotype == LiteCaloEval::CEMC)
+      // skip tower if there are no entries
+      if (!(htow->GetEntries()))
       {
-        // skip tower if there are no entries
-        if (!(cemc_hist_eta_phi[i][j]->GetEntries()))
-        {
-          std::cout << "No entries in EMCAL tower histogram (" << i << "," << j << "). Skipping fitting." << std::endl;
-          continue;
-        }
-
-        if (flag_fit_rings == true)
-        {
-          cleanEtaRef->Add((TH1F *) cemc_hist_eta_phi[i][j], -1.0);
-        }
-        else
-        {
-          hnewfp = (TH1F *) ref_lce->cemc_hist_eta_phi[i][j]->Clone(myClnmp.c_str());
-        }
+        std::cout << "No entries in " << caloname << " tower histogram (" << i << "," << j << "). Skipping fitting." << std::endl;
+        continue;
       }
 
-      else if (calotype == LiteCaloEval::HCALOUT)
-      {
-        // skip tower if there are no entries
-        if (!(hcal_out_eta_phi[i][j]->GetEntries()))
-        {
-          std::cout << "No entries in OHCAL tower histogram (" << i << "," << j << "). Skipping fitting." << std::endl;
-          continue;
-        }
+      TowerFitJob job;
+      job.iphi = j;
+      job.tower = CaloHistFitter::Histo(htow);
 
-        if (flag_fit_rings == true)
-        {
-          // check to see if tower is part of chimney/high eta support. If it isnt, proceed to remove that tower from eta ref. This is to ensure we dont remove towers in these regions  twice from eta ref bc they already were in L717
-
-          if (!_isChimney)
-          {
-            cleanEtaRef->Add((TH1F *) hcal_out_eta_phi[i][j], -1.0);
-          }
-        }
-
-        else
-        {
-          hnewfp = (TH1F *) ref_lce->hcal_out_eta_phi[i][j]->Clone(myClnmp.c_str());
-        }
-      }
-
-      else if (calotype == LiteCaloEval::HCALIN)
+      if (flag_fit_rings == true)
       {
-        // skip tower if there are no entries
-        if (!(hcal_in_eta_phi[i][j]->GetEntries()))
-        {
-          std::cout << "No entries in IHCAL tower histogram(" << i << "," << j << "). Skipping fitting." << std::endl;
-          continue;
-        }
-
-        if (flag_fit_rings == true)
-        {
-          cleanEtaRef->Add((TH1F *) hcal_in_eta_phi[i][j], -1.0);
-        }
-        else
-        {
-          hnewfp = (TH1F *) ref_lce->hcal_in_eta_phi[i][j]->Clone(myClnmp.c_str());
-        }
+        // towers of the chimney/high eta support ring in the OHCAL were already removed from the eta ref
+        job.subtract = !(calotype == LiteCaloEval::HCALOUT && chk_isChimney(i, j));
       }
-
-      /*
-        If false make tgraph out of tower and send to be fit with fit fuction.
-        If true the towers are actually fit against the eta ring. This happends bc "myexpo" uses a tgraph
-        to fit, and if we dont make LCE_grff for a tower, myexpo uses the latest version of LCE_grff, which is an eta slice tgraph
-      */
-
-      if (flag_fit_rings == false)
+      else
       {
+        /// names of tower histo for cloning. used in gain trace mode
+        std::string myClnmp = "newhc_eta" + std::to_string(1000 * (i + 2) + j);
+        TH1 *hnewfp = (TH1 *) ref_lce->tower_hist(i, j)->Clone(myClnmp.c_str());
         hnewfp->Smooth(nsmooth);
-        LCE_grff = new TGraph(hnewfp);
+        job.ref = CaloHistFitter::Histo(hnewfp);
+        delete hnewfp;
       }
+      jobs.push_back(std::move(job));
+    }
 
+    auto fit_tower = [&](size_t ijob)
+    {
+      TowerFitJob &job = jobs[ijob];
       if (flag_fit_rings == true)
       {
-        // cleanEtaRef->Smooth(nsmooth);
-        LCE_grff = new TGraph(cleanEtaRef);
-      }
-
-      /// make tf1 that will hold the resulting fit of towers
-      TF1 *f2f2 = nullptr;
-
-      // need to scale the reference histogram to allow it to start at an amplitude similar/at tower that is to be fit
-      if (calotype == LiteCaloEval::CEMC)
-      {
-        double scaleP0 = cemc_hist_eta_phi[i][j]->Integral(cemc_hist_eta_phi[i][j]->FindBin(fitmin), cemc_hist_eta_phi[i][j]->FindBin(fitmax));
-
-        if (flag_fit_rings == 1)
-        {
-          scaleP0 /= cleanEtaRef->Integral(cleanEtaRef->FindBin(fitmin), cleanEtaRef->FindBin(fitmax));
-        }
-        else
+        job.ref = ringRef;
+        if (job.subtract)
         {
-          scaleP0 /= hnewfp->Integral(hnewfp->FindBin(fitmin), hnewfp->FindBin(fitmax));
-        }
-
-        f1->SetParameters(scaleP0, 1.0);
-
-        cemc_hist_eta_phi[i][j]->Fit("myexpo", "Q", "", fitmin, fitmax);
-
-        f2f2 = (TF1 *) cemc_hist_eta_phi[i][j]->GetFunction("myexpo");
-
-        // add back the just fitted tower to the eta slice reference
-        if (flag_fit_rings == true)
-        {
-          cleanEtaRef->Add((TH1F *) cemc_hist_eta_phi[i][j], 1.0);
+          for (size_t k = 0; k < job.ref.content.size(); k++)
+          {
+            job.ref.content[k] -= job.tower.content[k];
+          }
         }
       }
+      // need to scale the reference histogram to allow it to start at an amplitude similar/at tower that is to be fit
+      job.scaleP0 = job.tower.Integral(job.tower.FindBin(fitmin), job.tower.FindBin(fitmax)) /
+                    job.ref.Integral(job.ref.FindBin(fitmin), job.ref.FindBin(fitmax));
+      job.result = CaloHistFitter::FitShift(job.tower, job.ref, job.scaleP0, 1.0, fitmin, fitmax);
+      // the copies are not needed anymore
+      job.tower = CaloHistFitter::Histo();
+      job.ref = CaloHistFitter::Histo();
+    };
+    fitter.run(jobs.size(), fit_tower);
+
+    for (size_t ijob = 0; ijob < jobs.size(); ijob++)
+    {
+      const TowerFitJob &job = jobs[ijob];
+      const int j = job.iphi;
+      TH1 *htow = tower_hist(i, j);
 
-      else if (calotype == LiteCaloEval::HCALOUT)
+      if (m_rootFitCheck > 0 && ijob % m_rootFitCheck == 0)
       {
-        double scaleP0 = hcal_out_eta_phi[i][j]->Integral(hcal_out_eta_phi[i][j]->FindBin(fitmin), hcal_out_eta_phi[i][j]->FindBin(fitmax));
-
-        if (flag_fit_rings == 1)
-        {
-          scaleP0 /= cleanEtaRef->Integral(cleanEtaRef->FindBin(fitmin), cleanEtaRef->FindBin(fitmax));
-        }
-        else
-        {
-          scaleP0 /= hnewfp->Integral(hnewfp->FindBin(fitmin), hnewfp->FindBin(fitmax));
-        }
-
-        f1->SetParameters(scaleP0, 1.0);
-
-        hcal_out_eta_phi[i][j]->Fit("myexpo", "Q", "", fitmin, fitmax);
-
-        f2f2 = (TF1 *) hcal_out_eta_phi[i][j]->GetFunction("myexpo");
-
+        TH1 *href = nullptr;
         if (flag_fit_rings == true)
         {
-          if (!_isChimney)
+          href = (TH1 *) cleanEtaRef->Clone("rootFitCheckRef");
+          if (job.subtract)
           {
-            cleanEtaRef->Add((TH1F *) hcal_out_eta_phi[i][j], 1.0);
+            href->Add(htow, -1.0);
           }
         }
-      }
-
-      else if (calotype == LiteCaloEval::HCALIN)
-      {
-        double scaleP0 = hcal_in_eta_phi[i][j]->Integral(hcal_in_eta_phi[i][j]->FindBin(fitmin), hcal_in_eta_phi[i][j]->FindBin(fitmax));
-
-        if (flag_fit_rings == 1)
+        else
         {
-          scaleP0 /= cleanEtaRef->Integral(cleanEtaRef->FindBin(fitmin), cleanEtaRef->FindBin(fitmax));
+          href = (TH1 *) ref_lce->tower_hist(i, j)->Clone("rootFitCheckRef");
+          href->Smooth(nsmooth);
         }
-
-        else
+        // same scaling of the start amplitude as the fit, computed on the ROOT histograms
+        const double rootScaleP0 = htow->Integral(htow->FindBin(fitmin), htow->FindBin(fitmax)) /
+                                   href->Integral(href->FindBin(fitmin), href->FindBin(fitmax));
+        TGraph *grsav = LCE_grff;
+        LCE_grff = new TGraph(href);
+        f1->SetParameters(rootScaleP0, 1.0);
+        htow->Fit(f1, "QN0", "", fitmin, fitmax);
+        delete LCE_grff;
+        LCE_grff = grsav;
+        delete href;
+
+        const double rootp1 = f1->GetParameter(1);
+        const double reldiff = (job.result.par[1] - rootp1) / rootp1;
+        h_rootFitDiff->Fill(reldiff);
+        if (Verbosity() > 0 || std::abs(reldiff) > 1e-3)
         {
-          scaleP0 /= hnewfp->Integral(hnewfp->FindBin(fitmin), hnewfp->FindBin(fitmax));
+          std::cout << "ROOT fit check (" << i << "," << j << "): p1 CaloHistFitter " << job.result.par[1]
+                    << " +- " << job.result.err[1] << ", ROOT " << rootp1 << " +- " << f1->GetParError(1) << std::endl;
         }
+      }
 
-        f1->SetParameters(scaleP0, 1.0);
-
-        hcal_in_eta_phi[i][j]->Fit("myexpo", "Q", "", fitmin, fitmax);
-
-        f2f2 = (TF1 *) hcal_in_eta_phi[i][j]->GetFunction("myexpo");
+      if (!job.result.ok)
+      {
+        std::cout << "Fit of tower (" << i << "," << j << ") did not converge" << std::endl;
+      }
 
-        if (flag_fit_rings == true)
-        {
-          cleanEtaRef->Add((TH1F *) hcal_in_eta_phi[i][j], 1.0);
-        }
+      // attach the fit function to the tower like TH1::Fit does, fit_info reads it back
+      TF1 *f2f2 = new TF1();
+      f1->Copy(*f2f2);
+      f2f2->SetParameters(job.result.par[0], job.result.par[1]);
+      f2f2->SetParErrors(job.result.err.data());
+      f2f2->SetChisquare(job.result.chi2);
+      f2f2->SetNDF(job.result.ndf);
+      f2f2->SetRange(fitmin, fitmax);
+      f2f2->SetParent(htow);
+      TObject *oldfunc = htow->GetListOfFunctions()->FindObject("myexpo");
+      if (oldfunc)
+      {
+        htow->GetListOfFunctions()->Remove(oldfunc);
+        delete oldfunc;
       }
+      htow->GetListOfFunctions()->Add(f2f2);
 
       float correction = f2f2->GetParameter(1);
 
@@ -1049,8 +1047,20 @@ void LiteCaloEval::FitRelativeShifts(LiteCaloEval *ref_lce, int modeFitShifts)
 
       h_gainErr->Fill(errProp);
 
+      if (cdbttree)
+      {
+        unsigned int key = (calotype == LiteCaloEval::CEMC) ? TowerInfoDefs::encode_emcal(i, j) : TowerInfoDefs::encode_hcal(i, j);
+        cdbttree->SetFloatValue(key, m_cdbFieldName, 1 / correction);
+      }
+
     }  // end of inner forloop (phi)
 
+    // the next eta slice fit starts from the last tower result (as TH1::Fit leaves f1)
+    if (!jobs.empty())
+    {
+      f1->SetParameters(jobs.back().result.par[0], jobs.back().result.par[1]);
+    }
+
   }  // end of outter forloop (eta)
 
   // create graph that plots eta slice par values (this is only when looping over eta slices - not towers)
@@ -1065,6 +1075,19 @@ void LiteCaloEval::FitRelativeShifts(LiteCaloEval *ref_lce, int modeFitShifts)
   h2_failQA->Write();
   gainvals->Write();
   h_gainErr->Write();
+  if (m_rootFitCheck > 0)
+  {
+    std::cout << "ROOT fit check of " << h_rootFitDiff->GetEntries() << " towers: mean relative p1 difference "
+              << h_rootFitDiff->GetMean() << ", rms " << h_rootFitDiff->GetRMS() << std::endl;
+    h_rootFitDiff->Write();
+  }
+
+  if (cdbttree)
+  {
+    cdbttree->Commit();
+    cdbttree->WriteCDBTTree();
+    delete cdbttree;
+  }
 
  
 
@@ -1076,6 +1099,19 @@ void LiteCaloEval::FitRelativeShifts(LiteCaloEval *ref_lce, int modeFitShifts)
   f_temp->Close();
 }
 
+TH1 *LiteCaloEval::tower_hist(int ieta, int iphi) const
+{
+  if (calotype == LiteCaloEval::CEMC)
+  {
+    return cemc_hist_eta_phi[ieta][iphi];
+  }
+  if (calotype == LiteCaloEval::HCALOUT)
+  {
+    return hcal_out_eta_phi[ieta][iphi];
+  }
+  return hcal_in_eta_phi[ieta][iphi];
+}
+
 bool LiteCaloEval::chk_isChimney(int ieta, int iphi)
 {
   if ((ieta < 4 || ieta > 19) && (iphi > 13 && iphi < 20))
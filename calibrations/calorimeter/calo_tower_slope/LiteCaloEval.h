@@ -115,6 +115,19 @@ class LiteCaloEval : public SubsysReco
     return;
   }
 
+  /// number of threads for the tower fits in FitRelativeShifts (default 1), 0 = all cores
+  void set_nThreads(unsigned int n) { m_nThreads = n; }
+
+  /// refit every n-th tower with TH1::Fit and compare to the CaloHistFitter result, 0 = off
+  void set_rootFitCheck(int every) { m_rootFitCheck = every; }
+
+  /// write the tower corrections (1/p1) of FitRelativeShifts to a CDBTTree
+  void set_cdbOutput(const std::string &fname, const std::string &fieldname = "towerslope_correction")
+  {
+    m_cdbFileName = fname;
+    m_cdbFieldName = fieldname;
+  }
+
  private:
   TFile *cal_output{nullptr};
 
@@ -151,6 +164,13 @@ class LiteCaloEval : public SubsysReco
 
   bool reqMinBias = true;
 
+  TH1 *tower_hist(int ieta, int iphi) const;
+
+  unsigned int m_nThreads{1};
+  int m_rootFitCheck{0};
+  std::string m_cdbFileName;
+  std::string m_cdbFieldName{"towerslope_correction"};
+
   int mode = 0;
 
   TriggerAnalyzer* trigAna{nullptr};
@@ -0,0 +1,52 @@
+// Counts the heap allocations done through the global operator new for
+// Fun4AllProfiler. This replaces operator new for the whole process, it only
+// works reliably if the library is preloaded:
+//   LD_PRELOAD=libfun4all_alloccounter.so root.exe Fun4All_G4_sPHENIX.C
+// The memory is still allocated with malloc, so the default operator delete
+// releases it
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+  std::atomic<uint64_t> nallocs{0};
+
+  void *counted_alloc(std::size_t size)
+  {
+    nallocs.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+  }
+}  // namespace
+
+extern "C" uint64_t Fun4AllAllocCount()
+{
+  return nallocs.load(std::memory_order_relaxed);
+}
+
+void *operator new(std::size_t size)
+{
+  void *ptr = counted_alloc(size);
+  if (!ptr)
+  {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t & /*unused*/) noexcept
+{
+  return counted_alloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t & /*unused*/) noexcept
+{
+  return counted_alloc(size);
+}
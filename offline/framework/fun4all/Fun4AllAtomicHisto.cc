@@ -0,0 +1,94 @@
+#include "Fun4AllAtomicHisto.h"
+
+#include <TArrayD.h>
+#include <TAxis.h>
+#include <TH1.h>
+
+namespace
+{
+  // std::atomic<double>::fetch_add is C++20
+  void atomic_add(std::atomic<double> &a, const double val)
+  {
+    double old = a.load(std::memory_order_relaxed);
+    while (!a.compare_exchange_weak(old, old + val, std::memory_order_relaxed))
+    {
+    }
+  }
+}  // namespace
+
+Fun4AllAtomicHisto::Fun4AllAtomicHisto(TH1 *h)
+  : m_Histo(h)
+  , m_Dimension(h->GetDimension())
+  , m_NCells(h->GetNcells())
+  , m_SumW(new std::atomic<double>[m_NCells])
+  , m_SumW2(new std::atomic<double>[m_NCells])
+{
+  Reset();
+}
+
+void Fun4AllAtomicHisto::Fill(const double x)
+{
+  Fill(x, 1.);
+}
+
+void Fun4AllAtomicHisto::Fill(const double x, const double yw)
+{
+  if (m_Dimension == 1)
+  {
+    add(m_Histo->GetXaxis()->FindFixBin(x), yw);
+  }
+  else
+  {
+    Fill(x, yw, 1.);
+  }
+}
+
+void Fun4AllAtomicHisto::Fill(const double x, const double y, const double w)
+{
+  add(m_Histo->GetBin(m_Histo->GetXaxis()->FindFixBin(x), m_Histo->GetYaxis()->FindFixBin(y)), w);
+}
+
+void Fun4AllAtomicHisto::add(const int bin, const double w)
+{
+  atomic_add(m_SumW[bin], w);
+  atomic_add(m_SumW2[bin], w * w);
+  m_Entries.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Fun4AllAtomicHisto::Flush()
+{
+  const long long entries = m_Entries.exchange(0);
+  if (entries == 0)
+  {
+    return;
+  }
+  const double oldentries = m_Histo->GetEntries();
+  if (m_Histo->GetSumw2N() == 0)
+  {
+    m_Histo->Sumw2();
+  }
+  TArrayD *sumw2 = m_Histo->GetSumw2();
+  for (int bin = 0; bin < m_NCells; bin++)
+  {
+    const double sumw = m_SumW[bin].exchange(0.);
+    const double sumwsq = m_SumW2[bin].exchange(0.);
+    if (sumw != 0. || sumwsq != 0.)
+    {
+      m_Histo->AddBinContent(bin, sumw);
+      (*sumw2)[bin] += sumwsq;
+    }
+  }
+  // recalculate mean/rms from the bins, this resets the entries as well
+  m_Histo->ResetStats();
+  m_Histo->SetEntries(oldentries + entries);
+}
+
+void Fun4AllAtomicHisto::Reset()
+{
+  for (int bin = 0; bin < m_NCells; bin++)
+  {
+    m_SumW[bin].store(0.);
+    m_SumW2[bin].store(0.);
+  }
+  m_Entries.store(0);
+}
@@ -0,0 +1,46 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef FUN4ALL_FUN4ALLATOMICHISTO_H
+#define FUN4ALL_FUN4ALLATOMICHISTO_H
+
+#include <atomic>
+#include <memory>
+
+class TH1;
+
+// Atomic bin counters for a plain 1d or 2d histogram (no profiles) which is filled
+// from several threads. Fill() only touches the counters, Flush() adds them to
+// the histogram (bin contents, sum of weights squared, entries) and clears them.
+// It must not run concurrently with Fill(), Fun4AllHistoManager calls it before
+// the histograms are written. The histogram statistics (mean, rms) are recalculated
+// from the bin contents after the flush.
+// Fill follows the ROOT convention of the histogram dimension:
+//   1d: Fill(x), Fill(x, w)
+//   2d: Fill(x, y), Fill(x, y, w)
+class Fun4AllAtomicHisto
+{
+ public:
+  explicit Fun4AllAtomicHisto(TH1 *h);
+  ~Fun4AllAtomicHisto() = default;
+
+  void Fill(const double x);
+  void Fill(const double x, const double yw);
+  void Fill(const double x, const double y, const double w);
+
+  void Flush();
+  void Reset();
+
+  TH1 *GetHisto() const { return m_Histo; }
+
+ private:
+  void add(const int bin, const double w);
+
+  TH1 *m_Histo{nullptr};
+  int m_Dimension{1};
+  int m_NCells{0};
+  std::unique_ptr<std::atomic<double>[]> m_SumW;
+  std::unique_ptr<std::atomic<double>[]> m_SumW2;
+  std::atomic<long long> m_Entries{0};
+};
+
+#endif /* FUN4ALL_FUN4ALLATOMICHISTO_H */
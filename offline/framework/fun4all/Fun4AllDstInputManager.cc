@@ -10,9 +10,12 @@
 #include <frog/FROG.h>
 
 #include <phool/PHCompositeNode.h>
+#include <phool/PHDataNode.h>
+#include <phool/PHNode.h>
 #include <phool/PHNodeIOManager.h>
 #include <phool/PHNodeIntegrate.h>
 #include <phool/PHNodeIterator.h>  // for PHNodeIterator
+#include <phool/PHNodeOperation.h>
 #include <phool/PHObject.h>        // for PHObject
 #include <phool/getClass.h>
 #include <phool/phool.h>  // for PHWHERE, PHReadOnly, PHRunTree
@@ -33,6 +36,33 @@
 
 class TBranch;
 
+namespace
+{
+  // checks if any object in a node tree is summed up over input files
+  class IntegrateCheck : public PHNodeOperation
+  {
+   public:
+    bool found{false};
+
+   private:
+    void perform(PHNode *node) override
+    {
+      if (found || node->getObjectType() != "PHObject")
+      {
+        return;
+      }
+      if (node->getType() == "PHDataNode" || node->getType() == "PHIODataNode")
+      {
+        PHObject *obj = static_cast<PHDataNode<PHObject> *>(node)->getData();
+        if (obj && obj->Integrate())
+        {
+          found = true;
+        }
+      }
+    }
+  };
+}  // namespace
+
 Fun4AllDstInputManager::Fun4AllDstInputManager(const std::string &name, const std::string &nodename, const std::string &topnodename)
   : Fun4AllInputManager(name, nodename, topnodename)
 {
@@ -57,6 +87,7 @@ int Fun4AllDstInputManager::fileopen(const std::string &filenam)
     fileclose();
   }
   FileName(filenam);
+  m_FirstEventTimer.restart();
   FROG frog;
   fullfilename = frog.location(FileName());
   if (Verbosity() > 0)
@@ -78,14 +109,24 @@ int Fun4AllDstInputManager::fileopen(const std::string &filenam)
     std::cout << "Have someone look into this problem - Exiting now" << std::endl;
     exit(1);
   }
+  // the file is opened once, the run tree is read from the same TFile as the events
+  m_IManager = new PHNodeIOManager(fullfilename, PHReadOnly);
+  if (!m_IManager->isFunctional())
+  {
+    std::cout << PHWHERE << ": " << Name() << " Could not open file "
+              << FileName() << std::endl;
+    delete m_IManager;
+    m_IManager = nullptr;
+    return -1;
+  }
   // first read the runnode if not disabled
   if (m_ReadRunTTree)
   {
-    m_IManager = new PHNodeIOManager(fullfilename, PHReadOnly, PHRunTree);
-    if (m_IManager->isFunctional())
+    PHNodeIOManager runIman(m_IManager->GetFile(), PHRunTree);
+    if (runIman.isFunctional())
     {
       m_RunNode = se->getNode(RunNode, TopNodeName());
-      m_IManager->read(m_RunNode);
+      runIman.read(m_RunNode);
       // get the current run number
       RunHeader *runheader = findNode::getClass<RunHeader>(m_RunNode, "RunHeader");
       if (runheader)
@@ -101,58 +142,53 @@ int Fun4AllDstInputManager::fileopen(const std::string &filenam)
                   << std::endl;
         gSystem->Exit(1);
       }
-      m_RunNodeCopy = new PHCompositeNode("RUNNODECOPY");
       if (!m_RunNodeSum)
       {
         m_RunNodeSum = new PHCompositeNode("RUNNODESUM");
       }
-      PHNodeIOManager *tmpIman = new PHNodeIOManager(fullfilename, PHReadOnly, PHRunTree);
-      tmpIman->read(m_RunNodeCopy);
-      delete tmpIman;
+      // the copy is only needed to sum up objects over files, skip reading
+      // the run tree a second time if there is nothing to integrate
+      IntegrateCheck check;
+      PHNodeIterator runIter(m_RunNode);
+      runIter.forEach(check);
+      if (check.found)
+      {
+        m_RunNodeCopy = new PHCompositeNode("RUNNODECOPY");
+        PHNodeIOManager tmpIman(m_IManager->GetFile(), PHRunTree);
+        tmpIman.read(m_RunNodeCopy);
 
-      PHNodeIntegrate integrate;
-      integrate.RunNode(m_RunNode);
-      integrate.RunSumNode(m_RunNodeSum);
-      // run recursively over internal run node copy and integrate objects
-      PHNodeIterator mainIter(m_RunNodeCopy);
-      mainIter.forEach(integrate);
-      // we do not need to keep the internal copy, keeping it would crate
-      // problems in case a subsequent file does not contain all the
-      // runwise objects from the previous file. Keeping this copy would then
-      // integrate the missing object again with the old copy
-      delete m_RunNodeCopy;
-      m_RunNodeCopy = nullptr;
+        PHNodeIntegrate integrate;
+        integrate.RunNode(m_RunNode);
+        integrate.RunSumNode(m_RunNodeSum);
+        // run recursively over internal run node copy and integrate objects
+        PHNodeIterator mainIter(m_RunNodeCopy);
+        mainIter.forEach(integrate);
+        // we do not need to keep the internal copy, keeping it would crate
+        // problems in case a subsequent file does not contain all the
+        // runwise objects from the previous file. Keeping this copy would then
+        // integrate the missing object again with the old copy
+        delete m_RunNodeCopy;
+        m_RunNodeCopy = nullptr;
+      }
     }
-    // DLW: move the delete outside the if block to cover the case where isFunctional() fails
-    delete m_IManager;
   }
   // now open the dst node
   dstNode = se->getNode(InputNode(), TopNodeName());
-  m_IManager = new PHNodeIOManager(fullfilename, PHReadOnly);
-  if (m_IManager->isFunctional())
-  {
-    IsOpen(1);
-    events_thisfile = 0;
-    setBranches();                // set branch selections
-    AddToFileOpened(FileName());  // add file to the list of files which were opened
-                                  // check if our input file has a sync object or not
-    if (m_IManager->NodeExist(syncdefs::SYNCNODENAME))
-    {
-      m_HaveSyncObject = 1;
-    }
-    else
-    {
-      m_HaveSyncObject = -1;
-    }
-
-    return 0;
+  IsOpen(1);
+  events_thisfile = 0;
+  setBranches();                // set branch selections
+  AddToFileOpened(FileName());  // add file to the list of files which were opened
+                                // check if our input file has a sync object or not
+  if (m_IManager->NodeExist(syncdefs::SYNCNODENAME))
+  {
+    m_HaveSyncObject = 1;
+  }
+  else
+  {
+    m_HaveSyncObject = -1;
   }
 
-  std::cout << PHWHERE << ": " << Name() << " Could not open file "
-            << FileName() << std::endl;
-  delete m_IManager;
-  m_IManager = nullptr;
-  return -1;
+  return 0;
 }
 
 int Fun4AllDstInputManager::run(const int nevents)
@@ -201,6 +237,15 @@ readagain:
     }
     return -1;
   }
+  if (events_thisfile == 0)
+  {
+    m_FirstEventTimer.stop();
+    if (Verbosity() > 0)
+    {
+      std::cout << Name() << ": time to first event of " << FileName() << ": "
+                << m_FirstEventTimer.elapsed() << " ms" << std::endl;
+    }
+  }
   events_total += ncount;
   events_thisfile += ncount;
   // check if the local SubsysReco discards this event
@@ -624,6 +669,13 @@ void Fun4AllDstInputManager::Print(const std::string &what) const
     std::cout << "PHNodeIOManager print in Fun4AllDstInputManager " << Name() << ":" << std::endl;
     m_IManager->print();
   }
+  if (what == "ALL" || what == "TIMER")
+  {
+    std::cout << Name() << ": files opened: " << m_FirstEventTimer.get_ncycle()
+              << ", average time to first event: "
+              << ((m_FirstEventTimer.get_ncycle() > 0) ? m_FirstEventTimer.get_accumulated_time() / m_FirstEventTimer.get_ncycle() : 0)
+              << " ms" << std::endl;
+  }
   Fun4AllInputManager::Print(what);
   return;
 }
@@ -5,6 +5,8 @@
 
 #include "Fun4AllInputManager.h"
 
+#include <phool/PHTimer.h>
+
 #include <map>
 #include <string>
 
@@ -58,6 +60,7 @@ class Fun4AllDstInputManager : public Fun4AllInputManager
   PHNodeIOManager *m_IManager = nullptr;
   SyncObject *syncobject = nullptr;
   std::string RunNode = "RUN";
+  PHTimer m_FirstEventTimer{"FirstEvent"};  // time from opening a file to its first event
 };
 
 #endif /* __FUN4ALLDSTINPUTMANAGER_H__ */
@@ -1,5 +1,6 @@
 #include "Fun4AllHistoManager.h"
 
+#include "Fun4AllAtomicHisto.h"
 #include "TDirectoryHelper.h"
 
 #include <phool/phool.h>
@@ -19,6 +20,7 @@
 
 #include <boost/format.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
@@ -37,6 +39,19 @@ Fun4AllHistoManager::~Fun4AllHistoManager()
   // we have to run it here
   RunAfterClosing();
 
+  for (auto &iter : m_AtomicHisto)
+  {
+    delete iter.second;
+  }
+  m_AtomicHisto.clear();
+  for (auto &iter : m_Shards)
+  {
+    for (auto *shard : iter.second)
+    {
+      delete shard;
+    }
+  }
+  m_Shards.clear();
   while (Histo.begin() != Histo.end())
   {
     delete Histo.begin()->second;
@@ -119,6 +134,9 @@ int Fun4AllHistoManager::dumpHistos(const std::string &filename, const std::stri
     runseg = (boost::format("-%08d-%05d.root") % runnumber % m_CurrentSegment).str();
   }
 
+  // the per thread shards and atomic counters go into the registered histograms
+  mergeShards();
+
   std::string theoutfile = m_outfilename + runseg;
   std::cout << "Fun4AllHistoManager::dumpHistos() Writing root file: " << theoutfile.c_str() << std::endl;
 
@@ -227,6 +245,11 @@ bool Fun4AllHistoManager::registerHisto(const std::string &hname, TNamed *h1d, c
   // this one did some very ugly mutilation to a const char *
   // using a string seems to avoid the damage
   h1d->SetName(histoname.c_str());
+  if (histoiter != Histo.end())
+  {
+    // replaced histogram, the shards and counters belong to the old one
+    deleteShards(hname);
+  }
   Histo[hname] = h1d;
 
   // reset directory for TTree
@@ -241,9 +264,150 @@ bool Fun4AllHistoManager::registerHisto(const std::string &hname, TNamed *h1d, c
     static_cast<TH1 *>(h1d)->Sumw2();
   }
 
+  makeShards(hname, h1d);
+
   return true;
 }
 
+Fun4AllAtomicHisto *Fun4AllHistoManager::registerAtomicHisto(TH1 *h1d)
+{
+  return registerAtomicHisto(h1d->GetName(), h1d);
+}
+
+Fun4AllAtomicHisto *Fun4AllHistoManager::registerAtomicHisto(const std::string &hname, TH1 *h1d)
+{
+  if (h1d->GetDimension() > 2 || h1d->InheritsFrom("TProfile") || h1d->InheritsFrom("TProfile2D"))
+  {
+    std::cout << PHWHERE << " atomic counters only for 1d/2d histograms, not for "
+              << h1d->ClassName() << " " << hname << std::endl;
+    return nullptr;
+  }
+  std::map<const std::string, TNamed *>::const_iterator histoiter = Histo.find(hname);
+  if (histoiter == Histo.end())
+  {
+    if (!registerHisto(hname, h1d))
+    {
+      return nullptr;
+    }
+  }
+  else if (histoiter->second != h1d)
+  {
+    std::cout << "Histogram " << hname << " already registered, I won't overwrite it" << std::endl;
+    std::cout << "Use a different name and try again" << std::endl;
+    return nullptr;
+  }
+  std::map<const std::string, Fun4AllAtomicHisto *>::const_iterator atomiciter = m_AtomicHisto.find(hname);
+  if (atomiciter != m_AtomicHisto.end())
+  {
+    return atomiciter->second;
+  }
+  // filled through the counters, no need for per thread copies
+  deleteShards(hname);
+  Fun4AllAtomicHisto *atomichisto = new Fun4AllAtomicHisto(h1d);
+  m_AtomicHisto[hname] = atomichisto;
+  return atomichisto;
+}
+
+void Fun4AllHistoManager::setNShards(const unsigned int nshards)
+{
+  // keep what was filled so far
+  mergeShards();
+  for (auto &iter : m_Shards)
+  {
+    for (auto *shard : iter.second)
+    {
+      delete shard;
+    }
+  }
+  m_Shards.clear();
+  m_NShards = std::max(nshards, 1U);
+  for (auto &iter : Histo)
+  {
+    if (m_AtomicHisto.find(iter.first) == m_AtomicHisto.end())
+    {
+      makeShards(iter.first, iter.second);
+    }
+  }
+}
+
+void Fun4AllHistoManager::makeShards(const std::string &hname, TNamed *h1d)
+{
+  if (m_NShards <= 1 || !h1d->InheritsFrom("TH1"))
+  {
+    return;
+  }
+  std::vector<TH1 *> &shards = m_Shards[hname];
+  for (unsigned int i = 1; i < m_NShards; i++)
+  {
+    std::string shardname = std::string(h1d->GetName()) + "_shard" + std::to_string(i);
+    TH1 *shard = static_cast<TH1 *>(h1d->Clone(shardname.c_str()));
+    shard->SetDirectory(nullptr);
+    shard->Reset();
+    shards.push_back(shard);
+  }
+}
+
+void Fun4AllHistoManager::deleteShards(const std::string &hname)
+{
+  auto shiter = m_Shards.find(hname);
+  if (shiter != m_Shards.end())
+  {
+    for (auto *shard : shiter->second)
+    {
+      delete shard;
+    }
+    m_Shards.erase(shiter);
+  }
+  auto atomiciter = m_AtomicHisto.find(hname);
+  if (atomiciter != m_AtomicHisto.end())
+  {
+    delete atomiciter->second;
+    m_AtomicHisto.erase(atomiciter);
+  }
+}
+
+TH1 *Fun4AllHistoManager::getHistoShard(const std::string &hname, const unsigned int ishard) const
+{
+  std::map<const std::string, TNamed *>::const_iterator histoiter = Histo.find(hname);
+  if (histoiter == Histo.end() || !histoiter->second->InheritsFrom("TH1"))
+  {
+    std::cout << PHWHERE << " no histogram " << hname << " registered" << std::endl;
+    return nullptr;
+  }
+  if (ishard == 0)
+  {
+    return static_cast<TH1 *>(histoiter->second);
+  }
+  auto shiter = m_Shards.find(hname);
+  if (shiter == m_Shards.end() || ishard > shiter->second.size())
+  {
+    std::cout << PHWHERE << " invalid shard " << ishard << " for " << hname
+              << ", number of shards is " << m_NShards << std::endl;
+    return nullptr;
+  }
+  return shiter->second[ishard - 1];
+}
+
+void Fun4AllHistoManager::mergeShards()
+{
+  for (auto &iter : m_Shards)
+  {
+    TH1 *h = static_cast<TH1 *>(Histo[iter.first]);
+    for (auto *shard : iter.second)
+    {
+      if (shard->GetEntries() > 0)
+      {
+        h->Add(shard);
+        shard->Reset();
+      }
+    }
+  }
+  for (auto &iter : m_AtomicHisto)
+  {
+    iter.second->Flush();
+  }
+}
+
 int Fun4AllHistoManager::isHistoRegistered(const std::string &name) const
 {
   std::map<const std::string, TNamed *>::const_iterator histoiter = Histo.find(name);
@@ -351,5 +515,16 @@ void Fun4AllHistoManager::Reset()
       (dynamic_cast<THnSparse *>(h))->Reset();
     }
   }
+  for (auto &iter : m_Shards)
+  {
+    for (auto *shard : iter.second)
+    {
+      shard->Reset();
+    }
+  }
+  for (auto &iter : m_AtomicHisto)
+  {
+    iter.second->Reset();
+  }
   return;
 }
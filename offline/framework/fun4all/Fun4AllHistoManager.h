@@ -7,7 +7,10 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
+class Fun4AllAtomicHisto;
+class TH1;
 class TNamed;
 
 class Fun4AllHistoManager : public Fun4AllBase
@@ -52,7 +55,27 @@ class Fun4AllHistoManager : public Fun4AllBase
   void SetClosingScriptArgs(const std::string &args) { m_ClosingArgs = args; }
   void segment(const int segment) { m_CurrentSegment = segment; }
 
+  //! Histograms filled from several threads, ROOT histograms are not thread safe.
+  //! With nshards > 1 every registered histogram (TH1) gets nshards-1 private copies,
+  //! thread ishard fills getHistoShard(hname, ishard) without locking, shard 0 is the
+  //! registered histogram itself. Get the shard pointers once (not per fill).
+  //! mergeShards() adds the copies to the registered histograms and resets them,
+  //! dumpHistos() calls it. No thread may fill while merging or dumping.
+  void setNShards(const unsigned int nshards);
+  unsigned int nShards() const { return m_NShards; }
+  TH1 *getHistoShard(const std::string &hname, const unsigned int ishard) const;
+  void mergeShards();
+
+  //! Register a 1d/2d histogram (no profiles) with atomic bin counters, it can be filled
+  //! from any thread through the returned object (owned by the manager), the counters are
+  //! added to the histogram by mergeShards()
+  Fun4AllAtomicHisto *registerAtomicHisto(const std::string &hname, TH1 *h1d);
+  Fun4AllAtomicHisto *registerAtomicHisto(TH1 *h1d);
+
  private:
+  void makeShards(const std::string &hname, TNamed *h1d);
+  void deleteShards(const std::string &hname);
+
   std::string m_outfilename;
   std::string m_RunAfterClosingScript;
   std::string m_ClosingArgs;
@@ -60,6 +83,9 @@ class Fun4AllHistoManager : public Fun4AllBase
   std::map<const std::string, TNamed *> Histo;
   bool m_dumpHistoSegments = false;
   int m_CurrentSegment = 0;
+  unsigned int m_NShards = 1;
+  std::map<const std::string, std::vector<TH1 *>> m_Shards;
+  std::map<const std::string, Fun4AllAtomicHisto *> m_AtomicHisto;
 };
 
 #endif /* __FUN4ALLHISTOMANAGER_H */
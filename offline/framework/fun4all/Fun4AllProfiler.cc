@@ -0,0 +1,309 @@
+#include "Fun4AllProfiler.h"
+
+#include <phool/phool.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// defined by libfun4all_alloccounter.so if it is preloaded
+extern "C" uint64_t Fun4AllAllocCount() __attribute__((weak));
+
+Fun4AllProfiler *Fun4AllProfiler::mInstance = nullptr;
+
+namespace
+{
+  const std::array<std::string, 3> countername = {"cycles", "instructions", "cache misses"};
+
+#ifdef __linux__
+  int open_counter(const uint64_t config, const int group_fd)
+  {
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = (group_fd == -1) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+  }
+#endif
+}  // namespace
+
+Fun4AllProfiler::Fun4AllProfiler()
+  : Fun4AllBase("Fun4AllProfiler")
+  , m_StartTime(Now())
+{
+}
+
+Fun4AllProfiler::~Fun4AllProfiler()
+{
+  EnableCounters(false);
+}
+
+bool Fun4AllProfiler::EnableCounters(const bool b)
+{
+#ifdef __linux__
+  if (!b)
+  {
+    for (auto &fd : m_CounterFds)
+    {
+      if (fd >= 0)
+      {
+        close(fd);
+      }
+      fd = -1;
+    }
+    m_CounterId.fill(0);
+    m_CounterFd = -1;
+    return true;
+  }
+  if (m_CounterFd >= 0)
+  {
+    return true;
+  }
+  const std::array<uint64_t, NCOUNTERS> config = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+  for (int i = 0; i < NCOUNTERS; i++)
+  {
+    int fd = open_counter(config[i], m_CounterFd);
+    if (fd < 0)
+    {
+      std::cout << PHWHERE << " could not open " << countername[i]
+                << " counter (check /proc/sys/kernel/perf_event_paranoid), hardware counters disabled" << std::endl;
+      EnableCounters(false);
+      return false;
+    }
+    m_CounterFds[i] = fd;
+    ioctl(fd, PERF_EVENT_IOC_ID, &m_CounterId[i]);
+    if (m_CounterFd < 0)
+    {
+      m_CounterFd = fd;
+    }
+  }
+  ioctl(m_CounterFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(m_CounterFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+#else
+  if (b)
+  {
+    std::cout << PHWHERE << " hardware counters are only supported on linux" << std::endl;
+  }
+  return false;
+#endif
+}
+
+void Fun4AllProfiler::TraceFile(const std::string &fname, const int first_event, const int last_event)
+{
+  m_TraceFileName = fname;
+  m_TraceFirstEvent = first_event;
+  m_TraceLastEvent = last_event;
+}
+
+int Fun4AllProfiler::RegisterModule(const std::string &name)
+{
+  Slot slot;
+  slot.name = name;
+  slot.latency.resize(NBINS, 0);
+  m_Slots.push_back(slot);
+  return m_Slots.size() - 1;
+}
+
+uint64_t Fun4AllProfiler::Now() const
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Fun4AllProfiler::ReadCounters(std::array<uint64_t, NCOUNTERS> &values) const
+{
+#ifdef __linux__
+  // nr, then value and id per counter
+  std::array<uint64_t, 1 + 2 * NCOUNTERS> buffer{};
+  if (read(m_CounterFd, buffer.data(), sizeof(buffer)) < 0)
+  {
+    return;
+  }
+  for (uint64_t i = 0; i < buffer[0] && i < NCOUNTERS; i++)
+  {
+    for (int j = 0; j < NCOUNTERS; j++)
+    {
+      if (buffer[2 + 2 * i] == m_CounterId[j])
+      {
+        values[j] = buffer[1 + 2 * i];
+      }
+    }
+  }
+#else
+  values.fill(0);
+#endif
+}
+
+void Fun4AllProfiler::StartSlot(const int slot)
+{
+  Slot &s = m_Slots[slot];
+  if (m_CounterFd >= 0)
+  {
+    ReadCounters(s.start_counters);
+  }
+  if (Fun4AllAllocCount)
+  {
+    s.start_allocs = Fun4AllAllocCount();
+  }
+  s.start_ns = Now();
+}
+
+void Fun4AllProfiler::StopSlot(const int slot, const int event)
+{
+  const uint64_t stop_ns = Now();
+  Slot &s = m_Slots[slot];
+  if (Fun4AllAllocCount)
+  {
+    s.sum_allocs += Fun4AllAllocCount() - s.start_allocs;
+  }
+  if (m_CounterFd >= 0)
+  {
+    std::array<uint64_t, NCOUNTERS> values{};
+    ReadCounters(values);
+    for (int i = 0; i < NCOUNTERS; i++)
+    {
+      s.sum_counters[i] += values[i] - s.start_counters[i];
+    }
+  }
+  const uint64_t duration = stop_ns - s.start_ns;
+  s.ncalls++;
+  s.sum_ns += duration;
+  s.max_ns = std::max(s.max_ns, duration);
+  s.latency[LatencyBin(duration)]++;
+  if (!m_TraceFileName.empty() && event >= m_TraceFirstEvent && event <= m_TraceLastEvent)
+  {
+    m_Spans.push_back({slot, event, s.start_ns, duration});
+  }
+}
+
+int Fun4AllProfiler::LatencyBin(const uint64_t ns)
+{
+  // below 16 ns one bin per ns, above 8 bins per power of 2
+  if (ns < 16)
+  {
+    return ns;
+  }
+  const int exponent = 63 - __builtin_clzll(ns);
+  const int mantissa = (ns >> (exponent - 3)) & 7U;
+  return 16 + (exponent - 4) * 8 + mantissa;
+}
+
+double Fun4AllProfiler::BinCenter(const int bin)
+{
+  if (bin < 16)
+  {
+    return bin;
+  }
+  const int exponent = (bin - 16) / 8 + 4;
+  const int mantissa = (bin - 16) % 8;
+  const double width = std::ldexp(1., exponent - 3);
+  return (8 + mantissa) * width + width / 2;
+}
+
+double Fun4AllProfiler::Percentile(const std::vector<uint32_t> &hist, const uint64_t ncalls, const double fraction)
+{
+  const uint64_t target = std::max<uint64_t>(1, std::ceil(fraction * ncalls));
+  uint64_t sum = 0;
+  for (int i = 0; i < NBINS; i++)
+  {
+    sum += hist[i];
+    if (sum >= target)
+    {
+      return BinCenter(i);
+    }
+  }
+  return 0;
+}
+
+void Fun4AllProfiler::Print(const std::string & /*what*/) const
+{
+  std::cout << "Fun4AllProfiler: process_event per module, times in ms" << std::endl;
+  std::cout << std::setw(32) << std::left << "module" << std::right
+            << std::setw(10) << "calls"
+            << std::setw(12) << "mean"
+            << std::setw(12) << "p50"
+            << std::setw(12) << "p99"
+            << std::setw(12) << "max";
+  if (Fun4AllAllocCount)
+  {
+    std::cout << std::setw(14) << "allocs/call";
+  }
+  if (m_CounterFd >= 0)
+  {
+    std::cout << std::setw(14) << "cycles/call" << std::setw(8) << "IPC" << std::setw(14) << "misses/call";
+  }
+  std::cout << std::endl;
+  for (const auto &s : m_Slots)
+  {
+    if (s.ncalls == 0)
+    {
+      continue;
+    }
+    const double ncalls = s.ncalls;
+    std::cout << std::setw(32) << std::left << s.name << std::right
+              << std::setw(10) << s.ncalls
+              << std::setw(12) << s.sum_ns / ncalls * 1e-6
+              << std::setw(12) << Percentile(s.latency, s.ncalls, 0.5) * 1e-6
+              << std::setw(12) << Percentile(s.latency, s.ncalls, 0.99) * 1e-6
+              << std::setw(12) << s.max_ns * 1e-6;
+    if (Fun4AllAllocCount)
+    {
+      std::cout << std::setw(14) << s.sum_allocs / ncalls;
+    }
+    if (m_CounterFd >= 0)
+    {
+      std::cout << std::setw(14) << s.sum_counters[0] / ncalls
+                << std::setw(8) << std::setprecision(3) << ((s.sum_counters[0] > 0) ? static_cast<double>(s.sum_counters[1]) / s.sum_counters[0] : 0.) << std::setprecision(6)
+                << std::setw(14) << s.sum_counters[2] / ncalls;
+    }
+    std::cout << std::endl;
+  }
+}
+
+void Fun4AllProfiler::WriteTrace()
+{
+  if (m_TraceFileName.empty())
+  {
+    return;
+  }
+  std::ofstream outfile(m_TraceFileName, std::ios_base::trunc);
+  if (!outfile.is_open())
+  {
+    std::cout << PHWHERE << " could not open trace file " << m_TraceFileName << std::endl;
+    return;
+  }
+  // chrome trace event format, complete events with times in us
+  outfile << "{\"traceEvents\":[" << std::endl;
+  outfile << std::fixed << std::setprecision(3);
+  for (size_t i = 0; i < m_Spans.size(); i++)
+  {
+    const Span &span = m_Spans[i];
+    outfile << "{\"name\":\"" << m_Slots[span.slot].name << "\",\"cat\":\"SubsysReco\",\"ph\":\"X\""
+            << ",\"ts\":" << (span.start_ns - m_StartTime) * 1e-3
+            << ",\"dur\":" << span.duration_ns * 1e-3
+            << ",\"pid\":1,\"tid\":1"
+            << ",\"args\":{\"event\":" << span.event << "}}"
+            << ((i + 1 < m_Spans.size()) ? "," : "") << std::endl;
+  }
+  outfile << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+  outfile.close();
+  if (Verbosity() > 0)
+  {
+    std::cout << "Fun4AllProfiler: wrote " << m_Spans.size() << " module spans to " << m_TraceFileName << std::endl;
+  }
+  m_Spans.clear();
+}
@@ -0,0 +1,119 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef FUN4ALL_FUN4ALLPROFILER_H
+#define FUN4ALL_FUN4ALLPROFILER_H
+
+#include "Fun4AllBase.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Per module profiling of the process_event calls, filled by the Fun4AllServer.
+// Modules get a slot when they are registered, per event only the slot index
+// is used. For every module the latency distribution (p50, p99), optionally
+// the hardware counters (perf_event_open) and the number of heap allocations
+// are kept and the module spans of an event window can be written as a
+// Chrome/Perfetto trace (load in chrome://tracing or ui.perfetto.dev).
+//
+// Heap allocations are only counted if libfun4all_alloccounter.so is
+// preloaded (LD_PRELOAD), it replaces the global operator new
+//
+// Usage in the macro:
+//   Fun4AllProfiler *prof = Fun4AllProfiler::instance();
+//   prof->Enable();
+//   prof->EnableCounters();            // cycles, instructions, cache misses
+//   prof->TraceFile("trace.json", 100, 110); // events 100 - 110
+// The summary is printed and the trace is written in Fun4AllServer::End()
+class Fun4AllProfiler : public Fun4AllBase
+{
+ public:
+  static Fun4AllProfiler *instance()
+  {
+    if (mInstance)
+    {
+      return mInstance;
+    }
+    mInstance = new Fun4AllProfiler();
+    return mInstance;
+  }
+  ~Fun4AllProfiler() override;
+
+  void Enable(const bool b = true) { m_Enabled = b; }
+  bool Enabled() const { return m_Enabled; }
+  //! open the hardware counters, returns false if the kernel does not let us
+  bool EnableCounters(const bool b = true);
+  //! write the module spans of the events first_event to last_event (event counter) to fname
+  void TraceFile(const std::string &fname, const int first_event, const int last_event);
+
+  //! returns the slot of a module
+  int RegisterModule(const std::string &name);
+  void Start(const int slot)
+  {
+    if (m_Enabled)
+    {
+      StartSlot(slot);
+    }
+  }
+  void Stop(const int slot, const int event)
+  {
+    if (m_Enabled)
+    {
+      StopSlot(slot, event);
+    }
+  }
+
+  void Print(const std::string &what = "ALL") const override;
+  //! write the collected spans to the trace file
+  void WriteTrace();
+
+ private:
+  static constexpr int NBINS = 496;  // log linear latency bins, 8 per power of 2 in ns
+  static constexpr int NCOUNTERS = 3;
+
+  struct Slot
+  {
+    std::string name;
+    uint64_t ncalls{0};
+    uint64_t start_ns{0};
+    uint64_t sum_ns{0};
+    uint64_t max_ns{0};
+    uint64_t start_allocs{0};
+    uint64_t sum_allocs{0};
+    std::array<uint64_t, NCOUNTERS> start_counters{};
+    std::array<uint64_t, NCOUNTERS> sum_counters{};
+    std::vector<uint32_t> latency;  // histogram, NBINS
+  };
+
+  struct Span
+  {
+    int slot;
+    int event;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+  };
+
+  Fun4AllProfiler();
+  void StartSlot(const int slot);
+  void StopSlot(const int slot, const int event);
+  void ReadCounters(std::array<uint64_t, NCOUNTERS> &values) const;
+  uint64_t Now() const;
+  static int LatencyBin(const uint64_t ns);
+  static double BinCenter(const int bin);
+  static double Percentile(const std::vector<uint32_t> &hist, const uint64_t ncalls, const double fraction);
+
+  static Fun4AllProfiler *mInstance;
+  bool m_Enabled{false};
+  int m_CounterFd{-1};  // group leader of the perf_event counters
+  std::array<int, NCOUNTERS> m_CounterFds{-1, -1, -1};
+  std::array<uint64_t, NCOUNTERS> m_CounterId{};
+  int m_TraceFirstEvent{0};
+  int m_TraceLastEvent{-1};
+  uint64_t m_StartTime{0};
+  std::string m_TraceFileName;
+  std::vector<Slot> m_Slots;
+  std::vector<Span> m_Spans;
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include "Fun4AllMemoryTracker.h"
 #include "Fun4AllMonitoring.h"
 #include "Fun4AllOutputManager.h"
+#include "Fun4AllProfiler.h"
 #include "Fun4AllReturnCodes.h"
 #include "Fun4AllSyncManager.h"
 #include "SubsysReco.h"
@@ -56,6 +57,7 @@ Fun4AllServer::Fun4AllServer(const std::string &name)
 #ifdef FFAMEMTRACKER
   , ffamemtracker(Fun4AllMemoryTracker::instance())
 #endif
+  , ffaprofiler(Fun4AllProfiler::instance())
 {
   InitAll();
   return;
@@ -267,10 +269,10 @@ int Fun4AllServer::registerSubsystem(SubsysReco *subsystem, const std::string &t
   std::string timer_name;
   timer_name = subsystem->Name() + "_" + topnodename;
   PHTimer timer(timer_name);
-  if (timer_map.find(timer_name) == timer_map.end())
-  {
-    timer_map.insert(make_pair(timer_name, timer));
-  }
+  // insert does nothing if the timer exists already, map entries do not move
+  // so the per event lookup is done here once
+  SubsystemTimers.push_back(&(timer_map.insert(make_pair(timer_name, timer)).first->second));
+  ProfilerSlots.push_back(ffaprofiler->RegisterModule(timer_name));
   RetCodes.push_back(iret);  // vector with return codes
   return 0;
 }
@@ -317,8 +319,10 @@ int Fun4AllServer::unregisterSubsystemsNow()
     }
     Subsystems.erase(Subsystems.begin() + index);
     delete (*removeiter).first;
-    // also update the vector with return codes
+    // also update the vector with return codes and the timers
     RetCodes.erase(RetCodes.begin() + index);
+    SubsystemTimers.erase(SubsystemTimers.begin() + index);
+    ProfilerSlots.erase(ProfilerSlots.begin() + index);
     std::vector<Fun4AllOutputManager *>::iterator outiter;
     for (outiter = OutputManager.begin(); outiter != OutputManager.end(); ++outiter)
     {
@@ -554,25 +558,13 @@ int Fun4AllServer::process_event()
       }
     }
 
-    PHTimer subsystem_timer("SubsystemTimer");
-    subsystem_timer.restart();
-
     try
     {
-      std::string timer_name;
-      timer_name = Subsystem.first->Name() + "_" + Subsystem.second->getName();
-      std::map<const std::string, PHTimer>::iterator titer = timer_map.find(timer_name);
-      bool timer_found = false;
-      if (titer != timer_map.end())
-      {
-        timer_found = true;
-        titer->second.restart();
-      }
-      else
-      {
-        std::cout << "could not find timer for " << timer_name << std::endl;
-      }
+      PHTimer *subsystem_timer = SubsystemTimers[icnt];
+      subsystem_timer->restart();
+      ffaprofiler->Start(ProfilerSlots[icnt]);
 #ifdef FFAMEMTRACKER
+      std::string timer_name = Subsystem.first->Name() + "_" + Subsystem.second->getName();
       ffamemtracker->Start(timer_name, "SubsysReco");
       ffamemtracker->Snapshot("Fun4AllServerProcessEvent");
 #endif
@@ -595,10 +587,8 @@ int Fun4AllServer::process_event()
         std::cout << "error: " << e.what() << std::endl;
         gSystem->Exit(1);
       }
-      if (timer_found)
-      {
-        titer->second.stop();
-      }
+      ffaprofiler->Stop(ProfilerSlots[icnt], eventcounter);
+      subsystem_timer->stop();
 #ifdef FFAMEMTRACKER
       ffamemtracker->Stop(timer_name, "SubsysReco");
 #endif
@@ -1153,6 +1143,12 @@ int Fun4AllServer::End()
   // done inside outfileclose())
   outfileclose();
 
+  if (ffaprofiler->Enabled())
+  {
+    ffaprofiler->Print();
+    ffaprofiler->WriteTrace();
+  }
+
   if (ScreamEveryEvent)
   {
     std::cout << "*******************************************************************************" << std::endl;
@@ -20,6 +20,7 @@ class Fun4AllInputManager;
 class Fun4AllMemoryTracker;
 class Fun4AllSyncManager;
 class Fun4AllOutputManager;
+class Fun4AllProfiler;
 class PHCompositeNode;
 class PHTimeStamp;
 class SubsysReco;
@@ -128,6 +129,7 @@ class Fun4AllServer : public Fun4AllBase
   static Fun4AllServer *__instance;
   TH1 *FrameWorkVars{nullptr};
   Fun4AllMemoryTracker *ffamemtracker{nullptr};
+  Fun4AllProfiler *ffaprofiler{nullptr};
   Fun4AllHistoManager *ServerHistoManager{nullptr};
   PHTimeStamp *beginruntimestamp{nullptr};
   PHCompositeNode *TopNode{nullptr};
@@ -147,6 +149,8 @@ class Fun4AllServer : public Fun4AllBase
   std::vector<std::pair<SubsysReco *, PHCompositeNode *>> DeleteSubsystems;
   std::deque<std::pair<SubsysReco *, std::string>> NewSubsystems;
   std::vector<int> RetCodes;
+  std::vector<PHTimer *> SubsystemTimers;  // same order as Subsystems, points into timer_map
+  std::vector<int> ProfilerSlots;          // same order as Subsystems
   std::vector<Fun4AllOutputManager *> OutputManager;
   std::vector<TDirectory *> TDirCollection;
   std::vector<Fun4AllHistoManager *> HistoManager;
@@ -0,0 +1,350 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef FUN4ALLRAW_BCOSTAGINGBUFFER_H
+#define FUN4ALLRAW_BCOSTAGINGBUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Time ordered staging buffer for raw hits, keyed by bco.
+// It provides the subset of the std::map interface which
+// Fun4AllStreamingInputManager uses (operator[], begin()->first, erase of the
+// oldest entry, ordered iteration).
+// The entries live in a ring of slots indexed by bco - window start, where the
+// window start is the oldest staged bco. Adding a bco inside the window, in or
+// out of order, and retiring the oldest one are O(1), ordered iteration walks
+// the slots. The ring doubles when a bco falls outside of it, up to
+// max_slots. Bcos which are still further out are kept in an overflow map and
+// move into the ring once the window has advanced far enough, so the memory
+// stays bounded however far apart the staged bcos are.
+template <class T>
+class BcoStagingBuffer
+{
+ public:
+  using value_type = std::pair<uint64_t, T>;
+
+  static constexpr size_t initial_slots = 1024;
+  static constexpr size_t max_slots = 65536;
+
+ private:
+  struct Slot
+  {
+    value_type entry;
+    bool used = false;
+  };
+  //! the overflow entries keep the same layout as the ring entries
+  using overflow_type = std::map<uint64_t, value_type>;
+
+ public:
+  template <bool Const>
+  class iterator_base
+  {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = BcoStagingBuffer::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const value_type &, value_type &>;
+    using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+    using buffer_pointer = std::conditional_t<Const, const BcoStagingBuffer *, BcoStagingBuffer *>;
+    using overflow_iterator = std::conditional_t<Const, typename overflow_type::const_iterator, typename overflow_type::iterator>;
+
+    iterator_base() = default;
+    iterator_base(buffer_pointer buffer, const size_t offset, overflow_iterator overflow_iter)
+      : m_buffer(buffer)
+      , m_offset(offset)
+      , m_overflow_iter(overflow_iter)
+    {
+    }
+    //! allow iterator to const_iterator conversion
+    template <bool OtherConst, class = std::enable_if_t<Const && !OtherConst>>
+    iterator_base(const iterator_base<OtherConst> &other)  // NOLINT(google-explicit-constructor)
+      : m_buffer(other.m_buffer)
+      , m_offset(other.m_offset)
+      , m_overflow_iter(other.m_overflow_iter)
+    {
+    }
+
+    reference operator*() const { return in_ring() ? m_buffer->slot(m_offset).entry : m_overflow_iter->second; }
+    pointer operator->() const { return &operator*(); }
+
+    iterator_base &operator++()
+    {
+      if (in_ring())
+      {
+        m_offset = m_buffer->next_used(m_offset + 1);
+      }
+      else
+      {
+        ++m_overflow_iter;
+      }
+      return *this;
+    }
+    iterator_base operator++(int)
+    {
+      iterator_base tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const iterator_base &other) const { return m_offset == other.m_offset && m_overflow_iter == other.m_overflow_iter; }
+    bool operator!=(const iterator_base &other) const { return !(*this == other); }
+
+   private:
+    template <bool>
+    friend class iterator_base;
+    friend class BcoStagingBuffer;
+
+    bool in_ring() const { return m_offset < m_buffer->m_span; }
+
+    buffer_pointer m_buffer = nullptr;
+    //! slot offset from the window start, m_span once past the ring
+    size_t m_offset = 0;
+    overflow_iterator m_overflow_iter{};
+  };
+
+  using iterator = iterator_base<false>;
+  using const_iterator = iterator_base<true>;
+
+  BcoStagingBuffer()
+    : m_slots(initial_slots)
+  {
+  }
+
+  T &operator[](const uint64_t bco)
+  {
+    if (!m_overflow.empty())
+    {
+      // a bco which is already staged beyond the window stays in the overflow map
+      auto iter = m_overflow.find(bco);
+      if (iter != m_overflow.end())
+      {
+        return iter->second.second;
+      }
+    }
+
+    if (m_count == 0)
+    {
+      // (re)start the window on this bco, or on the oldest overflow entry if that is older
+      m_start = (m_overflow.empty() || bco < m_overflow.begin()->first) ? bco : m_overflow.begin()->first;
+      m_head = 0;
+      m_span = 0;
+      migrate_overflow();
+    }
+
+    if (bco < m_start)
+    {
+      // older than the oldest staged bco, move the window start back
+      const uint64_t shift = m_start - bco;
+      if (!fit_span(shift + m_span))
+      {
+        // the newest entries do not fit anymore, move them to the overflow map
+        shrink_span(shift < max_slots ? max_slots - shift : 0);
+      }
+      if (m_count == 0)
+      {
+        m_head = 0;
+        m_span = 0;
+      }
+      else
+      {
+        m_head = (m_head + m_slots.size() - shift) & mask();
+        m_span += shift;
+      }
+      m_start = bco;
+      // a grown ring can reach overflow entries
+      migrate_overflow();
+    }
+    else if (bco - m_start >= m_slots.size())
+    {
+      if (!fit_span(bco - m_start + 1))
+      {
+        value_type &entry = m_overflow[bco];
+        entry.first = bco;
+        return entry.second;
+      }
+      // overflow entries between the old and the new end of the ring move in
+      // before the new bco, all ring bcos stay below the overflow bcos
+      migrate_overflow();
+    }
+
+    const size_t offset = bco - m_start;
+    Slot &entry_slot = slot(offset);
+    if (!entry_slot.used)
+    {
+      entry_slot.used = true;
+      entry_slot.entry.first = bco;
+      ++m_count;
+      if (offset >= m_span)
+      {
+        m_span = offset + 1;
+      }
+    }
+    return entry_slot.entry.second;
+  }
+
+  iterator begin() { return iterator(this, m_count ? 0 : m_span, m_overflow.begin()); }
+  iterator end() { return iterator(this, m_span, m_overflow.end()); }
+  const_iterator begin() const { return const_iterator(this, m_count ? 0 : m_span, m_overflow.begin()); }
+  const_iterator end() const { return const_iterator(this, m_span, m_overflow.end()); }
+
+  //! erasing the oldest entry (begin()) is O(1), up to skipping unused slots
+  iterator erase(iterator iter)
+  {
+    if (!iter.in_ring())
+    {
+      return iterator(this, m_span, m_overflow.erase(iter.m_overflow_iter));
+    }
+
+    Slot &entry_slot = slot(iter.m_offset);
+    entry_slot.used = false;
+    entry_slot.entry.second = T();
+    --m_count;
+    if (iter.m_offset != 0)
+    {
+      return iterator(this, next_used(iter.m_offset + 1), m_overflow.begin());
+    }
+
+    // oldest entry, advance the window start to the next staged bco
+    const size_t next = next_used(1);
+    if (next < m_span)
+    {
+      m_head = (m_head + next) & mask();
+      m_start += next;
+      m_span -= next;
+    }
+    else
+    {
+      m_head = 0;
+      m_span = 0;
+    }
+    // an empty ring is restarted by the next operator[], until then begin() is the oldest overflow entry
+    if (m_count > 0)
+    {
+      migrate_overflow();
+    }
+    return begin();
+  }
+
+  bool empty() const { return m_count == 0 && m_overflow.empty(); }
+  size_t size() const { return m_count + m_overflow.size(); }
+  void clear()
+  {
+    for (size_t offset = 0; offset < m_span; ++offset)
+    {
+      Slot &entry_slot = slot(offset);
+      entry_slot.used = false;
+      entry_slot.entry.second = T();
+    }
+    m_count = 0;
+    m_span = 0;
+    m_head = 0;
+    m_overflow.clear();
+  }
+
+ private:
+  size_t mask() const { return m_slots.size() - 1; }
+  Slot &slot(const size_t offset) { return m_slots[(m_head + offset) & mask()]; }
+  const Slot &slot(const size_t offset) const { return m_slots[(m_head + offset) & mask()]; }
+
+  //! first used slot at or after offset, m_span if there is none
+  size_t next_used(size_t offset) const
+  {
+    while (offset < m_span && !slot(offset).used)
+    {
+      ++offset;
+    }
+    return offset;
+  }
+
+  //! grow the ring so that it holds span slots, false if that exceeds max_slots
+  bool fit_span(const uint64_t span)
+  {
+    if (span <= m_slots.size())
+    {
+      return true;
+    }
+    if (span > max_slots)
+    {
+      return false;
+    }
+    size_t nslots = m_slots.size();
+    while (nslots < span)
+    {
+      nslots *= 2;
+    }
+    std::vector<Slot> slots(nslots);
+    for (size_t offset = 0; offset < m_span; ++offset)
+    {
+      slots[offset] = std::move(slot(offset));
+    }
+    m_slots.swap(slots);
+    m_head = 0;
+    return true;
+  }
+
+  //! move the entries at offset >= span to the overflow map
+  void shrink_span(const size_t span)
+  {
+    fit_span(max_slots);
+    for (size_t offset = span; offset < m_span; ++offset)
+    {
+      Slot &entry_slot = slot(offset);
+      if (entry_slot.used)
+      {
+        m_overflow[entry_slot.entry.first] = std::move(entry_slot.entry);
+        entry_slot.used = false;
+        entry_slot.entry.second = T();
+        --m_count;
+      }
+    }
+    m_span = std::min(m_span, next_used_back(span));
+  }
+
+  //! one past the last used slot before offset
+  size_t next_used_back(size_t offset) const
+  {
+    while (offset > 0 && !slot(offset - 1).used)
+    {
+      --offset;
+    }
+    return offset;
+  }
+
+  //! move overflow entries which fall into the window to the ring
+  void migrate_overflow()
+  {
+    for (auto iter = m_overflow.begin(); iter != m_overflow.end() && iter->first - m_start < m_slots.size();)
+    {
+      const size_t offset = iter->first - m_start;
+      Slot &entry_slot = slot(offset);
+      entry_slot.used = true;
+      entry_slot.entry = std::move(iter->second);
+      ++m_count;
+      if (offset >= m_span)
+      {
+        m_span = offset + 1;
+      }
+      iter = m_overflow.erase(iter);
+    }
+  }
+
+  std::vector<Slot> m_slots;
+  //! slot index of the window start
+  size_t m_head = 0;
+  //! bco of the window start, the oldest staged bco while the ring is not empty
+  uint64_t m_start = 0;
+  //! number of slots from the window start up to and including the newest staged bco in the ring
+  size_t m_span = 0;
+  //! number of used slots
+  size_t m_count = 0;
+  //! bcos beyond the window start + max_slots
+  overflow_type m_overflow;
+};
+
+#endif
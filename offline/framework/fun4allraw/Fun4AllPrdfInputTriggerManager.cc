@@ -391,6 +391,15 @@ int Fun4AllPrdfInputTriggerManager::SyncIt(const SyncObject *mastersync)
   return Fun4AllReturnCodes::SYNC_OK;
 }
 
+void Fun4AllPrdfInputTriggerManager::ReadAheadDepth(const unsigned int depth)
+{
+  m_ReadAheadDepth = depth;
+  for (auto iter : m_TriggerInputVector)
+  {
+    iter->ReadAheadDepth(m_ReadAheadDepth);
+  }
+}
+
 std::string Fun4AllPrdfInputTriggerManager::GetString(const std::string &what) const
 {
   std::cout << PHWHERE << " called with " << what << " , returning empty string" << std::endl;
@@ -432,6 +441,10 @@ void Fun4AllPrdfInputTriggerManager::registerTriggerInput(SingleTriggerInput *pr
     gSystem->Exit(1);
     exit(1);
   }
+  if (m_ReadAheadDepth > 0)
+  {
+    prdfin->ReadAheadDepth(m_ReadAheadDepth);
+  }
   m_TriggerInputVector.push_back(prdfin);
   // this is for convenience - we need to loop over all input managers except for the GL1
   if (system != InputManagerType::GL1)
@@ -51,6 +51,8 @@ class Fun4AllPrdfInputTriggerManager : public Fun4AllInputManager
   void DitchEvent(const int eventno);
   void ClearAllEvents(const int eventno);
   void SetPoolDepth(unsigned int d) { m_DefaultPoolDepth = d; }
+  // number of events each input reads ahead on its own thread (0: no read ahead)
+  void ReadAheadDepth(const unsigned int depth);
   int FillCemc(const unsigned int nEvents = 2);
   int MoveCemcToNodeTree();
   void AddCemcPacket(int eventno, CaloPacket *pkt);
@@ -126,6 +128,7 @@ class Fun4AllPrdfInputTriggerManager : public Fun4AllInputManager
   unsigned int m_InitialPoolDepth = 10;
   unsigned int m_DefaultPoolDepth = 10;
   unsigned int m_PoolDepth{m_InitialPoolDepth};
+  unsigned int m_ReadAheadDepth{0};
   std::set<int> m_Gl1DroppedEvent;
   std::vector<SingleTriggerInput *> m_TriggerInputVector;
   std::vector<SingleTriggerInput *> m_NoGl1InputVector;
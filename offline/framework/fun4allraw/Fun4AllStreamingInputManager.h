@@ -3,6 +3,7 @@
 #ifndef FUN4ALLRAW_FUN4ALLSTREAMINGINPUTMANAGER_H
 #define FUN4ALLRAW_FUN4ALLSTREAMINGINPUTMANAGER_H
 
+#include "BcoStagingBuffer.h"
 #include "InputManagerType.h"
 
 #include <fun4all/Fun4AllInputManager.h>
@@ -130,11 +131,11 @@ class Fun4AllStreamingInputManager : public Fun4AllInputManager
   std::vector<SingleStreamingInput *> m_MicromegasInputVector;
   std::vector<SingleStreamingInput *> m_MvtxInputVector;
   std::vector<SingleStreamingInput *> m_TpcInputVector;
-  std::map<uint64_t, Gl1RawHitInfo> m_Gl1RawHitMap;
-  std::map<uint64_t, InttRawHitInfo> m_InttRawHitMap;
-  std::map<uint64_t, MicromegasRawHitInfo> m_MicromegasRawHitMap;
-  std::map<uint64_t, MvtxRawHitInfo> m_MvtxRawHitMap;
-  std::map<uint64_t, TpcRawHitInfo> m_TpcRawHitMap;
+  BcoStagingBuffer<Gl1RawHitInfo> m_Gl1RawHitMap;
+  BcoStagingBuffer<InttRawHitInfo> m_InttRawHitMap;
+  BcoStagingBuffer<MicromegasRawHitInfo> m_MicromegasRawHitMap;
+  BcoStagingBuffer<MvtxRawHitInfo> m_MvtxRawHitMap;
+  BcoStagingBuffer<TpcRawHitInfo> m_TpcRawHitMap;
   std::map<int, std::map<int, uint64_t>> m_InttPacketFeeBcoMap;
 
   // QA histos
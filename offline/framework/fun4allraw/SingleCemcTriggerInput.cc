@@ -65,7 +65,7 @@ void SingleCemcTriggerInput::FillPool(const unsigned int keep)
   }
   while (GetSomeMoreEvents(keep))
   {
-    std::unique_ptr<Event> evt(GetEventiterator()->getNextEvent());
+    std::unique_ptr<Event> evt(GetNextEvent());
     while (!evt)
     {
       fileclose();
@@ -74,7 +74,7 @@ void SingleCemcTriggerInput::FillPool(const unsigned int keep)
         AllDone(1);
         return;
       }
-      evt.reset(GetEventiterator()->getNextEvent());
+      evt.reset(GetNextEvent());
     }
     if (Verbosity() > 21)
     {
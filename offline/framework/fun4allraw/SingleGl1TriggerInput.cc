@@ -59,7 +59,7 @@ void SingleGl1TriggerInput::FillPool(const unsigned int keep)
   }
   while (GetSomeMoreEvents(keep))
   {
-    std::unique_ptr<Event> evt(GetEventiterator()->getNextEvent());
+    std::unique_ptr<Event> evt(GetNextEvent());
     while (!evt)
     {
       fileclose();
@@ -68,7 +68,7 @@ void SingleGl1TriggerInput::FillPool(const unsigned int keep)
         AllDone(1);
         return;
       }
-      evt.reset(GetEventiterator()->getNextEvent());
+      evt.reset(GetNextEvent());
     }
     if (Verbosity() > 2)
     {
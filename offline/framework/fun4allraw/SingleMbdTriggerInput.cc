@@ -62,7 +62,7 @@ void SingleMbdTriggerInput::FillPool(const unsigned int keep)
   }
   while (GetSomeMoreEvents(keep))
   {
-    std::unique_ptr<Event> evt(GetEventiterator()->getNextEvent());
+    std::unique_ptr<Event> evt(GetNextEvent());
     while (!evt)
     {
       fileclose();
@@ -71,7 +71,7 @@ void SingleMbdTriggerInput::FillPool(const unsigned int keep)
         AllDone(1);
         return;
       }
-      evt.reset(GetEventiterator()->getNextEvent());
+      evt.reset(GetNextEvent());
     }
     if (Verbosity() > 2)
     {
@@ -3,14 +3,19 @@
 #include <frog/FROG.h>
 
 #include <ffarawobjects/CaloPacket.h>
+#include <fun4all/Fun4AllHistoManager.h>
 #include <phool/phool.h>
+#include <qautils/QAHistManagerDef.h>
 
+#include <Event/Event.h>
 #include <Event/Eventiterator.h>
 #include <Event/fileEventiterator.h>
 #include <Event/packet.h>
 
+#include <TH1.h>
 #include <TSystem.h>
 
+#include <chrono>
 #include <cstdint>   // for uint64_t
 #include <iostream>  // for operator<<, basic_ostream, endl
 #include <set>
@@ -24,6 +29,7 @@ SingleTriggerInput::SingleTriggerInput(const std::string &name)
 
 SingleTriggerInput::~SingleTriggerInput()
 {
+  StopReadAhead();
   for (auto &openfiles : m_PacketDumpFile)
   {
     openfiles.second->close();
@@ -62,6 +68,7 @@ int SingleTriggerInput::fileopen(const std::string &filenam)
   }
   IsOpen(1);
   AddToFileOpened(fname);  // add file to the list of files which were opened
+  StartReadAhead();
   return 0;
 }
 
@@ -72,6 +79,7 @@ int SingleTriggerInput::fileclose()
     std::cout << Name() << ": fileclose: No Input file open" << std::endl;
     return -1;
   }
+  StopReadAhead();
   delete m_EventIterator;
   m_EventIterator = nullptr;
   IsOpen(0);
@@ -365,3 +373,134 @@ int SingleTriggerInput::SetFEMEventRefPacketId(const int pktid)
   gSystem->Exit(1);
   exit(1);
 }
+
+void SingleTriggerInput::ReadAheadDepth(const unsigned int depth)
+{
+  if (depth == m_ReadAheadDepth)
+  {
+    return;
+  }
+  if (m_ReadAheadThread.joinable())
+  {
+    std::cout << PHWHERE << Name() << ": cannot change the read ahead depth while a file is open" << std::endl;
+    return;
+  }
+  m_ReadAheadDepth = depth;
+  if (m_ReadAheadDepth > 0 && !h_ReadAheadThroughput)
+  {
+    Fun4AllHistoManager *hm = QAHistManagerDef::getHistoManager();
+    h_ReadAheadThroughput = new TH1F(("h_" + Name() + "_ReadAheadThroughput").c_str(),
+                                     (Name() + " read ahead throughput;MB/s;events").c_str(), 500, 0, 1000);
+    hm->registerHisto(h_ReadAheadThroughput);
+    h_ReadAheadStall = new TH1F(("h_" + Name() + "_ReadAheadStall").c_str(),
+                                (Name() + " wait for read ahead thread;ms;events").c_str(), 500, 0, 50);
+    hm->registerHisto(h_ReadAheadStall);
+  }
+  if (IsOpen())
+  {
+    StartReadAhead();
+  }
+}
+
+Event *SingleTriggerInput::GetNextEvent()
+{
+  if (!m_ReadAheadThread.joinable())
+  {
+    return m_EventIterator->getNextEvent();
+  }
+  auto start = std::chrono::steady_clock::now();
+  Event *evt = nullptr;
+  double throughput = -1;
+  {
+    std::unique_lock<std::mutex> lock(m_ReadAheadMutex);
+    m_ReadAheadCondition.wait(lock, [this]
+                              { return !m_ReadAheadQueue.empty() || m_ReadAheadEndOfFile; });
+    if (!m_ReadAheadQueue.empty())
+    {
+      evt = m_ReadAheadQueue.front().first;
+      throughput = m_ReadAheadQueue.front().second;
+      m_ReadAheadQueue.pop_front();
+    }
+  }
+  m_ReadAheadCondition.notify_all();
+  std::chrono::duration<double, std::milli> waited = std::chrono::steady_clock::now() - start;
+  // histograms are only filled here on the main thread, the reader passes its timing along with the event
+  h_ReadAheadStall->Fill(waited.count());
+  if (throughput >= 0)
+  {
+    h_ReadAheadThroughput->Fill(throughput);
+  }
+  return evt;
+}
+
+void SingleTriggerInput::StartReadAhead()
+{
+  if (m_ReadAheadDepth == 0 || !m_EventIterator || m_ReadAheadThread.joinable())
+  {
+    return;
+  }
+  m_ReadAheadStop = false;
+  m_ReadAheadEndOfFile = false;
+  m_ReadAheadThread = std::thread(&SingleTriggerInput::ReadAheadLoop, this);
+}
+
+void SingleTriggerInput::StopReadAhead()
+{
+  if (!m_ReadAheadThread.joinable())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_ReadAheadMutex);
+    m_ReadAheadStop = true;
+  }
+  m_ReadAheadCondition.notify_all();
+  m_ReadAheadThread.join();
+  // events read ahead but not used (e.g. when closing the file early)
+  for (auto &queued : m_ReadAheadQueue)
+  {
+    delete queued.first;
+  }
+  m_ReadAheadQueue.clear();
+}
+
+void SingleTriggerInput::ReadAheadLoop()
+{
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_ReadAheadMutex);
+      m_ReadAheadCondition.wait(lock, [this]
+                                { return m_ReadAheadStop || m_ReadAheadQueue.size() < m_ReadAheadDepth; });
+      if (m_ReadAheadStop)
+      {
+        return;
+      }
+    }
+    auto start = std::chrono::steady_clock::now();
+    Event *evt = m_EventIterator->getNextEvent();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    // MB/s, the event length is in 32 bit words. Histogrammed by GetNextEvent on the main thread
+    double throughput = -1;
+    if (evt && elapsed.count() > 0)
+    {
+      throughput = 4. * evt->getEvtLength() / 1e6 / elapsed.count();
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_ReadAheadMutex);
+      if (evt)
+      {
+        m_ReadAheadQueue.emplace_back(evt, throughput);
+      }
+      else
+      {
+        m_ReadAheadEndOfFile = true;
+      }
+    }
+    m_ReadAheadCondition.notify_all();
+    if (!evt)
+    {
+      return;
+    }
+  }
+}
@@ -4,19 +4,26 @@
 #include <fun4all/Fun4AllBase.h>
 #include <fun4all/InputFileHandler.h>
 
+#include <condition_variable>
 #include <cstdint>  // for uint64_t
+#include <deque>
 #include <fstream>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <utility>  // for pair
 #include <vector>
 
+class Event;
 class Eventiterator;
 class Fun4AllPrdfInputTriggerManager;
 class OfflinePacket;
 class Packet;
 class PHCompositeNode;
+class TH1;
 
 class SingleTriggerInput : public Fun4AllBase, public InputFileHandler
 {
@@ -58,9 +65,16 @@ class SingleTriggerInput : public Fun4AllBase, public InputFileHandler
   virtual int LastEvent() const { return m_LastEvent; }
   virtual int SetFEMEventRefPacketId(const int pktid);
   virtual int FEMEventRefPacketId() const {return  m_FEMEventRefPacketId;}
+  // read events (file i/o and decompression) on a separate thread, keeping up
+  // to depth events in a queue. 0 (default) reads on the calling thread
+  virtual void ReadAheadDepth(const unsigned int depth);
+  virtual unsigned int ReadAheadDepth() const { return m_ReadAheadDepth; }
   // these ones are used directly by the derived classes, maybe later
   // move to cleaner accessors
  protected:
+  // next event from the current file, nullptr at the end of the file
+  Event *GetNextEvent();
+
   std::map<int, std::vector<OfflinePacket *>> m_PacketMap;
   unsigned int m_NumSpecialEvents{0};
   std::set<int> m_EventNumber;
@@ -86,6 +100,21 @@ class SingleTriggerInput : public Fun4AllBase, public InputFileHandler
   std::map<int, std::ofstream *> m_PacketDumpFile;
   std::map<int, int> m_PacketDumpCounter;
   std::map<int, int> m_EventNumberOffset;  // packet wise event number offset
+
+  // read ahead thread, runs for the currently open file
+  void StartReadAhead();
+  void StopReadAhead();
+  void ReadAheadLoop();
+  unsigned int m_ReadAheadDepth{0};
+  bool m_ReadAheadStop{false};
+  bool m_ReadAheadEndOfFile{false};
+  // events read ahead with the reader throughput (MB/s, negative if not measured)
+  std::deque<std::pair<Event *, double>> m_ReadAheadQueue;
+  std::mutex m_ReadAheadMutex;
+  std::condition_variable m_ReadAheadCondition;
+  std::thread m_ReadAheadThread;
+  TH1 *h_ReadAheadThroughput{nullptr};  // MB/s of the reader thread, per event
+  TH1 *h_ReadAheadStall{nullptr};       // ms waited for the reader thread, per event
 };
 
 #endif
@@ -20,12 +20,71 @@
 
 #include <cassert>
 #include <cstdint>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <string>
 
 using namespace std;
 
+namespace
+{
+  //! slicing-by-2 lookup tables for the reflected CRC-16 with polynomial 0xa001
+  /*!
+   * the CRC is linear, so advancing a 16-bit word splits into independent lookups
+   * for the two bytes of the running crc and the two bytes of the data word.
+   * The bit reversal of the data word is folded into the data tables
+   */
+  struct crc16_tables
+  {
+    uint16_t crc_lo[256] = {0};
+    uint16_t crc_hi[256] = {0};
+    uint16_t data_lo[256] = {0};
+    uint16_t data_hi[256] = {0};
+
+    crc16_tables()
+    {
+      auto shift16 = [](uint16_t crc)
+      {
+        for (uint16_t k = 0; k < 16U; k++)
+        {
+          crc = crc & 1U ? static_cast<uint16_t>(crc >> 1U) ^ 0xa001U : crc >> 1U;
+        }
+        return crc;
+      };
+
+      auto reverse8 = [](unsigned int b)
+      {
+        unsigned int r = 0;
+        for (unsigned int k = 0; k < 8U; ++k)
+        {
+          r |= ((b >> k) & 1U) << (7U - k);
+        }
+        return r;
+      };
+
+      for (unsigned int i = 0; i < 256U; ++i)
+      {
+        crc_lo[i] = shift16(static_cast<uint16_t>(i));
+        crc_hi[i] = shift16(static_cast<uint16_t>(i << 8U));
+      }
+
+      // the low byte of a data word ends up in the high byte once reversed, and vice versa
+      for (unsigned int i = 0; i < 256U; ++i)
+      {
+        data_lo[i] = crc_hi[reverse8(i)];
+        data_hi[i] = crc_lo[reverse8(i)];
+      }
+    }
+  };
+
+  const crc16_tables& get_crc16_tables()
+  {
+    static const crc16_tables tables;
+    return tables;
+  }
+}  // namespace
+
 TpcTimeFrameBuilder::TpcTimeFrameBuilder(const int packet_id)
   : m_packet_id(packet_id)
   , m_HistoPrefix("TpcTimeFrameBuilder_Packet" + to_string(packet_id))
@@ -528,10 +587,7 @@ int TpcTimeFrameBuilder::ProcessPacket(Packet* packet)
 
       if (fee_id < MAX_FEECOUNT)
       {
-        for (const uint16_t& i : dma_word_data.data)
-        {
-          m_feeData[fee_id].push_back(i);
-        }
+        m_feeData[fee_id].append(std::begin(dma_word_data.data), std::end(dma_word_data.data));
         m_hNorm->Fill("DMA_WORD_FEE", 1);
 
         // immediate fee buffer processing to reduce memory consuption
@@ -595,7 +651,7 @@ int TpcTimeFrameBuilder::process_fee_data(unsigned int fee)
   }
 
   assert(fee < m_feeData.size());
-  std::deque<uint16_t>& data_buffer = m_feeData[fee];
+  fee_buffer& data_buffer = m_feeData[fee];
 
   while (HEADER_LENGTH <= data_buffer.size())
   {
@@ -807,8 +863,7 @@ int TpcTimeFrameBuilder::process_fee_data(unsigned int fee)
 
       // Format is (N sample) (start time), (1st sample)... (Nth sample)
       size_t pos = HEADER_LENGTH;
-      std::deque<uint16_t>::const_iterator data_buffer_iterator = data_buffer.cbegin();
-      std::advance(data_buffer_iterator, pos);
+      const uint16_t* data_buffer_iterator = data_buffer.data() + pos;
       while (pos + 2 < pkt_length)
       {
         const uint16_t& nsamp = *data_buffer_iterator;
@@ -844,17 +899,13 @@ int TpcTimeFrameBuilder::process_fee_data(unsigned int fee)
         }
 
         const unsigned int fee_sampa_address = fee * MAX_SAMPA + payload.sampa_address;
-        std::vector<uint16_t> adc(nsamp);
+        std::vector<uint16_t> adc(data_buffer_iterator, data_buffer_iterator + nsamp);
         for (int j = 0; j < nsamp; j++)
         {
-          const uint16_t& adc_value = *data_buffer_iterator;
-
-          adc[j] = adc_value;
-          m_hFEESAMPAADC->Fill(start_t + j, fee_sampa_address, adc_value);
-
-          ++pos;
-          ++data_buffer_iterator;  //data_buffer[pos++];
+          m_hFEESAMPAADC->Fill(start_t + j, fee_sampa_address, adc[j]);
         }
+        pos += nsamp;
+        data_buffer_iterator += nsamp;
         payload.waveforms.emplace_back(start_t, std::move(adc));
 
         //   // an exception to deal with the last sample that is missing in the current hit format
@@ -895,7 +946,7 @@ int TpcTimeFrameBuilder::process_fee_data(unsigned int fee)
       }
     }  //     if (not m_fastBCOSkip)
 
-    data_buffer.erase(data_buffer.begin(), data_buffer.begin() + pkt_length + 1);
+    data_buffer.pop_front(pkt_length + 1);
     m_hFEEDataStream->Fill(fee, "WordValid", pkt_length + 1);
 
   }  //     while (HEADER_LENGTH < data_buffer.size())
@@ -997,38 +1048,30 @@ uint16_t TpcTimeFrameBuilder::reverseBits(const uint16_t x) const
 
 std::pair<uint16_t, uint16_t> TpcTimeFrameBuilder::crc16_parity(const uint32_t fee, const uint16_t l) const
 {
-  const std::deque<uint16_t>& data_buffer = m_feeData[fee];
+  const fee_buffer& data_buffer = m_feeData[fee];
   assert(l < data_buffer.size());
 
-  std::deque<uint16_t>::const_iterator it = data_buffer.begin();
+  const crc16_tables& tables = get_crc16_tables();
+  const uint16_t* words = data_buffer.data();
 
   uint16_t crc = 0xffffU;
-  uint16_t data_parity = 0U;
-
-  for (int i = 0; i < l; ++i, ++it)
+  for (int i = 0; i < l; ++i)
   {
-    const uint16_t& x = *it;
-
-    crc ^= reverseBits(x);
-    for (uint16_t k = 0; k < 16U; k++)
-    {
-      crc = crc & 1U ? static_cast<uint16_t>(crc >> 1U) ^ 0xa001U : crc >> 1U;
-    }
-
-    // parity on data payload only
-    if (i >= HEADER_LENGTH)
-    {
-      // fast parity
-      uint16_t word = x & uint16_t((1U << 10U) - 1U);
-      word = word ^ static_cast<uint16_t>(word >> 1U);
-      word = word ^ static_cast<uint16_t>(word >> 2U);
-      word = word ^ static_cast<uint16_t>(word >> 4U);
-      word = word ^ static_cast<uint16_t>(word >> 8U);
-      data_parity ^= word & 1U;
-    }
+    // equivalent to crc ^= reverseBits(x) followed by 16 bitwise shifts with polynomial 0xa001
+    const uint16_t& x = words[i];
+    crc = tables.crc_lo[crc & 0xffU] ^ tables.crc_hi[crc >> 8U] ^ tables.data_lo[x & 0xffU] ^ tables.data_hi[x >> 8U];
   }
   crc = reverseBits(crc);
-  return make_pair(crc, data_parity);
+
+  // parity on 10-bit data payload only
+  unsigned int data_parity = 0U;
+  for (int i = HEADER_LENGTH; i < l; ++i)
+  {
+    data_parity ^= words[i];
+  }
+  data_parity = static_cast<unsigned int>(__builtin_parity(data_parity & ((1U << 10U) - 1U)));
+
+  return make_pair(crc, static_cast<uint16_t>(data_parity));
 }
 
 namespace
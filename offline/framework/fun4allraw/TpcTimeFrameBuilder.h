@@ -3,7 +3,6 @@
 
 #include <algorithm>
 #include <cstdint>
-#include <deque>
 #include <functional>
 #include <iostream>
 #include <limits>
@@ -317,7 +316,47 @@ class TpcTimeFrameBuilder
   };  //   class BcoMatchingInformation
 
  private:
-  std::vector<std::deque<uint16_t>> m_feeData;
+  //! contiguous per-FEE word buffer, consumed from the front
+  /*!
+   * words are appended at the back and dropped from the front by advancing a read offset.
+   * The consumed head is only compacted away when it exceeds the unread part,
+   * so that decoding always runs over contiguous memory
+   */
+  class fee_buffer
+  {
+   public:
+    size_t size() const { return m_data.size() - m_start; }
+    bool empty() const { return m_start == m_data.size(); }
+
+    const uint16_t *data() const { return m_data.data() + m_start; }
+    const uint16_t &operator[](size_t i) const { return m_data[m_start + i]; }
+
+    void append(const uint16_t *begin, const uint16_t *end)
+    {
+      if (m_start > 0 && m_start >= size())
+      {
+        m_data.erase(m_data.begin(), m_data.begin() + m_start);
+        m_start = 0;
+      }
+      m_data.insert(m_data.end(), begin, end);
+    }
+
+    void pop_front(size_t n = 1)
+    {
+      m_start = std::min(m_start + n, m_data.size());
+      if (m_start == m_data.size())
+      {
+        m_data.clear();
+        m_start = 0;
+      }
+    }
+
+   private:
+    std::vector<uint16_t> m_data;
+    size_t m_start = 0;
+  };
+
+  std::vector<fee_buffer> m_feeData;
 
   int m_verbosity = 0;
   int m_packet_id = 0;
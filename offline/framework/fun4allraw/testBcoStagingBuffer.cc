@@ -0,0 +1,139 @@
+// Differential test of BcoStagingBuffer against std::map<uint64_t, T>.
+// Random sequences of the operations Fun4AllStreamingInputManager uses
+// (operator[] on new and staged bcos, erase of the oldest entries, erase while
+// iterating, ordered iteration, clear) are applied to both containers and the
+// contents are compared after every operation. The bcos mostly advance
+// slowly with some jitter, with jumps beyond BcoStagingBuffer::max_slots and
+// back so that the overflow map and the ring growth are exercised.
+// Returns 0 if both containers agree, 1 otherwise.
+#include "BcoStagingBuffer.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+
+namespace
+{
+  bool compare(const BcoStagingBuffer<uint64_t> &buffer, const std::map<uint64_t, uint64_t> &reference, const int trial, const int op)
+  {
+    if (buffer.size() != reference.size() || buffer.empty() != reference.empty())
+    {
+      std::cout << "size mismatch trial " << trial << " op " << op << ": "
+                << buffer.size() << " vs " << reference.size() << std::endl;
+      return false;
+    }
+    auto iter = buffer.begin();
+    for (const auto &[bco, value] : reference)
+    {
+      if (iter == buffer.end())
+      {
+        std::cout << "iter mismatch trial " << trial << " op " << op << ": end vs " << bco << std::endl;
+        return false;
+      }
+      if (iter->first != bco || iter->second != value)
+      {
+        std::cout << "iter mismatch trial " << trial << " op " << op << ": "
+                  << iter->first << " vs " << bco << ", value "
+                  << iter->second << " vs " << value << std::endl;
+        return false;
+      }
+      ++iter;
+    }
+    if (iter != buffer.end())
+    {
+      std::cout << "iter mismatch trial " << trial << " op " << op << ": "
+                << iter->first << " vs end" << std::endl;
+      return false;
+    }
+    return true;
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  const int ntrials = (argc > 1) ? std::atoi(argv[1]) : 2000;
+  const int nops = (argc > 2) ? std::atoi(argv[2]) : 500;
+  const uint64_t max_slots = BcoStagingBuffer<uint64_t>::max_slots;
+
+  std::mt19937_64 rng(20240611);
+  for (int trial = 0; trial < ntrials; trial++)
+  {
+    BcoStagingBuffer<uint64_t> buffer;
+    std::map<uint64_t, uint64_t> reference;
+    // start away from 0 so that jumps back do not wrap around
+    uint64_t current = 10 * max_slots + rng() % 1000;
+    // small windows stay in the ring, large ones reach the overflow map
+    const uint64_t jitter = (trial % 3 == 0) ? 50 : ((trial % 3 == 1) ? 3000 : 3 * max_slots);
+    for (int op = 0; op < nops; op++)
+    {
+      const unsigned int kind = rng() % 100;
+      if (kind < 55)
+      {
+        // stage a hit at a bco around the current one
+        uint64_t bco = current + rng() % jitter;
+        if (rng() % 4 == 0)
+        {
+          bco -= std::min<uint64_t>(bco, rng() % jitter);
+        }
+        current += rng() % 8;
+        const uint64_t value = rng() % 1000;
+        buffer[bco] += value;
+        reference[bco] += value;
+      }
+      else if (kind < 62)
+      {
+        // jump far ahead or back
+        const uint64_t jump = max_slots / 2 + rng() % (2 * max_slots);
+        const uint64_t bco = (rng() % 2) ? current + jump : current - std::min(current, jump);
+        buffer[bco] += 1;
+        reference[bco] += 1;
+      }
+      else if (kind < 72 && !reference.empty())
+      {
+        // lookup of an already staged bco
+        auto refiter = reference.begin();
+        std::advance(refiter, rng() % reference.size());
+        const uint64_t value = rng() % 1000;
+        buffer[refiter->first] += value;
+        refiter->second += value;
+      }
+      else if (kind < 90)
+      {
+        // retire the oldest bcos
+        const unsigned int nerase = 1 + rng() % 4;
+        for (unsigned int i = 0; i < nerase && !reference.empty(); i++)
+        {
+          buffer.erase(buffer.begin());
+          reference.erase(reference.begin());
+        }
+      }
+      else if (kind < 97 && !reference.empty())
+      {
+        // retire all bcos up to a limit while iterating, as for the micromegas
+        auto refiter = reference.begin();
+        std::advance(refiter, rng() % reference.size());
+        const uint64_t last_bco = refiter->first;
+        for (auto iter = buffer.begin(); iter != buffer.end() && iter->first <= last_bco; iter = buffer.erase(iter))
+        {
+        }
+        for (auto iter = reference.begin(); iter != reference.end() && iter->first <= last_bco; iter = reference.erase(iter))
+        {
+        }
+      }
+      else if (kind == 99)
+      {
+        buffer.clear();
+        reference.clear();
+      }
+      if (!compare(buffer, reference, trial, op))
+      {
+        return 1;
+      }
+    }
+  }
+  std::cout << "testBcoStagingBuffer: " << ntrials << " trials of " << nops << " operations agree with std::map" << std::endl;
+  return 0;
+}
@@ -28,30 +28,111 @@ PHCompositeNode::~PHCompositeNode()
   // a parent and supposed to stay. Then the deleted node has to take itself
   // out of the node list
   deleteMe = 1;
+  // take ourself out of the parent while the name index is still alive,
+  // PHNode::~PHNode() calls forgetMe() when only the PHNode part is left
+  if (parent)
+  {
+    parent->forgetMe(this);
+    parent = nullptr;
+  }
   subNodes.clearAndDestroy();
 }
 
 bool PHCompositeNode::addNode(PHNode* newNode)
 {
   //
-  // Check all existing subNodes for name-conflict.
+  // Check all existing subNodes for name-conflict (only if the
+  // name exists somewhere below us)
   //
-  PHPointerListIterator<PHNode> nodeIter(subNodes);
-  PHNode* thisNode;
-  while ((thisNode = nodeIter()))
+  if (countInSubTree(newNode->getName()))
   {
-    if (thisNode->getName() == newNode->getName())
+    PHPointerListIterator<PHNode> nodeIter(subNodes);
+    PHNode* thisNode;
+    while ((thisNode = nodeIter()))
     {
-      std::cout << PHWHERE << "Node " << newNode->getName()
-                << " already exists" << std::endl;
-      return false;
+      if (thisNode->getName() == newNode->getName())
+      {
+        std::cout << PHWHERE << "Node " << newNode->getName()
+                  << " already exists" << std::endl;
+        return false;
+      }
     }
   }
   //
   // No conflict, so we can append the new node.
   //
   newNode->setParent(this);
-  return (subNodes.append(newNode));
+  if (!subNodes.append(newNode))
+  {
+    return false;
+  }
+  updateIndex(newNode, 1);
+  return true;
+}
+
+unsigned int PHCompositeNode::countInSubTree(const std::string& nodename) const
+{
+  auto iter = m_SubTreeNames.find(nodename);
+  return (iter == m_SubTreeNames.end()) ? 0 : iter->second;
+}
+
+void PHCompositeNode::updateIndex(PHNode* node, const int sign)
+{
+  // the names of the node and of its whole sub tree
+  std::map<std::string, unsigned int> names;
+  PHCompositeNode* compnode = dynamic_cast<PHCompositeNode*>(node);
+  if (compnode)
+  {
+    names = compnode->m_SubTreeNames;
+  }
+  ++names[node->getName()];
+  for (PHCompositeNode* thisNode = this; thisNode; thisNode = static_cast<PHCompositeNode*>(thisNode->getParent()))
+  {
+    for (const auto& [nodename, count] : names)
+    {
+      if (sign > 0)
+      {
+        thisNode->m_SubTreeNames[nodename] += count;
+      }
+      else
+      {
+        auto iter = thisNode->m_SubTreeNames.find(nodename);
+        if (iter != thisNode->m_SubTreeNames.end())
+        {
+          if (iter->second > count)
+          {
+            iter->second -= count;
+          }
+          else
+          {
+            thisNode->m_SubTreeNames.erase(iter);
+          }
+        }
+      }
+    }
+    ++thisNode->m_Generation;
+  }
+}
+
+void PHCompositeNode::childRenamed(const std::string& oldname, const std::string& newname)
+{
+  for (PHCompositeNode* thisNode = this; thisNode; thisNode = static_cast<PHCompositeNode*>(thisNode->getParent()))
+  {
+    auto iter = thisNode->m_SubTreeNames.find(oldname);
+    if (iter != thisNode->m_SubTreeNames.end())
+    {
+      if (iter->second > 1)
+      {
+        --iter->second;
+      }
+      else
+      {
+        thisNode->m_SubTreeNames.erase(iter);
+      }
+    }
+    ++thisNode->m_SubTreeNames[newname];
+    ++thisNode->m_Generation;
+  }
 }
 
 void PHCompositeNode::prune()
@@ -62,6 +143,7 @@ void PHCompositeNode::prune()
   {
     if (!thisNode->isPersistent())
     {
+      updateIndex(thisNode, -1);
       subNodes.removeAt(nodeIter.pos());
       --nodeIter;
       delete thisNode;
@@ -89,6 +171,7 @@ void PHCompositeNode::forgetMe(PHNode* child)
   {
     if (thisNode == child)
     {
+      updateIndex(child, -1);
       subNodes.removeAt(nodeIter.pos());
       child = nullptr;
     }
@@ -7,6 +7,8 @@
 #include "PHNode.h"
 #include "PHPointerList.h"
 
+#include <cstdint>
+#include <map>
 #include <string>
 
 class PHIOManager;
@@ -24,6 +26,19 @@ class PHCompositeNode : public PHNode
   //
   bool addNode(PHNode *);
 
+  //
+  // Number of nodes with the given name below this node. Every composite node
+  // keeps the names of its sub tree, so searches do not need to walk the tree.
+  // Renaming a node with setName() updates the index of its parents.
+  //
+  unsigned int countInSubTree(const std::string &) const;
+
+  //
+  // Changes whenever a node is added to, removed from or renamed in the sub tree,
+  // used to invalidate cached search results (findNode::NodeHandle)
+  //
+  uint64_t generation() const { return m_Generation; }
+
   //
   // This recursively calls the prune function of all the subnodes.
   // If a subnode is found to be marked as transient (non persistent)
@@ -39,11 +54,17 @@ class PHCompositeNode : public PHNode
 
  protected:
   void forgetMe(PHNode *) override;
+  void childRenamed(const std::string &oldname, const std::string &newname) override;
   PHPointerList<PHNode> subNodes;
   int deleteMe = 0;
 
  private:
   PHCompositeNode() = delete;
+  // add (sign = 1) or remove (sign = -1) a node and its sub tree from the
+  // name index of this node and all its parents
+  void updateIndex(PHNode *, const int sign);
+  std::map<std::string, unsigned int> m_SubTreeNames;
+  uint64_t m_Generation{0};
 };
 
 #endif
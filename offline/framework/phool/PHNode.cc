@@ -58,6 +58,21 @@ PHNode::~PHNode()
   }
 }
 
+void PHNode::setName(const std::string& n)
+{
+  if (n == name)
+  {
+    return;
+  }
+  const std::string oldname = name;
+  name = n;
+  // the parents keep an index of the names below them
+  if (parent)
+  {
+    parent->childRenamed(oldname, name);
+  }
+}
+
 // Implementation of external functions.
 std::ostream&
 operator<<(std::ostream& stream, const PHNode& node)
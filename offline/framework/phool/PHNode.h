@@ -26,11 +26,13 @@ class PHNode
   const std::string getName() const { return name; }
   const std::string getClass() const { return objectclass; }
   void setParent(PHNode *p) { parent = p; }
-  void setName(const std::string &n) { name = n; }
+  void setName(const std::string &n);
   void setObjectType(const std::string &n) { objecttype = n; }
   virtual void prune() = 0;
   virtual void print(const std::string &) = 0;
   virtual void forgetMe(PHNode *) = 0;
+  // called by a child node which was renamed, see PHCompositeNode
+  virtual void childRenamed(const std::string & /*oldname*/, const std::string & /*newname*/) {}
   virtual bool write(PHIOManager *, const std::string & = "") = 0;
 
   virtual void setResetFlag(const bool b) { reset_able = b; }
@@ -54,15 +54,36 @@ PHNodeIOManager::PHNodeIOManager(const std::string& f, const PHAccessType a,
   isFunctionalFlag = setFile(f, "titled by PHOOL", a) ? 1 : 0;
 }
 
+PHNodeIOManager::PHNodeIOManager(TFile* f, const PHTreeType treeindex)
+  : file(f)
+  , m_OwnFile(false)
+{
+  if (treeindex != PHEventTree)
+  {
+    std::ostringstream temp;
+    temp << TreeName << treeindex;  // create e.g. T1
+    TreeName = temp.str();
+  }
+  if (file)
+  {
+    filename = file->GetName();
+    selectObjectToRead("*", true);
+    isFunctionalFlag = file->IsOpen() ? 1 : 0;
+  }
+}
+
 PHNodeIOManager::~PHNodeIOManager()
 {
   closeFile();
-  delete file;
+  if (m_OwnFile)
+  {
+    delete file;
+  }
 }
 
 void PHNodeIOManager::closeFile()
 {
-  if (file)
+  if (file && m_OwnFile)
   {
     if (accessMode == PHWrite || accessMode == PHUpdate)
     {
@@ -79,13 +100,17 @@ bool PHNodeIOManager::setFile(const std::string& f, const std::string& title,
   accessMode = a;
   if (file)
   {
-    if (file->IsOpen())
+    if (m_OwnFile)
     {
-      closeFile();
+      if (file->IsOpen())
+      {
+        closeFile();
+      }
+      delete file;
     }
-    delete file;
     file = nullptr;
   }
+  m_OwnFile = true;
   std::string currdir = gDirectory->GetPath();
   gROOT->cd();
   switch (accessMode)
@@ -28,6 +28,8 @@ class PHNodeIOManager : public PHIOManager
   PHNodeIOManager(const std::string &, const PHAccessType = PHReadOnly);
   PHNodeIOManager(const std::string &, const std::string &, const PHAccessType = PHReadOnly);
   PHNodeIOManager(const std::string &, const PHAccessType, const PHTreeType);
+  // read a tree from a file opened by another PHNodeIOManager (which keeps ownership)
+  PHNodeIOManager(TFile *, const PHTreeType);
   ~PHNodeIOManager() override;
 
   // cppcheck-suppress [virtualCallInConstructor]
@@ -46,6 +48,7 @@ class PHNodeIOManager : public PHIOManager
   uint64_t GetBytesWritten();
   uint64_t GetFileSize();
   std::map<std::string, TBranch *> *GetBranchMap();
+  TFile *GetFile() const { return file; }
 
   bool write(TObject **, const std::string &, int nodebuffersize, int nodesplitlevel);
   bool NodeExist(const std::string &nodename);
@@ -67,6 +70,7 @@ class PHNodeIOManager : public PHIOManager
   int accessMode{PHReadOnly};
   int m_CompressionSetting{505};  // ZSTD
   int isFunctionalFlag{0};        // flag to tell if that object initialized properly
+  bool m_OwnFile{true};           // file is closed and deleted by us
   int buffersize{std::numeric_limits<int>::min()};
   int splitlevel{std::numeric_limits<int>::min()};
   std::map<std::string, TBranch *> fBranches;
@@ -53,6 +53,11 @@ void PHNodeIterator::print()
 // NOLINTNEXTLINE(misc-no-recursion)
 PHNode* PHNodeIterator::findFirst(const std::string& requiredType, const std::string& requiredName)
 {
+  // the name index tells us which sub trees need to be searched
+  if (!currentNode->countInSubTree(requiredName))
+  {
+    return nullptr;
+  }
   PHPointerListIterator<PHNode> iter(currentNode->subNodes);
   PHNode* thisNode;
   while ((thisNode = iter()))
@@ -62,7 +67,7 @@ PHNode* PHNodeIterator::findFirst(const std::string& requiredType, const std::st
       return thisNode;
     }
 
-    if (thisNode->getType() == "PHCompositeNode")
+    if (thisNode->getType() == "PHCompositeNode" && static_cast<PHCompositeNode*>(thisNode)->countInSubTree(requiredName))
     {
       PHNodeIterator nodeIter(static_cast<PHCompositeNode*>(thisNode));
       PHNode* nodeFoundInSubTree = nodeIter.findFirst(requiredType, requiredName);
@@ -78,6 +83,12 @@ PHNode* PHNodeIterator::findFirst(const std::string& requiredType, const std::st
 // NOLINTNEXTLINE(misc-no-recursion)
 PHNode* PHNodeIterator::findFirst(const std::string& requiredName)
 {
+  // the name index tells us if and in which sub tree the node is, so we
+  // only descend into the sub tree which contains it
+  if (!currentNode->countInSubTree(requiredName))
+  {
+    return nullptr;
+  }
   PHPointerListIterator<PHNode> iter(currentNode->subNodes);
   PHNode* thisNode;
   while ((thisNode = iter()))
@@ -87,14 +98,10 @@ PHNode* PHNodeIterator::findFirst(const std::string& requiredName)
       return thisNode;
     }
 
-    if (thisNode->getType() == "PHCompositeNode")
+    if (thisNode->getType() == "PHCompositeNode" && static_cast<PHCompositeNode*>(thisNode)->countInSubTree(requiredName))
     {
       PHNodeIterator nodeIter(static_cast<PHCompositeNode*>(thisNode));
-      PHNode* nodeFoundInSubTree = nodeIter.findFirst(requiredName);
-      if (nodeFoundInSubTree)
-      {
-        return nodeFoundInSubTree;
-      }
+      return nodeIter.findFirst(requiredName);
     }
   }
   return nullptr;
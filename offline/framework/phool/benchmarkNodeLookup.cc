@@ -0,0 +1,195 @@
+// Microbenchmark of the per event node lookup overhead.
+// Builds a node tree shaped like a reconstructed DST (DST, RUN and PAR nodes,
+// per subsystem composite nodes below DST holding the PHIODataNodes) and
+// measures the time per lookup of
+//  - the depth first search over the sub nodes which findFirst() did before
+//    the name index (reimplemented here on PHNodeIterator::ls())
+//  - findNode::getClass<T>(top, name), which uses the name index
+//  - findNode::NodeHandle<T>::get() of a handle resolved once
+// It also checks that the indexed search returns the same node as the depth
+// first search for every node name, after nodes were added, deleted and
+// renamed.
+// benchmarkNodeLookup <nsubsystems> <nodes per subsystem> <events>
+// Returns 0 if all searches agree, 1 otherwise.
+#include "PHCompositeNode.h"
+#include "PHIODataNode.h"
+#include "PHNode.h"
+#include "PHNodeIterator.h"
+#include "PHNodeOperation.h"
+#include "PHObject.h"
+#include "PHPointerListIterator.h"
+#include "getClass.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // the search of PHNodeIterator::findFirst(name) without the name index
+  // NOLINTNEXTLINE(misc-no-recursion)
+  PHNode *findFirstWalk(PHCompositeNode *node, const std::string &name)
+  {
+    PHNodeIterator iter(node);
+    PHPointerListIterator<PHNode> subnodes(iter.ls());
+    PHNode *thisNode;
+    while ((thisNode = subnodes()))
+    {
+      if (thisNode->getName() == name)
+      {
+        return thisNode;
+      }
+      if (thisNode->getType() == "PHCompositeNode")
+      {
+        PHNode *found = findFirstWalk(static_cast<PHCompositeNode *>(thisNode), name);
+        if (found)
+        {
+          return found;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  // collects the names of all nodes below the top node
+  class NameCollector : public PHNodeOperation
+  {
+   public:
+    std::vector<std::string> names;
+
+   protected:
+    void perform(PHNode *node) override { names.push_back(node->getName()); }
+  };
+
+  int checkAll(PHCompositeNode *top, const std::string &when)
+  {
+    NameCollector collector;
+    PHNodeIterator iter(top);
+    iter.forEach(collector);
+    collector.names.push_back("NOT_IN_TREE");
+    int nbad = 0;
+    for (const auto &name : collector.names)
+    {
+      if (name == top->getName())
+      {
+        continue;
+      }
+      PHNodeIterator nodeiter(top);
+      PHNode *indexed = nodeiter.findFirst(name);
+      PHNode *walked = findFirstWalk(top, name);
+      if (indexed != walked)
+      {
+        std::cout << "benchmarkNodeLookup: " << when << ", search for " << name
+                  << " returns " << indexed << " instead of " << walked << std::endl;
+        nbad++;
+      }
+    }
+    return nbad;
+  }
+
+  template <class Func>
+  double nsPerCall(const unsigned int ncalls, Func func)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < ncalls; i++)
+    {
+      func(i);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ncalls;
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  const int nsubsystems = (argc > 1) ? std::atoi(argv[1]) : 20;
+  const int nnodes = (argc > 2) ? std::atoi(argv[2]) : 10;
+  const unsigned int nevents = (argc > 3) ? std::atoi(argv[3]) : 100000;
+
+  PHCompositeNode *top = new PHCompositeNode("TOP");
+  PHCompositeNode *dst = new PHCompositeNode("DST");
+  PHCompositeNode *run = new PHCompositeNode("RUN");
+  PHCompositeNode *par = new PHCompositeNode("PAR");
+  top->addNode(dst);
+  top->addNode(run);
+  top->addNode(par);
+  std::vector<std::string> names;
+  for (int isub = 0; isub < nsubsystems; isub++)
+  {
+    PHCompositeNode *subsystem = new PHCompositeNode("SUBSYSTEM" + std::to_string(isub));
+    dst->addNode(subsystem);
+    for (int inode = 0; inode < nnodes; inode++)
+    {
+      const std::string name = "NODE" + std::to_string(isub) + "_" + std::to_string(inode);
+      subsystem->addNode(new PHIODataNode<PHObject>(new PHObject(), name, "PHObject"));
+      names.push_back(name);
+    }
+  }
+  for (int inode = 0; inode < nnodes; inode++)
+  {
+    run->addNode(new PHIODataNode<PHObject>(new PHObject(), "RUNNODE" + std::to_string(inode), "PHObject"));
+    par->addNode(new PHIODataNode<PHObject>(new PHObject(), "PARNODE" + std::to_string(inode), "PHObject"));
+  }
+
+  int nbad = checkAll(top, "after building the tree");
+
+  // three lookups per event, spread over the tree
+  const std::vector<std::string> lookups = {names.front(), names[names.size() / 2], names.back()};
+  std::vector<findNode::NodeHandle<PHObject>> handles;
+  for (const auto &name : lookups)
+  {
+    handles.emplace_back(top, name);
+  }
+  PHObject *sink = nullptr;
+  const unsigned int ncalls = nevents * lookups.size();
+  const double walk = nsPerCall(ncalls, [&](unsigned int i)
+                                { sink = findNode::getClass<PHObject>(findFirstWalk(top, lookups[i % 3])); });
+  const double indexed = nsPerCall(ncalls, [&](unsigned int i)
+                                   { sink = findNode::getClass<PHObject>(top, lookups[i % 3]); });
+  const double handle = nsPerCall(ncalls, [&](unsigned int i)
+                                  { sink = handles[i % 3].get(); });
+  if (!sink)
+  {
+    std::cout << "benchmarkNodeLookup: lookup failed" << std::endl;
+    nbad++;
+  }
+  std::cout << "benchmarkNodeLookup: " << names.size() + 2 * nnodes + nsubsystems + 3 << " nodes, "
+            << lookups.size() << " lookups per event, per lookup: search without index " << walk
+            << " ns, getClass " << indexed << " ns, NodeHandle " << handle << " ns" << std::endl;
+
+  // add, delete and rename nodes, the index and the handles have to follow
+  PHCompositeNode *extra = new PHCompositeNode("EXTRA");
+  dst->addNode(extra);
+  extra->addNode(new PHIODataNode<PHObject>(new PHObject(), names.front(), "PHObject"));
+  nbad += checkAll(top, "after adding nodes");
+
+  PHNodeIterator iter(top);
+  delete iter.findFirst(names[names.size() / 2]);
+  nbad += checkAll(top, "after deleting a node");
+  if (handles[1].get())
+  {
+    std::cout << "benchmarkNodeLookup: handle of the deleted node " << handles[1].name() << " is still valid" << std::endl;
+    nbad++;
+  }
+
+  PHNode *renamed = iter.findFirst(names.back());
+  renamed->setName("RENAMED");
+  iter.findFirst("SUBSYSTEM0")->setName("RENAMEDSUBSYSTEM");
+  nbad += checkAll(top, "after renaming nodes");
+  findNode::NodeHandle<PHObject> renamedhandle(top, "RENAMED");
+  if (handles[2].get() || renamedhandle.get() != findNode::getClass<PHObject>(renamed))
+  {
+    std::cout << "benchmarkNodeLookup: handles do not follow the renamed node" << std::endl;
+    nbad++;
+  }
+
+  delete top;
+
+  if (nbad)
+  {
+    std::cout << "benchmarkNodeLookup: " << nbad << " failed checks" << std::endl;
+    return 1;
+  }
+  return 0;
+}
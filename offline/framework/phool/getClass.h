@@ -1,6 +1,7 @@
 #ifndef PHOOL_GETCLASS_H
 #define PHOOL_GETCLASS_H
 
+#include "PHCompositeNode.h"
 #include "PHDataNode.h"
 #include "PHIODataNode.h"
 #include "PHNode.h"
@@ -8,17 +9,16 @@
 
 #include <TObject.h>
 
+#include <cstdint>
+#include <limits>
 #include <string>
 
-class PHCompositeNode;
-
 namespace findNode
 {
+  // returns the object of type T held by a node, nullptr if there is none
   template <class T>
-  T *getClass(PHCompositeNode *top, const std::string &name)
+  T *getClass(PHNode *FoundNode)
   {
-    PHNodeIterator iter(top);
-    PHNode *FoundNode = iter.findFirst(name);  // returns pointer to PHNode
     if (!FoundNode)
     {
       return nullptr;
@@ -55,6 +55,83 @@ namespace findNode
 
     return nullptr;
   }
+
+  template <class T>
+  T *getClass(PHCompositeNode *top, const std::string &name)
+  {
+    PHNodeIterator iter(top);
+    return getClass<T>(iter.findFirst(name));  // returns pointer to PHNode
+  }
+
+  // Caches the result of getClass<T>(top, name). The node tree is only searched
+  // again after nodes were added to or removed from the tree below top, if the
+  // node keeps its object the cast is skipped as well. Resolve it once
+  // (e.g. in InitRun) and dereference it per event:
+  //   m_ClusterMap = findNode::NodeHandle<TrkrClusterContainer>(topNode, "TRKR_CLUSTER");
+  //   TrkrClusterContainer *clustermap = m_ClusterMap.get();
+  // The top node has to outlive the handle
+  template <class T>
+  class NodeHandle
+  {
+   public:
+    NodeHandle() = default;
+    NodeHandle(PHCompositeNode *top, const std::string &name)
+      : m_Top(top)
+      , m_Name(name)
+    {
+    }
+
+    T *get()
+    {
+      if (!m_Top)
+      {
+        return nullptr;
+      }
+      if (m_Top->generation() != m_Generation)
+      {
+        resolve();
+      }
+      if (m_DataNode)
+      {
+        m_Object = m_DataNode->getData();
+      }
+      else if (m_IONode && m_IONode->getData() != m_TObject)
+      {
+        m_TObject = m_IONode->getData();
+        m_Object = dynamic_cast<T *>(m_TObject);
+      }
+      return m_Object;
+    }
+
+    T *operator->() { return get(); }
+    explicit operator bool() { return get() != nullptr; }
+
+    // search the node tree again with the next get()
+    void invalidate() { m_Generation = std::numeric_limits<uint64_t>::max(); }
+
+    const std::string &name() const { return m_Name; }
+
+   private:
+    void resolve()
+    {
+      m_Generation = m_Top->generation();
+      PHNodeIterator iter(m_Top);
+      PHNode *node = iter.findFirst(m_Name);
+      m_DataNode = dynamic_cast<PHDataNode<T> *>(node);
+      // see getClass(), all other nodes with objects are PHIODataNodes
+      m_IONode = (node && !m_DataNode && node->getType() != "PHCompositeNode") ? static_cast<PHIODataNode<TObject> *>(node) : nullptr;
+      m_TObject = nullptr;
+      m_Object = nullptr;
+    }
+
+    PHCompositeNode *m_Top{nullptr};
+    std::string m_Name;
+    uint64_t m_Generation{std::numeric_limits<uint64_t>::max()};
+    PHDataNode<T> *m_DataNode{nullptr};
+    PHIODataNode<TObject> *m_IONode{nullptr};
+    TObject *m_TObject{nullptr};
+    T *m_Object{nullptr};
+  };
 }  // namespace findNode
 
 #endif
@@ -0,0 +1,352 @@
+#include "TowerInfoContainerv5.h"
+#include "TowerInfov5.h"
+
+#include <TBuffer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+  unsigned int detector_channels(TowerInfoContainer::DETECTOR detec)
+  {
+    switch (detec)
+    {
+    case TowerInfoContainer::DETECTOR::EMCAL:
+      return 24576;
+    case TowerInfoContainer::DETECTOR::HCAL:
+      return 1536;
+    case TowerInfoContainer::DETECTOR::MBD:
+      return 256;
+    case TowerInfoContainer::DETECTOR::ZDC:
+      return 52;
+    default:
+      break;
+    }
+    return 744;
+  }
+
+  // nan is stored as the lowest value of the integer type,
+  // values outside the range are clamped to the range. The clamp is done in
+  // double, float(INT32_MAX) rounds up to 2^31 which does not fit into int32_t
+  template <class T>
+  T quantize(float value, float lsb)
+  {
+    if (std::isnan(value))
+    {
+      return std::numeric_limits<T>::min();
+    }
+    double scaled = std::round(value / lsb);
+    scaled = std::max(scaled, static_cast<double>(std::numeric_limits<T>::min() + 1));
+    scaled = std::min(scaled, static_cast<double>(std::numeric_limits<T>::max()));
+    return static_cast<T>(scaled);
+  }
+
+  template <class T>
+  float dequantize(T value, float lsb)
+  {
+    if (value == std::numeric_limits<T>::min())
+    {
+      return std::numeric_limits<float>::quiet_NaN();
+    }
+    return value * lsb;
+  }
+}  // namespace
+
+TowerInfoContainerv5::TowerInfoContainerv5(DETECTOR detec)
+  : _detector(detec)
+{
+  unsigned int nchannels = detector_channels(_detector);
+  m_energy.resize(nchannels, 0);
+  m_time.resize(nchannels, 0);
+  m_pedestal.resize(nchannels, 0);
+  m_chi2.resize(nchannels, 0);
+  m_status.resize(nchannels, 0);
+  build_proxies();
+}
+
+TowerInfoContainerv5::TowerInfoContainerv5(const TowerInfoContainerv5& source)
+  : TowerInfoContainer(source)
+  , _detector(source._detector)
+  , m_EnergyLsb(source.m_EnergyLsb)
+  , m_TimeLsb(source.m_TimeLsb)
+  , m_PedestalLsb(source.m_PedestalLsb)
+  , m_Chi2Base(source.m_Chi2Base)
+  , m_ZeroSuppression(source.m_ZeroSuppression)
+  , m_energy(source.m_energy)
+  , m_time(source.m_time)
+  , m_pedestal(source.m_pedestal)
+  , m_chi2(source.m_chi2)
+  , m_status(source.m_status)
+{
+  // the proxies have to point to this container, not to the source
+  build_proxies();
+}
+
+void TowerInfoContainerv5::identify(std::ostream& os) const
+{
+  os << "TowerInfoContainerv5 of size " << size()
+     << ", energy precision " << m_EnergyLsb
+     << ", time precision " << m_TimeLsb
+     << ", pedestal precision " << m_PedestalLsb
+     << ", chi2 base " << m_Chi2Base;
+  if (m_ZeroSuppression >= 0)
+  {
+    os << ", zero suppression below " << m_ZeroSuppression;
+  }
+  os << std::endl;
+}
+
+void TowerInfoContainerv5::Reset()
+{
+  // clear content of towers in the container for the next event
+  std::fill(m_energy.begin(), m_energy.end(), 0);
+  std::fill(m_time.begin(), m_time.end(), 0);
+  std::fill(m_pedestal.begin(), m_pedestal.end(), 0);
+  std::fill(m_chi2.begin(), m_chi2.end(), 0);
+  std::fill(m_status.begin(), m_status.end(), 0);
+}
+
+TowerInfov5* TowerInfoContainerv5::get_tower_at_channel(int pos)
+{
+  if (pos < 0 || pos >= static_cast<int>(m_towers.size()))
+  {
+    return nullptr;
+  }
+  return &m_towers[pos];
+}
+
+TowerInfov5* TowerInfoContainerv5::get_tower_at_key(int pos)
+{
+  int index = decode_key(pos);
+  return get_tower_at_channel(index);
+}
+
+unsigned int TowerInfoContainerv5::encode_key(unsigned int towerIndex)
+{
+  int key = 0;
+  if (_detector == DETECTOR::EMCAL)
+  {
+    key = TowerInfoContainer::encode_emcal(towerIndex);
+  }
+  else if (_detector == DETECTOR::HCAL)
+  {
+    key = TowerInfoContainer::encode_hcal(towerIndex);
+  }
+  else if (_detector == DETECTOR::SEPD)
+  {
+    key = TowerInfoContainer::encode_epd(towerIndex);
+  }
+  else if (_detector == DETECTOR::MBD)
+  {
+    key = TowerInfoContainer::encode_mbd(towerIndex);
+  }
+  else if (_detector == DETECTOR::ZDC)
+  {
+    key = TowerInfoContainer::encode_zdc(towerIndex);
+  }
+  return key;
+}
+
+unsigned int TowerInfoContainerv5::decode_key(unsigned int tower_key)
+{
+  int index = 0;
+
+  if (_detector == DETECTOR::EMCAL)
+  {
+    index = TowerInfoContainer::decode_emcal(tower_key);
+  }
+  else if (_detector == DETECTOR::HCAL)
+  {
+    index = TowerInfoContainer::decode_hcal(tower_key);
+  }
+  else if (_detector == DETECTOR::SEPD)
+  {
+    index = TowerInfoContainer::decode_epd(tower_key);
+  }
+  else if (_detector == DETECTOR::MBD)
+  {
+    index = TowerInfoContainer::decode_mbd(tower_key);
+  }
+  else if (_detector == DETECTOR::ZDC)
+  {
+    index = TowerInfoContainer::decode_zdc(tower_key);
+  }
+  return index;
+}
+
+float TowerInfoContainerv5::get_energy(unsigned int channel) const
+{
+  return dequantize(m_energy[channel], m_EnergyLsb);
+}
+
+void TowerInfoContainerv5::set_energy(unsigned int channel, float energy)
+{
+  m_energy[channel] = quantize<int32_t>(energy, m_EnergyLsb);
+}
+
+float TowerInfoContainerv5::get_time(unsigned int channel) const
+{
+  return dequantize(m_time[channel], m_TimeLsb);
+}
+
+void TowerInfoContainerv5::set_time(unsigned int channel, float time)
+{
+  m_time[channel] = quantize<int16_t>(time, m_TimeLsb);
+}
+
+float TowerInfoContainerv5::get_pedestal(unsigned int channel) const
+{
+  return dequantize(m_pedestal[channel], m_PedestalLsb);
+}
+
+void TowerInfoContainerv5::set_pedestal(unsigned int channel, float pedestal)
+{
+  m_pedestal[channel] = quantize<int32_t>(pedestal, m_PedestalLsb);
+}
+
+// same log encoding as TowerInfov4 with a configurable base,
+// 0 is reserved for nan
+float TowerInfoContainerv5::get_chi2(unsigned int channel) const
+{
+  uint8_t chi2 = m_chi2[channel];
+  return (chi2 == 0)
+             ? std::numeric_limits<float>::quiet_NaN()
+             : (std::pow(m_Chi2Base, static_cast<float>(chi2)) - 1.0F);
+}
+
+void TowerInfoContainerv5::set_chi2(unsigned int channel, float chi2)
+{
+  float lnChi2;
+  if (std::isnan(chi2))
+  {
+    lnChi2 = 0;
+  }
+  else if (chi2 <= 0)
+  {
+    lnChi2 = 1;
+  }
+  else
+  {
+    lnChi2 = std::max(std::log(chi2 + 1) / std::log(m_Chi2Base), 1.F);
+  }
+  lnChi2 = std::min(lnChi2, 255.F);
+  m_chi2[channel] = static_cast<uint8_t>(std::round(lnChi2));
+}
+
+void TowerInfoContainerv5::clear_channel(unsigned int channel)
+{
+  m_energy[channel] = 0;
+  m_time[channel] = 0;
+  m_pedestal[channel] = 0;
+  m_chi2[channel] = 0;
+  m_status[channel] = 0;
+}
+
+void TowerInfoContainerv5::build_proxies()
+{
+  m_towers.clear();
+  m_towers.reserve(size());
+  for (unsigned int i = 0; i < size(); ++i)
+  {
+    m_towers.emplace_back(this, i);
+  }
+}
+
+void TowerInfoContainerv5::pack()
+{
+  // the status is always written for all towers
+  m_StoredStatus = m_status;
+  m_StoredChannel.clear();
+  if (m_ZeroSuppression < 0)
+  {
+    m_StoredEnergy = m_energy;
+    m_StoredTime = m_time;
+    m_StoredPedestal = m_pedestal;
+    m_StoredChi2 = m_chi2;
+    return;
+  }
+  m_StoredEnergy.clear();
+  m_StoredTime.clear();
+  m_StoredPedestal.clear();
+  m_StoredChi2.clear();
+  // compare in quantized units, nan energies are kept
+  int32_t threshold = quantize<int32_t>(m_ZeroSuppression, m_EnergyLsb);
+  for (unsigned int i = 0; i < size(); ++i)
+  {
+    if (m_energy[i] != std::numeric_limits<int32_t>::min() &&
+        std::abs(m_energy[i]) <= threshold)
+    {
+      continue;
+    }
+    m_StoredChannel.push_back(i);
+    m_StoredEnergy.push_back(m_energy[i]);
+    m_StoredTime.push_back(m_time[i]);
+    m_StoredPedestal.push_back(m_pedestal[i]);
+    m_StoredChi2.push_back(m_chi2[i]);
+  }
+}
+
+void TowerInfoContainerv5::unpack()
+{
+  unsigned int nchannels = detector_channels(_detector);
+  if (size() != nchannels)
+  {
+    m_energy.resize(nchannels);
+    m_time.resize(nchannels);
+    m_pedestal.resize(nchannels);
+    m_chi2.resize(nchannels);
+    m_status.resize(nchannels);
+  }
+  if (m_towers.size() != nchannels)
+  {
+    build_proxies();
+  }
+  if (m_StoredStatus.size() == nchannels)
+  {
+    std::copy(m_StoredStatus.begin(), m_StoredStatus.end(), m_status.begin());
+  }
+  else
+  {
+    std::fill(m_status.begin(), m_status.end(), 0);
+  }
+  if (m_StoredChannel.empty() && m_StoredEnergy.size() == nchannels)
+  {
+    std::copy(m_StoredEnergy.begin(), m_StoredEnergy.end(), m_energy.begin());
+    std::copy(m_StoredTime.begin(), m_StoredTime.end(), m_time.begin());
+    std::copy(m_StoredPedestal.begin(), m_StoredPedestal.end(), m_pedestal.begin());
+    std::copy(m_StoredChi2.begin(), m_StoredChi2.end(), m_chi2.begin());
+    return;
+  }
+  std::fill(m_energy.begin(), m_energy.end(), 0);
+  std::fill(m_time.begin(), m_time.end(), 0);
+  std::fill(m_pedestal.begin(), m_pedestal.end(), 0);
+  std::fill(m_chi2.begin(), m_chi2.end(), 0);
+  for (size_t i = 0; i < m_StoredChannel.size(); ++i)
+  {
+    unsigned int channel = m_StoredChannel[i];
+    m_energy[channel] = m_StoredEnergy[i];
+    m_time[channel] = m_StoredTime[i];
+    m_pedestal[channel] = m_StoredPedestal[i];
+    m_chi2[channel] = m_StoredChi2[i];
+  }
+}
+
+// the persistent columns are filled from the working columns right before
+// writing and unpacked right after reading, otherwise the standard streamer
+// is used (which keeps schema evolution working)
+void TowerInfoContainerv5::Streamer(TBuffer& R__b)
+{
+  if (R__b.IsReading())
+  {
+    R__b.ReadClassBuffer(TowerInfoContainerv5::Class(), this);
+    unpack();
+  }
+  else
+  {
+    pack();
+    R__b.WriteClassBuffer(TowerInfoContainerv5::Class(), this);
+  }
+}
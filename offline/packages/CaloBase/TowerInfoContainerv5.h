@@ -0,0 +1,109 @@
+#ifndef TOWERINFOCONTAINERV5_H
+#define TOWERINFOCONTAINERV5_H
+
+#include "TowerInfoContainer.h"
+#include "TowerInfov5.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+class PHObject;
+
+// column (SoA) storage of the towers of one detector. Energy, time, pedestal
+// and chi2 are kept quantized with a configurable precision, the status bits
+// in one byte per tower. On output energy, time, pedestal and chi2 of empty
+// towers (|energy| below the zero suppression threshold) can be dropped, the
+// channel numbers of the towers which are kept are written in this case.
+// get_tower_at_channel() returns a TowerInfov5 proxy into the columns
+class TowerInfoContainerv5 : public TowerInfoContainer
+{
+ public:
+  TowerInfoContainerv5(DETECTOR detec);
+
+  // default constructor for ROOT IO
+  TowerInfoContainerv5() = default;
+  PHObject *CloneMe() const override { return new TowerInfoContainerv5(*this); }
+  TowerInfoContainerv5(const TowerInfoContainerv5 &);
+  TowerInfoContainerv5 &operator=(const TowerInfoContainerv5 &) = delete;
+
+  ~TowerInfoContainerv5() override = default;
+
+  void identify(std::ostream &os = std::cout) const override;
+
+  void Reset() override;
+  TowerInfov5 *get_tower_at_channel(int pos) override;
+  TowerInfov5 *get_tower_at_key(int pos) override;
+
+  unsigned int encode_key(unsigned int towerIndex) override;
+  unsigned int decode_key(unsigned int tower_key) override;
+
+  size_t size() const override { return m_energy.size(); }
+  DETECTOR get_detectorid() const override { return _detector; }
+
+  // precision of the stored values, has to be set before the towers are filled
+  void set_energy_precision(float lsb) { m_EnergyLsb = lsb; }
+  float get_energy_precision() const { return m_EnergyLsb; }
+  void set_time_precision(float lsb) { m_TimeLsb = lsb; }
+  float get_time_precision() const { return m_TimeLsb; }
+  void set_pedestal_precision(float lsb) { m_PedestalLsb = lsb; }
+  float get_pedestal_precision() const { return m_PedestalLsb; }
+  // chi2 is stored as round(log_base(chi2+1)) in 8 bits
+  void set_chi2_base(float base) { m_Chi2Base = base; }
+  float get_chi2_base() const { return m_Chi2Base; }
+
+  // towers with |energy| <= threshold are written with their status only
+  // (and read back with zero energy, time, pedestal and nan chi2),
+  // a negative threshold writes all towers
+  void set_zero_suppression(float threshold) { m_ZeroSuppression = threshold; }
+  float get_zero_suppression() const { return m_ZeroSuppression; }
+
+  // direct access to the columns by channel, the proxies use these
+  float get_energy(unsigned int channel) const;
+  void set_energy(unsigned int channel, float energy);
+  float get_time(unsigned int channel) const;
+  void set_time(unsigned int channel, float time);
+  float get_pedestal(unsigned int channel) const;
+  void set_pedestal(unsigned int channel, float pedestal);
+  float get_chi2(unsigned int channel) const;
+  void set_chi2(unsigned int channel, float chi2);
+  uint8_t get_status(unsigned int channel) const { return m_status[channel]; }
+  void set_status(unsigned int channel, uint8_t status) { m_status[channel] = status; }
+  void clear_channel(unsigned int channel);
+
+ private:
+  void build_proxies();
+  // copy the non empty towers into the persistent columns
+  void pack();
+  // fill the working columns from the persistent ones
+  void unpack();
+
+  DETECTOR _detector{DETECTOR_INVALID};
+  float m_EnergyLsb{1e-4};
+  float m_TimeLsb{1e-3};
+  float m_PedestalLsb{1e-2};
+  float m_Chi2Base{1.08};
+  float m_ZeroSuppression{-1};
+
+  // persistent columns, m_StoredChannel is empty if all towers are written,
+  // m_StoredStatus always holds all towers
+  std::vector<uint16_t> m_StoredChannel;
+  std::vector<int32_t> m_StoredEnergy;
+  std::vector<int16_t> m_StoredTime;
+  std::vector<int32_t> m_StoredPedestal;
+  std::vector<uint8_t> m_StoredChi2;
+  std::vector<uint8_t> m_StoredStatus;
+
+  // working columns, one entry per channel
+  std::vector<int32_t> m_energy;    //!
+  std::vector<int16_t> m_time;      //!
+  std::vector<int32_t> m_pedestal;  //!
+  std::vector<uint8_t> m_chi2;      //!
+  std::vector<uint8_t> m_status;    //!
+  std::vector<TowerInfov5> m_towers;  //!
+
+  ClassDefOverride(TowerInfoContainerv5, 1);
+};
+
+#endif
@@ -0,0 +1,6 @@
+#ifdef __CINT__
+
+// custom streamer, packs the towers into the persistent columns
+#pragma link C++ class TowerInfoContainerv5 - ;
+
+#endif /* __CINT__ */
@@ -0,0 +1,97 @@
+#include "TowerInfov5.h"
+
+#include "TowerInfoContainerv5.h"
+
+#include <limits>
+
+void TowerInfov5::Reset()
+{
+  m_container->clear_channel(m_channel);
+  m_container->set_energy(m_channel, std::numeric_limits<float>::signaling_NaN());
+}
+
+void TowerInfov5::Clear(Option_t* /*unused*/)
+{
+  m_container->clear_channel(m_channel);
+}
+
+void TowerInfov5::set_energy(float energy)
+{
+  m_container->set_energy(m_channel, energy);
+}
+
+float TowerInfov5::get_energy()
+{
+  return m_container->get_energy(m_channel);
+}
+
+void TowerInfov5::set_time_float(float t)
+{
+  m_container->set_time(m_channel, t);
+}
+
+float TowerInfov5::get_time_float()
+{
+  return m_container->get_time(m_channel);
+}
+
+void TowerInfov5::set_chi2(float chi2)
+{
+  m_container->set_chi2(m_channel, chi2);
+}
+
+float TowerInfov5::get_chi2()
+{
+  return m_container->get_chi2(m_channel);
+}
+
+void TowerInfov5::set_pedestal(float pedestal)
+{
+  m_container->set_pedestal(m_channel, pedestal);
+}
+
+float TowerInfov5::get_pedestal()
+{
+  return m_container->get_pedestal(m_channel);
+}
+
+uint8_t TowerInfov5::get_status() const
+{
+  return m_container->get_status(m_channel);
+}
+
+void TowerInfov5::set_status(uint8_t status)
+{
+  m_container->set_status(m_channel, status);
+}
+
+void TowerInfov5::copy_tower(TowerInfo* tower)
+{
+  set_time_float(tower->get_time_float());
+  set_energy(tower->get_energy());
+  set_pedestal(tower->get_pedestal());
+  set_chi2(tower->get_chi2());
+  set_status(tower->get_status());
+  return;
+}
+
+void TowerInfov5::set_status_bit(int bit, bool value)
+{
+  if (bit < 0 || bit > 7)
+  {
+    return;
+  }
+  uint8_t status = get_status();
+  status &= ~((uint8_t) 1 << bit);
+  status |= (uint8_t) value << bit;
+  set_status(status);
+}
+
+bool TowerInfov5::get_status_bit(int bit) const
+{
+  if (bit < 0 || bit > 7)
+  {
+    return false;  // default behavior
+  }
+  return (get_status() & ((uint8_t) 1 << bit)) != 0;
+}
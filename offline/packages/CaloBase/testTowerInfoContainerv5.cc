@@ -0,0 +1,212 @@
+// Round trip test of TowerInfoContainerv5 through its streamer.
+// In range, over range, under range and nan energies, times and pedestals are
+// written into a TBufferFile and read back, with and without zero
+// suppression. Over and under range values have to come back clamped to the
+// largest and smallest stored value, only nan reads back as nan.
+// It also prints the uncompressed streamer size per tower of
+// TowerInfoContainerv2, v4 and v5 for an EMCal event with a given fraction
+// of non empty towers (ROOT compression of the DST comes on top of this).
+// Returns 0 if all values read back as expected, 1 otherwise.
+#include "TowerInfoContainerv2.h"
+#include "TowerInfoContainerv4.h"
+#include "TowerInfoContainerv5.h"
+#include "TowerInfo.h"
+
+#include <TBufferFile.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  struct Value
+  {
+    float set;
+    float expected;
+  };
+
+  bool same(float a, float b)
+  {
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+  }
+
+  // stream the container out and back in, the content of the copy is returned
+  TowerInfoContainerv5 *roundtrip(TowerInfoContainerv5 &container)
+  {
+    TBufferFile outbuf(TBuffer::kWrite);
+    container.Streamer(outbuf);
+    TBufferFile inbuf(TBuffer::kRead, outbuf.Length(), outbuf.Buffer(), false);
+    TowerInfoContainerv5 *copy = new TowerInfoContainerv5();
+    copy->Streamer(inbuf);
+    return copy;
+  }
+
+  int check(const std::string &what, float got, float expected, unsigned int channel)
+  {
+    if (same(got, expected))
+    {
+      return 0;
+    }
+    std::cout << what << " mismatch in channel " << channel << ": read back " << got
+              << ", expected " << expected << std::endl;
+    return 1;
+  }
+
+  // in range values read back as a multiple of the precision
+  float stored(float value, float lsb)
+  {
+    return static_cast<float>(std::lround(value / lsb)) * lsb;
+  }
+
+  template <class T>
+  float largest(float lsb)
+  {
+    return static_cast<T>(std::numeric_limits<T>::max()) * lsb;
+  }
+
+  template <class T>
+  float smallest(float lsb)
+  {
+    return static_cast<T>(std::numeric_limits<T>::min() + 1) * lsb;
+  }
+
+  size_t streamed_size(TowerInfoContainer &container)
+  {
+    TBufferFile outbuf(TBuffer::kWrite);
+    container.Streamer(outbuf);
+    return outbuf.Length();
+  }
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+  const double occupancy = (argc > 1) ? std::atof(argv[1]) : 0.1;
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  int nbad = 0;
+
+  // default precision, and precision 1 where 2^31 (2147483648.F) is the first
+  // float above the int32 range
+  for (const float lsb : {0.F, 1.F})
+  {
+    TowerInfoContainerv5 container(TowerInfoContainer::DETECTOR::EMCAL);
+    if (lsb > 0)
+    {
+      container.set_energy_precision(lsb);
+      container.set_pedestal_precision(lsb);
+    }
+    const float elsb = container.get_energy_precision();
+    const float tlsb = container.get_time_precision();
+    const float plsb = container.get_pedestal_precision();
+    // first value above the int32 range, at the default precision the product
+    // is not exact and a value clearly above it is used
+    const float edge = (lsb > 0) ? 2147483648.F : 3e9F;
+
+    const std::vector<Value> energies = {
+        {1.5, stored(1.5, elsb)},
+        {-0.25, stored(-0.25, elsb)},
+        {edge * elsb, largest<int32_t>(elsb)},
+        {4294967296.F * elsb, largest<int32_t>(elsb)},
+        {std::numeric_limits<float>::max(), largest<int32_t>(elsb)},
+        {std::numeric_limits<float>::infinity(), largest<int32_t>(elsb)},
+        {-edge * elsb, smallest<int32_t>(elsb)},
+        {-4294967296.F * elsb, smallest<int32_t>(elsb)},
+        {-std::numeric_limits<float>::infinity(), smallest<int32_t>(elsb)},
+        {nan, nan}};
+    const std::vector<Value> times = {
+        {2.5, stored(2.5, tlsb)},
+        {1e3, largest<int16_t>(tlsb)},
+        {-1e3, smallest<int16_t>(tlsb)},
+        {nan, nan}};
+    const std::vector<Value> pedestals = {
+        {1500, stored(1500, plsb)},
+        {edge * plsb, largest<int32_t>(plsb)},
+        {-edge * plsb, smallest<int32_t>(plsb)},
+        {nan, nan}};
+
+    for (const float zs : {-1.F, 0.5F})
+    {
+      container.Reset();
+      container.set_zero_suppression(zs);
+      unsigned int channel = 0;
+      for (const auto &energy : energies)
+      {
+        for (const auto &time : times)
+        {
+          for (const auto &pedestal : pedestals)
+          {
+            TowerInfo *tower = container.get_tower_at_channel(channel++);
+            tower->set_energy(energy.set);
+            tower->set_time_float(time.set);
+            tower->set_pedestal(pedestal.set);
+          }
+        }
+      }
+      TowerInfoContainerv5 *copy = roundtrip(container);
+      channel = 0;
+      for (const auto &energy : energies)
+      {
+        // towers below the zero suppression threshold come back empty
+        const bool suppressed = (zs >= 0 && !std::isnan(energy.expected) && std::fabs(energy.expected) <= zs);
+        for (const auto &time : times)
+        {
+          for (const auto &pedestal : pedestals)
+          {
+            TowerInfo *tower = copy->get_tower_at_channel(channel);
+            nbad += check("energy", tower->get_energy(), suppressed ? 0 : energy.expected, channel);
+            nbad += check("time", tower->get_time_float(), suppressed ? 0 : time.expected, channel);
+            nbad += check("pedestal", tower->get_pedestal(), suppressed ? 0 : pedestal.expected, channel);
+            channel++;
+          }
+        }
+      }
+      delete copy;
+    }
+  }
+
+  // uncompressed streamer size per tower for a random EMCal event
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> uniform(0, 1);
+  std::exponential_distribution<float> spectrum(2.);
+  TowerInfoContainerv2 v2(TowerInfoContainer::DETECTOR::EMCAL);
+  TowerInfoContainerv4 v4(TowerInfoContainer::DETECTOR::EMCAL);
+  TowerInfoContainerv5 v5(TowerInfoContainer::DETECTOR::EMCAL);
+  TowerInfoContainerv5 v5zs(TowerInfoContainer::DETECTOR::EMCAL);
+  v5zs.set_zero_suppression(0);
+  for (unsigned int channel = 0; channel < v5.size(); channel++)
+  {
+    const bool hit = uniform(rng) < occupancy;
+    const float energy = hit ? spectrum(rng) : 0;
+    const float time = hit ? 6 * uniform(rng) : 0;
+    const float pedestal = 1500 + 100 * uniform(rng);
+    const float chi2 = hit ? 100 * uniform(rng) : 0;
+    for (TowerInfoContainer *tc : std::vector<TowerInfoContainer *>{&v2, &v4, &v5, &v5zs})
+    {
+      TowerInfo *tower = tc->get_tower_at_channel(channel);
+      tower->set_energy(energy);
+      tower->set_time_float(time);
+      tower->set_pedestal(pedestal);
+      tower->set_chi2(chi2);
+      tower->set_isZS(!hit);
+    }
+  }
+  const double ntowers = v5.size();
+  std::cout << "uncompressed bytes per EMCal tower at occupancy " << occupancy
+            << ": v2 " << streamed_size(v2) / ntowers
+            << ", v4 " << streamed_size(v4) / ntowers << " (no pedestal)"
+            << ", v5 " << streamed_size(v5) / ntowers
+            << ", v5 zero suppressed " << streamed_size(v5zs) / ntowers << std::endl;
+
+  if (nbad)
+  {
+    std::cout << "testTowerInfoContainerv5: " << nbad << " values did not read back as expected" << std::endl;
+    return 1;
+  }
+  std::cout << "testTowerInfoContainerv5: all values read back as expected" << std::endl;
+  return 0;
+}
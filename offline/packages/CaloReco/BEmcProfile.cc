@@ -143,6 +143,30 @@ BEmcProfile::BEmcProfile(const std::string& fname)
   }
 
   f->Close();
+
+  // profile tables, the same binning is used for the mean and sigma of a profile
+  mean_offset.push_back(0);
+  for (int i = 0; i < nth * nen * NP; i++)
+  {
+    int nbins = hmean[i]->GetNbinsX();
+    for (int ibin = 0; ibin <= nbins + 1; ibin++)
+    {
+      mean_table.push_back(hmean[i]->GetBinContent(ibin));
+      sigma_table.push_back(hsigma[i]->GetBinContent(ibin));
+    }
+    mean_offset.push_back(mean_table.size());
+  }
+  r4_offset.push_back(0);
+  for (int i = 0; i < nth * nen; i++)
+  {
+    int nbins = hr4[i]->GetNbinsX();
+    for (int ibin = 0; ibin <= nbins + 1; ibin++)
+    {
+      r4_table.push_back(hr4[i]->GetBinContent(ibin));
+    }
+    r4_offset.push_back(r4_table.size());
+  }
+
   bloaded = true;
 }
 
@@ -515,32 +539,32 @@ void BEmcProfile::PredictEnergy(int ip, float energy, float theta, float /*phi*/
 
   // Log (1/sqrt) energy dependence of mean (sigma)
   //
-  float pr11 = hmean[ii11]->GetBinContent(ibin);
-  float pr21 = hmean[ii21]->GetBinContent(ibin);
+  float pr11 = mean_table[mean_offset[ii11] + ibin];
+  float pr21 = mean_table[mean_offset[ii21] + ibin];
   float prt1 = pr11 + (pr21 - pr11) / (log(en2) - log(en1)) * (log(energy) - log(en1));
   if (prt1 < 0)
   {
     prt1 = 0;
   }
 
-  float er11 = hsigma[ii11]->GetBinContent(ibin);
-  float er21 = hsigma[ii21]->GetBinContent(ibin);
+  float er11 = sigma_table[mean_offset[ii11] + ibin];
+  float er21 = sigma_table[mean_offset[ii21] + ibin];
   float ert1 = er11 + (er21 - er11) / (1. / sqrt(en2) - 1. / sqrt(en1)) * (1. / sqrt(energy) - 1. / sqrt(en1));
   if (ert1 < 0)
   {
     ert1 = 0;
   }
 
-  float pr12 = hmean[ii12]->GetBinContent(ibin);
-  float pr22 = hmean[ii22]->GetBinContent(ibin);
+  float pr12 = mean_table[mean_offset[ii12] + ibin];
+  float pr22 = mean_table[mean_offset[ii22] + ibin];
   float prt2 = pr12 + (pr22 - pr12) / (log(en2) - log(en1)) * (log(energy) - log(en1));
   if (prt2 < 0)
   {
     prt2 = 0;
   }
 
-  float er12 = hsigma[ii12]->GetBinContent(ibin);
-  float er22 = hsigma[ii22]->GetBinContent(ibin);
+  float er12 = sigma_table[mean_offset[ii12] + ibin];
+  float er22 = sigma_table[mean_offset[ii22] + ibin];
   float ert2 = er12 + (er22 - er12) / (1. / sqrt(en2) - 1. / sqrt(en1)) * (1. / sqrt(energy) - 1. / sqrt(en1));
   if (ert2 < 0)
   {
@@ -568,15 +592,16 @@ void BEmcProfile::PredictEnergy(int ip, float energy, float theta, float /*phi*/
     ibin1 = ibin - 1;
   }
   int ibin2 = ibin;
-  if (ibin < hmean[ii11]->GetNbinsX())
+  const float* mean11 = &mean_table[mean_offset[ii11]];
+  if (ibin < mean_offset[ii11 + 1] - mean_offset[ii11] - 2)
   {
-    if (hmean[ii11]->GetBinContent(ibin + 1) > 0)
+    if (mean11[ibin + 1] > 0)
     {
       ibin2 = ibin + 1;
     }
   }
-  float dd = (hmean[ii11]->GetBinContent(ibin2) -
-              hmean[ii11]->GetBinContent(ibin1)) /
+  float dd = (mean11[ibin2] -
+              mean11[ibin1]) /
              2.;
   //  if( fabs(dd)>er )
   // {
@@ -667,16 +692,16 @@ float BEmcProfile::PredictEnergyR(float energy, float theta, float /*phi*/, floa
 
   // Log (1/sqrt) energy dependence of mean (sigma)
   //
-  float pr11 = hr4[ii11]->GetBinContent(ibin);
-  float pr21 = hr4[ii21]->GetBinContent(ibin);
+  float pr11 = r4_table[r4_offset[ii11] + ibin];
+  float pr21 = r4_table[r4_offset[ii21] + ibin];
   float prt1 = pr11 + (pr21 - pr11) / (log(en2) - log(en1)) * (log(energy) - log(en1));
   if (prt1 < 0)
   {
     prt1 = 0;
   }
 
-  float pr12 = hr4[ii12]->GetBinContent(ibin);
-  float pr22 = hr4[ii22]->GetBinContent(ibin);
+  float pr12 = r4_table[r4_offset[ii12] + ibin];
+  float pr22 = r4_table[r4_offset[ii22] + ibin];
   float prt2 = pr12 + (pr22 - pr12) / (log(en2) - log(en1)) * (log(energy) - log(en1));
   if (prt2 < 0)
   {
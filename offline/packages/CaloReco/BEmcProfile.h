@@ -38,6 +38,14 @@ class BEmcProfile
   TH1F** hsigma;
   TH1F** hr4;
 
+  // bin contents (including under/overflow) of hmean/hsigma and hr4, the bins of histogram i
+  // start at mean_offset[i] (r4_offset[i]); PredictEnergy() reads these instead of the histograms
+  std::vector<float> mean_table;
+  std::vector<float> sigma_table;
+  std::vector<int> mean_offset;
+  std::vector<float> r4_table;
+  std::vector<int> r4_offset;
+
  private:
   int m_Verbosity;
 };
@@ -12,6 +12,7 @@
 
 #include <TMath.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
@@ -122,6 +123,7 @@ bool BEmcRec::SetTowerGeometry(int ix, int iy, float xx, float yy, float zz)
 
   int ich = iy * fNx + ix;
   fTowerGeom[ich] = geom;
+  fProfCache.valid = false;
   return true;
 }
 
@@ -187,6 +189,7 @@ bool BEmcRec::CompleteTowerGeometry()
 
   }  // it = fTowerGeom.begin()
 
+  fProfCache.valid = false;
   return true;
 }
 
@@ -317,6 +320,17 @@ float BEmcRec::fTowerDist(float x1, float x2)
 // ///////////////////////////////////
 
 int BEmcRec::FindClusters()
+{
+  if (bFastClustering)
+  {
+    return FindClustersGrid();
+  }
+  return FindClustersLednev();
+}
+
+// ///////////////////////////////////////////////////////////////////////////
+
+int BEmcRec::FindClustersLednev()
 // Cluster search algorithm based on Lednev's one developed for GAMS.
 // Returns number of clusters found
 {
@@ -477,6 +491,159 @@ int BEmcRec::FindClusters()
 
 // ///////////////////////////////////////////////////////////////////////////
 
+void BEmcRec::BuildNeighborGrid()
+// Neighbours with a common edge for each tower of the (ix,iy) grid,
+// in cylindrical geometry x wraps around
+{
+  int ngrid = fNx * fNy;
+  fGridLabel.assign(ngrid, -1);
+  fGridNeighbors.assign(4 * ngrid, -1);
+  fGridCYL = bCYL;
+
+  for (int iy = 0; iy < fNy; iy++)
+  {
+    for (int ix = 0; ix < fNx; ix++)
+    {
+      int ich = iy * fNx + ix;
+      int* nb = &fGridNeighbors[4 * ich];
+      if (ix > 0)
+      {
+        nb[0] = ich - 1;
+      }
+      else if (bCYL && fNx > 1)
+      {
+        nb[0] = ich + fNx - 1;
+      }
+      if (ix < fNx - 1)
+      {
+        nb[1] = ich + 1;
+      }
+      else if (bCYL && fNx > 1)
+      {
+        nb[1] = ich - fNx + 1;
+      }
+      if (iy > 0)
+      {
+        nb[2] = ich - fNx;
+      }
+      if (iy < fNy - 1)
+      {
+        nb[3] = ich + fNx;
+      }
+    }
+  }
+}
+
+// ///////////////////////////////////////////////////////////////////////////
+
+int BEmcRec::FindClustersGrid()
+// Cluster search as connected component labeling on the (ix,iy) grid:
+// towers with a common edge belong to the same cluster.
+// Clusters are ordered by their lowest channel number, towers in a cluster by channel number.
+// Returns number of clusters found
+{
+  (*fClusters).clear();
+  int nhit = (*fModules).size();
+
+  if (nhit <= 0)
+  {
+    return 0;
+  }
+
+  EmcCluster Clt(this);
+  if (nhit == 1)
+  {
+    Clt.ReInitialize((*fModules));
+    fClusters->push_back(Clt);
+    return 1;
+  }
+
+  if (fNx <= 0 || fNy <= 0)
+  {
+    std::cout << "Error in BEmcRec::FindClustersGrid(): grid not defined (NX = "
+              << fNx << ", NY = " << fNy << ")" << std::endl;
+    return -1;
+  }
+
+  int ngrid = fNx * fNy;
+  if ((int) fGridLabel.size() != ngrid || fGridCYL != bCYL)
+  {
+    BuildNeighborGrid();
+  }
+
+  std::vector<EmcModule> hits(*fModules);
+  std::sort(hits.begin(), hits.end(), [](const EmcModule& a, const EmcModule& b)
+            { return a.ich < b.ich; });
+
+  for (const auto& hit : hits)
+  {
+    if (hit.ich >= 0 && hit.ich < ngrid)
+    {
+      fGridLabel[hit.ich] = -2;
+    }
+  }
+
+  int nCl = 0;
+  std::vector<int> hitlabel(nhit);
+  std::vector<int> stack;
+  for (int i = 0; i < nhit; i++)
+  {
+    int ich = hits[i].ich;
+    if (ich < 0 || ich >= ngrid)
+    {
+      // should not happen, such a tower is a cluster on its own
+      hitlabel[i] = nCl++;
+      continue;
+    }
+    if (fGridLabel[ich] == -2)
+    {
+      // new cluster, flood fill it from here
+      fGridLabel[ich] = nCl;
+      stack.push_back(ich);
+      while (!stack.empty())
+      {
+        int jch = stack.back();
+        stack.pop_back();
+        for (int k = 0; k < 4; k++)
+        {
+          int nb = fGridNeighbors[4 * jch + k];
+          if (nb >= 0 && fGridLabel[nb] == -2)
+          {
+            fGridLabel[nb] = nCl;
+            stack.push_back(nb);
+          }
+        }
+      }
+      nCl++;
+    }
+    hitlabel[i] = fGridLabel[ich];
+  }
+
+  std::vector<std::vector<EmcModule> > hl(nCl);
+  for (int i = 0; i < nhit; i++)
+  {
+    hl[hitlabel[i]].push_back(hits[i]);
+  }
+  for (int iCl = 0; iCl < nCl; iCl++)
+  {
+    Clt.ReInitialize(hl[iCl]);
+    fClusters->push_back(Clt);
+  }
+
+  // reset the grid for the next event
+  for (const auto& hit : hits)
+  {
+    if (hit.ich >= 0 && hit.ich < ngrid)
+    {
+      fGridLabel[hit.ich] = -1;
+    }
+  }
+
+  return nCl;
+}
+
+// ///////////////////////////////////////////////////////////////////////////
+
 void BEmcRec::Momenta(std::vector<EmcModule>* phit, float& pe, float& px,
                       float& py, float& pxx, float& pyy, float& pyx,
                       float thresh)
@@ -672,11 +839,21 @@ float BEmcRec::PredictEnergyProb(float en, float xcg, float ycg, int ix, int iy)
   float ddx = fabs(xcg - ixcg);
   float ddy = fabs(ycg - iycg);
 
-  float xg=0, yg=0, zg=0;
-  Tower2Global(en, xcg, ycg, xg, yg, zg);
-
-  float theta, phi;
-  GetImpactThetaPhi(xg, yg, zg, theta, phi);
+  // impact angles (and profile predictions below) depend only on the shower, not on the tower
+  if (!fProfCache.valid || fProfCache.prof != _emcprof || fProfCache.en != en || fProfCache.xcg != xcg || fProfCache.ycg != ycg)
+  {
+    float xg = 0, yg = 0, zg = 0;
+    Tower2Global(en, xcg, ycg, xg, yg, zg);
+    GetImpactThetaPhi(xg, yg, zg, fProfCache.theta, fProfCache.phi);
+    fProfCache.valid = true;
+    fProfCache.prof = _emcprof;
+    fProfCache.en = en;
+    fProfCache.xcg = xcg;
+    fProfCache.ycg = ycg;
+    fProfCache.has_ep = false;
+  }
+  float theta = fProfCache.theta;
+  float phi = fProfCache.phi;
 
   int isx = 1;
   if (xcg - ixcg < 0)
@@ -719,10 +896,15 @@ float BEmcRec::PredictEnergyProb(float en, float xcg, float ycg, int ix, int iy)
     return _emcprof->PredictEnergyR(en, theta, phi, rr);
   }
 
-  float ep[4], err[4];
-  for (int ip = 0; ip < 4; ip++)
+  float* ep = fProfCache.ep;
+  if (!fProfCache.has_ep)
   {
-    _emcprof->PredictEnergy(ip, en, theta, phi, ddx, ddy, ep[ip], err[ip]);
+    float err[4];
+    for (int ip = 0; ip < 4; ip++)
+    {
+      _emcprof->PredictEnergy(ip, en, theta, phi, ddx, ddy, ep[ip], err[ip]);
+    }
+    fProfCache.has_ep = true;
   }
 
   float eout;
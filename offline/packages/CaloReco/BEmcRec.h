@@ -40,6 +40,7 @@ class BEmcRec
     fVx = vv[0];
     fVy = vv[1];
     fVz = vv[2];
+    fProfCache.valid = false;
   }
   void SetDim(int nx, int ny)
   {
@@ -79,7 +80,12 @@ class BEmcRec
   int iTowerDist(int ix1, int ix2);
   float fTowerDist(float x1, float x2);
 
+  // Cluster search, FindClustersGrid() if fast clustering is enabled, FindClustersLednev() otherwise
   int FindClusters();
+  int FindClustersLednev();
+  int FindClustersGrid();
+  void SetFastClustering(bool bfast) { bFastClustering = bfast; }
+  bool isFastClustering() const { return bFastClustering; }
 
   void Momenta(std::vector<EmcModule> *, float &, float &, float &, float &, float &,
                float &, float thresh = 0);
@@ -150,6 +156,32 @@ class BEmcRec
   BEmcProfile *_emcprof = nullptr;
 
  private:
+  void BuildNeighborGrid();
+
+  bool bFastClustering = false;
+
+  // Flat (ix,iy) grid for FindClustersGrid(): neighbour channels (4 per tower, -1 if none)
+  // and the cluster label of each channel (-1 no hit, -2 hit not yet labeled)
+  std::vector<int> fGridNeighbors;
+  std::vector<int> fGridLabel;
+  bool fGridCYL = true;
+
+  // PredictEnergyProb() is called for all towers around a peak with the same shower
+  // energy and position; the shower quantities of the last call are kept here
+  struct ProfileCache
+  {
+    bool valid = false;
+    const BEmcProfile *prof = nullptr;
+    float en = 0;
+    float xcg = 0;
+    float ycg = 0;
+    float theta = 0;
+    float phi = 0;
+    bool has_ep = false;
+    float ep[4] = {0, 0, 0, 0};
+  };
+  ProfileCache fProfCache;
+
   std::string m_ThisName = "NOTSET";
   int Calorimeter_ID = 0;
   float Scin_size = NAN;
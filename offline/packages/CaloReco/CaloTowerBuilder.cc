@@ -7,6 +7,7 @@
 #include <calobase/TowerInfoContainerv2.h>
 #include <calobase/TowerInfoContainerv3.h>
 #include <calobase/TowerInfoContainerv4.h>
+#include <calobase/TowerInfoContainerv5.h>
 #include <calobase/TowerInfoContainerSimv1.h>
 #include <calobase/TowerInfoContainerSimv2.h>
 
@@ -34,12 +35,26 @@
 
 #include <TSystem.h>
 
+#include <algorithm>
 #include <climits>
 #include <variant>
 #include <iostream>  // for operator<<, endl, basic...
 #include <memory>    // for allocator_traits<>::val...
 #include <vector>    // for vector
 
+namespace
+{
+  // the typed CaloPacket accessors avoid the string dispatch of iValue in the per channel loop
+  bool isSuppressed(CaloPacket *packet, int channel) { return packet->getSuppressed(channel); }
+  bool isSuppressed(Packet *packet, int channel) { return packet->iValue(channel, "SUPPRESSED"); }
+  float getPre(CaloPacket *packet, int channel) { return packet->getPre(channel); }
+  float getPre(Packet *packet, int channel) { return packet->iValue(channel, "PRE"); }
+  float getPost(CaloPacket *packet, int channel) { return packet->getPost(channel); }
+  float getPost(Packet *packet, int channel) { return packet->iValue(channel, "POST"); }
+  float getSample(CaloPacket *packet, int channel, int samp) { return packet->getSample(channel, samp); }
+  float getSample(Packet *packet, int channel, int samp) { return packet->iValue(samp, channel); }
+}  // namespace
+
 static const std::map<CaloTowerDefs::DetectorSystem, std::string> nodemap{
     {CaloTowerDefs::CEMC, "CEMCPackets"},
     {CaloTowerDefs::HCALIN, "HCALPackets"},
@@ -161,13 +176,11 @@ int CaloTowerBuilder::InitRun(PHCompositeNode *topNode)
 
 int CaloTowerBuilder::process_sim()
 {
-  std::vector<std::vector<float>> waveforms;
+  m_waveforms.reset(std::max(m_nsamples, m_nzerosuppsamples));
 
   for (int ich = 0; ich < (int) m_CalowaveformContainer->size(); ich++)
   {
     TowerInfo *towerinfo = m_CalowaveformContainer->get_tower_at_channel(ich);
-    std::vector<float> waveform;
-    waveform.reserve(m_nsamples);
     bool fillwaveform = true;
     //get key
     if(m_dotbtszs)
@@ -181,37 +194,39 @@ int CaloTowerBuilder::process_sim()
       {
         //zero suppressed
         fillwaveform = false;
-        waveform.push_back(pre);
-        waveform.push_back(post);
+        float *waveform = m_waveforms.add_channel(2);
+        waveform[0] = pre;
+        waveform[1] = post;
       }
       
     }
     if(fillwaveform)
     {
+      float *waveform = m_waveforms.add_channel(m_nsamples);
       for (int samp = 0; samp < m_nsamples; samp++)
       {
-        waveform.push_back(towerinfo->get_waveform_value(samp));
+        waveform[samp] = towerinfo->get_waveform_value(samp);
       }
     }
-    waveforms.push_back(waveform);
-    waveform.clear();
   }
 
-  std::vector<std::vector<float>> processed_waveforms = WaveformProcessing->process_waveform(waveforms);
-  int n_channels = processed_waveforms.size();
+  WaveformProcessing->process_waveform(m_waveforms);
+  int n_channels = m_waveforms.nchannels();
   for (int i = 0; i < n_channels; i++)
   {
+    const float *fitresult = m_waveforms.results(i);
+    const float *waveform = m_waveforms.samples(i);
     //this is for copying the truth info to the downstream object
     TowerInfo* towerwaveform = m_CalowaveformContainer->get_tower_at_channel(i);
     TowerInfo *towerinfo = m_CaloInfoContainer->get_tower_at_channel(i);
     towerinfo->copy_tower(towerwaveform);
-    towerinfo->set_time(processed_waveforms.at(i).at(1));
-    towerinfo->set_energy(processed_waveforms.at(i).at(0));
-    towerinfo->set_time_float(processed_waveforms.at(i).at(1));
-    towerinfo->set_pedestal(processed_waveforms.at(i).at(2));
-    towerinfo->set_chi2(processed_waveforms.at(i).at(3));
-    bool SZS = isSZS(processed_waveforms.at(i).at(1), processed_waveforms.at(i).at(3));
-    if (processed_waveforms.at(i).at(4) == 0) 
+    towerinfo->set_time(fitresult[CaloWaveformBlock::TIME]);
+    towerinfo->set_energy(fitresult[CaloWaveformBlock::AMPLITUDE]);
+    towerinfo->set_time_float(fitresult[CaloWaveformBlock::TIME]);
+    towerinfo->set_pedestal(fitresult[CaloWaveformBlock::PEDESTAL]);
+    towerinfo->set_chi2(fitresult[CaloWaveformBlock::CHI2]);
+    bool SZS = isSZS(fitresult[CaloWaveformBlock::TIME], fitresult[CaloWaveformBlock::CHI2]);
+    if (fitresult[CaloWaveformBlock::RECOVERED] == 0) 
     {
       towerinfo->set_isRecovered(false);
     }
@@ -219,29 +234,30 @@ int CaloTowerBuilder::process_sim()
     {
       towerinfo->set_isRecovered(true);
     }
-    int n_samples = waveforms.at(i).size();
+    int n_samples = m_waveforms.nsamples(i);
     if (n_samples == m_nzerosuppsamples || SZS)
     {
       towerinfo->set_isZS(true);
     }
     for (int j = 0; j < n_samples; j++)
     {
-      towerinfo->set_waveform_value(j, waveforms.at(i).at(j));
-      if(std::round(waveforms.at(i).at(j)) >= m_saturation)
+      towerinfo->set_waveform_value(j, waveform[j]);
+      if(std::round(waveform[j]) >= m_saturation)
       {
         towerinfo->set_isSaturated(true);
       }
     }
   }
-  waveforms.clear();
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
 
 
-int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::vector<float>> &waveforms)
+int CaloTowerBuilder::process_data(PHCompositeNode *topNode, CaloWaveformBlock &waveforms)
 {
+  waveforms.reset(std::max(m_nsamples, m_nzerosuppsamples));
+
   std::variant<CaloPacketContainer*, Event*> event;
   if (m_UseOfflinePacketFlag)
   {
@@ -302,36 +318,26 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
             {
               for (int iskip = 0; iskip < 64; iskip++)
               {
-                std::vector<float> waveform;
-                waveform.reserve(m_nsamples);
-
-                for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-                {
-                  waveform.push_back(0);
-                }
-                waveforms.push_back(waveform);
-                waveform.clear();
+                waveforms.add_channel(m_nzerosuppsamples, 0);
               }
             }
           }
         }
 
-        std::vector<float> waveform;
-        waveform.reserve(m_nsamples);
-        if (packet->iValue(channel, "SUPPRESSED"))
+        if (isSuppressed(packet, channel))
         {
-          waveform.push_back(packet->iValue(channel, "PRE"));
-          waveform.push_back(packet->iValue(channel, "POST"));
+          float *waveform = waveforms.add_channel(2);
+          waveform[0] = getPre(packet, channel);
+          waveform[1] = getPost(packet, channel);
         }
         else
         {
+          float *waveform = waveforms.add_channel(m_nsamples);
           for (int samp = 0; samp < m_nsamples; samp++)
           {
-            waveform.push_back(packet->iValue(samp, channel));
+            waveform[samp] = getSample(packet, channel, samp);
           }
         }
-        waveforms.push_back(waveform);
-        waveform.clear();
       }
 
       if (nchannels < m_nchannels && !(m_dettype == CaloTowerDefs::CEMC && adc_skip_mask < 4))
@@ -342,15 +348,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
           {
             continue;
           }
-          std::vector<float> waveform;
-          waveform.reserve(m_nsamples);
-
-          for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-          {
-            waveform.push_back(0);
-          }
-          waveforms.push_back(waveform);
-          waveform.clear();
+          waveforms.add_channel(m_nzerosuppsamples, 0);
         }
       }
     }
@@ -362,14 +360,7 @@ int CaloTowerBuilder::process_data(PHCompositeNode *topNode, std::vector<std::ve
         {
           continue;
         }
-        std::vector<float> waveform;
-        waveform.reserve(2);
-        for (int samp = 0; samp < m_nzerosuppsamples; samp++)
-        {
-          waveform.push_back(0);
-        }
-        waveforms.push_back(waveform);
-        waveform.clear();
+        waveforms.add_channel(m_nzerosuppsamples, 0);
       }
     }
     return Fun4AllReturnCodes::EVENT_OK;
@@ -412,25 +403,26 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
   {
     return process_sim();
   }
-  std::vector<std::vector<float>> waveforms;
-  if(process_data(topNode, waveforms) == Fun4AllReturnCodes::ABORTEVENT)
+  if(process_data(topNode, m_waveforms) == Fun4AllReturnCodes::ABORTEVENT)
   {
     return Fun4AllReturnCodes::ABORTEVENT;
   }
-  // waveform vector is filled here, now fill our output. methods from the base class make sure
+  // waveform block is filled here, now fill our output. methods from the base class make sure
   // we only fill what the chosen container version supports
-  std::vector<std::vector<float>> processed_waveforms = WaveformProcessing->process_waveform(waveforms);
-  int n_channels = processed_waveforms.size();
+  WaveformProcessing->process_waveform(m_waveforms);
+  int n_channels = m_waveforms.nchannels();
   for (int i = 0; i < n_channels; i++)
   {
+    const float *fitresult = m_waveforms.results(i);
+    const float *waveform = m_waveforms.samples(i);
     TowerInfo *towerinfo = m_CaloInfoContainer->get_tower_at_channel(i);
-    towerinfo->set_time(processed_waveforms.at(i).at(1));
-    towerinfo->set_energy(processed_waveforms.at(i).at(0));
-    towerinfo->set_time_float(processed_waveforms.at(i).at(1));
-    towerinfo->set_pedestal(processed_waveforms.at(i).at(2));
-    towerinfo->set_chi2(processed_waveforms.at(i).at(3));
-    bool SZS = isSZS(processed_waveforms.at(i).at(1), processed_waveforms.at(i).at(3));
-    if (processed_waveforms.at(i).at(4) == 0) 
+    towerinfo->set_time(fitresult[CaloWaveformBlock::TIME]);
+    towerinfo->set_energy(fitresult[CaloWaveformBlock::AMPLITUDE]);
+    towerinfo->set_time_float(fitresult[CaloWaveformBlock::TIME]);
+    towerinfo->set_pedestal(fitresult[CaloWaveformBlock::PEDESTAL]);
+    towerinfo->set_chi2(fitresult[CaloWaveformBlock::CHI2]);
+    bool SZS = isSZS(fitresult[CaloWaveformBlock::TIME], fitresult[CaloWaveformBlock::CHI2]);
+    if (fitresult[CaloWaveformBlock::RECOVERED] == 0) 
     {
       towerinfo->set_isRecovered(false);
     }
@@ -438,10 +430,10 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
     {
       towerinfo->set_isRecovered(true);
     }
-    int n_samples = waveforms.at(i).size();
+    int n_samples = m_waveforms.nsamples(i);
     if (n_samples == m_nzerosuppsamples || SZS)
     {
-      if(waveforms.at(i).at(0) == 0)
+      if(waveform[0] == 0)
       {
         towerinfo->set_isNotInstr(true);
       }
@@ -453,14 +445,13 @@ int CaloTowerBuilder::process_event(PHCompositeNode *topNode)
     
     for (int j = 0; j < n_samples; j++)
     {
-      if(std::round(waveforms.at(i).at(j)) >= m_saturation)
+      if(std::round(waveform[j]) >= m_saturation)
       {
         towerinfo->set_isSaturated(true);
       }
-      towerinfo->set_waveform_value(j, waveforms.at(i).at(j));
+      towerinfo->set_waveform_value(j, waveform[j]);
     }
   }
-  waveforms.clear();
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
@@ -588,6 +579,10 @@ void CaloTowerBuilder::CreateNodeTree(PHCompositeNode *topNode)
   {
     m_CaloInfoContainer = new TowerInfoContainerv4(DetectorEnum);
   }
+  else if (m_buildertype == CaloTowerDefs::kPRDFTowerv5)
+  {
+    m_CaloInfoContainer = new TowerInfoContainerv5(DetectorEnum);
+  }
   else if (m_buildertype == CaloTowerDefs::kWaveformTowerSimv1)
   {
     m_CaloInfoContainer = new TowerInfoContainerSimv1(DetectorEnum);
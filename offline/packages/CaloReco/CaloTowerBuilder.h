@@ -4,6 +4,7 @@
 #define CALOTOWERBUILDER_H
 
 #include "CaloTowerDefs.h"
+#include "CaloWaveformBlock.h"
 #include "CaloWaveformProcessing.h"
 
 #include <cdbobjects/CDBTTree.h>  // for CDBTTree
@@ -29,7 +30,7 @@ class CaloTowerBuilder : public SubsysReco
 
   void CreateNodeTree(PHCompositeNode *topNode);
 
-  int process_data(PHCompositeNode *topNode, std::vector<std::vector<float>> &wv);
+  int process_data(PHCompositeNode *topNode, CaloWaveformBlock &wv);
   
 
   void set_detector_type(CaloTowerDefs::DetectorSystem dettype)
@@ -113,6 +114,7 @@ class CaloTowerBuilder : public SubsysReco
   bool skipChannel(int ich, int pid);
   bool isSZS(float time, float chi2);
   CaloWaveformProcessing *WaveformProcessing{nullptr};
+  CaloWaveformBlock m_waveforms;  // reused from event to event
   TowerInfoContainer *m_CaloInfoContainer{nullptr};      //! Calo info
   TowerInfoContainer *m_CalowaveformContainer{nullptr};  // waveform from simulation
   CDBTTree *cdbttree = nullptr;
@@ -19,7 +19,8 @@ namespace CaloTowerDefs
     kPRDFWaveform = 1,
     kWaveformTowerv2 = 2,
     kPRDFTowerv4 = 3,
-    kWaveformTowerSimv1 = 4
+    kWaveformTowerSimv1 = 4,
+    kPRDFTowerv5 = 5
   };
 }
 
@@ -0,0 +1,111 @@
+#ifndef CALORECO_CALOWAVEFORMBLOCK_H
+#define CALORECO_CALOWAVEFORMBLOCK_H
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+//! channel-major, contiguous block of calorimeter waveforms and their fit results
+/*!
+ * every channel owns a fixed stride of samples in one buffer, the number of
+ * samples actually filled (e.g. 2 for zero suppressed channels) is kept per channel.
+ * The fitters read the samples in place and write their results into the
+ * NRESULTS floats reserved per channel. The buffers are only grown, so a block
+ * kept as a module member does not reallocate from event to event
+ */
+class CaloWaveformBlock
+{
+ public:
+  enum fitresult
+  {
+    AMPLITUDE = 0,
+    TIME = 1,
+    PEDESTAL = 2,
+    CHI2 = 3,
+    RECOVERED = 4,
+    NRESULTS = 5
+  };
+
+  CaloWaveformBlock() = default;
+  ~CaloWaveformBlock() = default;
+
+  //! drop all channels and set the per channel sample stride
+  void reset(int maxsamples)
+  {
+    m_maxsamples = std::max(maxsamples, 1);
+    m_nchannels = 0;
+  }
+
+  //! append a channel holding nsamples samples, returns its sample storage to be filled
+  float *add_channel(int nsamples)
+  {
+    assert(nsamples <= m_maxsamples);
+    const size_t ich = m_nchannels++;
+    const size_t stride = m_maxsamples;
+    if (m_nsamples.size() < m_nchannels)
+    {
+      m_nsamples.resize(m_nchannels);
+      m_results.resize(m_nchannels * NRESULTS);
+    }
+    if (m_samples.size() < m_nchannels * stride)
+    {
+      m_samples.resize(m_nchannels * stride);
+    }
+    m_nsamples[ich] = nsamples;
+    std::fill_n(&m_results[ich * NRESULTS], NRESULTS, 0.F);
+    return &m_samples[ich * stride];
+  }
+
+  //! append a channel with nsamples samples set to value
+  void add_channel(int nsamples, float value)
+  {
+    std::fill_n(add_channel(nsamples), nsamples, value);
+  }
+
+  int nchannels() const { return static_cast<int>(m_nchannels); }
+  int max_samples() const { return m_maxsamples; }
+  int nsamples(int ich) const { return m_nsamples[ich]; }
+
+  const float *samples(int ich) const { return &m_samples[ich * m_maxsamples]; }
+  float *samples(int ich) { return &m_samples[ich * m_maxsamples]; }
+
+  const float *results(int ich) const { return &m_results[ich * NRESULTS]; }
+  float *results(int ich) { return &m_results[ich * NRESULTS]; }
+  float result(int ich, fitresult ires) const { return m_results[ich * NRESULTS + ires]; }
+
+  //! fill the block from per channel waveform vectors
+  void assign(const std::vector<std::vector<float>> &waveforms)
+  {
+    int maxsamples = 0;
+    for (const auto &waveform : waveforms)
+    {
+      maxsamples = std::max(maxsamples, static_cast<int>(waveform.size()));
+    }
+    reset(maxsamples);
+    for (const auto &waveform : waveforms)
+    {
+      std::copy(waveform.begin(), waveform.end(), add_channel(static_cast<int>(waveform.size())));
+    }
+  }
+
+  //! fit results as per channel vectors, in the {amplitude, time, pedestal, chi2, recovered} order
+  std::vector<std::vector<float>> get_results() const
+  {
+    std::vector<std::vector<float>> fitresults;
+    fitresults.reserve(m_nchannels);
+    for (int ich = 0; ich < nchannels(); ++ich)
+    {
+      fitresults.emplace_back(results(ich), results(ich) + NRESULTS);
+    }
+    return fitresults;
+  }
+
+ private:
+  int m_maxsamples{1};
+  size_t m_nchannels{0};
+  std::vector<int> m_nsamples;
+  std::vector<float> m_samples;
+  std::vector<float> m_results;
+};
+
+#endif
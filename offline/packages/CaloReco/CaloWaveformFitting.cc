@@ -1,4 +1,5 @@
 #include "CaloWaveformFitting.h"
+#include "CaloWaveformBlock.h"
 
 #include <TF1.h>
 #include <TFile.h>
@@ -12,6 +13,7 @@
 #include <HFitInterface.h>
 #include <Math/WrappedMultiTF1.h>
 #include <Math/WrappedTF1.h>
+#include <ROOT/TSeq.hxx>
 #include <ROOT/TThreadExecutor.hxx>
 #include <ROOT/TThreadedObject.hxx>
 
@@ -47,35 +49,46 @@ void CaloWaveformFitting::initialize_processing(const std::string &templatefile)
 
 std::vector<std::vector<float>> CaloWaveformFitting::process_waveform(std::vector<std::vector<float>> waveformvector)
 {
-  int size1 = waveformvector.size();
-  std::vector<std::vector<float>> fitresults;
-  for (int i = 0; i < size1; i++)
+  CaloWaveformBlock block;
+  block.assign(waveformvector);
+  calo_processing_templatefit(block);
+  return block.get_results();
+}
+
+std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit(std::vector<std::vector<float>> chnlvector)
+{
+  // the last entry of each waveform is the channel index, see process_waveform
+  for (std::vector<float> &v : chnlvector)
   {
-    waveformvector.at(i).push_back(i);
+    v.pop_back();
   }
-  fitresults = calo_processing_templatefit(waveformvector);
-  return fitresults;
+  CaloWaveformBlock block;
+  block.assign(chnlvector);
+  calo_processing_templatefit(block);
+  return block.get_results();
 }
 
-std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit(std::vector<std::vector<float>> chnlvector)
+void CaloWaveformFitting::calo_processing_templatefit(CaloWaveformBlock &block)
 {
-  auto func = [&](std::vector<float> &v)
+  auto func = [&](int ich)
   {
-    int size1 = v.size() - 1;
+    const float *v = block.samples(ich);
+    const int size1 = block.nsamples(ich);
+    float *fitresult = block.results(ich);
     if (size1 == _nzerosuppresssamples)
     {
-      v.push_back(v.at(1) - v.at(0));  // returns peak sample - pedestal sample
-      v.push_back(std::numeric_limits<float>::quiet_NaN());                 // set time to qnan for ZS
-      v.push_back(v.at(0));
-      if (v.at(0) != 0 && v.at(1) == 0) // check if post-sample is 0, if so set high chi2
-      { 
-        v.push_back(1000000);
-      } 
-      else 
+      fitresult[0] = v[1] - v[0];  // returns peak sample - pedestal sample
+      fitresult[1] = std::numeric_limits<float>::quiet_NaN();  // set time to qnan for ZS
+      fitresult[2] = v[0];
+      if (v[0] != 0 && v[1] == 0)  // check if post-sample is 0, if so set high chi2
+      {
+        fitresult[3] = 1000000;
+      }
+      else
       {
-        v.push_back(std::numeric_limits<float>::quiet_NaN());
+        fitresult[3] = std::numeric_limits<float>::quiet_NaN();
       }
-      v.push_back(0);
+      fitresult[4] = 0;
     }
     else
     {
@@ -83,55 +96,55 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
       int maxbin = 0;
       for (int i = 0; i < size1; i++)
       {
-        if (v.at(i) > maxheight)
+        if (v[i] > maxheight)
         {
-          maxheight = v.at(i);
+          maxheight = v[i];
           maxbin = i;
         }
       }
       float pedestal = 1500;
       if (maxbin > 4)
       {
-        pedestal = 0.5 * (v.at(maxbin - 4) + v.at(maxbin - 5));
+        pedestal = 0.5 * (v[maxbin - 4] + v[maxbin - 5]);
       }
       else if (maxbin > 3)
       {
-        pedestal = (v.at(maxbin - 4));
+        pedestal = (v[maxbin - 4]);
       }
       else
       {
-        pedestal = 0.5 * (v.at(size1 - 3) + v.at(size1 - 2));
+        pedestal = 0.5 * (v[size1 - 3] + v[size1 - 2]);
       }
 
-      if ( (_bdosoftwarezerosuppression && v.at(6) - v.at(0) < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight-pedestal  < _nsoftwarezerosuppression)  )
+      if ( (_bdosoftwarezerosuppression && v[6] - v[0] < _nsoftwarezerosuppression) || (_maxsoftwarezerosuppression && maxheight-pedestal  < _nsoftwarezerosuppression)  )
       {
-        v.push_back(v.at(6) - v.at(0));
-        v.push_back(std::numeric_limits<float>::quiet_NaN());
-        v.push_back(v.at(0));
-        if (v.at(0) != 0 && v.at(1) == 0) // check if post-sample is 0, if so set high chi2
-        { 
-          v.push_back(1000000);
-        } 
-        else 
+        fitresult[0] = v[6] - v[0];
+        fitresult[1] = std::numeric_limits<float>::quiet_NaN();
+        fitresult[2] = v[0];
+        if (v[0] != 0 && v[1] == 0)  // check if post-sample is 0, if so set high chi2
         {
-          v.push_back(std::numeric_limits<float>::quiet_NaN());
+          fitresult[3] = 1000000;
         }
-        v.push_back(0);
+        else
+        {
+          fitresult[3] = std::numeric_limits<float>::quiet_NaN();
+        }
+        fitresult[4] = 0;
       }
       else
       {
-        auto h = new TH1F(std::string("h_" + std::to_string((int) round(v.at(size1)))).c_str(), "", size1, -0.5, size1 - 0.5);
+        auto h = new TH1F(std::string("h_" + std::to_string(ich)).c_str(), "", size1, -0.5, size1 - 0.5);
 
         int ndata = 0;
         for (int i = 0; i < size1; ++i)
         {
-          if (v.at(i) == 16383)
+          if (v[i] == 16383)
           {
             continue;
           }
           else
           {
-            h->SetBinContent(i + 1, v.at(i));
+            h->SetBinContent(i + 1, v[i]);
             h->SetBinError(i + 1, 1);
             ndata++;
           }
@@ -142,14 +155,14 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
 	 ndata = size1;
          for (int i = 0; i < size1; ++i)
          {
-            h->SetBinContent(i + 1, v.at(i));
+            h->SetBinContent(i + 1, v[i]);
             h->SetBinError(i + 1, 1);  
          }       
         }
 
-        auto f = new TF1(std::string("f_" + std::to_string((int) round(v.at(size1)))).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
+        auto f = new TF1(std::string("f_" + std::to_string(ich)).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
         ROOT::Math::WrappedMultiTF1 *fitFunction = new ROOT::Math::WrappedMultiTF1(*f, 3);
-        ROOT::Fit::BinData data(v.size() - 1, 1);
+        ROOT::Fit::BinData data(size1, 1);
         ROOT::Fit::FillData(data, h);
         ROOT::Fit::Chi2Function *EPChi2 = new ROOT::Fit::Chi2Function(data, *fitFunction);
         ROOT::Fit::Fitter *fitter = new ROOT::Fit::Fitter();
@@ -173,7 +186,7 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
           std::cout<<"invalid fit"<<std::endl;
           for (int i = 0; i < size1; ++i)
         {
-          std::cout<<v.at(i)<<std::endl;
+          std::cout<<v[i]<<std::endl;
         }
         }
         */
@@ -182,12 +195,7 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
         chi2min /= ndata - 3;  // divide by the number of dof
         if (chi2min > _chi2threshold && (f->GetParameter(2) < _bfr_highpedestalthreshold || pedestal < _bfr_highpedestalthreshold) && (f->GetParameter(2) > _bfr_lowpedestalthreshold || pedestal > _bfr_lowpedestalthreshold) && _dobitfliprecovery) 
         {
-          std::vector<float> rv; // temporary recovered waveform
-          rv.reserve(size1);
-          for (int i = 0; i < size1; i++)
-          {
-            rv.push_back(v.at(i));
-          }
+          std::vector<float> rv(v, v + size1); // temporary recovered waveform
           unsigned int bits[3] = {8192,4096,2048};
           for (auto bit : bits) 
           {
@@ -228,7 +236,7 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
             pedestal = 0.5 * (rv.at(size1 - 3) + rv.at(size1 - 2));
           }
           
-          auto recover_f = new TF1(std::string("recover_f_" + std::to_string((int) round(v.at(size1)))).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
+          auto recover_f = new TF1(std::string("recover_f_" + std::to_string(ich)).c_str(), this, &CaloWaveformFitting::template_function, 0, 31, 3, "CaloWaveformFitting", "template_function");
           ROOT::Math::WrappedMultiTF1 *recoverFitFunction = new ROOT::Math::WrappedMultiTF1(*recover_f, 3);
           ROOT::Fit::BinData recoverData(rv.size() - 1, 1);
           ROOT::Fit::FillData(recoverData, h);
@@ -243,25 +251,21 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
           double recover_chi2min = recover_fitres.MinFcnValue();
           recover_chi2min /= size1-3; // divide by the number of dof
           if (recover_chi2min < _chi2lowthreshold && recover_f->GetParameter(2) < _bfr_highpedestalthreshold && recover_f->GetParameter(2) > _bfr_lowpedestalthreshold) {
-            for (int i = 0; i < size1; i++)
-            {
-              v.at(i) = rv.at(i);
-            }
             for (int i = 0; i < 3; i++)
             {
-              v.push_back(recover_f->GetParameter(i));
+              fitresult[i] = recover_f->GetParameter(i);
             }
-            v.push_back(recover_chi2min);
-            v.push_back(1);
+            fitresult[3] = recover_chi2min;
+            fitresult[4] = 1;
           }
           else 
           {
             for (int i = 0; i < 3; i++)
             {
-              v.push_back(f->GetParameter(i));
+              fitresult[i] = f->GetParameter(i);
             }
-            v.push_back(chi2min);
-            v.push_back(0);
+            fitresult[3] = chi2min;
+            fitresult[4] = 0;
           }
           recover_f->Delete();
           delete recoverFitFunction;
@@ -272,10 +276,10 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
         {
           for (int i = 0; i < 3; i++)
           {
-            v.push_back(f->GetParameter(i));
+            fitresult[i] = f->GetParameter(i);
           }
-          v.push_back(chi2min);
-          v.push_back(0);
+          fitresult[3] = chi2min;
+          fitresult[4] = 0;
         }
         h->Delete();
         f->Delete();
@@ -286,23 +290,7 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_templatefit
     }
   };
 
-  t->Foreach(func, chnlvector);
-  int size3 = chnlvector.size();
-  std::vector<std::vector<float>> fit_params;
-  std::vector<float> fit_params_tmp;
-  for (int i = 0; i < size3; i++)
-  {
-    std::vector<float> tv = chnlvector.at(i);
-    int size2 = tv.size();
-    for (int q = 5; q > 0; q--)
-    {
-      fit_params_tmp.push_back(tv.at(size2 - q));
-    }
-    fit_params.push_back(fit_params_tmp);
-    fit_params_tmp.clear();
-  }
-  chnlvector.clear();
-  return fit_params;
+  t->Foreach(func, ROOT::TSeq<int>(block.nchannels()));
 }
 
 void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float y1, float y2, float &xmax, float &ymax)
@@ -375,24 +363,31 @@ void CaloWaveformFitting::FastMax(float x0, float x1, float x2, float y0, float
 }
 std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_fast(std::vector<std::vector<float>> chnlvector)
 {
-  std::vector<std::vector<float>> fit_values;
-  int nchnls = chnlvector.size();
+  CaloWaveformBlock block;
+  block.assign(chnlvector);
+  calo_processing_fast(block);
+  return block.get_results();
+}
+
+void CaloWaveformFitting::calo_processing_fast(CaloWaveformBlock &block)
+{
+  int nchnls = block.nchannels();
   for (int m = 0; m < nchnls; m++)
   {
-    std::vector<float> v = chnlvector.at(m);
-    int nsamples = v.size();
+    const float *v = block.samples(m);
+    int nsamples = block.nsamples(m);
 
-    double maxy = v.at(0);
+    double maxy = v[0];
     float amp = 0;
     float time = 0;
     float ped = 0;
     float chi2 = std::numeric_limits<float>::quiet_NaN();
     if (nsamples == 2)
     {
-      amp = v.at(1);
+      amp = v[1];
       time = std::numeric_limits<float>::quiet_NaN();
-      ped = v.at(0);
-      if (v.at(0) != 0 && v.at(1) == 0) // check if post-sample is 0, if so set high chi2
+      ped = v[0];
+      if (v[0] != 0 && v[1] == 0) // check if post-sample is 0, if so set high chi2
       { 
         chi2 = 1000000;
       } 
@@ -404,11 +399,11 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_fast(std::v
       {
         if (i < 3)
         {
-          ped += v.at(i);
+          ped += v[i];
         }
-        if (v.at(i) > maxy)
+        if (v[i] > maxy)
         {
-          maxy = v.at(i);
+          maxy = v[i];
           maxx = i;
         }
       }
@@ -416,7 +411,7 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_fast(std::v
       // if maxx <=5 nsample >=10 use the last two sample for pedestal(for HCal TP)
       if (maxx <= 5 && nsamples >= 10)
       {
-        ped = 0.5 * (v.at(nsamples - 2) + v.at(nsamples - 1));
+        ped = 0.5 * (v[nsamples - 2] + v[nsamples - 1]);
       }
       if (maxx == 0 || maxx == nsamples - 1)
       {
@@ -425,49 +420,59 @@ std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_fast(std::v
       }
       else
       {
-        FastMax(maxx - 1, maxx, maxx + 1, v.at(maxx - 1), v.at(maxx), v.at(maxx + 1), time, amp);
+        FastMax(maxx - 1, maxx, maxx + 1, v[maxx - 1], v[maxx], v[maxx + 1], time, amp);
       }
     }
     amp -= ped;
-    std::vector<float> val = {amp, time, ped, chi2, 0};
-    fit_values.push_back(val);
-    val.clear();
+    float *fitresult = block.results(m);
+    fitresult[0] = amp;
+    fitresult[1] = time;
+    fitresult[2] = ped;
+    fitresult[3] = chi2;
+    fitresult[4] = 0;
   }
-  return fit_values;
 }
 
 std::vector<std::vector<float>> CaloWaveformFitting::calo_processing_nyquist(std::vector<std::vector<float>> chnlvector)
 {
-  std::vector<std::vector<float>> fit_values;
-  int nchnls = chnlvector.size();
+  CaloWaveformBlock block;
+  block.assign(chnlvector);
+  calo_processing_nyquist(block);
+  return block.get_results();
+}
+
+void CaloWaveformFitting::calo_processing_nyquist(CaloWaveformBlock &block)
+{
+  int nchnls = block.nchannels();
   for (int m = 0; m < nchnls; m++)
   {
-    std::vector<float> v = chnlvector.at(m);
-    int nsamples = (int)v.size();
+    const float *v = block.samples(m);
+    int nsamples = block.nsamples(m);
+    float *fitresult = block.results(m);
 
     if (nsamples == 2)
     {
       float chi2 = std::numeric_limits<float>::quiet_NaN();
-      if (v.at(0) != 0 && v.at(1) == 0) // check if post-sample is 0, if so set high chi2
+      if (v[0] != 0 && v[1] == 0) // check if post-sample is 0, if so set high chi2
       { 
         chi2 = 1000000;
       }
-      fit_values.push_back({v.at(1) - v.at(0), std::numeric_limits<float>::quiet_NaN(), v.at(0), chi2, 0});
+      fitresult[0] = v[1] - v[0];
+      fitresult[1] = std::numeric_limits<float>::quiet_NaN();
+      fitresult[2] = v[0];
+      fitresult[3] = chi2;
+      fitresult[4] = 0;
       continue;
     }
-    
-    std::vector<float> result = NyquistInterpolation(v);
-    fit_values.push_back(result);
-  }
-  return fit_values;
 
+    NyquistInterpolation(v, nsamples, fitresult);
+  }
 }
 //mabye I can find a way to make it thread safe
-std::vector<float> CaloWaveformFitting::NyquistInterpolation(std::vector<float> &vec_signal_samples)
+void CaloWaveformFitting::NyquistInterpolation(const float *vec_signal_samples, int N, float *result)
 {
-  // int N = (int) vec_signal_samples.size();
-  auto max_elem_iter = std::max_element(vec_signal_samples.begin(), vec_signal_samples.end());
-  int maxx = std::distance(vec_signal_samples.begin(), max_elem_iter);
+  auto max_elem_iter = std::max_element(vec_signal_samples, vec_signal_samples + N);
+  int maxx = std::distance(vec_signal_samples, max_elem_iter);
   float max = *max_elem_iter;
 
   float maxpos = maxx;
@@ -484,7 +489,7 @@ std::vector<float> CaloWaveformFitting::NyquistInterpolation(std::vector<float>
 
       float yval = max;
       if(i != maxpos){ 
-        yval = psinc(i, vec_signal_samples);
+        yval = psinc(i, vec_signal_samples, N);
        
       }
       if (yval > max)
@@ -516,7 +521,7 @@ std::vector<float> CaloWaveformFitting::NyquistInterpolation(std::vector<float>
     pedestal = max;
     for (float i = maxpos - 5; i < maxpos; i += 0.1)
     {
-      float yval = psinc(i, vec_signal_samples);
+      float yval = psinc(i, vec_signal_samples, N);
       if (yval < pedestal)
       {
         pedestal = yval;
@@ -526,13 +531,16 @@ std::vector<float> CaloWaveformFitting::NyquistInterpolation(std::vector<float>
   //calculate chi2 using the tempalte
   float chi2 = 0;
   double par[3] = {max - pedestal, maxpos - m_peakTimeTemp, pedestal};
-  for(int i = 0; i < (int)vec_signal_samples.size(); i++){
+  for(int i = 0; i < N; i++){
     double xval[1] = {(double)i};
     float diff = vec_signal_samples[i] - template_function(xval, par);
     chi2 += diff*diff;
   }
-  std::vector<float> val = {max - pedestal, maxpos, pedestal, chi2, 0};
-  return val;
+  result[0] = max - pedestal;
+  result[1] = maxpos;
+  result[2] = pedestal;
+  result[3] = chi2;
+  result[4] = 0;
 }
 
 // for odd N
@@ -562,9 +570,8 @@ double CaloWaveformFitting::Dkernel(double x, int N)
   return sum;
 }
 
-float CaloWaveformFitting::stablepsinc(float time, std::vector<float> &vec_signal_samples)
+float CaloWaveformFitting::stablepsinc(float time, const float *vec_signal_samples, int N)
 {
-  int N = (int) vec_signal_samples.size();
   float sum = 0;
   if (N % 2 == 0)
   {
@@ -583,20 +590,19 @@ float CaloWaveformFitting::stablepsinc(float time, std::vector<float> &vec_signa
   return sum;
 }
 
-float CaloWaveformFitting::psinc(float time, std::vector<float> &vec_signal_samples)
+float CaloWaveformFitting::psinc(float time, const float *vec_signal_samples, int N)
 {
-  int N = (int) vec_signal_samples.size();
 
   if (std::abs(std::round(time) - time) < 1e-6)
   {
  
     if (time < 0 || time >= N)
     {
-      return stablepsinc(time, vec_signal_samples);
+      return stablepsinc(time, vec_signal_samples, N);
     }
     else
     {
-      return vec_signal_samples.at(std::round(time));
+      return vec_signal_samples[static_cast<int>(std::round(time))];
     }
   }
 
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+class CaloWaveformBlock;
 class TProfile;
 
 class CaloWaveformFitting
@@ -56,17 +57,22 @@ class CaloWaveformFitting
   std::vector<std::vector<float>> calo_processing_fast(std::vector<std::vector<float>> chnlvector);
   std::vector<std::vector<float>> calo_processing_nyquist(std::vector<std::vector<float>> chnlvector);
 
+  // in place versions, the fit results are stored in the block next to the waveforms
+  void calo_processing_templatefit(CaloWaveformBlock &block);
+  void calo_processing_fast(CaloWaveformBlock &block);
+  void calo_processing_nyquist(CaloWaveformBlock &block);
+
   void initialize_processing(const std::string &templatefile);
 
  private:
   void FastMax(float x0, float x1, float x2, float y0, float y1, float y2, float &xmax, float &ymax);
-  std::vector<float> NyquistInterpolation(std::vector<float> &vec_signal_samples);
+  void NyquistInterpolation(const float *vec_signal_samples, int N, float *result);
   double Dkernelodd(double x, int N);
   double Dkernel(double x, int N);
 
-  float stablepsinc(float t, std::vector<float> &vec_signal_samples);
+  float stablepsinc(float t, const float *vec_signal_samples, int N);
 
-  float psinc(float t, std::vector<float> &vec_signal_samples);
+  float psinc(float t, const float *vec_signal_samples, int N);
   double template_function(double *x, double *par);
 
   TProfile *h_template {nullptr};
@@ -1,4 +1,5 @@
 #include "CaloWaveformProcessing.h"
+#include "CaloWaveformBlock.h"
 #include "CaloWaveformFitting.h"
 
 #include <ffamodules/CDBInterface.h>
@@ -61,58 +62,65 @@ void CaloWaveformProcessing::initialize_processing()
 
 std::vector<std::vector<float>> CaloWaveformProcessing::process_waveform(std::vector<std::vector<float>> waveformvector)
 {
-  int size1 = waveformvector.size();
-  std::vector<std::vector<float>> fitresults;
+  CaloWaveformBlock block;
+  block.assign(waveformvector);
+  process_waveform(block);
+  return block.get_results();
+}
+
+void CaloWaveformProcessing::process_waveform(CaloWaveformBlock &block)
+{
   if (m_processingtype == CaloWaveformProcessing::TEMPLATE)
   {
-    for (int i = 0; i < size1; i++)
-    {
-      waveformvector.at(i).push_back(i);
-    }
-    fitresults = m_Fitter->calo_processing_templatefit(waveformvector);
+    m_Fitter->calo_processing_templatefit(block);
   }
   if (m_processingtype == CaloWaveformProcessing::ONNX)
   {
-    fitresults = CaloWaveformProcessing::calo_processing_ONNX(waveformvector);
+    calo_processing_ONNX(block);
   }
   if (m_processingtype == CaloWaveformProcessing::FAST)
   {
-    fitresults = m_Fitter->calo_processing_fast(waveformvector);
+    m_Fitter->calo_processing_fast(block);
   }
   if (m_processingtype == CaloWaveformProcessing::NYQUIST)
   {
-    fitresults = m_Fitter->calo_processing_nyquist(waveformvector);
+    m_Fitter->calo_processing_nyquist(block);
   }
-  return fitresults;
 }
 
 std::vector<std::vector<float>> CaloWaveformProcessing::calo_processing_ONNX(std::vector<std::vector<float>> chnlvector)
 {
-  std::vector<std::vector<float>> fit_values;
-  int nchnls = chnlvector.size();
+  CaloWaveformBlock block;
+  block.assign(chnlvector);
+  calo_processing_ONNX(block);
+  return block.get_results();
+}
+
+void CaloWaveformProcessing::calo_processing_ONNX(CaloWaveformBlock &block)
+{
+  int nchnls = block.nchannels();
+  std::vector<float> vtmp;
   for (int m = 0; m < nchnls; m++)
   {
-    std::vector<float> v = chnlvector.at(m);
-    int nsamples = v.size() - 1;
-    std::vector<float> vtmp;
-    vtmp.reserve(nsamples);
+    const float *v = block.samples(m);
+    int nsamples = block.nsamples(m) - 1;
+    vtmp.clear();
     for (int k = 0; k < nsamples; k++)
     {
-      vtmp.push_back(v.at(k) / 1000.0);
+      vtmp.push_back(v[k] / 1000.0);
     }
     std::vector<float> val = onnxInference(onnxmodule, vtmp, 1, 31, 3);
-    int nvals = val.size();
+    int nvals = std::min<int>(val.size(), CaloWaveformBlock::NRESULTS);
+    float *fitresult = block.results(m);
     for (int i = 0; i < nvals; i++)
     {
+      fitresult[i] = val.at(i);
       if (i == 0 || i == 2)
       {
-        val.at(i) = val.at(i) * 1000;
+        fitresult[i] = val.at(i) * 1000;
       }
     }
-    fit_values.push_back(val);
-    val.clear();
   }
-  return fit_values;
 }
 
 int CaloWaveformProcessing::get_nthreads()
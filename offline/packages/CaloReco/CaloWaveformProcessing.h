@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+class CaloWaveformBlock;
 class CaloWaveformFitting;
 
 class CaloWaveformProcessing : public SubsysReco
@@ -75,6 +76,10 @@ class CaloWaveformProcessing : public SubsysReco
   std::vector<std::vector<float>> process_waveform(std::vector<std::vector<float>> waveformvector);
   std::vector<std::vector<float>> calo_processing_ONNX(std::vector<std::vector<float>> chnlvector);
 
+  // fits the waveforms of the block in place, results are stored in the block
+  void process_waveform(CaloWaveformBlock &block);
+  void calo_processing_ONNX(CaloWaveformBlock &block);
+
   void initialize_processing();
 
  private:
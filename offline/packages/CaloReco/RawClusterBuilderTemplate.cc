@@ -30,9 +30,11 @@
 #include <phool/PHNode.h>
 #include <phool/PHNodeIterator.h>
 #include <phool/PHObject.h>
+#include <phool/PHTimer.h>
 #include <phool/getClass.h>
 #include <phool/phool.h>
 
+#include <algorithm>
 #include <cmath>
 #include <exception>
 #include <fstream>
@@ -438,6 +440,12 @@ int RawClusterBuilderTemplate::process_event(PHCompositeNode *topNode)
   }
 
   bemc->SetModules(&HitList);
+  bemc->SetFastClustering(m_fast_clustering);
+
+  if (m_benchmark_clustering)
+  {
+    BenchmarkClustering();
+  }
 
   // Find clusters (as a set of towers with common edge)
   int ncl = bemc->FindClusters();
@@ -649,6 +657,68 @@ void RawClusterBuilderTemplate::CreateNodes(PHCompositeNode *topNode)
   cemcNode->addNode(clusterNode);
 }
 
+int RawClusterBuilderTemplate::End(PHCompositeNode * /*topNode*/)
+{
+  if (m_benchmark_clustering && m_bench_nevents > 0)
+  {
+    std::cout << "RawClusterBuilderTemplate::End(): clustering benchmark for " << detector
+              << " over " << m_bench_nevents << " events" << std::endl;
+    std::cout << "  BEmcRec::FindClustersLednev(): " << m_bench_time_lednev / m_bench_nevents << " ms/event" << std::endl;
+    std::cout << "  BEmcRec::FindClustersGrid():   " << m_bench_time_grid / m_bench_nevents << " ms/event" << std::endl;
+    std::cout << "  events with different clusters: " << m_bench_nmismatch << std::endl;
+  }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+namespace
+{
+  // channel lists of all clusters, sorted, to compare cluster finders independent of the ordering
+  std::vector<std::vector<int>> cluster_channels(std::vector<EmcCluster> *clusters)
+  {
+    std::vector<std::vector<int>> channels;
+    for (auto &cluster : *clusters)
+    {
+      std::vector<int> ich;
+      for (const auto &hit : cluster.GetHitList())
+      {
+        ich.push_back(hit.ich);
+      }
+      std::sort(ich.begin(), ich.end());
+      channels.push_back(ich);
+    }
+    std::sort(channels.begin(), channels.end());
+    return channels;
+  }
+}  // namespace
+
+void RawClusterBuilderTemplate::BenchmarkClustering()
+{
+  PHTimer timer("ClusteringTimer");
+
+  timer.restart();
+  int ncl_lednev = bemc->FindClustersLednev();
+  timer.stop();
+  m_bench_time_lednev += timer.elapsed();
+  std::vector<std::vector<int>> channels_lednev = cluster_channels(bemc->GetClusters());
+
+  timer.restart();
+  int ncl_grid = bemc->FindClustersGrid();
+  timer.stop();
+  m_bench_time_grid += timer.elapsed();
+  std::vector<std::vector<int>> channels_grid = cluster_channels(bemc->GetClusters());
+
+  m_bench_nevents++;
+  if (ncl_lednev != ncl_grid || channels_lednev != channels_grid)
+  {
+    m_bench_nmismatch++;
+    if (Verbosity() > 0)
+    {
+      std::cout << "RawClusterBuilderTemplate::BenchmarkClustering(): cluster finders differ, "
+                << ncl_lednev << " (Lednev) vs " << ncl_grid << " (grid) clusters" << std::endl;
+    }
+  }
+}
+
 bool RawClusterBuilderTemplate::IsAcceptableTower(TowerInfo *tower)
 {
   if (tower->get_energy() < _min_tower_e)
@@ -20,6 +20,7 @@ class RawClusterBuilderTemplate : public SubsysReco
 
   int InitRun(PHCompositeNode* topNode) override;
   int process_event(PHCompositeNode* topNode) override;
+  int End(PHCompositeNode* topNode) override;
   void Detector(const std::string& d);
 
   void SetCylindricalGeometry();
@@ -69,6 +70,12 @@ class RawClusterBuilderTemplate : public SubsysReco
     m_subclustersplitting = doSubClusterSplitting;
   }
 
+  // grid (connected component) cluster finder instead of the default BEmcRec one
+  void set_fast_clustering(bool b) { m_fast_clustering = b; }
+
+  // run both cluster finders on each event, compare their clusters and print the timing at End()
+  void set_benchmark_clustering(bool b) { m_benchmark_clustering = b; }
+
   
 
  private:
@@ -76,6 +83,7 @@ class RawClusterBuilderTemplate : public SubsysReco
   bool Cell2Abs(RawTowerGeomContainer* towergeom, float phiC, float etaC, float& phi, float& eta);
   bool IsAcceptableTower(TowerInfo *tower);
   bool IsAcceptableTower(RawTower *tower);
+  void BenchmarkClustering();
 
   RawClusterContainer* _clusters{nullptr};
   //  BEmcProfile *_emcprof;
@@ -114,6 +122,13 @@ class RawClusterBuilderTemplate : public SubsysReco
 
   bool m_subclustersplitting{true};
 
+  bool m_fast_clustering{false};
+  bool m_benchmark_clustering{false};
+  unsigned int m_bench_nevents{0};
+  unsigned int m_bench_nmismatch{0};
+  double m_bench_time_lednev{0};  // ms
+  double m_bench_time_grid{0};    // ms
+
   std::string m_inputnodename;
   std::string m_outputnodename;
 };
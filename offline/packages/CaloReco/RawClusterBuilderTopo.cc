@@ -26,7 +26,6 @@
 #include <exception>
 #include <iostream>
 #include <iterator>  // for begin, end
-#include <list>
 #include <memory>  // for allocator_traits<>::valu...
 #include <stdexcept>
 #include <utility>
@@ -195,6 +194,29 @@ std::vector<int> RawClusterBuilderTopo::get_adjacent_towers_by_ID(int ID)
   return adjacent_towers;
 }
 
+void RawClusterBuilderTopo::build_neighbor_table()
+{
+  int n_ID = get_n_ID();
+  _NEIGHBOR_OFFSET_ID.assign(n_ID + 1, 0);
+  _NEIGHBOR_LIST.clear();
+  for (int ID = 0; ID < n_ID; ID++)
+  {
+    _NEIGHBOR_OFFSET_ID[ID] = _NEIGHBOR_LIST.size();
+    // IDs between the end of the OHCal and the start of the EMCal are not towers
+    bool is_tower = (ID >= _EMCAL_NPHI * _EMCAL_NETA) || (ID < 2 * _HCAL_NETA * _HCAL_NPHI);
+    if (is_tower)
+    {
+      std::vector<int> adjacent_towers = get_adjacent_towers_by_ID(ID);
+      _NEIGHBOR_LIST.insert(_NEIGHBOR_LIST.end(), adjacent_towers.begin(), adjacent_towers.end());
+    }
+  }
+  _NEIGHBOR_OFFSET_ID[n_ID] = _NEIGHBOR_LIST.size();
+  if (Verbosity() > 0)
+  {
+    std::cout << "RawClusterBuilderTopo::build_neighbor_table: " << _NEIGHBOR_LIST.size() << " neighbors for " << n_ID << " tower IDs" << std::endl;
+  }
+}
+
 void RawClusterBuilderTopo::export_single_cluster(const std::vector<int> &original_towers)
 {
   if (Verbosity() > 2)
@@ -202,17 +224,16 @@ void RawClusterBuilderTopo::export_single_cluster(const std::vector<int> &origin
     std::cout << "RawClusterBuilderTopo::export_single_cluster called " << std::endl;
   }
 
-  std::map<int, std::pair<int, int> > tower_ownership;
   for (const int &original_tower : original_towers)
   {
-    tower_ownership[original_tower] = std::pair<int, int>(0, -1);  // all towers owned by cluster 0
+    _TOWER_OWNERSHIP_ID[original_tower] = std::pair<int, int>(0, -1);  // all towers owned by cluster 0
   }
-  export_clusters(original_towers, tower_ownership, 1, std::vector<float>(), std::vector<float>(), std::vector<float>());
+  export_clusters(original_towers, 1, std::vector<float>(), std::vector<float>(), std::vector<float>());
 
   return;
 }
 
-void RawClusterBuilderTopo::export_clusters(const std::vector<int> &original_towers, std::map<int, std::pair<int, int> > tower_ownership, unsigned int n_clusters, std::vector<float> pseudocluster_sumE, std::vector<float> pseudocluster_eta, std::vector<float> pseudocluster_phi)
+void RawClusterBuilderTopo::export_clusters(const std::vector<int> &original_towers, unsigned int n_clusters, const std::vector<float> &pseudocluster_sumE, const std::vector<float> &pseudocluster_eta, const std::vector<float> &pseudocluster_phi)
 {
   if (n_clusters != 1)  // if we didn't just pass down from export_single_cluster
   {
@@ -242,26 +263,16 @@ void RawClusterBuilderTopo::export_clusters(const std::vector<int> &original_tow
   for (int original_tower : original_towers)
   {
     int this_ID = original_tower;
-    std::pair<int, int> the_pair = tower_ownership[this_ID];
+    std::pair<int, int> the_pair = _TOWER_OWNERSHIP_ID[this_ID];
 
     if (Verbosity() > 5)
     {
       std::cout << "RawClusterBuilderTopo::export_clusters -> assigning tower " << original_tower << " with ownership ( " << the_pair.first << ", " << the_pair.second << " ) " << std::endl;
     }
-    int this_ieta = get_ieta_from_ID(this_ID);
-    int this_iphi = get_iphi_from_ID(this_ID);
     int this_layer = get_ilayer_from_ID(this_ID);
     float this_E = get_E_from_ID(this_ID);
 
-    int this_key = 0;
-    if (this_layer == 2)
-    {
-      this_key = _EMTOWERMAP_KEY_ETA_PHI[this_ieta][this_iphi];
-    }
-    else
-    {
-      this_key = _TOWERMAP_KEY_LAYER_ETA_PHI[this_layer][this_ieta][this_iphi];
-    }
+    int this_key = _TOWERMAP_KEY_ID[this_ID];
 
     RawTowerGeom *tower_geom = _geom_containers[this_layer]->get_tower_geometry(this_key);
 
@@ -462,10 +473,6 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
     // define geometry only once if it has not been yet
     _EMCAL_NETA = _geom_containers[2]->get_etabins();
     _EMCAL_NPHI = _geom_containers[2]->get_phibins();
-
-    _EMTOWERMAP_STATUS_ETA_PHI.resize(_EMCAL_NETA, std::vector<int>(_EMCAL_NPHI, -2));
-    _EMTOWERMAP_KEY_ETA_PHI.resize(_EMCAL_NETA, std::vector<int>(_EMCAL_NPHI, 0));
-    _EMTOWERMAP_E_ETA_PHI.resize(_EMCAL_NETA, std::vector<float>(_EMCAL_NPHI, 0));
   }
 
   if (_HCAL_NETA < 0)
@@ -473,33 +480,22 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
     // define geometry only once if it has not been yet
     _HCAL_NETA = _geom_containers[1]->get_etabins();
     _HCAL_NPHI = _geom_containers[1]->get_phibins();
+  }
 
-    _TOWERMAP_STATUS_LAYER_ETA_PHI.resize(2, std::vector<std::vector<int> >(_HCAL_NETA, std::vector<int>(_HCAL_NPHI, -2)));
-    _TOWERMAP_KEY_LAYER_ETA_PHI.resize(2, std::vector<std::vector<int> >(_HCAL_NETA, std::vector<int>(_HCAL_NPHI, 0)));
-    _TOWERMAP_E_LAYER_ETA_PHI.resize(2, std::vector<std::vector<float> >(_HCAL_NETA, std::vector<float>(_HCAL_NPHI, 0)));
+  if (_NEIGHBOR_OFFSET_ID.empty())
+  {
+    // tower maps and neighbor table are built only once as well
+    _TOWERMAP_STATUS_ID.resize(get_n_ID(), -2);
+    _TOWERMAP_KEY_ID.resize(get_n_ID(), 0);
+    _TOWERMAP_E_ID.resize(get_n_ID(), 0);
+    _TOWER_OWNERSHIP_ID.resize(get_n_ID(), std::pair<int, int>(-1, -1));
+    build_neighbor_table();
   }
 
   // reset maps
   // but note -- do not reset keys!
-  for (int ieta = 0; ieta < _EMCAL_NETA; ieta++)
-  {
-    for (int iphi = 0; iphi < _EMCAL_NPHI; iphi++)
-    {
-      _EMTOWERMAP_STATUS_ETA_PHI[ieta][iphi] = -2;  // set tower does not exist
-      _EMTOWERMAP_E_ETA_PHI[ieta][iphi] = 0;        // set zero energy
-    }
-  }
-  for (int ilayer = 0; ilayer < 2; ilayer++)
-  {
-    for (int ieta = 0; ieta < _HCAL_NETA; ieta++)
-    {
-      for (int iphi = 0; iphi < _HCAL_NPHI; iphi++)
-      {
-        _TOWERMAP_STATUS_LAYER_ETA_PHI[ilayer][ieta][iphi] = -2;  // set tower does not exist
-        _TOWERMAP_E_LAYER_ETA_PHI[ilayer][ieta][iphi] = 0;        // set zero energy
-      }
-    }
-  }
+  std::fill(_TOWERMAP_STATUS_ID.begin(), _TOWERMAP_STATUS_ID.end(), -2);  // set tower does not exist
+  std::fill(_TOWERMAP_E_ID.begin(), _TOWERMAP_E_ID.end(), 0);             // set zero energy
 
   // setup
   std::vector<std::pair<int, float> > list_of_seeds;
@@ -537,14 +533,14 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         continue;
       }
 
-      _EMTOWERMAP_STATUS_ETA_PHI[ieta][iphi] = -1;  // change status to unknown
-      _EMTOWERMAP_E_ETA_PHI[ieta][iphi] = this_E;
-      _EMTOWERMAP_KEY_ETA_PHI[ieta][iphi] = key;
+      int ID = get_ID(2, ieta, iphi);
+      _TOWERMAP_STATUS_ID[ID] = -1;  // change status to unknown
+      _TOWERMAP_E_ID[ID] = this_E;
+      _TOWERMAP_KEY_ID[ID] = key;
 
       // use fabs() here for simplicity - if we're not using abs E, negative towers are already excluded
       if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[2])
       {
-        int ID = get_ID(2, ieta, iphi);
         list_of_seeds.emplace_back(ID, this_E);
         if (Verbosity() > 10)
         {
@@ -583,13 +579,13 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         continue;
       }
 
-      _TOWERMAP_STATUS_LAYER_ETA_PHI[0][ieta][iphi] = -1;  // change status to unknown
-      _TOWERMAP_E_LAYER_ETA_PHI[0][ieta][iphi] = this_E;
-      _TOWERMAP_KEY_LAYER_ETA_PHI[0][ieta][iphi] = key;
+      int ID = get_ID(0, ieta, iphi);
+      _TOWERMAP_STATUS_ID[ID] = -1;  // change status to unknown
+      _TOWERMAP_E_ID[ID] = this_E;
+      _TOWERMAP_KEY_ID[ID] = key;
 
       if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[0])
       {
-        int ID = get_ID(0, ieta, iphi);
         list_of_seeds.emplace_back(ID, this_E);
         if (Verbosity() > 10)
         {
@@ -623,13 +619,13 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         continue;
       }
 
-      _TOWERMAP_STATUS_LAYER_ETA_PHI[1][ieta][iphi] = -1;  // change status to unknown
-      _TOWERMAP_E_LAYER_ETA_PHI[1][ieta][iphi] = this_E;
-      _TOWERMAP_KEY_LAYER_ETA_PHI[1][ieta][iphi] = key;
+      int ID = get_ID(1, ieta, iphi);
+      _TOWERMAP_STATUS_ID[ID] = -1;  // change status to unknown
+      _TOWERMAP_E_ID[ID] = this_E;
+      _TOWERMAP_KEY_ID[ID] = key;
 
       if (std::fabs(this_E) >= _sigma_seed * _noise_LAYER[1])
       {
-        int ID = get_ID(1, ieta, iphi);
         list_of_seeds.emplace_back(ID, this_E);
         if (Verbosity() > 10)
         {
@@ -667,14 +663,15 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
 
   std::vector<std::vector<int> > all_cluster_towers;  // store final cluster tower lists here
 
-  while (list_of_seeds.size() > 0)
+  // seeds and grow towers are processed in order, the vectors are only walked through
+  std::vector<int> grow_tower_ID;
+  for (unsigned int iseed = 0; iseed < list_of_seeds.size(); iseed++)
   {
-    int seed_ID = list_of_seeds.at(0).first;
-    list_of_seeds.erase(list_of_seeds.begin());
+    int seed_ID = list_of_seeds[iseed].first;
 
     if (Verbosity() > 5)
     {
-      std::cout << " RawClusterBuilderTopo::process_event: in seeded loop, current seed has ID = " << seed_ID << " , length of remaining seed vector = " << list_of_seeds.size() << std::endl;
+      std::cout << " RawClusterBuilderTopo::process_event: in seeded loop, current seed has ID = " << seed_ID << " , length of remaining seed vector = " << list_of_seeds.size() - iseed - 1 << std::endl;
     }
 
     // if this seed was already claimed by some other seed during its growth, remove it and do nothing
@@ -694,7 +691,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
     std::vector<int> cluster_tower_ID;
     cluster_tower_ID.push_back(seed_ID);
 
-    std::vector<int> grow_tower_ID;
+    grow_tower_ID.clear();
     grow_tower_ID.push_back(seed_ID);
 
     // iteratively process growth towers, adding > 2 * sigma neighbors to the list for further checking
@@ -704,19 +701,16 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
       std::cout << " RawClusterBuilderTopo::process_event: Entering Growth stage for cluster " << cluster_index << std::endl;
     }
 
-    while (grow_tower_ID.size() > 0)
+    for (unsigned int igrow = 0; igrow < grow_tower_ID.size(); igrow++)
     {
-      int grow_ID = grow_tower_ID.at(0);
-      grow_tower_ID.erase(grow_tower_ID.begin());
+      int grow_ID = grow_tower_ID[igrow];
 
       if (Verbosity() > 5)
       {
-        std::cout << " --> cluster " << cluster_index << ", growth stage, examining neighbors of ID " << grow_ID << ", " << grow_tower_ID.size() << " grow towers left" << std::endl;
+        std::cout << " --> cluster " << cluster_index << ", growth stage, examining neighbors of ID " << grow_ID << ", " << grow_tower_ID.size() - igrow - 1 << " grow towers left" << std::endl;
       }
 
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(grow_ID);
-
-      for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+      for (int this_adjacent_tower_ID : get_adjacent_towers(grow_ID))
       {
         if (Verbosity() > 10)
         {
@@ -776,7 +770,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
 
       if (Verbosity() > 5)
       {
-        std::cout << " --> after examining neighbors, grow list is now " << grow_tower_ID.size() << ", # of towers in cluster = " << cluster_tower_ID.size() << std::endl;
+        std::cout << " --> after examining neighbors, grow list is now " << grow_tower_ID.size() - igrow - 1 << ", # of towers in cluster = " << cluster_tower_ID.size() << std::endl;
       }
     }
 
@@ -796,9 +790,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
       {
         std::cout << " --> cluster " << cluster_index << ", perimeter stage, examining neighbors of ID " << core_ID << ", core cluster # " << ic << " of " << n_core_towers << " total " << std::endl;
       }
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(core_ID);
-
-      for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+      for (int this_adjacent_tower_ID : get_adjacent_towers(core_ID))
       {
         if (Verbosity() > 10)
         {
@@ -870,7 +862,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
 
   for (int cl = 0; cl < original_cluster_index; cl++)
   {
-    std::vector<int> original_towers = all_cluster_towers.at(cl);
+    const std::vector<int> &original_towers = all_cluster_towers.at(cl);
 
     if (!_do_split)
     {
@@ -904,12 +896,11 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
       }
 
       // examine neighbors
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(tower_ID);
       int neighbors_in_cluster = 0;
 
       // check for higher neighbor
       bool has_higher_neighbor = false;
-      for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+      for (int this_adjacent_tower_ID : get_adjacent_towers(tower_ID))
       {
         if (get_status_from_ID(this_adjacent_tower_ID) != cl)
         {
@@ -1051,8 +1042,8 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
     // -1 means unseen
     // -2 means seen and in the seed list now (e.g. don't add it to the seed list again)
     // -3 shared tower, ignore going forward...
-    std::map<int, std::pair<int, int> > tower_ownership;
-    for (int &original_tower : original_towers)
+    std::vector<std::pair<int, int> > &tower_ownership = _TOWER_OWNERSHIP_ID;
+    for (const int &original_tower : original_towers)
     {
       tower_ownership[original_tower] = std::pair<int, int>(-1, -1);  // initialize all towers as un-seen
     }
@@ -1072,7 +1063,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
 
     if (Verbosity() > 100)
     {
-      for (int &original_tower : original_towers)
+      for (const int &original_tower : original_towers)
       {
         std::pair<int, int> the_pair = tower_ownership[original_tower];
         std::cout << " Debug Pre-Split: tower_ownership[ " << original_tower << " ] = ( " << the_pair.first << ", " << the_pair.second << " ) ";
@@ -1091,6 +1082,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
       }
       // go through neighbor list, assigning ownership only via the seed list
       std::vector<int> new_ownerships;
+      std::vector<bool> pseudocluster_adjacency;
 
       for (unsigned int n = 0; n < neighbor_list.size(); n++)
       {
@@ -1110,15 +1102,9 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         }
         else
         {
-          std::map<int, bool> pseudocluster_adjacency;
-          for (unsigned int s = 0; s < local_maxima_ID.size(); s++)
-          {
-            pseudocluster_adjacency[s] = false;
-          }
+          pseudocluster_adjacency.assign(local_maxima_ID.size(), false);
           // look over all towers THIS one is adjacent to, and count up...
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(neighbor_ID);
-
-          for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+          for (int this_adjacent_tower_ID : get_adjacent_towers(neighbor_ID))
           {
             if (get_status_from_ID(this_adjacent_tower_ID) != cl)
             {
@@ -1131,7 +1117,11 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
               {
                 std::cout << " -> -> -> adjacent tower to this one, with ID " << this_adjacent_tower_ID << " , is owned by pseudocluster " << tower_ownership[this_adjacent_tower_ID].first << std::endl;
               }
-              pseudocluster_adjacency[tower_ownership[this_adjacent_tower_ID].first] = true;
+              // 9999 flags a tower which could not be assigned (see below)
+              if (tower_ownership[this_adjacent_tower_ID].first < (int) pseudocluster_adjacency.size())
+              {
+                pseudocluster_adjacency[tower_ownership[this_adjacent_tower_ID].first] = true;
+              }
             }
           }
           int n_pseudocluster_adjacent = 0;
@@ -1206,15 +1196,13 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         std::cout << " producing a new neighbor list ... " << std::endl;
       }
       // populate a new neighbor list from the about-to-be-owned towers before transferring this one
-      std::list<int> new_neighbor_list;
+      std::vector<int> new_neighbor_list;
       for (unsigned int n = 0; n < neighbor_list.size(); n++)
       {
         int neighbor_ID = neighbor_list.at(n);
         if (new_ownerships.at(n) > -1)
         {
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(neighbor_ID);
-
-          for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+          for (int this_adjacent_tower_ID : get_adjacent_towers(neighbor_ID))
           {
             if (get_status_from_ID(this_adjacent_tower_ID) != cl)
             {
@@ -1237,23 +1225,16 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         std::cout << " new neighbor list has size " << new_neighbor_list.size() << ", but after removing duplicate elements: ";
       }
 
-      new_neighbor_list.sort();
-      new_neighbor_list.unique();
+      std::sort(new_neighbor_list.begin(), new_neighbor_list.end());
+      new_neighbor_list.erase(std::unique(new_neighbor_list.begin(), new_neighbor_list.end()), new_neighbor_list.end());
 
       if (Verbosity() > 5)
       {
         std::cout << new_neighbor_list.size() << std::endl;
       }
 
-      // clear neighbor list!
-      neighbor_list.clear();
-
       // now transfer over new neighbor list
-      for (; new_neighbor_list.size() > 0;)
-      {
-        neighbor_list.push_back(new_neighbor_list.front());
-        new_neighbor_list.pop_front();
-      }
+      neighbor_list.swap(new_neighbor_list);
 
       first_pass = false;
 
@@ -1261,7 +1242,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
 
     if (Verbosity() > 100)
     {
-      for (int &original_tower : original_towers)
+      for (const int &original_tower : original_towers)
       {
         std::pair<int, int> the_pair = tower_ownership[original_tower];
         std::cout << " Debug Mid-Split: tower_ownership[ " << original_tower << " ] = ( " << the_pair.first << ", " << the_pair.second << " ) ";
@@ -1269,9 +1250,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         std::cout << std::endl;
         if (the_pair.first == -1)
         {
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(original_tower);
-
-          for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+          for (int this_adjacent_tower_ID : get_adjacent_towers(original_tower))
           {
             if (get_status_from_ID(this_adjacent_tower_ID) != cl)
             {
@@ -1296,7 +1275,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
     pseudocluster_sumE.resize(local_maxima_ID.size(), 0);
     pseudocluster_ntower.resize(local_maxima_ID.size(), 0);
 
-    for (int &original_tower : original_towers)
+    for (const int &original_tower : original_towers)
     {
       std::pair<int, int> the_pair = tower_ownership[original_tower];
       if (the_pair.first > -1)
@@ -1328,23 +1307,20 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
       std::cout << "RawClusterBuilderTopo::process_event now splitting up shared clusters (including unassigned clusters), initial shared list has size " << shared_list.size() << std::endl;
     }
     // iterate through shared cells, identifying which two they belong to
-    while (shared_list.size() > 0)
+    std::vector<bool> pseudocluster_adjacency;
+    for (unsigned int ishared = 0; ishared < shared_list.size(); ishared++)
     {
-      // pick the first cell and pop off list
-      int shared_ID = shared_list.at(0);
-      shared_list.erase(shared_list.begin());
+      // pick the next cell, the list may grow while we walk through it
+      int shared_ID = shared_list[ishared];
 
       if (Verbosity() > 5)
       {
-        std::cout << " -> looking at shared tower " << shared_ID << ", after this one there are " << shared_list.size() << " shared towers left " << std::endl;
+        std::cout << " -> looking at shared tower " << shared_ID << ", after this one there are " << shared_list.size() - ishared - 1 << " shared towers left " << std::endl;
       }
       // look through adjacent pseudoclusters, taking two with highest energies
-      std::vector<bool> pseudocluster_adjacency;
-      pseudocluster_adjacency.resize(local_maxima_ID.size(), false);
+      pseudocluster_adjacency.assign(local_maxima_ID.size(), false);
 
-      std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(shared_ID);
-
-      for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+      for (int this_adjacent_tower_ID : get_adjacent_towers(shared_ID))
       {
         if (get_status_from_ID(this_adjacent_tower_ID) != cl)
         {
@@ -1410,7 +1386,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
 
     if (Verbosity() > 100)
     {
-      for (int &original_tower : original_towers)
+      for (const int &original_tower : original_towers)
       {
         std::pair<int, int> the_pair = tower_ownership[original_tower];
         std::cout << " Debug Post-Split: tower_ownership[ " << original_tower << " ] = ( " << the_pair.first << ", " << the_pair.second << " ) ";
@@ -1418,9 +1394,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
         std::cout << std::endl;
         if (the_pair.first == -1)
         {
-          std::vector<int> adjacent_tower_IDs = get_adjacent_towers_by_ID(original_tower);
-
-          for (int this_adjacent_tower_ID : adjacent_tower_IDs)
+          for (int this_adjacent_tower_ID : get_adjacent_towers(original_tower))
           {
             if (get_status_from_ID(this_adjacent_tower_ID) != cl)
             {
@@ -1433,7 +1407,7 @@ int RawClusterBuilderTopo::process_event(PHCompositeNode *topNode)
     }
 
     // call helper function
-    export_clusters(original_towers, tower_ownership, local_maxima_ID.size(), pseudocluster_sumE, pseudocluster_eta, pseudocluster_phi);
+    export_clusters(original_towers, local_maxima_ID.size(), pseudocluster_sumE, pseudocluster_eta, pseudocluster_phi);
   }
 
   if (Verbosity() > 1)
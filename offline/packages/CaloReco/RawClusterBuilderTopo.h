@@ -9,7 +9,6 @@
 
 #include <fun4all/SubsysReco.h>
 
-#include <map>
 #include <string>
 #include <utility>  // for pair
 #include <vector>
@@ -100,13 +99,34 @@ class RawClusterBuilderTopo : public SubsysReco
  private:
   void CreateNodes(PHCompositeNode *topNode);
 
-  std::vector<std::vector<std::vector<float> > > _TOWERMAP_E_LAYER_ETA_PHI;
-  std::vector<std::vector<std::vector<int> > > _TOWERMAP_KEY_LAYER_ETA_PHI;
-  std::vector<std::vector<std::vector<int> > > _TOWERMAP_STATUS_LAYER_ETA_PHI;
+  // tower maps of all three layers, indexed by tower ID (see get_ID)
+  std::vector<float> _TOWERMAP_E_ID;
+  std::vector<int> _TOWERMAP_KEY_ID;
+  std::vector<int> _TOWERMAP_STATUS_ID;
 
-  std::vector<std::vector<float> > _EMTOWERMAP_E_ETA_PHI;
-  std::vector<std::vector<int> > _EMTOWERMAP_KEY_ETA_PHI;
-  std::vector<std::vector<int> > _EMTOWERMAP_STATUS_ETA_PHI;
+  // ownership of the towers of the cluster which is split, indexed by tower ID
+  std::vector<std::pair<int, int> > _TOWER_OWNERSHIP_ID;
+
+  // neighbors of all towers (compressed rows), the neighbors of tower ID are
+  // _NEIGHBOR_LIST[_NEIGHBOR_OFFSET_ID[ID]] ... _NEIGHBOR_LIST[_NEIGHBOR_OFFSET_ID[ID + 1] - 1]
+  std::vector<int> _NEIGHBOR_OFFSET_ID;
+  std::vector<int> _NEIGHBOR_LIST;
+
+  class AdjacentTowers
+  {
+   public:
+    AdjacentTowers(const int *b, const int *e)
+      : _begin(b)
+      , _end(e)
+    {
+    }
+    const int *begin() const { return _begin; }
+    const int *end() const { return _end; }
+
+   private:
+    const int *_begin;
+    const int *_end;
+  };
 
   // geometric constants to express IHCal<->EMCal overlap in eta
   static int RawClusterBuilderTopo_constants_EMCal_eta_start_given_IHCal[];
@@ -135,11 +155,25 @@ class RawClusterBuilderTopo : public SubsysReco
 
   std::vector<int> get_adjacent_towers_by_ID(int ID);
 
+  // fills the neighbor table from get_adjacent_towers_by_ID, once the geometry is known
+  void build_neighbor_table();
+
+  AdjacentTowers get_adjacent_towers(int ID) const
+  {
+    return AdjacentTowers(_NEIGHBOR_LIST.data() + _NEIGHBOR_OFFSET_ID[ID], _NEIGHBOR_LIST.data() + _NEIGHBOR_OFFSET_ID[ID + 1]);
+  }
+
+  int get_n_ID() const
+  {
+    return 2 * _EMCAL_NPHI * _EMCAL_NETA;
+  }
+
   float calculate_dR(float, float, float, float);
 
   void export_single_cluster(const std::vector<int> &);
 
-  void export_clusters(const std::vector<int> &, std::map<int, std::pair<int, int> >, unsigned int, std::vector<float>, std::vector<float>, std::vector<float>);
+  // the ownership of the towers is taken from _TOWER_OWNERSHIP_ID
+  void export_clusters(const std::vector<int> &, unsigned int, const std::vector<float> &, const std::vector<float> &, const std::vector<float> &);
 
   int get_ID(int ilayer, int ieta, int iphi)
   {
@@ -186,34 +220,19 @@ class RawClusterBuilderTopo : public SubsysReco
     }
   }
 
-  int get_status_from_ID(int ID)
+  int get_status_from_ID(int ID) const
   {
-    if (ID < _EMCAL_NPHI * _EMCAL_NETA)
-    {
-      return _TOWERMAP_STATUS_LAYER_ETA_PHI[get_ilayer_from_ID(ID)][get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
-    }
-    return _EMTOWERMAP_STATUS_ETA_PHI[get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
+    return _TOWERMAP_STATUS_ID[ID];
   }
 
-  float get_E_from_ID(int ID)
+  float get_E_from_ID(int ID) const
   {
-    if (ID < _EMCAL_NPHI * _EMCAL_NETA)
-    {
-      return _TOWERMAP_E_LAYER_ETA_PHI[get_ilayer_from_ID(ID)][get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
-    }
-    return _EMTOWERMAP_E_ETA_PHI[get_ieta_from_ID(ID)][get_iphi_from_ID(ID)];
+    return _TOWERMAP_E_ID[ID];
   }
 
   void set_status_by_ID(int ID, int status)
   {
-    if (ID < _EMCAL_NPHI * _EMCAL_NETA)
-    {
-      _TOWERMAP_STATUS_LAYER_ETA_PHI[get_ilayer_from_ID(ID)][get_ieta_from_ID(ID)][get_iphi_from_ID(ID)] = status;
-    }
-    else
-    {
-      _EMTOWERMAP_STATUS_ETA_PHI[get_ieta_from_ID(ID)][get_iphi_from_ID(ID)] = status;
-    }
+    _TOWERMAP_STATUS_ID[ID] = status;
   }
 
   RawClusterContainer *_clusters = nullptr;
@@ -27,6 +27,8 @@
 
 #include <CLHEP/Vector/ThreeVector.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <map>
 #include <utility>
@@ -221,6 +223,14 @@ int ClusterIso::process_event(PHCompositeNode *topNode)
           }
         }
 
+        // tower tables for this vertex
+        if (m_use_tower_tables)
+        {
+          fillTowerTable(m_tableEM, towersEM3old, geomEM, RawTowerDefs::CalorimeterId::HCALIN, false);
+          fillTowerTable(m_tableIH, towersIH3, geomIH, RawTowerDefs::CalorimeterId::HCALIN, true);
+          fillTowerTable(m_tableOH, towersOH3, geomOH, RawTowerDefs::CalorimeterId::HCALOUT, true);
+        }
+
         for (rtiter = begin_end.first; rtiter != begin_end.second; ++rtiter)
         {
           RawCluster *cluster = rtiter->second;
@@ -239,78 +249,13 @@ int ClusterIso::process_event(PHCompositeNode *topNode)
           }  // skip if cluster is under eT cut
 
           // calculate EMCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersEM3old->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersEM3old->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersEM3old->encode_key(channel);
-              int ieta = towersEM3old->getTowerEtaBin(towerkey);
-              int iphi = towersEM3old->getTowerPhiBin(towerkey);
-
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALIN, ieta, iphi);
-
-              RawTowerGeom *tower_geom = geomEM->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = tower_geom->get_eta();
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
+          isoEt += getConeEt(m_tableEM, towersEM3old, geomEM, RawTowerDefs::CalorimeterId::HCALIN, false, cluster_eta, cluster_phi);
 
           // calculate Inner HCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersIH3->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersIH3->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersIH3->encode_key(channel);
-              int ieta = towersIH3->getTowerEtaBin(towerkey);
-              int iphi = towersIH3->getTowerPhiBin(towerkey);
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALIN, ieta, iphi);
-              RawTowerGeom *tower_geom = geomIH->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = getTowerEta(tower_geom, m_vx, m_vy, m_vz);
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
+          isoEt += getConeEt(m_tableIH, towersIH3, geomIH, RawTowerDefs::CalorimeterId::HCALIN, true, cluster_eta, cluster_phi);
 
           // calculate Outer HCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersOH3->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersOH3->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersOH3->encode_key(channel);
-              int ieta = towersOH3->getTowerEtaBin(towerkey);
-              int iphi = towersOH3->getTowerPhiBin(towerkey);
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALOUT, ieta, iphi);
-              RawTowerGeom *tower_geom = geomOH->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = getTowerEta(tower_geom, m_vx, m_vy, m_vz);
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
+          isoEt += getConeEt(m_tableOH, towersOH3, geomOH, RawTowerDefs::CalorimeterId::HCALOUT, true, cluster_eta, cluster_phi);
 
           isoEt -= et;  // Subtract cluster eT from isoET
           if (Verbosity() >= VERBOSITY_EVEN_MORE)
@@ -384,6 +329,14 @@ int ClusterIso::process_event(PHCompositeNode *topNode)
           }
         }
 
+        // tower tables for this vertex
+        if (m_use_tower_tables)
+        {
+          fillTowerTable(m_tableEM, towersEM3old, geomEM, RawTowerDefs::CalorimeterId::CEMC, true);
+          fillTowerTable(m_tableIH, towersIH3, geomIH, RawTowerDefs::CalorimeterId::HCALIN, true);
+          fillTowerTable(m_tableOH, towersOH3, geomOH, RawTowerDefs::CalorimeterId::HCALOUT, true);
+        }
+
         for (rtiter = begin_end.first; rtiter != begin_end.second; ++rtiter)
         {
           RawCluster *cluster = rtiter->second;
@@ -411,82 +364,19 @@ int ClusterIso::process_event(PHCompositeNode *topNode)
           }  // skip if cluster is below eT cut
 
           // calculate EMCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersEM3old->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersEM3old->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersEM3old->encode_key(channel);
-              int ieta = towersEM3old->getTowerEtaBin(towerkey);
-              int iphi = towersEM3old->getTowerPhiBin(towerkey);
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::CEMC, ieta, iphi);
-              RawTowerGeom *tower_geom = geomEM->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = getTowerEta(tower_geom, m_vx, m_vy, m_vz);
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
+          isoEt += getConeEt(m_tableEM, towersEM3old, geomEM, RawTowerDefs::CalorimeterId::CEMC, true, cluster_eta, cluster_phi);
           if (Verbosity() >= VERBOSITY_MAX)
           {
             std::cout << "\t after EMCal isoEt:" << isoEt << '\n';
           }
           // calculate Inner HCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersIH3->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersIH3->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersIH3->encode_key(channel);
-              int ieta = towersIH3->getTowerEtaBin(towerkey);
-              int iphi = towersIH3->getTowerPhiBin(towerkey);
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALIN, ieta, iphi);
-              RawTowerGeom *tower_geom = geomIH->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = getTowerEta(tower_geom, m_vx, m_vy, m_vz);
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
+          isoEt += getConeEt(m_tableIH, towersIH3, geomIH, RawTowerDefs::CalorimeterId::HCALIN, true, cluster_eta, cluster_phi);
           if (Verbosity() >= VERBOSITY_MAX)
           {
             std::cout << "\t after innerHCal isoEt:" << isoEt << '\n';
           }
           // calculate Outer HCal tower contribution to isolation energy
-          {
-            unsigned int ntowers = towersOH3->size();
-            for (unsigned int channel = 0; channel < ntowers; channel++)
-            {
-              TowerInfo *tower = towersOH3->get_tower_at_channel(channel);
-              if (!IsAcceptableTower(tower))
-              {
-                continue;
-              }
-              unsigned int towerkey = towersOH3->encode_key(channel);
-              int ieta = towersOH3->getTowerEtaBin(towerkey);
-              int iphi = towersOH3->getTowerPhiBin(towerkey);
-              const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(RawTowerDefs::CalorimeterId::HCALOUT, ieta, iphi);
-              RawTowerGeom *tower_geom = geomOH->get_tower_geometry(key);
-              double this_phi = tower_geom->get_phi();
-              double this_eta = getTowerEta(tower_geom, m_vx, m_vy, m_vz);
-              if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
-              {
-                isoEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
-              }
-            }
-          }
+          isoEt += getConeEt(m_tableOH, towersOH3, geomOH, RawTowerDefs::CalorimeterId::HCALOUT, true, cluster_eta, cluster_phi);
           if (Verbosity() >= VERBOSITY_MAX)
           {
             std::cout << "\t after outerHCal isoEt:" << isoEt << '\n';
@@ -508,6 +398,11 @@ int ClusterIso::process_event(PHCompositeNode *topNode)
 
 int ClusterIso::End(PHCompositeNode * /*topNode*/)
 {
+  if (m_validate_tower_tables && m_validate_ncones > 0)
+  {
+    std::cout << Name() << "::ClusterIso tower table validation: " << m_validate_nmismatch << " of " << m_validate_ncones
+              << " cones differ from the sum over all towers, largest difference " << m_validate_maxdiff << " GeV" << '\n';
+  }
   return 0;
 }
 
@@ -533,4 +428,214 @@ bool ClusterIso::IsAcceptableTower(TowerInfo *tower)
     return false;
   }
   return true;
-}
\ No newline at end of file
+}
+/**
+ * Fills the tower table of one calorimeter for the current vertex. The table is only
+ * used if every (ieta, iphi) of the grid has a tower.
+ */
+void ClusterIso::fillTowerTable(TowerTable &table, TowerInfoContainer *towers, RawTowerGeomContainer *geom, RawTowerDefs::CalorimeterId caloid, bool vertex_correction)
+{
+  table.neta = 0;
+  table.nphi = 0;
+  table.complete = false;
+  unsigned int ntowers = towers->size();
+  for (unsigned int channel = 0; channel < ntowers; channel++)
+  {
+    unsigned int towerkey = towers->encode_key(channel);
+    table.neta = std::max(table.neta, (int) towers->getTowerEtaBin(towerkey) + 1);
+    table.nphi = std::max(table.nphi, (int) towers->getTowerPhiBin(towerkey) + 1);
+  }
+  if (table.nphi < 2)
+  {
+    return;
+  }
+
+  const int ncells = table.neta * table.nphi;
+  table.eta.assign(ncells, 0);
+  table.phi.assign(ncells, 0);
+  table.et.assign(ncells, 0);
+  std::vector<bool> filled(ncells, false);
+  for (unsigned int channel = 0; channel < ntowers; channel++)
+  {
+    unsigned int towerkey = towers->encode_key(channel);
+    int ieta = towers->getTowerEtaBin(towerkey);
+    int iphi = towers->getTowerPhiBin(towerkey);
+    const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(caloid, ieta, iphi);
+    RawTowerGeom *tower_geom = geom->get_tower_geometry(key);
+    if (!tower_geom)
+    {
+      continue;
+    }
+    const int cell = ieta * table.nphi + iphi;
+    table.phi[cell] = tower_geom->get_phi();
+    table.eta[cell] = vertex_correction ? getTowerEta(tower_geom, m_vx, m_vy, m_vz) : tower_geom->get_eta();
+    filled[cell] = true;
+    TowerInfo *tower = towers->get_tower_at_channel(channel);
+    if (IsAcceptableTower(tower))
+    {
+      table.et[cell] = tower->get_energy() / cosh(table.eta[cell]);
+    }
+  }
+  if (std::find(filled.begin(), filled.end(), false) != filled.end())
+  {
+    if (Verbosity() >= VERBOSITY_SOME)
+    {
+      std::cout << Name() << "::ClusterIso tower grid of calorimeter " << caloid << " is not complete, summing over all towers" << '\n';
+    }
+    return;
+  }
+
+  const int rowsize = 2 * table.nphi + 1;
+  table.row_sum.assign(table.neta * rowsize, 0);
+  table.row_eta_min.assign(table.neta, 0);
+  table.row_eta_max.assign(table.neta, 0);
+  for (int ieta = 0; ieta < table.neta; ieta++)
+  {
+    double *row_sum = &table.row_sum[ieta * rowsize];
+    const double *row_et = &table.et[ieta * table.nphi];
+    for (int j = 0; j < 2 * table.nphi; j++)
+    {
+      row_sum[j + 1] = row_sum[j] + row_et[j % table.nphi];
+    }
+    const double *row_eta = &table.eta[ieta * table.nphi];
+    table.row_eta_min[ieta] = *std::min_element(row_eta, row_eta + table.nphi);
+    table.row_eta_max[ieta] = *std::max_element(row_eta, row_eta + table.nphi);
+  }
+  table.complete = true;
+}
+
+/**
+ * Returns the eT of the towers of one calorimeter within the cone around the cluster,
+ * from the tower table if it can be used
+ */
+double ClusterIso::getConeEt(TowerTable &table, TowerInfoContainer *towers, RawTowerGeomContainer *geom, RawTowerDefs::CalorimeterId caloid, bool vertex_correction, double cluster_eta, double cluster_phi)
+{
+  if (!m_use_tower_tables || !table.complete)
+  {
+    return getConeEtAllTowers(towers, geom, caloid, vertex_correction, cluster_eta, cluster_phi);
+  }
+  double coneEt = getConeEtTable(table, cluster_eta, cluster_phi);
+  if (m_validate_tower_tables)
+  {
+    double allEt = getConeEtAllTowers(towers, geom, caloid, vertex_correction, cluster_eta, cluster_phi);
+    double diff = std::fabs(coneEt - allEt);
+    m_validate_ncones++;
+    m_validate_maxdiff = std::max(m_validate_maxdiff, diff);
+    if (diff > 1e-6 * std::max(1., std::fabs(allEt)))
+    {
+      m_validate_nmismatch++;
+      if (Verbosity() >= VERBOSITY_SOME)
+      {
+        std::cout << Name() << "::ClusterIso cone eT of calorimeter " << caloid << " at eta " << cluster_eta << " phi " << cluster_phi
+                  << ": " << coneEt << " from the tower table, " << allEt << " from all towers" << '\n';
+      }
+    }
+  }
+  return coneEt;
+}
+
+/**
+ * Cone sum from the tower table. In each eta row the towers within the cone are one
+ * range in phi: its edges are estimated from the circle, moved tower by tower until
+ * they agree with deltaR(), and the eT of the range is the difference of two row sums.
+ * The cost goes with the number of rows in the cone, not with the number of towers.
+ */
+double ClusterIso::getConeEtTable(const TowerTable &table, double cluster_eta, double cluster_phi) const
+{
+  const int nphi = table.nphi;
+  double coneEt = 0;
+  for (int ieta = 0; ieta < table.neta; ieta++)
+  {
+    // rows which are clearly outside of the cone
+    if (cluster_eta < table.row_eta_min[ieta] - m_coneSize - 0.01 || cluster_eta > table.row_eta_max[ieta] + m_coneSize + 0.01)
+    {
+      continue;
+    }
+    const double *row_eta = &table.eta[ieta * nphi];
+    const double *row_phi = &table.phi[ieta * nphi];
+    auto inCone = [&](int iphi)
+    {
+      iphi = ((iphi % nphi) + nphi) % nphi;
+      return deltaR(cluster_eta, row_eta[iphi], cluster_phi, row_phi[iphi]) < m_coneSize;
+    };
+
+    // tower closest in phi and the number of towers to the edge of the circle
+    double step = row_phi[1] - row_phi[0];
+    step -= 2 * M_PI * std::round(step / (2 * M_PI));
+    double dphi = cluster_phi - row_phi[0];
+    dphi -= 2 * M_PI * std::round(dphi / (2 * M_PI));
+    const int center = ((int) std::lround(dphi / step) % nphi + nphi) % nphi;
+    const double deta = cluster_eta - 0.5 * (table.row_eta_min[ieta] + table.row_eta_max[ieta]);
+    const int half_width = std::min((nphi - 1) / 2, (int) (std::sqrt(std::max(0., m_coneSize * m_coneSize - deta * deta)) / std::fabs(step)));
+
+    int lo = center - half_width;
+    int hi = center + half_width;
+    while (lo <= hi && !inCone(lo))
+    {
+      lo++;
+    }
+    while (hi >= lo && !inCone(hi))
+    {
+      hi--;
+    }
+    if (lo > hi)
+    {
+      // a row at the edge of the cone, the tower eta changes a little along phi with a
+      // transverse vertex offset so the tower in the cone can be the neighbor of the closest one
+      if (inCone(center - 1))
+      {
+        lo = hi = center - 1;
+      }
+      else if (inCone(center + 1))
+      {
+        lo = hi = center + 1;
+      }
+      else
+      {
+        continue;
+      }
+    }
+    while (hi - lo + 1 < nphi && inCone(hi + 1))
+    {
+      hi++;
+    }
+    while (hi - lo + 1 < nphi && inCone(lo - 1))
+    {
+      lo--;
+    }
+
+    const double *row_sum = &table.row_sum[ieta * (2 * nphi + 1)];
+    const int first = ((lo % nphi) + nphi) % nphi;
+    coneEt += row_sum[first + hi - lo + 1] - row_sum[first];
+  }
+  return coneEt;
+}
+
+/**
+ * Cone sum over all towers of one calorimeter
+ */
+double ClusterIso::getConeEtAllTowers(TowerInfoContainer *towers, RawTowerGeomContainer *geom, RawTowerDefs::CalorimeterId caloid, bool vertex_correction, double cluster_eta, double cluster_phi)
+{
+  double coneEt = 0;
+  unsigned int ntowers = towers->size();
+  for (unsigned int channel = 0; channel < ntowers; channel++)
+  {
+    TowerInfo *tower = towers->get_tower_at_channel(channel);
+    if (!IsAcceptableTower(tower))
+    {
+      continue;
+    }
+    unsigned int towerkey = towers->encode_key(channel);
+    int ieta = towers->getTowerEtaBin(towerkey);
+    int iphi = towers->getTowerPhiBin(towerkey);
+    const RawTowerDefs::keytype key = RawTowerDefs::encode_towerid(caloid, ieta, iphi);
+    RawTowerGeom *tower_geom = geom->get_tower_geometry(key);
+    double this_phi = tower_geom->get_phi();
+    double this_eta = vertex_correction ? getTowerEta(tower_geom, m_vx, m_vy, m_vz) : tower_geom->get_eta();
+    if (deltaR(cluster_eta, this_eta, cluster_phi, this_phi) < m_coneSize)
+    {
+      coneEt += tower->get_energy() / cosh(this_eta);  // if tower is in cone, add energy
+    }
+  }
+  return coneEt;
+}
@@ -4,14 +4,19 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <calobase/RawTowerDefs.h>
+
 #include <CLHEP/Vector/ThreeVector.h>
 
 #include <cmath>
 #include <string>
+#include <vector>
 
 class PHCompositeNode;
 class RawTowerGeom;
+class RawTowerGeomContainer;
 class TowerInfo;
+class TowerInfoContainer;
 
 /** \Brief Tool to find isolation energy of each EMCal cluster.
  *
@@ -49,9 +54,50 @@ class ClusterIso : public SubsysReco
     m_cluster_node_name = name;
   }
 
+  /**
+   * Sum the cone from tables of the tower eT which are filled once per event (default)
+   * instead of testing every tower of the calorimeters for every cluster
+   */
+  void set_use_tower_tables(bool b)
+  {
+    m_use_tower_tables = b;
+  }
+
+  /**
+   * Also sum every cone over all towers and compare to the table sum, the number of
+   * differences is printed at End()
+   */
+  void set_validate_tower_tables(bool b)
+  {
+    m_validate_tower_tables = b;
+  }
+
  private:
+  /** \Brief Towers of one calorimeter on the (ieta, iphi) grid
+   *
+   * Holds the tower eta for the event vertex, the tower phi and the eT of the acceptable
+   * towers, and for every eta row the running sum of the eT over phi (two turns, so
+   * a phi range across the wrap is one difference).
+   */
+  struct TowerTable
+  {
+    int neta{0};
+    int nphi{0};
+    bool complete{false};           ///< every (ieta, iphi) has a tower, otherwise all towers are used
+    std::vector<double> eta;        ///< [ieta * nphi + iphi]
+    std::vector<double> phi;        ///< [ieta * nphi + iphi]
+    std::vector<double> et;         ///< [ieta * nphi + iphi], 0 for towers which are not acceptable
+    std::vector<double> row_sum;    ///< [ieta * (2 * nphi + 1) + j], eT sum of the first j towers of the row
+    std::vector<double> row_eta_min;
+    std::vector<double> row_eta_max;
+  };
+
   double getTowerEta(RawTowerGeom* tower_geom, double vx, double vy, double vz);
   bool IsAcceptableTower(TowerInfo* tower);
+  void fillTowerTable(TowerTable& table, TowerInfoContainer* towers, RawTowerGeomContainer* geom, RawTowerDefs::CalorimeterId caloid, bool vertex_correction);
+  double getConeEt(TowerTable& table, TowerInfoContainer* towers, RawTowerGeomContainer* geom, RawTowerDefs::CalorimeterId caloid, bool vertex_correction, double cluster_eta, double cluster_phi);
+  double getConeEtTable(const TowerTable& table, double cluster_eta, double cluster_phi) const;
+  double getConeEtAllTowers(TowerInfoContainer* towers, RawTowerGeomContainer* geom, RawTowerDefs::CalorimeterId caloid, bool vertex_correction, double cluster_eta, double cluster_phi);
   float m_eTCut{};     ///< The minimum required transverse energy in a cluster for ClusterIso to be run
   float m_coneSize{};  ///< Size of the cone used to isolate a given cluster
   float m_vx;          ///< Correct vertex x coordinate
@@ -61,6 +107,14 @@ class ClusterIso : public SubsysReco
   bool m_do_unsubtracted;
   bool m_use_towerinfo = true;
   std::string m_cluster_node_name = "CLUSTERINFO_CEMC";
+  bool m_use_tower_tables = true;
+  bool m_validate_tower_tables = false;
+  TowerTable m_tableEM;
+  TowerTable m_tableIH;
+  TowerTable m_tableOH;
+  unsigned long m_validate_ncones = 0;
+  unsigned long m_validate_nmismatch = 0;
+  double m_validate_maxdiff = 0;
 };
 
 /** \Brief Function to find delta R between 2 objects
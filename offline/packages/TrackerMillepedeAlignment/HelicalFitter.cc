@@ -42,12 +42,19 @@
 #include <TFile.h>
 #include <TNtuple.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <climits>   // for UINT_MAX
 #include <cmath>     // for fabs, sqrt
+#include <fstream>
+#include <functional>
 #include <iostream>  // for operator<<, basic_ostream
 #include <memory>
 #include <set>      // for _Rb_tree_const_iterator
+#include <thread>
 #include <utility>  // for pair
+#include <vector>
 
 using namespace std;
 
@@ -55,11 +62,137 @@ using namespace std;
 // Global chi^2 approach to the Alignment of the ATLAS Silicon Tracking Detectors
 // ATL-INDET-PUB-2005-002, 11 October 2005
 
+namespace
+{
+  // calls func(ithread, ijob) for ijob = 0 ... njobs-1, the jobs are handed out to the threads one by one
+  void run_jobs(const unsigned int nthreads, const unsigned int njobs, const std::function<void(unsigned int, unsigned int)>& func)
+  {
+    std::atomic<unsigned int> next{0};
+    auto worker = [&](const unsigned int ithread)
+    {
+      for (unsigned int i = next++; i < njobs; i = next++)
+      {
+        func(ithread, i);
+      }
+    };
+    const unsigned int nworkers = std::min(nthreads, njobs);
+    if (nworkers <= 1)
+    {
+      worker(0);
+      return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(nworkers - 1);
+    for (unsigned int i = 1; i < nworkers; i++)
+    {
+      threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+  }
+}  // namespace
+
+// one accepted track, everything from the fit to the mille record
+struct HelicalFitter::TrackRecord
+{
+  // arguments of one Mille::mille call
+  struct Measurement
+  {
+    float lcl_derivative[AlignmentDefs::NLC]{};
+    float glbl_derivative[AlignmentDefs::NGL]{};
+    int glbl_label[AlignmentDefs::NGL]{};
+    float residual{0};
+    float sigma{0};
+  };
+
+  unsigned int trackid{0};  // index of the accepted track in the event
+  unsigned int nsilicon{0};
+  unsigned int ntpc{0};
+  // which of the event wide nsilicon/ntpc/nclus counters of the serial seed loop this seed set
+  bool set_nsilicon{false};
+  bool set_ntpc{false};
+  bool set_nclus{false};
+  std::vector<Acts::Vector3> global_vec;
+  std::vector<TrkrDefs::cluskey> cluskey_vec;
+  std::vector<float> fitpars;
+  Acts::Vector3 track_vtx{0, 0, 0};
+  Acts::Vector3 event_vtx{0, 0, 0};
+  TrackSeed_v2 someseed;
+  SvtxTrack_v4 newTrack;
+  SvtxAlignmentStateMap::StateVec statevec;
+  std::vector<Measurement> measurements;
+
+  // ntuple rows, the ideal geometry columns of ntp are filled from the surface and
+  // the cluster local position after the threads are done (use_alignment is global)
+  std::vector<std::vector<float>> ntp_rows;
+  std::vector<std::pair<Surface, Acts::Vector3>> ntp_ideal_input;
+  std::vector<float> track_ntp_row;
+};
+
+// Buffers for the derivatives of the clusters of one track, one per thread.
+// The sensor frame and the best fit intersection are stored per cluster, the kernels
+// then loop over all clusters for each parameter variation
+struct HelicalFitter::DerivativeWorkspace
+{
+  unsigned int size() const { return global.size(); }
+
+  void clear()
+  {
+    global.clear();
+    fitpoint.clear();
+    sensorCenter.clear();
+    sensorNormal.clear();
+    projX.clear();
+    projY.clear();
+    layer.clear();
+  }
+
+  void add(const Acts::Vector3& glob, const Acts::Vector3& fitp, const Acts::Vector3& center, const Acts::Vector3& normal, const unsigned int lyr)
+  {
+    global.push_back(glob);
+    fitpoint.push_back(fitp);
+    sensorCenter.push_back(center);
+    sensorNormal.push_back(normal);
+    projX.emplace_back(0, 0, 0);
+    projY.emplace_back(0, 0, 0);
+    layer.push_back(lyr);
+  }
+
+  // resize the outputs (and the intersection shifts) to the number of clusters
+  void resize()
+  {
+    delta[0].resize(size());
+    delta[1].resize(size());
+    lcl_derivativeX.assign(size() * AlignmentDefs::NLC, 0.);
+    lcl_derivativeY.assign(size() * AlignmentDefs::NLC, 0.);
+    glbl_derivativeX.assign(size() * AlignmentDefs::NGL, 0.);
+    glbl_derivativeY.assign(size() * AlignmentDefs::NGL, 0.);
+  }
+
+  std::vector<Acts::Vector3> global;
+  std::vector<Acts::Vector3> fitpoint;      // intersection of the best fit with the sensor plane
+  std::vector<Acts::Vector3> sensorCenter;  // mm
+  std::vector<Acts::Vector3> sensorNormal;  // unit vector
+  std::vector<Acts::Vector3> projX;
+  std::vector<Acts::Vector3> projY;
+  std::vector<unsigned int> layer;
+
+  std::vector<Acts::Vector3> delta[2];  // intersection shift for +-delta of one parameter
+
+  // NLC/NGL values per cluster
+  std::vector<float> lcl_derivativeX;
+  std::vector<float> lcl_derivativeY;
+  std::vector<float> glbl_derivativeX;
+  std::vector<float> glbl_derivativeY;
+};
+
 //____________________________________________________________________________..
 HelicalFitter::HelicalFitter(const std::string& name)
   : SubsysReco(name)
   , PHParameterInterface(name)
-  , _mille(nullptr)
 {
   InitializeParameters();
 
@@ -87,20 +220,42 @@ int HelicalFitter::InitRun(PHCompositeNode* topNode)
     return ret;
   }
 
-  // Instantiate Mille and open output data file
-  if (test_output)
+  if (nthreads == 0)
   {
-    _mille = new Mille(data_outfilename.c_str(), false);  // write text in data files, rather than binary, for debugging only
+    nthreads = std::max(std::thread::hardware_concurrency(), 1U);
   }
-  else
+
+  // Instantiate Mille and open output data file, one per thread (shard).
+  // The writers and the steering file are created on the first run only, later
+  // runs keep writing to the same data files
+  if (_mille.empty())
   {
-    _mille = new Mille(data_outfilename.c_str());
-  }
+    for (unsigned int shard = 0; shard < nthreads; ++shard)
+    {
+      if (test_output)
+      {
+        _mille.push_back(new Mille(shardFileName(shard).c_str(), false));  // write text in data files, rather than binary, for debugging only
+      }
+      else
+      {
+        _mille.push_back(new Mille(shardFileName(shard).c_str()));
+      }
+    }
 
-  // Write the steering file here, and add the data file path to it
-  std::ofstream steering_file(steering_outfilename);
-  steering_file << data_outfilename << std::endl;
-  steering_file.close();
+    // Write the steering file here, and add the data file paths to it (in shard order)
+    std::ofstream steering_file(steering_outfilename);
+    for (unsigned int shard = 0; shard < nthreads; ++shard)
+    {
+      steering_file << shardFileName(shard) << std::endl;
+    }
+    steering_file.close();
+  }
+  else if (nthreads != _mille.size())
+  {
+    std::cout << PHWHERE << " the number of threads can not change between runs, keeping "
+              << _mille.size() << " threads for the " << _mille.size() << " open data files" << std::endl;
+    nthreads = _mille.size();
+  }
 
   if (make_ntuple)
   {
@@ -157,6 +312,21 @@ void HelicalFitter::SetDefaultParameters()
   return;
 }
 
+std::string HelicalFitter::shardFileName(unsigned int shard) const
+{
+  if (nthreads <= 1)
+  {
+    return data_outfilename;
+  }
+  // insert _shard<n> before the extension
+  std::string::size_type pos = data_outfilename.rfind('.');
+  if (pos == std::string::npos || pos < data_outfilename.rfind('/') + 1)
+  {
+    pos = data_outfilename.size();
+  }
+  return data_outfilename.substr(0, pos) + "_shard" + std::to_string(shard) + data_outfilename.substr(pos);
+}
+
 //____________________________________________________________________________..
 int HelicalFitter::process_event(PHCompositeNode* /*unused*/)
 {
@@ -195,16 +365,6 @@ int HelicalFitter::process_event(PHCompositeNode* /*unused*/)
 
   // Decide whether we want to make a helical fit for silicon or TPC
   unsigned int maxtracks = 0;
-  unsigned int nsilicon = 0;
-  unsigned int ntpc = 0;
-  unsigned int nclus = 0;
-  std::vector<std::vector<Acts::Vector3>> cumulative_global_vec;
-  std::vector<std::vector<TrkrDefs::cluskey>> cumulative_cluskey_vec;
-  std::vector<std::vector<float>> cumulative_fitpars_vec;
-  std::vector<Acts::Vector3> cumulative_vertex;
-  std::vector<TrackSeed> cumulative_someseed;
-  std::vector<SvtxTrack_v4> cumulative_newTrack;
-
   if (fittpc && _track_map_tpc != nullptr)
   {
     maxtracks = _track_map_tpc->size();
@@ -213,765 +373,939 @@ int HelicalFitter::process_event(PHCompositeNode* /*unused*/)
   {
     maxtracks = _track_map_silicon->size();
   }
-  for (unsigned int trackid = 0; trackid < maxtracks; ++trackid)
+
+  // fit all tracklets, the accepted ones are kept in the order of the seed container
+  std::vector<TrackRecord> fitted(maxtracks);
+  std::vector<char> accepted(maxtracks, 0);
+  run_jobs(nthreads, maxtracks, [&](unsigned int /*ithread*/, unsigned int trackid)
+           { accepted[trackid] = fitTracklet(trackid, fitted[trackid]); });
+
+  // the nsilicon/ntpc/nclus ntuple columns are event wide counters, they keep the
+  // values set by the last seed which got that far, accepted or not
+  unsigned int nsilicon = 0;
+  unsigned int ntpc = 0;
+  unsigned int nclus = 0;
+  for (const auto& rec : fitted)
   {
-    TrackSeed* tracklet = nullptr;
-    if (fitsilicon && _track_map_silicon != nullptr)
+    if (rec.set_nsilicon)
     {
-      tracklet = _track_map_silicon->get(trackid);
+      nsilicon = rec.nsilicon;
     }
-    else if (fittpc && _track_map_tpc != nullptr)
+    if (rec.set_ntpc)
     {
-      tracklet = _track_map_tpc->get(trackid);
+      ntpc = rec.ntpc;
     }
-    if (!tracklet)
+    if (rec.set_nclus)
     {
-      continue;
+      nclus = ntpc + nsilicon;
+    }
+  }
+
+  std::vector<TrackRecord> tracks;
+  for (unsigned int trackid = 0; trackid < maxtracks; ++trackid)
+  {
+    if (accepted[trackid])
+    {
+      tracks.push_back(std::move(fitted[trackid]));
+      tracks.back().trackid = tracks.size() - 1;
     }
+  }
+  fitted.clear();
+
+  // terminate loop over tracks
+  // Collect fitpars for each track by intializing array of size maxtracks and populaating thorughout the loop
+  // Then start new loop over tracks and for each track go over clsutaer
+  //  make vector of global_vecs
+  float xsum = 0;
+  float ysum = 0;
+  float zsum = 0;
+  unsigned int accepted_tracks = tracks.size();
 
-    std::vector<Acts::Vector3> global_vec;
-    std::vector<TrkrDefs::cluskey> cluskey_vec;
+  for (unsigned int trackid = 0; trackid < accepted_tracks; ++trackid)
+  {
+    xsum += tracks[trackid].track_vtx[0];
+    ysum += tracks[trackid].track_vtx[1];
+    zsum += tracks[trackid].track_vtx[2];
+  }
+  Acts::Vector3 averageVertex(xsum / accepted_tracks, ysum / accepted_tracks, zsum / accepted_tracks);
+
+  // get the residuals and derivatives for all clusters, one workspace per thread
+  std::vector<DerivativeWorkspace> workspaces(nthreads);
+  run_jobs(nthreads, accepted_tracks, [&](unsigned int ithread, unsigned int trackid)
+           { processTrackClusters(tracks[trackid], workspaces[ithread]); });
 
-    // Get a vector of cluster keys from the tracklet
-    getTrackletClusterList(tracklet, cluskey_vec);
-    if(cluskey_vec.size() < 3)
+  // the node and ntuple output is filled in track order
+  if (make_ntuple)
+  {
+    // get the local parameters using the ideal transforms
+    alignmentTransformationContainer::use_alignment = false;
+    for (auto& rec : tracks)
+    {
+      for (unsigned int irow = 0; irow < rec.ntp_rows.size(); ++irow)
       {
-	continue;
+        const Surface& surf = rec.ntp_ideal_input[irow].first;
+        Acts::Vector3 ideal_center = surf->center(_tGeometry->geometry().getGeoContext()) * 0.1;
+        Acts::Vector3 ideal_norm = -surf->normal(_tGeometry->geometry().getGeoContext());
+        Acts::Vector3 ideal_local = rec.ntp_ideal_input[irow].second;  // cm
+        Acts::Vector3 ideal_glob = surf->transform(_tGeometry->geometry().getGeoContext()) * (ideal_local * Acts::UnitConstants::cm);
+        ideal_glob /= Acts::UnitConstants::cm;
+
+        std::vector<float>& ntp_data = rec.ntp_rows[irow];
+        ntp_data[3] = nsilicon;
+        ntp_data[4] = ntpc;
+        ntp_data[5] = nclus;
+        for (int i = 0; i < 3; ++i)
+        {
+          ntp_data[23 + i] = ideal_center(i);
+          ntp_data[26 + i] = ideal_norm(i);
+          ntp_data[29 + i] = ideal_glob(i);
+        }
+        ntp->Fill(ntp_data.data());
+
+        if (Verbosity() > 2 && !straight_line_fit)
+        {
+          for (auto& i : ntp_data)
+          {
+            std::cout << i << "  ";
+          }
+          std::cout << std::endl;
+        }
+      }
+    }
+    alignmentTransformationContainer::use_alignment = true;
+  }
+
+  for (unsigned int trackid = 0; trackid < accepted_tracks; ++trackid)
+  {
+    auto& rec = tracks[trackid];
+    m_alignmentmap->insertWithKey(trackid, rec.statevec);
+    m_trackmap->insertWithKey(&rec.newTrack, trackid);
+
+    // calculate vertex residual with perigee surface
+    //-------------------------------------------------------
+
+    Acts::Vector3 event_vtx(averageVertex(0), averageVertex(1), averageVertex(2));
+
+    for (const auto &[vtxkey, vertex] : *m_vertexmap)
+      {
+	for (auto trackiter = vertex->begin_tracks(); trackiter != vertex->end_tracks(); ++trackiter)
+	  {
+	    SvtxTrack *vtxtrack = m_trackmap->get(*trackiter);
+	    if (vtxtrack)
+	      {
+		unsigned int vtxtrackid = vtxtrack->get_id();
+		if(trackid == vtxtrackid)
+		  {
+		    event_vtx(0) = vertex->get_x();
+		    event_vtx(1) = vertex->get_y();
+		    event_vtx(2) = vertex->get_z();
+		    if(Verbosity() > 0)
+		      {
+			std::cout << "     setting event_vertex for trackid " << trackid << " to vtxid " << vtxkey
+				  << " vtx " << event_vtx(0) << "  " << event_vtx(1) << "  " << event_vtx(2) << std::endl;
+		      }
+		  }
+	      }
+	  }
       }
-    int nintt = 0;
-    for (auto& key : cluskey_vec)
+    rec.event_vtx = event_vtx;
+  }
+
+  // Every shard writes the records of a contiguous block of tracks, the content of
+  // the data files only depends on the number of shards, not on the thread scheduling.
+  // Without the vertex constraint (< 3 tracks) the records are not closed, these
+  // events go to the first shard which continues the open record like the serial writer.
+  // There are never more shards than tracks, so the first shard always gets a track
+  // and closes that open record
+  const unsigned int nshards = (accepted_tracks < 3) ? 1 : std::min(nthreads, accepted_tracks);
+  run_jobs(nshards, nshards, [&](unsigned int /*ithread*/, unsigned int shard)
+           {
+             const unsigned int first = shard * accepted_tracks / nshards;
+             const unsigned int last = (shard + 1) * accepted_tracks / nshards;
+             for (unsigned int trackid = first; trackid < last; ++trackid)
+             {
+               writeTrackRecord(tracks[trackid], _mille[shard], accepted_tracks);
+             }
+           });
+
+  if (make_ntuple)
+  {
+    for (auto& rec : tracks)
     {
-      if(TrkrDefs::getTrkrId(key) == TrkrDefs::inttId)
+      if (!rec.track_ntp_row.empty())
       {
-        nintt++;
+        track_ntp->Fill(rec.track_ntp_row.data());
       }
     }
+  }
+
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+bool HelicalFitter::fitTracklet(unsigned int trackid, TrackRecord& rec)
+{
+  TrackSeed* tracklet = nullptr;
+  if (fitsilicon && _track_map_silicon != nullptr)
+  {
+    tracklet = _track_map_silicon->get(trackid);
+  }
+  else if (fittpc && _track_map_tpc != nullptr)
+  {
+    tracklet = _track_map_tpc->get(trackid);
+  }
+  if (!tracklet)
+  {
+    return false;
+  }
+
+  std::vector<Acts::Vector3>& global_vec = rec.global_vec;
+  std::vector<TrkrDefs::cluskey>& cluskey_vec = rec.cluskey_vec;
 
-    // store cluster global positions in a vector global_vec and cluskey_vec
+  // Get a vector of cluster keys from the tracklet
+  getTrackletClusterList(tracklet, cluskey_vec);
+  if(cluskey_vec.size() < 3)
+    {
+      return false;
+    }
+  int nintt = 0;
+  for (auto& key : cluskey_vec)
+  {
+    if(TrkrDefs::getTrkrId(key) == TrkrDefs::inttId)
+    {
+      nintt++;
+    }
+  }
+
+  // store cluster global positions in a vector global_vec and cluskey_vec
+
+  TrackFitUtils::getTrackletClusters(_tGeometry, _cluster_map, global_vec, cluskey_vec);
+
+  correctTpcGlobalPositions(global_vec, cluskey_vec);
+
+  std::vector<float>& fitpars = rec.fitpars;
+  if(straight_line_fit)
+    {
+      fitpars = TrackFitUtils::fitClustersZeroField(global_vec, cluskey_vec, use_intt_zfit);
+
+      if (fitpars.size() == 0)
+	{
+	  return false;  // discard this track, not enough clusters to fit
+	}
+
+      if (Verbosity() > 1)
+	{
+	  std::cout << " Track " << trackid << " xy slope " << fitpars[0] << " y intercept " << fitpars[1]
+		    << " zslope " << fitpars[2] << " Z0 " << fitpars[3] << std::endl;
+	}
+    }
+  else
+    {
+      if(fitsilicon && nintt<2)
+	{
+	  return false;   // discard incomplete seeds
+	}
 
-    TrackFitUtils::getTrackletClusters(_tGeometry, _cluster_map, global_vec, cluskey_vec);
-     
-    correctTpcGlobalPositions(global_vec, cluskey_vec);
+      fitpars = TrackFitUtils::fitClusters(global_vec, cluskey_vec);  // do helical fit
 
- 
-    std::vector<float> fitpars;
+      if (fitpars.size() == 0)
+	{
+	  return false;  // discard this track, not enough clusters to fit
+	}
+
+      if (Verbosity() > 1)
+	{
+	  std::cout << " Track " << trackid << " radius " << fitpars[0] << " X0 " << fitpars[1] << " Y0 " << fitpars[2]
+		    << " zslope " << fitpars[3] << " Z0 " << fitpars[4] << std::endl;
+	}
+    }
+
+  //// Create a track map for diagnostics
+  SvtxTrack_v4& newTrack = rec.newTrack;
+  newTrack.set_id(trackid);
+  if (fitsilicon)
+  {
+    newTrack.set_silicon_seed(tracklet);
+  }
+  else if (fittpc)
+  {
+    newTrack.set_tpc_seed(tracklet);
+  }
+
+  unsigned int& nsilicon = rec.nsilicon;
+  unsigned int& ntpc = rec.ntpc;
+
+  // if a full track is requested, get the silicon clusters too and refit
+  if (fittpc && fitfulltrack)
+  {
+    // this associates silicon clusters and adds them to the vectors
+    ntpc = cluskey_vec.size();
+    rec.set_ntpc = true;
+
+    if(straight_line_fit)
+      {
+	std::tuple<double, double> linefit_xy(fitpars[0], fitpars[1]);
+	nsilicon = TrackFitUtils::addClustersOnLine(linefit_xy, true, dca_cut, _tGeometry, _cluster_map, global_vec, cluskey_vec, 0, 6);
+      }
+    else
+      {
+	nsilicon = TrackFitUtils::addClusters(fitpars, dca_cut, _tGeometry, _cluster_map, global_vec, cluskey_vec, 0, 6);
+      }
+    rec.set_nsilicon = true;
+
+    if (nsilicon < 5)
+    {
+      return false;  // discard this TPC seed, did not get a good match to silicon
+    }
+    auto trackseed = std::make_unique<TrackSeed_v2>();
+    for (auto& ckey : cluskey_vec)
+    {
+      if (TrkrDefs::getTrkrId(ckey) == TrkrDefs::TrkrId::mvtxId or
+          TrkrDefs::getTrkrId(ckey) == TrkrDefs::TrkrId::inttId)
+      {
+        trackseed->insert_cluster_key(ckey);
+      }
+    }
+
+    newTrack.set_silicon_seed(trackseed.get());
+
+    // fit the full track now
+    fitpars.clear();
     if(straight_line_fit)
       {
 	fitpars = TrackFitUtils::fitClustersZeroField(global_vec, cluskey_vec, use_intt_zfit);
 
 	if (fitpars.size() == 0)
 	  {
-	    continue;  // discard this track, not enough clusters to fit
+	    return false;  // discard this track, not enough clusters to fit
 	  }
 
 	if (Verbosity() > 1)
 	  {
-	    std::cout << " Track " << trackid << " xy slope " << fitpars[0] << " y intercept " << fitpars[1] 
-		      << " zslope " << fitpars[2] << " Z0 " << fitpars[3] << std::endl;
+	    std::cout << " Track " << trackid << " dy/dx " << fitpars[0] << " y intercept " << fitpars[1]
+		      << " dx/dz " << fitpars[2] << " Z0 " << fitpars[3] << std::endl;
 	  }
       }
     else
       {
-	if(fitsilicon && nintt<2)
-	  {
-	    continue;   // discard incomplete seeds
-	  }
+	fitpars = TrackFitUtils::fitClusters(global_vec, cluskey_vec, use_intt_zfit);  // do helical fit
 
-	fitpars = TrackFitUtils::fitClusters(global_vec, cluskey_vec);  // do helical fit
-      
 	if (fitpars.size() == 0)
 	  {
-	    continue;  // discard this track, not enough clusters to fit
+	    return false;  // discard this track, fit failed
 	  }
 
 	if (Verbosity() > 1)
 	  {
-	    std::cout << " Track " << trackid << " radius " << fitpars[0] << " X0 " << fitpars[1] << " Y0 " << fitpars[2]
+	    std::cout << " Full track " << trackid << " radius " << fitpars[0] << " X0 " << fitpars[1] << " Y0 " << fitpars[2]
 		      << " zslope " << fitpars[3] << " Z0 " << fitpars[4] << std::endl;
 	  }
       }
-    
+  }
+  else if (fitsilicon)
+  {
+    nsilicon = cluskey_vec.size();
+    rec.set_nsilicon = true;
+  }
+  else if (fittpc && !fitfulltrack)
+  {
+    ntpc = cluskey_vec.size();
+    rec.set_ntpc = true;
+  }
 
-    //// Create a track map for diagnostics
-    SvtxTrack_v4 newTrack;
-    newTrack.set_id(trackid);
-    if (fitsilicon)
+  Acts::Vector3 beamline(0, 0, 0);
+  Acts::Vector2 pca2d;
+  Acts::Vector3& track_vtx = rec.track_vtx;
+  if(straight_line_fit)
     {
-      newTrack.set_silicon_seed(tracklet);
+      pca2d = TrackFitUtils::get_line_point_pca(fitpars[0], fitpars[1], beamline);
+      track_vtx(0) = pca2d(0);
+      track_vtx(1) = pca2d(1);
+      track_vtx(2) = fitpars[3];   // z axis intercept
     }
-    else if (fittpc)
+  else
     {
-      newTrack.set_tpc_seed(tracklet);
+      pca2d = TrackFitUtils::get_circle_point_pca(fitpars[0], fitpars[1], fitpars[2], beamline);
+      track_vtx(0) = pca2d(0);
+      track_vtx(1) = pca2d(1);
+      track_vtx(2) = fitpars[4];   // z axis intercept
     }
 
-    // if a full track is requested, get the silicon clusters too and refit
-    if (fittpc && fitfulltrack)
-    {
-      // this associates silicon clusters and adds them to the vectors
-      ntpc = cluskey_vec.size();
+  newTrack.set_crossing(tracklet->get_crossing());
+  newTrack.set_id(trackid);
 
-      if(straight_line_fit)
-	{
-	  std::tuple<double, double> linefit_xy(fitpars[0], fitpars[1]); 
-	  nsilicon = TrackFitUtils::addClustersOnLine(linefit_xy, true, dca_cut, _tGeometry, _cluster_map, global_vec, cluskey_vec, 0, 6);
-	}
-      else
-	{
-	  nsilicon = TrackFitUtils::addClusters(fitpars, dca_cut, _tGeometry, _cluster_map, global_vec, cluskey_vec, 0, 6);
-	}
+  /// use the track seed functions to help get the track trajectory values
+  /// in the usual coordinates
 
-      if (nsilicon < 5)
-      {
-        continue;  // discard this TPC seed, did not get a good match to silicon
-      }
-      auto trackseed = std::make_unique<TrackSeed_v2>();
-      for (auto& ckey : cluskey_vec)
-      {
-        if (TrkrDefs::getTrkrId(ckey) == TrkrDefs::TrkrId::mvtxId or
-            TrkrDefs::getTrkrId(ckey) == TrkrDefs::TrkrId::inttId)
-        {
-          trackseed->insert_cluster_key(ckey);
-        }
-      }
+  TrackSeed_v2& someseed = rec.someseed;
+  for (auto& ckey : cluskey_vec)
+  {
+    someseed.insert_cluster_key(ckey);
+  }
 
-      newTrack.set_silicon_seed(trackseed.get());
+  if(straight_line_fit)
+    {
+      someseed.set_qOverR(1.0);
+      someseed.set_phi(tracklet->get_phi());
+
+      someseed.set_X0(fitpars[0]);
+      someseed.set_Y0(fitpars[1]);
+      someseed.set_Z0(fitpars[3]);
+      someseed.set_slope(fitpars[2]);
+
+      auto tangent=get_line_tangent(fitpars, global_vec[0]);
+      newTrack.set_x(track_vtx(0));
+      newTrack.set_y(track_vtx(1));
+      newTrack.set_z(track_vtx(2));
+      newTrack.set_px(tangent.second(0));
+      newTrack.set_py(tangent.second(1));
+      newTrack.set_pz(tangent.second(2));
+      newTrack.set_charge(tracklet->get_charge());
+    }
+  else
+    {
+      someseed.set_qOverR(tracklet->get_charge() / fitpars[0]);
+      someseed.set_phi(tracklet->get_phi());
+
+      someseed.set_X0(fitpars[1]);
+      someseed.set_Y0(fitpars[2]);
+      someseed.set_Z0(fitpars[4]);
+      someseed.set_slope(fitpars[3]);
+
+      const auto position = TrackSeedHelper::get_xyz(&someseed);
+
+      newTrack.set_x(position.x());
+      newTrack.set_y(position.y());
+      newTrack.set_z(position.z());
+      newTrack.set_px(someseed.get_px());
+      newTrack.set_py(someseed.get_py());
+      newTrack.set_pz(someseed.get_pz());
+      newTrack.set_charge(tracklet->get_charge());
+    }
 
-      // fit the full track now
-      fitpars.clear();
-      if(straight_line_fit)
-	{
-	  fitpars = TrackFitUtils::fitClustersZeroField(global_vec, cluskey_vec, use_intt_zfit);
-	    
-	  if (fitpars.size() == 0)
-	    {
-	      continue;  // discard this track, not enough clusters to fit
-	    }
-	  
-	  if (Verbosity() > 1)
-	    {
-	      std::cout << " Track " << trackid << " dy/dx " << fitpars[0] << " y intercept " << fitpars[1] 
-			<< " dx/dz " << fitpars[2] << " Z0 " << fitpars[3] << std::endl;
-	    }
-	}
-      else
-	{
-	  fitpars = TrackFitUtils::fitClusters(global_vec, cluskey_vec, use_intt_zfit);  // do helical fit
-
-	  if (fitpars.size() == 0)
-	    {
-	      continue;  // discard this track, fit failed
-	    }
-
-	  if (Verbosity() > 1)
-	    {
-	      std::cout << " Full track " << trackid << " radius " << fitpars[0] << " X0 " << fitpars[1] << " Y0 " << fitpars[2]
-			<< " zslope " << fitpars[3] << " Z0 " << fitpars[4] << std::endl;
-	    }
-	}
+  rec.set_nclus = true;
+
+  // some basic track quality requirements
+  if (fittpc && ntpc < 35)
+  {
+    if (Verbosity() > 1)
+    {
+      std::cout << " reject this track, ntpc = " << ntpc << std::endl;
     }
-    else if (fitsilicon)
+    return false;
+  }
+  if ((fitsilicon || fitfulltrack) && nsilicon < 3)
+  {
+    if (Verbosity() > 1)
     {
-      nsilicon = cluskey_vec.size();
+      std::cout << " reject this track, nsilicon = " << nsilicon << std::endl;
     }
-    else if (fittpc && !fitfulltrack)
+    return false;
+  }
+
+  return true;
+}
+
+void HelicalFitter::processTrackClusters(TrackRecord& rec, DerivativeWorkspace& ws)
+{
+  const unsigned int trackid = rec.trackid;
+  const auto& global_vec = rec.global_vec;
+  const auto& cluskey_vec = rec.cluskey_vec;
+  const auto& fitpars = rec.fitpars;
+  const auto& someseed = rec.someseed;
+  auto& newTrack = rec.newTrack;
+  // the event wide nsilicon/ntpc/nclus ntuple columns are filled in process_event
+  const unsigned int nsilicon = 0;
+  const unsigned int ntpc = 0;
+  const unsigned int nclus = 0;
+
+  // the clusters with a measurement for mille, the derivatives are calculated for all of them at once
+  ws.clear();
+  std::vector<TrkrCluster*> clusters;
+  std::vector<unsigned int> clusindex;
+  std::vector<Acts::Vector2> residuals;
+  std::vector<Acts::Vector2> sigmas;
+  std::vector<Acts::Vector2> locals;
+  std::vector<Acts::Vector2> fitpoint_locals;
+  std::vector<std::pair<Acts::Vector3, Acts::Vector3>> tangents;
+  std::vector<Surface> surfaces;
+  std::vector<std::array<int, AlignmentDefs::NGL>> labels;
+
+  // the straight line does not depend on the cluster
+  std::pair<Acts::Vector3, Acts::Vector3> zero_field_line;
+  if (straight_line_fit)
+  {
+    zero_field_line = get_line_zero_field(fitpars);
+  }
+
+  for (unsigned int ivec = 0; ivec < global_vec.size(); ++ivec)
+  {
+    auto global = global_vec[ivec];
+    auto cluskey = cluskey_vec[ivec];
+    auto cluster = _cluster_map->findCluster(cluskey);
+    if (!cluster)
     {
-      ntpc = cluskey_vec.size();
+      continue;
     }
 
-    Acts::Vector3 beamline(0, 0, 0);
-    Acts::Vector2 pca2d;
-    Acts::Vector3 track_vtx;
+    unsigned int trkrid = TrkrDefs::getTrkrId(cluskey);
+
+    // What we need now is to find the point on the surface at which the helix would intersect
+    // If we have that point, we can transform the fit back to local coords
+    // we have fitpars for the helix, and the cluster key - from which we get the surface
+    // The surface frame and the tangent at the best fit are calculated once per cluster,
+    // they are also used for the derivatives
+
+    Surface surf = _tGeometry->maps().getSurface(cluskey, cluster);
+    Acts::Vector3 sensorCenter = surf->center(_tGeometry->geometry().getGeoContext());  // mm
+    Acts::Vector3 sensorNormal = -surf->normal(_tGeometry->geometry().getGeoContext());
+    sensorNormal /= sensorNormal.norm();
+
+    std::pair<Acts::Vector3, Acts::Vector3> tangent;
+    Acts::Vector3 fitpoint;
     if(straight_line_fit)
       {
-	pca2d = TrackFitUtils::get_line_point_pca(fitpars[0], fitpars[1], beamline);
-	track_vtx(0) = pca2d(0);
-	track_vtx(1) = pca2d(1);
-	track_vtx(2) = fitpars[3];   // z axis intercept
+	tangent = get_line_tangent(fitpars, global);
+	fitpoint = get_line_plane_intersection(zero_field_line.first, zero_field_line.second, sensorCenter * 0.1, sensorNormal);
       }
     else
       {
-	pca2d = TrackFitUtils::get_circle_point_pca(fitpars[0], fitpars[1], fitpars[2], beamline);
-	track_vtx(0) = pca2d(0);
-	track_vtx(1) = pca2d(1);
-	track_vtx(2) = fitpars[4];   // z axis intercept
+	tangent = get_helix_tangent(fitpars, global);
+	fitpoint = get_line_plane_intersection(tangent.first, tangent.second, sensorCenter * 0.1, sensorNormal);
       }
 
-    newTrack.set_crossing(tracklet->get_crossing());
-    newTrack.set_id(trackid);
+    // fitpoint is the point where the helical fit intersects the plane of the surface
+    // Now transform the helix fitpoint to local coordinates to compare with cluster local coordinates
+    Acts::Vector3 fitpoint_local = surf->transform(_tGeometry->geometry().getGeoContext()).inverse() * (fitpoint * Acts::UnitConstants::cm);
 
-    /// use the track seed functions to help get the track trajectory values
-    /// in the usual coordinates
+    fitpoint_local /= Acts::UnitConstants::cm;
 
-    TrackSeed_v2 someseed;
-    for (auto& ckey : cluskey_vec)
+    auto xloc = cluster->getLocalX();  // in cm
+    auto zloc = cluster->getLocalY();
+
+    if (trkrid == TrkrDefs::tpcId)
     {
-      someseed.insert_cluster_key(ckey);
+      zloc = convertTimeToZ(cluskey, cluster);
     }
 
-    if(straight_line_fit)
-      {
-	someseed.set_qOverR(1.0);
-	someseed.set_phi(tracklet->get_phi());
-	
-	someseed.set_X0(fitpars[0]);
-	someseed.set_Y0(fitpars[1]);
-	someseed.set_Z0(fitpars[3]);
-	someseed.set_slope(fitpars[2]);
-	
-	auto tangent=get_line_tangent(fitpars, global_vec[0]);
-	newTrack.set_x(track_vtx(0));
-	newTrack.set_y(track_vtx(1));
-	newTrack.set_z(track_vtx(2));
-	newTrack.set_px(tangent.second(0));
-	newTrack.set_py(tangent.second(1));
-	newTrack.set_pz(tangent.second(2));
-	newTrack.set_charge(tracklet->get_charge());
-      }
-    else
-      {
-	someseed.set_qOverR(tracklet->get_charge() / fitpars[0]);
-	someseed.set_phi(tracklet->get_phi());
-	
-	someseed.set_X0(fitpars[1]);
-	someseed.set_Y0(fitpars[2]);
-	someseed.set_Z0(fitpars[4]);
-	someseed.set_slope(fitpars[3]);
-	
-	const auto position = TrackSeedHelper::get_xyz(&someseed);
-	
-	newTrack.set_x(position.x());
-	newTrack.set_y(position.y());
-	newTrack.set_z(position.z());
-	newTrack.set_px(someseed.get_px());
-	newTrack.set_py(someseed.get_py());
-	newTrack.set_pz(someseed.get_pz());
-	newTrack.set_charge(tracklet->get_charge());
-      }	
-	    
-    nclus = ntpc + nsilicon;
-
-    // some basic track quality requirements
-    if (fittpc && ntpc < 35)
+    Acts::Vector2 residual(xloc - fitpoint_local(0), zloc - fitpoint_local(1));
+
+    unsigned int layer = TrkrDefs::getLayer(cluskey_vec[ivec]);
+
+    SvtxTrackState_v1 svtxstate(fitpoint.norm());
+    svtxstate.set_x(fitpoint(0));
+    svtxstate.set_y(fitpoint(1));
+    svtxstate.set_z(fitpoint(2));
+    // the states always got the momentum of a TrackSeed base class copy of someseed
+    svtxstate.set_px(someseed.TrackSeed::get_p() * tangent.second.x());
+    svtxstate.set_py(someseed.TrackSeed::get_p() * tangent.second.y());
+    svtxstate.set_pz(someseed.TrackSeed::get_p() * tangent.second.z());
+    newTrack.insert_state(&svtxstate);
+
+    if (Verbosity() > 1)
+    {
+      Acts::Vector3 loc_check = surf->transform(_tGeometry->geometry().getGeoContext()).inverse() * (global * Acts::UnitConstants::cm);
+      loc_check /= Acts::UnitConstants::cm;
+      std::cout << "    layer " << layer << std::endl
+                << " cluster global " << global(0) << " " << global(1) << " " << global(2) << std::endl
+                << " fitpoint " << fitpoint(0) << " " << fitpoint(1) << " " << fitpoint(2) << std::endl
+                << " fitpoint_local " << fitpoint_local(0) << " " << fitpoint_local(1) << " " << fitpoint_local(2) << std::endl
+                << " cluster local x " << cluster->getLocalX() << " cluster local y " << cluster->getLocalY() << std::endl
+                << " cluster global to local x " << loc_check(0) << " local y " << loc_check(1) << "  local z " << loc_check(2) << std::endl
+                << " cluster local residual x " << residual(0) << " cluster local residual y " << residual(1) << std::endl;
+    }
+
+    if (Verbosity() > 1)
+    {
+      Acts::Transform3 transform = surf->transform(_tGeometry->geometry().getGeoContext());
+      std::cout << "Transform is:" << std::endl;
+      std::cout << transform.matrix() << std::endl;
+      Acts::Vector3 loc_check = surf->transform(_tGeometry->geometry().getGeoContext()).inverse() * (global * Acts::UnitConstants::cm);
+      loc_check /= Acts::UnitConstants::cm;
+      unsigned int sector = TpcDefs::getSectorId(cluskey_vec[ivec]);
+      unsigned int side = TpcDefs::getSide(cluskey_vec[ivec]);
+      std::cout << "    layer " << layer << " sector " << sector << " side " << side << " subsurf " << cluster->getSubSurfKey() << std::endl
+                << " cluster global " << global(0) << " " << global(1) << " " << global(2) << std::endl
+                << " fitpoint " << fitpoint(0) << " " << fitpoint(1) << " " << fitpoint(2) << std::endl
+                << " fitpoint_local " << fitpoint_local(0) << " " << fitpoint_local(1) << " " << fitpoint_local(2) << std::endl
+                << " cluster local x " << cluster->getLocalX() << " cluster local y " << cluster->getLocalY() << std::endl
+                << " cluster global to local x " << loc_check(0) << " local y " << loc_check(1) << "  local z " << loc_check(2) << std::endl
+                << " cluster local residual x " << residual(0) << " cluster local residual y " << residual(1) << std::endl;
+    }
+
+    // need standard deviation of measurements
+    Acts::Vector2 clus_sigma = getClusterError(cluster, cluskey, global);
+    if (isnan(clus_sigma(0)) || isnan(clus_sigma(1)))
     {
-      if (Verbosity() > 1)
-      {
-        std::cout << " reject this track, ntpc = " << ntpc << std::endl;
-      }
       continue;
     }
-    if ((fitsilicon || fitfulltrack) && nsilicon < 3)
+
+    std::array<int, AlignmentDefs::NGL> glbl_label{};
+    if (layer < 3)
+    {
+      AlignmentDefs::getMvtxGlobalLabels(surf, cluskey, glbl_label.data(), mvtx_grp);
+    }
+    else if (layer > 2 && layer < 7)
+    {
+      AlignmentDefs::getInttGlobalLabels(surf, cluskey, glbl_label.data(), intt_grp);
+    }
+    else if (layer < 55)
+    {
+      AlignmentDefs::getTpcGlobalLabels(surf, cluskey, glbl_label.data(), tpc_grp);
+    }
+    else
     {
-      if (Verbosity() > 1)
-      {
-        std::cout << " reject this track, nsilicon = " << nsilicon << std::endl;
-      }
       continue;
     }
 
-    cumulative_global_vec.push_back(global_vec);
-    cumulative_cluskey_vec.push_back(cluskey_vec);
-    cumulative_vertex.push_back(track_vtx);
-    cumulative_fitpars_vec.push_back(fitpars);
-    cumulative_someseed.push_back(someseed);
-    cumulative_newTrack.push_back(newTrack);
+    ws.add(global, fitpoint, sensorCenter, sensorNormal, layer);
+    get_projectionXY(surf, tangent, ws.projX.back(), ws.projY.back());
+
+    clusters.push_back(cluster);
+    clusindex.push_back(ivec);
+    residuals.push_back(residual);
+    sigmas.push_back(clus_sigma);
+    locals.emplace_back(xloc, zloc);
+    fitpoint_locals.emplace_back(fitpoint_local(0), fitpoint_local(1));
+    tangents.push_back(tangent);
+    surfaces.push_back(surf);
+    labels.push_back(glbl_label);
   }
 
-  // terminate loop over tracks
-  // Collect fitpars for each track by intializing array of size maxtracks and populaating thorughout the loop
-  // Then start new loop over tracks and for each track go over clsutaer
-  //  make vector of global_vecs
-  float xsum = 0;
-  float ysum = 0;
-  float zsum = 0;
-  unsigned int accepted_tracks = cumulative_fitpars_vec.size();
+  // These derivatives are for the local parameters
+  ws.resize();
+  if(straight_line_fit)
+    {
+      getLocalDerivativesZeroFieldXY(ws, fitpars);
+    }
+  else
+    {
+      getLocalDerivativesXY(ws, fitpars);
+    }
 
-  for (unsigned int trackid = 0; trackid < accepted_tracks; ++trackid)
-  {
-    xsum += cumulative_vertex[trackid][0];
-    ysum += cumulative_vertex[trackid][1];
-    zsum += cumulative_vertex[trackid][2];
-  }
-  Acts::Vector3 averageVertex(xsum / accepted_tracks, ysum / accepted_tracks, zsum / accepted_tracks);
+  // The global derivs dimensions are [alpha/beta/gamma](x/y/z)
+  getGlobalDerivativesXY(ws);
 
-  for (unsigned int trackid = 0; trackid < accepted_tracks; ++trackid)
+  for (unsigned int iclus = 0; iclus < ws.size(); ++iclus)
   {
-    auto global_vec = cumulative_global_vec[trackid];
-    auto cluskey_vec = cumulative_cluskey_vec[trackid];
-    auto fitpars = cumulative_fitpars_vec[trackid];
-    auto someseed = cumulative_someseed[trackid];
-    auto newTrack = cumulative_newTrack[trackid];
-    SvtxAlignmentStateMap::StateVec statevec;
-
-    // get the residuals and derivatives for all clusters
-    for (unsigned int ivec = 0; ivec < global_vec.size(); ++ivec)
+    const unsigned int ivec = clusindex[iclus];
+    const auto& global = global_vec[ivec];
+    const auto& fitpoint = ws.fitpoint[iclus];
+    const auto& tangent = tangents[iclus];
+    const auto& surf = surfaces[iclus];
+    const auto& residual = residuals[iclus];
+    const auto& clus_sigma = sigmas[iclus];
+    const int* glbl_label = labels[iclus].data();
+    auto cluskey = cluskey_vec[ivec];
+    auto cluster = clusters[iclus];
+    unsigned int trkrid = TrkrDefs::getTrkrId(cluskey);
+    unsigned int layer = ws.layer[iclus];
+    float phi = atan2(global(1), global(0));
+    float xloc = locals[iclus](0);
+    float zloc = locals[iclus](1);
+    const auto& fitpoint_local = fitpoint_locals[iclus];
+
+    float* lcl_derivativeX = &ws.lcl_derivativeX[iclus * AlignmentDefs::NLC];
+    float* lcl_derivativeY = &ws.lcl_derivativeY[iclus * AlignmentDefs::NLC];
+    float* glbl_derivativeX = &ws.glbl_derivativeX[iclus * AlignmentDefs::NGL];
+    float* glbl_derivativeY = &ws.glbl_derivativeY[iclus * AlignmentDefs::NGL];
+
+    auto alignmentstate = std::make_unique<SvtxAlignmentState_v1>();
+    alignmentstate->set_residual(residual);
+    alignmentstate->set_cluster_key(cluskey);
+    SvtxAlignmentState::GlobalMatrix svtxglob =
+        SvtxAlignmentState::GlobalMatrix::Zero();
+    SvtxAlignmentState::LocalMatrix svtxloc =
+        SvtxAlignmentState::LocalMatrix::Zero();
+    for (int i = 0; i < AlignmentDefs::NLC; i++)
     {
-      auto global = global_vec[ivec];
-      auto cluskey = cluskey_vec[ivec];
-      auto cluster = _cluster_map->findCluster(cluskey);
-      if (!cluster)
-      {
-        continue;
-      }
-
-      unsigned int trkrid = TrkrDefs::getTrkrId(cluskey);
-
-      // What we need now is to find the point on the surface at which the helix would intersect
-      // If we have that point, we can transform the fit back to local coords
-      // we have fitpars for the helix, and the cluster key - from which we get the surface
-
-      Surface surf = _tGeometry->maps().getSurface(cluskey, cluster);
-      Acts::Vector3 helix_pca(0, 0, 0);
-      Acts::Vector3 helix_tangent(0, 0, 0);
-      Acts::Vector3 fitpoint;
-      if(straight_line_fit)
-	{
-	  fitpoint = get_line_surface_intersection(surf, fitpars);
-	}
-      else
-	{
-	  fitpoint = get_helix_surface_intersection(surf, fitpars, global, helix_pca, helix_tangent);
-	}
-
-      // fitpoint is the point where the helical fit intersects the plane of the surface
-      // Now transform the helix fitpoint to local coordinates to compare with cluster local coordinates
-      Acts::Vector3 fitpoint_local = surf->transform(_tGeometry->geometry().getGeoContext()).inverse() * (fitpoint * Acts::UnitConstants::cm);
+      svtxloc(0, i) = lcl_derivativeX[i];
+      svtxloc(1, i) = lcl_derivativeY[i];
+    }
+    for (int i = 0; i < AlignmentDefs::NGL; i++)
+    {
+      svtxglob(0, i) = glbl_derivativeX[i];
+      svtxglob(1, i) = glbl_derivativeY[i];
+    }
 
-      fitpoint_local /= Acts::UnitConstants::cm;
+    alignmentstate->set_local_derivative_matrix(svtxloc);
+    alignmentstate->set_global_derivative_matrix(svtxglob);
 
-      auto xloc = cluster->getLocalX();  // in cm
-      auto zloc = cluster->getLocalY();
+    rec.statevec.push_back(alignmentstate.release());
 
-      if (trkrid == TrkrDefs::tpcId)
+    for (unsigned int i = 0; i < AlignmentDefs::NGL; ++i)
+    {
+      if (trkrid == TrkrDefs::mvtxId)
       {
-        zloc = convertTimeToZ(cluskey, cluster);
+        // need stave to get clamshell
+        auto stave = MvtxDefs::getStaveId(cluskey_vec[ivec]);
+        auto clamshell = AlignmentDefs::getMvtxClamshell(layer, stave);
+        if (is_layer_param_fixed(layer, i) || is_mvtx_layer_fixed(layer, clamshell))
+        {
+          glbl_derivativeX[i] = 0;
+          glbl_derivativeY[i] = 0;
+        }
       }
 
-      Acts::Vector2 residual(xloc - fitpoint_local(0), zloc - fitpoint_local(1));
-
-      unsigned int layer = TrkrDefs::getLayer(cluskey_vec[ivec]);
-      float phi = atan2(global(1), global(0));
-
-      SvtxTrackState_v1 svtxstate(fitpoint.norm());
-      svtxstate.set_x(fitpoint(0));
-      svtxstate.set_y(fitpoint(1));
-      svtxstate.set_z(fitpoint(2));
-      std::pair<Acts::Vector3, Acts::Vector3> tangent;
-      if(straight_line_fit)
-	{
-	  tangent = get_line_tangent(fitpars, global);
-	}
-      else
-	{
-	  tangent = get_helix_tangent(fitpars, global);
-	}
-
-      svtxstate.set_px(someseed.get_p() * tangent.second.x());
-      svtxstate.set_py(someseed.get_p() * tangent.second.y());
-      svtxstate.set_pz(someseed.get_p() * tangent.second.z());
-      newTrack.insert_state(&svtxstate);
-
-      if (Verbosity() > 1)
+      if (trkrid == TrkrDefs::inttId)
       {
-        Acts::Vector3 loc_check = surf->transform(_tGeometry->geometry().getGeoContext()).inverse() * (global * Acts::UnitConstants::cm);
-        loc_check /= Acts::UnitConstants::cm;
-        std::cout << "    layer " << layer << std::endl
-                  << " cluster global " << global(0) << " " << global(1) << " " << global(2) << std::endl
-                  << " fitpoint " << fitpoint(0) << " " << fitpoint(1) << " " << fitpoint(2) << std::endl
-                  << " fitpoint_local " << fitpoint_local(0) << " " << fitpoint_local(1) << " " << fitpoint_local(2) << std::endl
-                  << " cluster local x " << cluster->getLocalX() << " cluster local y " << cluster->getLocalY() << std::endl
-                  << " cluster global to local x " << loc_check(0) << " local y " << loc_check(1) << "  local z " << loc_check(2) << std::endl
-                  << " cluster local residual x " << residual(0) << " cluster local residual y " << residual(1) << std::endl;
+        if (is_layer_param_fixed(layer, i) || is_intt_layer_fixed(layer))
+        {
+          glbl_derivativeX[i] = 0;
+          glbl_derivativeY[i] = 0;
+        }
       }
 
-      if (Verbosity() > 1)
+      if (trkrid == TrkrDefs::tpcId)
       {
-        Acts::Transform3 transform = surf->transform(_tGeometry->geometry().getGeoContext());
-        std::cout << "Transform is:" << std::endl;
-        std::cout << transform.matrix() << std::endl;
-        Acts::Vector3 loc_check = surf->transform(_tGeometry->geometry().getGeoContext()).inverse() * (global * Acts::UnitConstants::cm);
-        loc_check /= Acts::UnitConstants::cm;
         unsigned int sector = TpcDefs::getSectorId(cluskey_vec[ivec]);
         unsigned int side = TpcDefs::getSide(cluskey_vec[ivec]);
-        std::cout << "    layer " << layer << " sector " << sector << " side " << side << " subsurf " << cluster->getSubSurfKey() << std::endl
-                  << " cluster global " << global(0) << " " << global(1) << " " << global(2) << std::endl
-                  << " fitpoint " << fitpoint(0) << " " << fitpoint(1) << " " << fitpoint(2) << std::endl
-                  << " fitpoint_local " << fitpoint_local(0) << " " << fitpoint_local(1) << " " << fitpoint_local(2) << std::endl
-                  << " cluster local x " << cluster->getLocalX() << " cluster local y " << cluster->getLocalY() << std::endl
-                  << " cluster global to local x " << loc_check(0) << " local y " << loc_check(1) << "  local z " << loc_check(2) << std::endl
-                  << " cluster local residual x " << residual(0) << " cluster local residual y " << residual(1) << std::endl;
+        if (is_layer_param_fixed(layer, i) || is_tpc_sector_fixed(layer, sector, side))
+        {
+          glbl_derivativeX[i] = 0;
+          glbl_derivativeY[i] = 0;
+        }
       }
+    }
 
-      // need standard deviation of measurements
-      Acts::Vector2 clus_sigma = getClusterError(cluster, cluskey, global);
-      if (isnan(clus_sigma(0)) || isnan(clus_sigma(1)))
-      {
-        continue;
-      }
+    // Add the measurement separately for each coordinate direction to Mille
+    // set the derivatives non-zero only for parameters we want to be optimized
+    // local parameter numbering is arbitrary:
+    float errinf = 1.0;
 
-      int glbl_label[AlignmentDefs::NGL];
+    if (_layerMisalignment.find(layer) != _layerMisalignment.end())
+    {
+      errinf = _layerMisalignment.find(layer)->second;
+    }
+    if (make_ntuple)
+    {
+      // the columns from the ideal transforms (23-31) and the counters (3-5) are filled in process_event, after all threads are done
+      Acts::Vector3 ideal_center(0, 0, 0);
+      Acts::Vector3 ideal_norm(0, 0, 0);
+      Acts::Vector3 ideal_glob(0, 0, 0);
+      rec.ntp_ideal_input.emplace_back(surf, Acts::Vector3(xloc, zloc, 0.0));
+
+      Acts::Vector3 sensorCenter = surf->center(_tGeometry->geometry().getGeoContext()) * 0.1;  // cm
+      Acts::Vector3 sensorNormal = -surf->normal(_tGeometry->geometry().getGeoContext());
+      unsigned int sector = TpcDefs::getSectorId(cluskey_vec[ivec]);
+      unsigned int side = TpcDefs::getSide(cluskey_vec[ivec]);
+      unsigned int subsurf = cluster->getSubSurfKey();
       if (layer < 3)
       {
-        AlignmentDefs::getMvtxGlobalLabels(surf, cluskey, glbl_label, mvtx_grp);
+        sector = MvtxDefs::getStaveId(cluskey_vec[ivec]);
+        subsurf = MvtxDefs::getChipId(cluskey_vec[ivec]);
       }
       else if (layer > 2 && layer < 7)
       {
-        AlignmentDefs::getInttGlobalLabels(surf, cluskey, glbl_label, intt_grp);
-      }
-      else if (layer < 55)
-      {
-        AlignmentDefs::getTpcGlobalLabels(surf, cluskey, glbl_label, tpc_grp);
+        sector = InttDefs::getLadderPhiId(cluskey_vec[ivec]);
+        subsurf = InttDefs::getLadderZId(cluskey_vec[ivec]);
       }
-      else
-      {
-        continue;
-      }
-
-      // These derivatives are for the local parameters
-      float lcl_derivativeX[AlignmentDefs::NLC] = {0., 0., 0., 0., 0.};
-      float lcl_derivativeY[AlignmentDefs::NLC] = {0., 0., 0., 0., 0.};
       if(straight_line_fit)
 	{
-	  getLocalDerivativesZeroFieldXY(surf, global, fitpars, lcl_derivativeX, lcl_derivativeY, layer);
+	  rec.ntp_rows.push_back({
+	    (float) event, (float) trackid,
+	    (float) layer, (float) nsilicon, (float) ntpc, (float) nclus, (float) trkrid, (float) sector, (float) side,
+	    (float) subsurf, phi,
+	    (float) glbl_label[0], (float) glbl_label[1], (float) glbl_label[2], (float) glbl_label[3], (float) glbl_label[4], (float) glbl_label[5],
+	    (float) sensorCenter(0), (float) sensorCenter(1), (float) sensorCenter(2),
+	    (float) sensorNormal(0), (float) sensorNormal(1), (float) sensorNormal(2),
+	    (float) ideal_center(0), (float) ideal_center(1), (float) ideal_center(2),
+	    (float) ideal_norm(0), (float) ideal_norm(1), (float) ideal_norm(2),
+	    (float) ideal_glob(0), (float) ideal_glob(1), (float) ideal_glob(2),
+	    (float) fitpars[0], (float) fitpars[1], (float) fitpars[2], (float) fitpars[3],
+	    (float) global(0), (float) global(1), (float) global(2),
+	    (float) fitpoint(0), (float) fitpoint(1), (float) fitpoint(2),
+	    (float) tangent.first.x(), (float) tangent.first.y(), (float) tangent.first.z(),
+	    (float) tangent.second.x(), (float) tangent.second.y(), (float) tangent.second.z(),
+	    xloc, zloc, (float) fitpoint_local(0), (float) fitpoint_local(1),
+	    lcl_derivativeX[0], lcl_derivativeX[1], lcl_derivativeX[2], lcl_derivativeX[3],
+	    glbl_derivativeX[0], glbl_derivativeX[1], glbl_derivativeX[2], glbl_derivativeX[3], glbl_derivativeX[4], glbl_derivativeX[5],
+	    lcl_derivativeY[0], lcl_derivativeY[1], lcl_derivativeY[2], lcl_derivativeY[3],
+	    glbl_derivativeY[0], glbl_derivativeY[1], glbl_derivativeY[2], glbl_derivativeY[3], glbl_derivativeY[4], glbl_derivativeY[5]});
 	}
       else
 	{
-	  getLocalDerivativesXY(surf, global, fitpars, lcl_derivativeX, lcl_derivativeY, layer);
+	  rec.ntp_rows.push_back({
+	    (float) event, (float) trackid,
+	    (float) layer, (float) nsilicon, (float) ntpc, (float) nclus, (float) trkrid, (float) sector, (float) side,
+	    (float) subsurf, phi,
+	    (float) glbl_label[0], (float) glbl_label[1], (float) glbl_label[2], (float) glbl_label[3], (float) glbl_label[4], (float) glbl_label[5],
+	    (float) sensorCenter(0), (float) sensorCenter(1), (float) sensorCenter(2),
+	    (float) sensorNormal(0), (float) sensorNormal(1), (float) sensorNormal(2),
+	    (float) ideal_center(0), (float) ideal_center(1), (float) ideal_center(2),
+	    (float) ideal_norm(0), (float) ideal_norm(1), (float) ideal_norm(2),
+	    (float) ideal_glob(0), (float) ideal_glob(1), (float) ideal_glob(2),
+	    (float) fitpars[0], (float) fitpars[1], (float) fitpars[2], (float) fitpars[3], (float) fitpars[4],
+	    (float) global(0), (float) global(1), (float) global(2),
+	    (float) fitpoint(0), (float) fitpoint(1), (float) fitpoint(2),
+	    (float) tangent.first.x(), (float) tangent.first.y(), (float) tangent.first.z(),
+	    (float) tangent.second.x(), (float) tangent.second.y(), (float) tangent.second.z(),
+	    xloc, zloc, (float) fitpoint_local(0), (float) fitpoint_local(1),
+	    lcl_derivativeX[0], lcl_derivativeX[1], lcl_derivativeX[2], lcl_derivativeX[3], lcl_derivativeX[4],
+	    glbl_derivativeX[0], glbl_derivativeX[1], glbl_derivativeX[2], glbl_derivativeX[3], glbl_derivativeX[4], glbl_derivativeX[5],
+	    lcl_derivativeY[0], lcl_derivativeY[1], lcl_derivativeY[2], lcl_derivativeY[3], lcl_derivativeY[4],
+	    glbl_derivativeY[0], glbl_derivativeY[1], glbl_derivativeY[2], glbl_derivativeY[3], glbl_derivativeY[4], glbl_derivativeY[5]});
 	}
+    }
 
-      // The global derivs dimensions are [alpha/beta/gamma](x/y/z)
-      float glbl_derivativeX[AlignmentDefs::NGL];
-      float glbl_derivativeY[AlignmentDefs::NGL];
-      getGlobalDerivativesXY(surf, global, fitpoint, fitpars, glbl_derivativeX, glbl_derivativeY, layer);
-
-      auto alignmentstate = std::make_unique<SvtxAlignmentState_v1>();
-      alignmentstate->set_residual(residual);
-      alignmentstate->set_cluster_key(cluskey);
-      SvtxAlignmentState::GlobalMatrix svtxglob =
-          SvtxAlignmentState::GlobalMatrix::Zero();
-      SvtxAlignmentState::LocalMatrix svtxloc =
-          SvtxAlignmentState::LocalMatrix::Zero();
-      for (int i = 0; i < AlignmentDefs::NLC; i++)
-      {
-        svtxloc(0, i) = lcl_derivativeX[i];
-        svtxloc(1, i) = lcl_derivativeY[i];
-      }
-      for (int i = 0; i < AlignmentDefs::NGL; i++)
-      {
-        svtxglob(0, i) = glbl_derivativeX[i];
-        svtxglob(1, i) = glbl_derivativeY[i];
-      }
-
-      alignmentstate->set_local_derivative_matrix(svtxloc);
-      alignmentstate->set_global_derivative_matrix(svtxglob);
-
-      statevec.push_back(alignmentstate.release());
+    TrackRecord::Measurement meas;
+    std::copy(glbl_label, glbl_label + AlignmentDefs::NGL, meas.glbl_label);
+    if (!isnan(residual(0)) && clus_sigma(0) < 1.0)  // discards crazy clusters
+    {
+      std::copy(lcl_derivativeX, lcl_derivativeX + AlignmentDefs::NLC, meas.lcl_derivative);
+      std::copy(glbl_derivativeX, glbl_derivativeX + AlignmentDefs::NGL, meas.glbl_derivative);
+      meas.residual = residual(0);
+      meas.sigma = errinf * clus_sigma(0);
+      rec.measurements.push_back(meas);
+    }
+    if (!isnan(residual(1)) && clus_sigma(1) < 1.0)
+    {
+      std::copy(lcl_derivativeY, lcl_derivativeY + AlignmentDefs::NLC, meas.lcl_derivative);
+      std::copy(glbl_derivativeY, glbl_derivativeY + AlignmentDefs::NGL, meas.glbl_derivative);
+      meas.residual = residual(1);
+      meas.sigma = errinf * clus_sigma(1);
+      rec.measurements.push_back(meas);
+    }
+  }
+}
 
-      for (unsigned int i = 0; i < AlignmentDefs::NGL; ++i)
-      {
-        if (trkrid == TrkrDefs::mvtxId)
-        {
-          // need stave to get clamshell
-          auto stave = MvtxDefs::getStaveId(cluskey_vec[ivec]);
-          auto clamshell = AlignmentDefs::getMvtxClamshell(layer, stave);
-          if (is_layer_param_fixed(layer, i) || is_mvtx_layer_fixed(layer, clamshell))
-          {
-            glbl_derivativeX[i] = 0;
-            glbl_derivativeY[i] = 0;
-          }
-        }
+void HelicalFitter::writeTrackRecord(TrackRecord& rec, Mille* mille, unsigned int accepted_tracks)
+{
+  const unsigned int trackid = rec.trackid;
+  const auto& fitpars = rec.fitpars;
+  auto& newTrack = rec.newTrack;
+  const Acts::Vector3& event_vtx = rec.event_vtx;
 
-        if (trkrid == TrkrDefs::inttId)
-        {
-          if (is_layer_param_fixed(layer, i) || is_intt_layer_fixed(layer))
-          {
-            glbl_derivativeX[i] = 0;
-            glbl_derivativeY[i] = 0;
-          }
-        }
+  for (const auto& meas : rec.measurements)
+  {
+    mille->mille(AlignmentDefs::NLC, meas.lcl_derivative, AlignmentDefs::NGL, meas.glbl_derivative, meas.glbl_label, meas.residual, meas.sigma);
+  }
 
-        if (trkrid == TrkrDefs::tpcId)
-        {
-          unsigned int sector = TpcDefs::getSectorId(cluskey_vec[ivec]);
-          unsigned int side = TpcDefs::getSide(cluskey_vec[ivec]);
-          if (is_layer_param_fixed(layer, i) || is_tpc_sector_fixed(layer, sector, side))
-          {
-            glbl_derivativeX[i] = 0;
-            glbl_derivativeY[i] = 0;
-          }
-        }
-      }
+  //  skip the common vertex requirement for this track unless there are 3 tracks in the event
+  if(accepted_tracks < 3) { return; }
 
-      // Add the measurement separately for each coordinate direction to Mille
-      // set the derivatives non-zero only for parameters we want to be optimized
-      // local parameter numbering is arbitrary:
-      float errinf = 1.0;
+  // The residual for the vtx case is (event vtx - track vtx)
+  // that is -dca
+  float dca3dxy = 0;
+  float dca3dz = 0;
+  float dca3dxysigma = 0;
+  float dca3dzsigma = 0;
+  if(!straight_line_fit)
+    {
+      get_dca(newTrack, dca3dxy, dca3dz, dca3dxysigma, dca3dzsigma, event_vtx);
+    }
+  else
+    {
+      get_dca_zero_field(newTrack, dca3dxy, dca3dz, dca3dxysigma, dca3dzsigma, event_vtx);
+    }
 
-      if (_layerMisalignment.find(layer) != _layerMisalignment.end())
-      {
-        errinf = _layerMisalignment.find(layer)->second;
-      }
-      if (make_ntuple)
-      {
-        // get the local parameters using the ideal transforms
-        alignmentTransformationContainer::use_alignment = false;
-        Acts::Vector3 ideal_center = surf->center(_tGeometry->geometry().getGeoContext()) * 0.1;
-        Acts::Vector3 ideal_norm = -surf->normal(_tGeometry->geometry().getGeoContext());
-        Acts::Vector3 ideal_local(xloc, zloc, 0.0);  // cm
-        Acts::Vector3 ideal_glob = surf->transform(_tGeometry->geometry().getGeoContext()) * (ideal_local * Acts::UnitConstants::cm);
-        ideal_glob /= Acts::UnitConstants::cm;
-        alignmentTransformationContainer::use_alignment = true;
+  // These are local coordinate residuals in the perigee surface
+  Acts::Vector2 vtx_residual(-dca3dxy, -dca3dz);
 
-        Acts::Vector3 sensorCenter = surf->center(_tGeometry->geometry().getGeoContext()) * 0.1;  // cm
-        Acts::Vector3 sensorNormal = -surf->normal(_tGeometry->geometry().getGeoContext());
-        unsigned int sector = TpcDefs::getSectorId(cluskey_vec[ivec]);
-        unsigned int side = TpcDefs::getSide(cluskey_vec[ivec]);
-        unsigned int subsurf = cluster->getSubSurfKey();
-        if (layer < 3)
-        {
-          sector = MvtxDefs::getStaveId(cluskey_vec[ivec]);
-          subsurf = MvtxDefs::getChipId(cluskey_vec[ivec]);
-        }
-        else if (layer > 2 && layer < 7)
-        {
-          sector = InttDefs::getLadderPhiId(cluskey_vec[ivec]);
-          subsurf = InttDefs::getLadderZId(cluskey_vec[ivec]);
-        }
-	if(straight_line_fit)
-	  {
-	    float ntp_data[72] = {
-	      (float) event, (float) trackid,
-	      (float) layer, (float) nsilicon, (float) ntpc, (float) nclus, (float) trkrid, (float) sector, (float) side,
-	      (float) subsurf, phi,
-	      (float) glbl_label[0], (float) glbl_label[1], (float) glbl_label[2], (float) glbl_label[3], (float) glbl_label[4], (float) glbl_label[5],
-	      (float) sensorCenter(0), (float) sensorCenter(1), (float) sensorCenter(2),
-	      (float) sensorNormal(0), (float) sensorNormal(1), (float) sensorNormal(2),
-	      (float) ideal_center(0), (float) ideal_center(1), (float) ideal_center(2),
-	      (float) ideal_norm(0), (float) ideal_norm(1), (float) ideal_norm(2),
-	      (float) ideal_glob(0), (float) ideal_glob(1), (float) ideal_glob(2),
-	      (float) fitpars[0], (float) fitpars[1], (float) fitpars[2], (float) fitpars[3],
-	      (float) global(0), (float) global(1), (float) global(2),
-	      (float) fitpoint(0), (float) fitpoint(1), (float) fitpoint(2),
-	      (float) tangent.first.x(), (float) tangent.first.y(), (float) tangent.first.z(),
-	      (float) tangent.second.x(), (float) tangent.second.y(), (float) tangent.second.z(),
-	      xloc, zloc, (float) fitpoint_local(0), (float) fitpoint_local(1),
-	      lcl_derivativeX[0], lcl_derivativeX[1], lcl_derivativeX[2], lcl_derivativeX[3],
-	      glbl_derivativeX[0], glbl_derivativeX[1], glbl_derivativeX[2], glbl_derivativeX[3], glbl_derivativeX[4], glbl_derivativeX[5],
-	      lcl_derivativeY[0], lcl_derivativeY[1], lcl_derivativeY[2], lcl_derivativeY[3],
-	      glbl_derivativeY[0], glbl_derivativeY[1], glbl_derivativeY[2], glbl_derivativeY[3], glbl_derivativeY[4], glbl_derivativeY[5]};
-	    
-	    ntp->Fill(ntp_data);
-	  }
-	else
-	  {
-	    float ntp_data[75] = {
-	      (float) event, (float) trackid,
-	      (float) layer, (float) nsilicon, (float) ntpc, (float) nclus, (float) trkrid, (float) sector, (float) side,
-	      (float) subsurf, phi,
-	      (float) glbl_label[0], (float) glbl_label[1], (float) glbl_label[2], (float) glbl_label[3], (float) glbl_label[4], (float) glbl_label[5],
-	      (float) sensorCenter(0), (float) sensorCenter(1), (float) sensorCenter(2),
-	      (float) sensorNormal(0), (float) sensorNormal(1), (float) sensorNormal(2),
-	      (float) ideal_center(0), (float) ideal_center(1), (float) ideal_center(2),
-	      (float) ideal_norm(0), (float) ideal_norm(1), (float) ideal_norm(2),
-	      (float) ideal_glob(0), (float) ideal_glob(1), (float) ideal_glob(2),
-	      (float) fitpars[0], (float) fitpars[1], (float) fitpars[2], (float) fitpars[3], (float) fitpars[4],
-	      (float) global(0), (float) global(1), (float) global(2),
-	      (float) fitpoint(0), (float) fitpoint(1), (float) fitpoint(2),
-	      (float) tangent.first.x(), (float) tangent.first.y(), (float) tangent.first.z(),
-	      (float) tangent.second.x(), (float) tangent.second.y(), (float) tangent.second.z(),
-	      xloc, zloc, (float) fitpoint_local(0), (float) fitpoint_local(1),
-	      lcl_derivativeX[0], lcl_derivativeX[1], lcl_derivativeX[2], lcl_derivativeX[3], lcl_derivativeX[4],
-	      glbl_derivativeX[0], glbl_derivativeX[1], glbl_derivativeX[2], glbl_derivativeX[3], glbl_derivativeX[4], glbl_derivativeX[5],
-	      lcl_derivativeY[0], lcl_derivativeY[1], lcl_derivativeY[2], lcl_derivativeY[3], lcl_derivativeY[4],
-	      glbl_derivativeY[0], glbl_derivativeY[1], glbl_derivativeY[2], glbl_derivativeY[3], glbl_derivativeY[4], glbl_derivativeY[5]};
-	    
-	    ntp->Fill(ntp_data);
-
-	    if (Verbosity() > 2)
-	      {
-		for (auto& i : ntp_data)
-		  {
-		    std::cout << i << "  ";
-		  }
-		std::cout << std::endl;
-	      }
-	  }
-      }
-      
-      if (!isnan(residual(0)) && clus_sigma(0) < 1.0)  // discards crazy clusters
-      {
-        _mille->mille(AlignmentDefs::NLC, lcl_derivativeX, AlignmentDefs::NGL, glbl_derivativeX, glbl_label, residual(0), errinf * clus_sigma(0));
-      }
-      if (!isnan(residual(1)) && clus_sigma(1) < 1.0)
-      {
-        _mille->mille(AlignmentDefs::NLC, lcl_derivativeY, AlignmentDefs::NGL, glbl_derivativeY, glbl_label, residual(1), errinf * clus_sigma(1));
-      }
+  float lclvtx_derivativeX[AlignmentDefs::NLC];
+  float lclvtx_derivativeY[AlignmentDefs::NLC];
+  if(straight_line_fit)
+    {
+      getLocalVtxDerivativesZeroFieldXY(newTrack, event_vtx, fitpars, lclvtx_derivativeX, lclvtx_derivativeY);
+    }
+  else
+    {
+      getLocalVtxDerivativesXY(newTrack, event_vtx, fitpars, lclvtx_derivativeX, lclvtx_derivativeY);
     }
 
-    m_alignmentmap->insertWithKey(trackid, statevec);
-    m_trackmap->insertWithKey(&newTrack, trackid);
+  // The global derivs dimensions are [alpha/beta/gamma](x/y/z)
+  float glblvtx_derivativeX[3];
+  float glblvtx_derivativeY[3];
+  getGlobalVtxDerivativesXY(newTrack, event_vtx, glblvtx_derivativeX, glblvtx_derivativeY);
 
-    // calculate vertex residual with perigee surface
-    //-------------------------------------------------------
+  if (use_event_vertex)
+  {
+    for(int p = 0; p<3; p++)
+    {
 
-    Acts::Vector3 event_vtx(averageVertex(0), averageVertex(1), averageVertex(2));
 
-    for (const auto &[vtxkey, vertex] : *m_vertexmap)
-      {
-	for (auto trackiter = vertex->begin_tracks(); trackiter != vertex->end_tracks(); ++trackiter)
-	  {
-	    SvtxTrack *vtxtrack = m_trackmap->get(*trackiter);
-	    if (vtxtrack)
-	      {	    
-		unsigned int vtxtrackid = vtxtrack->get_id();
-		if(trackid == vtxtrackid)
-		  {
-		    event_vtx(0) = vertex->get_x();
-		    event_vtx(1) = vertex->get_y();
-		    event_vtx(2) = vertex->get_z();
-		    if(Verbosity() > 0)
-		      {
-			std::cout << "     setting event_vertex for trackid " << trackid << " to vtxid " << vtxkey
-				  << " vtx " << event_vtx(0) << "  " << event_vtx(1) << "  " << event_vtx(2) << std::endl;
-		      }
-		  }
-	      }
-	  }
-      }
-    
-    //  skip the common vertex requirement for this track unless there are 3 tracks in the event
-    if(accepted_tracks < 3) {  continue; }
-    
-    // The residual for the vtx case is (event vtx - track vtx)
-    // that is -dca
-    float dca3dxy = 0;
-    float dca3dz = 0;
-    float dca3dxysigma = 0;
-    float dca3dzsigma = 0;
-    if(!straight_line_fit)
-      {
-	get_dca(newTrack, dca3dxy, dca3dz, dca3dxysigma, dca3dzsigma, event_vtx);
-      }
-    else
-      {
-	get_dca_zero_field(newTrack, dca3dxy, dca3dz, dca3dxysigma, dca3dzsigma, event_vtx);
-      } 
-    
-    // These are local coordinate residuals in the perigee surface
-   Acts::Vector2 vtx_residual(-dca3dxy, -dca3dz);
-
-    float lclvtx_derivativeX[AlignmentDefs::NLC];
-    float lclvtx_derivativeY[AlignmentDefs::NLC];
-    if(straight_line_fit)
-      {
-	getLocalVtxDerivativesZeroFieldXY(newTrack, event_vtx, fitpars, lclvtx_derivativeX, lclvtx_derivativeY);
-      }
-    else
-      {
-	getLocalVtxDerivativesXY(newTrack, event_vtx, fitpars, lclvtx_derivativeX, lclvtx_derivativeY);
-      }
+    if(is_vertex_param_fixed(p))
+    {
+      glblvtx_derivativeX[p] = 0;
+      glblvtx_derivativeY[p] = 0;
+    }
 
-    // The global derivs dimensions are [alpha/beta/gamma](x/y/z)
-    float glblvtx_derivativeX[3];
-    float glblvtx_derivativeY[3];
-    getGlobalVtxDerivativesXY(newTrack, event_vtx, glblvtx_derivativeX, glblvtx_derivativeY);
 
-    if (use_event_vertex)
+    }
+    if (Verbosity() > 1)
     {
-      for(int p = 0; p<3; p++)
-      {
+      std::cout << "vertex info for track " << trackid << " with charge " << newTrack.get_charge() << std::endl;
 
-
-      if(is_vertex_param_fixed(p))
+      std::cout << "vertex is " << event_vtx.transpose() << std::endl;
+      std::cout << "vertex residuals " << vtx_residual.transpose()
+                << std::endl;
+      std::cout << "local derivatives " << std::endl;
+      for (float i : lclvtx_derivativeX)
       {
-        glblvtx_derivativeX[p] = 0;
-        glblvtx_derivativeY[p] = 0;
-      }
-
-
+        std::cout << i << ", ";
       }
-      if (Verbosity() > 1)
+      std::cout << std::endl;
+      for (float i : lclvtx_derivativeY)
       {
-        std::cout << "vertex info for track " << trackid << " with charge " << newTrack.get_charge() << std::endl;
-
-        std::cout << "vertex is " << event_vtx.transpose() << std::endl;
-        std::cout << "vertex residuals " << vtx_residual.transpose()
-                  << std::endl;
-        std::cout << "local derivatives " << std::endl;
-        for (float i : lclvtx_derivativeX)
-        {
-          std::cout << i << ", ";
-        }
-        std::cout << std::endl;
-        for (float i : lclvtx_derivativeY)
-        {
-          std::cout << i << ", ";
-        }
-        std::cout << "global vtx derivaties " << std::endl;
-        for (float i : glblvtx_derivativeX)
-        {
-          std::cout << i << ", ";
-        }
-        std::cout << std::endl;
-        for (float i : glblvtx_derivativeY)
-        {
-          std::cout << i << ", ";
-        }
+        std::cout << i << ", ";
       }
-
-      if (!isnan(vtx_residual(0)))
+      std::cout << "global vtx derivaties " << std::endl;
+      for (float i : glblvtx_derivativeX)
       {
-        _mille->mille(AlignmentDefs::NLC, lclvtx_derivativeX, AlignmentDefs::NGLVTX, glblvtx_derivativeX, AlignmentDefs::glbl_vtx_label, vtx_residual(0), vtx_sigma(0));
+        std::cout << i << ", ";
       }
-      if (!isnan(vtx_residual(1)))
+      std::cout << std::endl;
+      for (float i : glblvtx_derivativeY)
       {
-        _mille->mille(AlignmentDefs::NLC, lclvtx_derivativeY, AlignmentDefs::NGLVTX, glblvtx_derivativeY, AlignmentDefs::glbl_vtx_label, vtx_residual(1), vtx_sigma(1));
+        std::cout << i << ", ";
       }
     }
 
-    if (make_ntuple)
+    if (!isnan(vtx_residual(0)))
     {
-      Acts::Vector3 mom(newTrack.get_px(), newTrack.get_py(), newTrack.get_pz());
-      Acts::Vector3 r = mom.cross(Acts::Vector3(0., 0., 1.));
-      float perigee_phi = atan2(r(1), r(0));
-      float track_phi = atan2(newTrack.get_py(), newTrack.get_px());
-      if(straight_line_fit)
-	{
-	  float ntp_data[27] = {(float) trackid, (float) vtx_residual(0), (float) vtx_residual(1), (float) vtx_sigma(0), (float) vtx_sigma(1),
-				lclvtx_derivativeX[0], lclvtx_derivativeX[1], lclvtx_derivativeX[2], lclvtx_derivativeX[3],
-				glblvtx_derivativeX[0], glblvtx_derivativeX[1], glblvtx_derivativeX[2],
-				lclvtx_derivativeY[0], lclvtx_derivativeY[1], lclvtx_derivativeY[2], lclvtx_derivativeY[3],
-				glblvtx_derivativeY[0], glblvtx_derivativeY[1], glblvtx_derivativeY[2],
-				newTrack.get_x(), newTrack.get_y(), newTrack.get_z(), 
-				(float) event_vtx(0), (float ) event_vtx(1), (float) event_vtx(2), track_phi, perigee_phi};
-	  
-	  track_ntp->Fill(ntp_data);
-	}
-      else
-	{
-	  float ntp_data[29] = {(float) trackid, (float) vtx_residual(0), (float) vtx_residual(1), (float) vtx_sigma(0), (float) vtx_sigma(1),
-				lclvtx_derivativeX[0], lclvtx_derivativeX[1], lclvtx_derivativeX[2], lclvtx_derivativeX[3], lclvtx_derivativeX[4],
-				glblvtx_derivativeX[0], glblvtx_derivativeX[1], glblvtx_derivativeX[2],
-				lclvtx_derivativeY[0], lclvtx_derivativeY[1], lclvtx_derivativeY[2], lclvtx_derivativeY[3], lclvtx_derivativeY[4],
-				glblvtx_derivativeY[0], glblvtx_derivativeY[1], glblvtx_derivativeY[2],
-				newTrack.get_x(), newTrack.get_y(), newTrack.get_z(), 
-				(float) event_vtx(0), (float ) event_vtx(1), (float) event_vtx(2), track_phi, perigee_phi};
-	  
-	  track_ntp->Fill(ntp_data);
-	}
+      mille->mille(AlignmentDefs::NLC, lclvtx_derivativeX, AlignmentDefs::NGLVTX, glblvtx_derivativeX, AlignmentDefs::glbl_vtx_label, vtx_residual(0), vtx_sigma(0));
     }
-
-    if (Verbosity() > 1)
+    if (!isnan(vtx_residual(1)))
     {
-      std::cout << "vtx_residual xy: " << vtx_residual(0) << " vtx_residual z: " << vtx_residual(1) << " vtx_sigma xy: " << vtx_sigma(0) << " vtx_sigma z: " << vtx_sigma(1) << std::endl;
-      std::cout << "track_x " << newTrack.get_x() << "track_y " << newTrack.get_y() << "track_z " << newTrack.get_z() << std::endl;
+      mille->mille(AlignmentDefs::NLC, lclvtx_derivativeY, AlignmentDefs::NGLVTX, glblvtx_derivativeY, AlignmentDefs::glbl_vtx_label, vtx_residual(1), vtx_sigma(1));
     }
+  }
 
-    // close out this track
-    _mille->end();
+  if (make_ntuple)
+  {
+    Acts::Vector3 mom(newTrack.get_px(), newTrack.get_py(), newTrack.get_pz());
+    Acts::Vector3 r = mom.cross(Acts::Vector3(0., 0., 1.));
+    float perigee_phi = atan2(r(1), r(0));
+    float track_phi = atan2(newTrack.get_py(), newTrack.get_px());
+    if(straight_line_fit)
+      {
+	rec.track_ntp_row = {(float) trackid, (float) vtx_residual(0), (float) vtx_residual(1), (float) vtx_sigma(0), (float) vtx_sigma(1),
+			     lclvtx_derivativeX[0], lclvtx_derivativeX[1], lclvtx_derivativeX[2], lclvtx_derivativeX[3],
+			     glblvtx_derivativeX[0], glblvtx_derivativeX[1], glblvtx_derivativeX[2],
+			     lclvtx_derivativeY[0], lclvtx_derivativeY[1], lclvtx_derivativeY[2], lclvtx_derivativeY[3],
+			     glblvtx_derivativeY[0], glblvtx_derivativeY[1], glblvtx_derivativeY[2],
+			     newTrack.get_x(), newTrack.get_y(), newTrack.get_z(),
+			     (float) event_vtx(0), (float ) event_vtx(1), (float) event_vtx(2), track_phi, perigee_phi};
+      }
+    else
+      {
+	rec.track_ntp_row = {(float) trackid, (float) vtx_residual(0), (float) vtx_residual(1), (float) vtx_sigma(0), (float) vtx_sigma(1),
+			     lclvtx_derivativeX[0], lclvtx_derivativeX[1], lclvtx_derivativeX[2], lclvtx_derivativeX[3], lclvtx_derivativeX[4],
+			     glblvtx_derivativeX[0], glblvtx_derivativeX[1], glblvtx_derivativeX[2],
+			     lclvtx_derivativeY[0], lclvtx_derivativeY[1], lclvtx_derivativeY[2], lclvtx_derivativeY[3], lclvtx_derivativeY[4],
+			     glblvtx_derivativeY[0], glblvtx_derivativeY[1], glblvtx_derivativeY[2],
+			     newTrack.get_x(), newTrack.get_y(), newTrack.get_z(),
+			     (float) event_vtx(0), (float ) event_vtx(1), (float) event_vtx(2), track_phi, perigee_phi};
+      }
+  }
 
-  }  // end loop over tracks
+  if (Verbosity() > 1)
+  {
+    std::cout << "vtx_residual xy: " << vtx_residual(0) << " vtx_residual z: " << vtx_residual(1) << " vtx_sigma xy: " << vtx_sigma(0) << " vtx_sigma z: " << vtx_sigma(1) << std::endl;
+    std::cout << "track_x " << newTrack.get_x() << "track_y " << newTrack.get_y() << "track_z " << newTrack.get_z() << std::endl;
+  }
 
-  return Fun4AllReturnCodes::EVENT_OK;
+  // close out this track
+  mille->end();
 }
 /*
 std::make_pair<unsigned int, Acts::Vector3> HelicalFitter::getAverageVertex( std::vector<Acts::Vector3> cumulative_vertex)
@@ -1221,8 +1555,12 @@ std::pair<Acts::Vector3, Acts::Vector3> HelicalFitter::get_helix_tangent(const s
 
 int HelicalFitter::End(PHCompositeNode* /*unused*/)
 {
-  // closes output file in destructor
-  delete _mille;
+  // closes output files in destructor
+  for (auto* mille : _mille)
+  {
+    delete mille;
+  }
+  _mille.clear();
 
   if (make_ntuple)
   {
@@ -1427,10 +1765,11 @@ Acts::Vector2 HelicalFitter::getClusterError(TrkrCluster* cluster, TrkrDefs::clu
 }
 
 // new one
-void HelicalFitter::getLocalDerivativesXY(const Surface& surf, const Acts::Vector3& global, const std::vector<float>& fitpars, float lcl_derivativeX[5], float lcl_derivativeY[5], unsigned int layer)
+void HelicalFitter::getLocalDerivativesXY(DerivativeWorkspace& ws, const std::vector<float>& fitpars)
 {
   // Calculate the derivatives of the residual wrt the track parameters numerically
-  std::vector<float> temp_fitpars;
+  // Each parameter variation is applied to all clusters of the track in one pass
+  std::vector<float> temp_fitpars = fitpars;
 
   std::vector<float> fitpars_delta;
   fitpars_delta.push_back(0.1);  // radius, cm
@@ -1439,66 +1778,51 @@ void HelicalFitter::getLocalDerivativesXY(const Surface& surf, const Acts::Vecto
   fitpars_delta.push_back(0.1);  // zslope, cm
   fitpars_delta.push_back(0.1);  // Z0, cm
 
-  temp_fitpars.reserve(fitpars.size());
-  for (float fitpar : fitpars)
-  {
-    temp_fitpars.push_back(fitpar);
-  }
-
-  // calculate projX and projY vectors once for the optimum fit parameters
-  if (Verbosity() > 1)
-  {
-    std::cout << "Call get_helix_tangent for best fit fitpars" << std::endl;
-  }
-  std::pair<Acts::Vector3, Acts::Vector3> tangent = get_helix_tangent(fitpars, global);
-
-  Acts::Vector3 projX(0, 0, 0), projY(0, 0, 0);
-  get_projectionXY(surf, tangent, projX, projY);
-
-  Acts::Vector3 intersection = get_helix_surface_intersection(surf, temp_fitpars, global);
-
   // loop over the track fit parameters
   for (unsigned int ip = 0; ip < fitpars.size(); ++ip)
   {
-    Acts::Vector3 intersection_delta[2];
     for (int ipm = 0; ipm < 2; ++ipm)
     {
       temp_fitpars[ip] = fitpars[ip];  // reset to best fit value
       float deltapm = pow(-1.0, ipm);
       temp_fitpars[ip] += deltapm * fitpars_delta[ip];
 
-      Acts::Vector3 temp_intersection = get_helix_surface_intersection(surf, temp_fitpars, global);
-      intersection_delta[ipm] = temp_intersection - intersection;
+      for (unsigned int i = 0; i < ws.size(); ++i)
+      {
+        std::pair<Acts::Vector3, Acts::Vector3> line = get_helix_tangent(temp_fitpars, ws.global[i]);
+        Acts::Vector3 temp_intersection = get_line_plane_intersection(line.first, line.second, ws.sensorCenter[i] * 0.1, ws.sensorNormal[i]);
+        ws.delta[ipm][i] = temp_intersection - ws.fitpoint[i];
+      }
     }
-    Acts::Vector3 average_intersection_delta = (intersection_delta[0] - intersection_delta[1]) / (2 * fitpars_delta[ip]);
+    temp_fitpars[ip] = fitpars[ip];
 
-    if (Verbosity() > 1)
+    for (unsigned int i = 0; i < ws.size(); ++i)
     {
-      std::cout << " average_intersection_delta / delta " << average_intersection_delta(0) << "  " << average_intersection_delta(1) << "  " << average_intersection_delta(2) << std::endl;
-    }
+      Acts::Vector3 average_intersection_delta = (ws.delta[0][i] - ws.delta[1][i]) / (2 * fitpars_delta[ip]);
 
-    // calculate the change in fit for X and Y
-    // - note negative sign from ATLAS paper is dropped here because mille wants the derivative of the fit, not the derivative of the residual
-    lcl_derivativeX[ip] = average_intersection_delta.dot(projX);
-    lcl_derivativeY[ip] = average_intersection_delta.dot(projY);
-    if (Verbosity() > 1)
-    {
-      std::cout << " layer " << layer << " ip " << ip << "  derivativeX " << lcl_derivativeX[ip] << "  "
-                << " derivativeY " << lcl_derivativeY[ip] << std::endl;
+      // calculate the change in fit for X and Y
+      // - note negative sign from ATLAS paper is dropped here because mille wants the derivative of the fit, not the derivative of the residual
+      ws.lcl_derivativeX[i * AlignmentDefs::NLC + ip] = average_intersection_delta.dot(ws.projX[i]);
+      ws.lcl_derivativeY[i * AlignmentDefs::NLC + ip] = average_intersection_delta.dot(ws.projY[i]);
+      if (Verbosity() > 1)
+      {
+        std::cout << " average_intersection_delta / delta " << average_intersection_delta(0) << "  " << average_intersection_delta(1) << "  " << average_intersection_delta(2) << std::endl;
+        std::cout << " layer " << ws.layer[i] << " ip " << ip << "  derivativeX " << ws.lcl_derivativeX[i * AlignmentDefs::NLC + ip] << "  "
+                  << " derivativeY " << ws.lcl_derivativeY[i * AlignmentDefs::NLC + ip] << std::endl;
+      }
     }
-
-    temp_fitpars[ip] = fitpars[ip];
   }
 }
 
-void HelicalFitter::getLocalDerivativesZeroFieldXY(const Surface& surf, const Acts::Vector3& global, const std::vector<float>& fitpars, float lcl_derivativeX[5], float lcl_derivativeY[5], unsigned int layer)
+void HelicalFitter::getLocalDerivativesZeroFieldXY(DerivativeWorkspace& ws, const std::vector<float>& fitpars)
 {
   // Calculate the derivatives of the residual wrt the track parameters numerically
   // This version differs from the field on one in that:
   // Fitpars has parameters of a straight line (4) instead of a helix (5)
   // The track tangent is just the line direction
+  // The varied line does not depend on the cluster, it is calculated once for all clusters
 
-  std::vector<float> temp_fitpars;
+  std::vector<float> temp_fitpars = fitpars;
 
   std::vector<float> fitpars_delta;
   fitpars_delta.push_back(0.1);  // xyslope, cm
@@ -1506,59 +1830,43 @@ void HelicalFitter::getLocalDerivativesZeroFieldXY(const Surface& surf, const Ac
   fitpars_delta.push_back(0.1);  // zslope, cm
   fitpars_delta.push_back(0.1);  // Z0, cm
 
-  temp_fitpars.reserve(fitpars.size());
-  for (float fitpar : fitpars)
-  {
-    temp_fitpars.push_back(fitpar);
-  }
-
-  // calculate projX and projY vectors once for the optimum fit parameters
-  if (Verbosity() > 1)
-  {
-    std::cout << "Call get_line to get tangent for ZF fitpars" << std::endl;
-  }
-
-  std::pair<Acts::Vector3, Acts::Vector3> tangent = get_line_tangent(fitpars, global);
-
-  Acts::Vector3 projX(0, 0, 0), projY(0, 0, 0);
-  get_projectionXY(surf, tangent, projX, projY);
-
-  Acts::Vector3 intersection = get_line_surface_intersection(surf, temp_fitpars);
-
   // loop over the track fit parameters
   for (unsigned int ip = 0; ip < fitpars.size(); ++ip)
   {
-    Acts::Vector3 intersection_delta[2];
     for (int ipm = 0; ipm < 2; ++ipm)
     {
       temp_fitpars[ip] = fitpars[ip];  // reset to best fit value
       float deltapm = pow(-1.0, ipm);
       temp_fitpars[ip] += deltapm * fitpars_delta[ip];
 
-      Acts::Vector3 temp_intersection = get_line_surface_intersection(surf, temp_fitpars);
-      intersection_delta[ipm] = temp_intersection - intersection;
+      auto line = get_line_zero_field(temp_fitpars);
+      for (unsigned int i = 0; i < ws.size(); ++i)
+      {
+        Acts::Vector3 temp_intersection = get_line_plane_intersection(line.first, line.second, ws.sensorCenter[i] * 0.1, ws.sensorNormal[i]);
+        ws.delta[ipm][i] = temp_intersection - ws.fitpoint[i];
+      }
     }
-    Acts::Vector3 average_intersection_delta = (intersection_delta[0] - intersection_delta[1]) / (2 * fitpars_delta[ip]);
+    temp_fitpars[ip] = fitpars[ip];
 
-    if (Verbosity() > 1)
+    for (unsigned int i = 0; i < ws.size(); ++i)
     {
-      std::cout << " average_intersection_delta / delta " << average_intersection_delta(0) << "  " << average_intersection_delta(1) << "  " << average_intersection_delta(2) << std::endl;
-    }
+      Acts::Vector3 average_intersection_delta = (ws.delta[0][i] - ws.delta[1][i]) / (2 * fitpars_delta[ip]);
 
-    // calculate the change in fit for X and Y
-    // - note negative sign from ATLAS paper is dropped here because mille wants the derivative of the fit, not the derivative of the residual
-    lcl_derivativeX[ip] = average_intersection_delta.dot(projX);
-    lcl_derivativeY[ip] = average_intersection_delta.dot(projY);
-    if (Verbosity() > 1)
-    {
-      std::cout << " layer " << layer << " ip " << ip << "  derivativeX " << lcl_derivativeX[ip] << "  "
-                << " derivativeY " << lcl_derivativeY[ip] << std::endl;
+      // calculate the change in fit for X and Y
+      // - note negative sign from ATLAS paper is dropped here because mille wants the derivative of the fit, not the derivative of the residual
+      ws.lcl_derivativeX[i * AlignmentDefs::NLC + ip] = average_intersection_delta.dot(ws.projX[i]);
+      ws.lcl_derivativeY[i * AlignmentDefs::NLC + ip] = average_intersection_delta.dot(ws.projY[i]);
+      if (Verbosity() > 1)
+      {
+        std::cout << " average_intersection_delta / delta " << average_intersection_delta(0) << "  " << average_intersection_delta(1) << "  " << average_intersection_delta(2) << std::endl;
+        std::cout << " layer " << ws.layer[i] << " ip " << ip << "  derivativeX " << ws.lcl_derivativeX[i * AlignmentDefs::NLC + ip] << "  "
+                  << " derivativeY " << ws.lcl_derivativeY[i * AlignmentDefs::NLC + ip] << std::endl;
+      }
     }
-
-    temp_fitpars[ip] = fitpars[ip];
   }
 }
 
+
 void HelicalFitter::getLocalVtxDerivativesXY(SvtxTrack& track, const Acts::Vector3& event_vtx, const std::vector<float>& fitpars, float lcl_derivativeX[5], float lcl_derivativeY[5])
 {
   // Calculate the derivatives of the residual wrt the track parameters numerically
@@ -1693,42 +2001,9 @@ void HelicalFitter::getLocalVtxDerivativesZeroFieldXY(SvtxTrack& track, const Ac
   }
 }
 
-void HelicalFitter::getGlobalDerivativesXY(const Surface& surf, const Acts::Vector3& global, const Acts::Vector3& fitpoint, const std::vector<float>& fitpars, float glbl_derivativeX[6], float glbl_derivativeY[6], unsigned int layer)
+void HelicalFitter::getGlobalDerivativesXY(DerivativeWorkspace& ws)
 {
-  // calculate projX and projY vectors once for the optimum fit parameters
-  std::pair<Acts::Vector3, Acts::Vector3> tangent;
-  if(straight_line_fit)
-    {
-      tangent = get_line_tangent(fitpars, global);
-    }
-  else
-    {
-      tangent = get_helix_tangent(fitpars, global);
-    }
-
-  Acts::Vector3 projX(0, 0, 0), projY(0, 0, 0);
-  get_projectionXY(surf, tangent, projX, projY);
-
-  /*
-  // translations in polar coordinates, unit vectors must be in polar coordinates
-  //   -- There is an implicit assumption here that unitrphi is a length
-  // unit vector in r is the normalized radial vector pointing to the surface center
-
-  Acts::Vector3 center = surf->center(_tGeometry->geometry().getGeoContext()) / Acts::UnitConstants::cm;
-  Acts::Vector3 unitr( center(0), center(1), 0.0);
-  unitr /= unitr.norm();
-  float phi = atan2(center(1), center(0));
-  Acts::Vector3 unitrphi(-sin(phi), cos(phi), 0.0);  // unit vector phi in polar coordinates
-  Acts::Vector3 unitz(0, 0, 1); 
-
-  glbl_derivativeX[3] = unitr.dot(projX);
-  glbl_derivativeX[4] = unitrphi.dot(projX);
-  glbl_derivativeX[5] = unitz.dot(projX);
-
-  glbl_derivativeY[3] = unitr.dot(projY);
-  glbl_derivativeY[4] = unitrphi.dot(projY);
-  glbl_derivativeY[5] = unitz.dot(projY);
-  */
+  // the projX and projY vectors are calculated once per cluster for the optimum fit parameters
 
   // translations in cartesian coordinates
   // Unit vectors in the global cartesian frame
@@ -1736,68 +2011,49 @@ void HelicalFitter::getGlobalDerivativesXY(const Surface& surf, const Acts::Vect
   Acts::Vector3 unity(0, 1, 0);
   Acts::Vector3 unitz(0, 0, 1);
 
-  glbl_derivativeX[3] = unitx.dot(projX);
-  glbl_derivativeX[4] = unity.dot(projX);
-  glbl_derivativeX[5] = unitz.dot(projX);
+  for (unsigned int i = 0; i < ws.size(); ++i)
+  {
+    float* glbl_derivativeX = &ws.glbl_derivativeX[i * AlignmentDefs::NGL];
+    float* glbl_derivativeY = &ws.glbl_derivativeY[i * AlignmentDefs::NGL];
+    const Acts::Vector3& projX = ws.projX[i];
+    const Acts::Vector3& projY = ws.projY[i];
 
-  glbl_derivativeY[3] = unitx.dot(projY);
-  glbl_derivativeY[4] = unity.dot(projY);
-  glbl_derivativeY[5] = unitz.dot(projY);
+    glbl_derivativeX[3] = unitx.dot(projX);
+    glbl_derivativeX[4] = unity.dot(projX);
+    glbl_derivativeX[5] = unitz.dot(projX);
 
-  /*
-  // note: the global derivative sign should be reversed from the ATLAS paper
-  // because mille wants the derivative of the fit, while the ATLAS paper gives the derivative of the residual.
-  // But this sign reversal does NOT work.
-  // Verified that not reversing the sign here produces the correct sign of the prediction of the residual..
-  for(unsigned int i = 3; i < 6; ++i)
-  {
-  glbl_derivativeX[i] *= -1.0;
-  glbl_derivativeY[i] *= -1.0;
-  }
-  */
-  // rotations
-  // need center of sensor to intersection point
-  Acts::Vector3 sensorCenter = surf->center(_tGeometry->geometry().getGeoContext()) / Acts::UnitConstants::cm;  // convert to cm
-  Acts::Vector3 OM = fitpoint - sensorCenter;              // this effectively reverses the sign from the ATLAS paper
+    glbl_derivativeY[3] = unitx.dot(projY);
+    glbl_derivativeY[4] = unity.dot(projY);
+    glbl_derivativeY[5] = unitz.dot(projY);
 
-  /*
-  glbl_derivativeX[0] = (unitr.cross(OM)).dot(projX);
-  glbl_derivativeX[1] = (unitrphi.cross(OM)).dot(projX);
-  glbl_derivativeX[2] = (unitz.cross(OM)).dot(projX);
+    // note: the global derivative sign should be reversed from the ATLAS paper
+    // because mille wants the derivative of the fit, while the ATLAS paper gives the derivative of the residual.
+    // But this sign reversal does NOT work.
+    // Verified that not reversing the sign here produces the correct sign of the prediction of the residual..
 
-  glbl_derivativeY[0] = (unitr.cross(OM)).dot(projY);
-  glbl_derivativeY[1] = (unitrphi.cross(OM)).dot(projY);
-  glbl_derivativeY[2] = (unitz.cross(OM)).dot(projY);
-  */
+    // rotations
+    // need center of sensor to intersection point
+    Acts::Vector3 sensorCenter = ws.sensorCenter[i] / Acts::UnitConstants::cm;  // convert to cm
+    Acts::Vector3 OM = ws.fitpoint[i] - sensorCenter;                           // this effectively reverses the sign from the ATLAS paper
 
-  glbl_derivativeX[0] = (unitx.cross(OM)).dot(projX);
-  glbl_derivativeX[1] = (unity.cross(OM)).dot(projX);
-  glbl_derivativeX[2] = (unitz.cross(OM)).dot(projX);
+    glbl_derivativeX[0] = (unitx.cross(OM)).dot(projX);
+    glbl_derivativeX[1] = (unity.cross(OM)).dot(projX);
+    glbl_derivativeX[2] = (unitz.cross(OM)).dot(projX);
 
-  glbl_derivativeY[0] = (unitx.cross(OM)).dot(projY);
-  glbl_derivativeY[1] = (unity.cross(OM)).dot(projY);
-  glbl_derivativeY[2] = (unitz.cross(OM)).dot(projY);
+    glbl_derivativeY[0] = (unitx.cross(OM)).dot(projY);
+    glbl_derivativeY[1] = (unity.cross(OM)).dot(projY);
+    glbl_derivativeY[2] = (unitz.cross(OM)).dot(projY);
 
-  if (Verbosity() > 1)
+    if (Verbosity() > 1)
     {
       for (int ip = 0; ip < 6; ++ip)
-	{
-	  std::cout << " layer " << layer << " ip " << ip 
-		    << "  glbl_derivativeX " << glbl_derivativeX[ip] << "  "
-		    << " glbl_derivativeY " << glbl_derivativeY[ip] << std::endl;
-	}
-    }
-
-  /*
-  if(Verbosity() > 2)
-    {
-      std::cout << "    unitr mag: " << unitr.norm() << " unitr: " << std::endl << unitr << std::endl;
-      std::cout << "    unitrphi mag: " << unitrphi.norm() << " unitrphi: " << std::endl << unitrphi << std::endl;
-      std::cout << "    unitz mag: " << unitz.norm() << " unitz: " << std::endl << unitz << std::endl;
-      std::cout << "    projX: " << std::endl << projX << std::endl;
-      std::cout << "    projY: " << std::endl << projY << std::endl;
+      {
+        std::cout << " layer " << ws.layer[i] << " ip " << ip
+                  << "  glbl_derivativeX " << glbl_derivativeX[ip] << "  "
+                  << " glbl_derivativeY " << glbl_derivativeY[ip] << std::endl;
+      }
     }
-  */
+  }
 }
 
 void HelicalFitter::getGlobalVtxDerivativesXY(SvtxTrack& track, const Acts::Vector3& event_vtx, float glbl_derivativeX[3], float glbl_derivativeY[3])
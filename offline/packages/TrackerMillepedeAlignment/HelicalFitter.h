@@ -17,6 +17,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 class PHCompositeNode;
 class TrackSeedContainer;
@@ -107,13 +108,29 @@ class HelicalFitter : public SubsysReco, public PHParameterInterface
 
   void set_dca_cut(float dca) { dca_cut = dca; }
 
+  // number of threads for the track fits and the derivatives, 0 = all cores
+  // with more than one thread every thread writes its own mille data file (data file name
+  // with _shard<n> before the extension), the steering file lists them in shard order
+  void set_nthreads(unsigned int n) { nthreads = n; }
+
  private:
-  Mille* _mille;
+  struct TrackRecord;
+  struct DerivativeWorkspace;
+
+  // one writer per shard, a single one writing data_outfilename without threads
+  std::vector<Mille*> _mille;
 
   int GetNodes(PHCompositeNode* topNode);
   int CreateNodes(PHCompositeNode* topNode);
   void getTrackletClusterList(TrackSeed* tracklet, std::vector<TrkrDefs::cluskey>& cluskey_vec);
 
+  // the steps of process_event for one track, fitTracklet, processTrackClusters and
+  // writeTrackRecord run on the worker threads
+  bool fitTracklet(unsigned int trackid, TrackRecord& rec);
+  void processTrackClusters(TrackRecord& rec, DerivativeWorkspace& ws);
+  void writeTrackRecord(TrackRecord& rec, Mille* mille, unsigned int accepted_tracks);
+  std::string shardFileName(unsigned int shard) const;
+
   Acts::Vector3 getPCALinePoint(const Acts::Vector3& global, const Acts::Vector3& tangent, const Acts::Vector3& posref);
   Acts::Vector3 get_line_plane_intersection(const Acts::Vector3& PCA, const Acts::Vector3& tangent,
                                             const Acts::Vector3& sensor_center, const Acts::Vector3& sensor_normal);
@@ -135,13 +152,14 @@ class HelicalFitter : public SubsysReco, public PHParameterInterface
   bool is_layer_param_fixed(unsigned int layer, unsigned int param);
   bool is_vertex_param_fixed(unsigned int param);
 
-  void getLocalDerivativesXY(const Surface& surf, const Acts::Vector3& global, const std::vector<float>& fitpars, float lcl_derivativeX[5], float lcl_derivativeY[5], unsigned int layer);
-  void getLocalDerivativesZeroFieldXY(const Surface& surf,  const Acts::Vector3& global, const std::vector<float>& fitpars, float lcl_derivativeX[5], float lcl_derivativeY[5], unsigned int layer);
+  // derivatives for all clusters of a track in the workspace at once
+  void getLocalDerivativesXY(DerivativeWorkspace& ws, const std::vector<float>& fitpars);
+  void getLocalDerivativesZeroFieldXY(DerivativeWorkspace& ws, const std::vector<float>& fitpars);
 
   void getLocalVtxDerivativesXY(SvtxTrack& track, const Acts::Vector3& track_vtx, const std::vector<float>& fitpars, float lcl_derivativeX[5], float lcl_derivativeY[5]);
   void getLocalVtxDerivativesZeroFieldXY(SvtxTrack& track, const Acts::Vector3& event_vtx, const std::vector<float>& fitpars, float lcl_derivativeX[5], float lcl_derivativeY[5]);
 
-  void getGlobalDerivativesXY(const Surface& surf, const Acts::Vector3& global, const Acts::Vector3& fitpoint, const std::vector<float>& fitpars, float glb_derivativeX[6], float glbl_derivativeY[6], unsigned int layer);
+  void getGlobalDerivativesXY(DerivativeWorkspace& ws);
 
   void getGlobalVtxDerivativesXY(SvtxTrack& track, const Acts::Vector3& track_vtx, float glbl_derivativeX[3], float glbl_derivativeY[3]);
 
@@ -221,6 +239,8 @@ class HelicalFitter : public SubsysReco, public PHParameterInterface
 
   int event{0};
 
+  unsigned int nthreads{1};
+
   Acts::Vector3 vertexPosition;
   Acts::Vector3 vertexPosUncertainty;
   Acts::Vector2 vtx_sigma;
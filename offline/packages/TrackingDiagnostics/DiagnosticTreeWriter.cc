@@ -0,0 +1,349 @@
+#include "DiagnosticTreeWriter.h"
+
+#include <phool/phool.h>
+
+#include <RVersion.h>
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TNtuple.h>
+#include <TROOT.h>
+#include <TTree.h>
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 34, 0)
+#define DIAGNOSTICTREEWRITER_RNTUPLE
+#include <ROOT/REntry.hxx>
+#include <ROOT/RField.hxx>
+#include <ROOT/RNTupleModel.hxx>
+#include <ROOT/RNTupleWriteOptions.hxx>
+#include <ROOT/RNTupleWriter.hxx>
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+namespace
+{
+  // set by EnableParallelCompression(), the RNTuple writers stay off the implicit MT pool otherwise
+  bool parallel_compression = false;
+
+  class TTreeWriter : public DiagnosticTreeWriter
+  {
+   public:
+    TTreeWriter(const std::string &name, const std::string &title)
+      : m_tree(new TTree(name.c_str(), title.c_str()))
+    {
+    }
+    TTreeWriter(const std::string &name, const std::string &title, const std::string &varlist)
+      : m_ntuple(new TNtuple(name.c_str(), title.c_str(), varlist.c_str()))
+    {
+      m_tree = m_ntuple;
+    }
+    // the tree belongs to its directory
+    ~TTreeWriter() override = default;
+
+    void Fill() override { m_tree->Fill(); }
+    void Fill(const float *values) override { m_ntuple->Fill(values); }
+    void Write() override { m_tree->Write(); }
+    long long GetEntries() const override { return m_tree->GetEntries(); }
+    Format GetFormat() const override { return TTREE; }
+
+   protected:
+    void AddColumn(const Column &column) override
+    {
+      if (!column.leaflist.empty())
+      {
+        m_tree->Branch(column.name.c_str(), column.address, column.leaflist.c_str());
+        return;
+      }
+      switch (column.type)
+      {
+      case INT:
+        m_tree->Branch(column.name.c_str(), static_cast<int *>(column.address));
+        break;
+      case UINT:
+        m_tree->Branch(column.name.c_str(), static_cast<unsigned int *>(column.address));
+        break;
+      case FLOAT:
+        m_tree->Branch(column.name.c_str(), static_cast<float *>(column.address));
+        break;
+      case DOUBLE:
+        m_tree->Branch(column.name.c_str(), static_cast<double *>(column.address));
+        break;
+      case ULONG:
+        m_tree->Branch(column.name.c_str(), static_cast<uint64_t *>(column.address));
+        break;
+      case VINT:
+        m_tree->Branch(column.name.c_str(), static_cast<std::vector<int> *>(column.address));
+        break;
+      case VUINT:
+        m_tree->Branch(column.name.c_str(), static_cast<std::vector<unsigned int> *>(column.address));
+        break;
+      case VFLOAT:
+        m_tree->Branch(column.name.c_str(), static_cast<std::vector<float> *>(column.address));
+        break;
+      case VDOUBLE:
+        m_tree->Branch(column.name.c_str(), static_cast<std::vector<double> *>(column.address));
+        break;
+      case VULONG:
+        m_tree->Branch(column.name.c_str(), static_cast<std::vector<uint64_t> *>(column.address));
+        break;
+      }
+    }
+
+   private:
+    TTree *m_tree{nullptr};
+    TNtuple *m_ntuple{nullptr};
+  };
+
+#ifdef DIAGNOSTICTREEWRITER_RNTUPLE
+// the RNTuple classes moved out of Experimental in 6.36
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 36, 0)
+  namespace RNT = ROOT;
+#else
+  namespace RNT = ROOT::Experimental;
+#endif
+
+  std::vector<std::string> split_varlist(const std::string &varlist)
+  {
+    std::vector<std::string> names;
+    std::stringstream ss(varlist);
+    std::string name;
+    while (std::getline(ss, name, ':'))
+    {
+      names.push_back(name);
+    }
+    return names;
+  }
+
+  class RNTupleTreeWriter : public DiagnosticTreeWriter
+  {
+   public:
+    RNTupleTreeWriter(const std::string &name, TDirectory *dir)
+      : m_name(name)
+      , m_dir(dir)
+      , m_model(RNT::RNTupleModel::CreateBare())
+    {
+    }
+    RNTupleTreeWriter(const std::string &name, TDirectory *dir, const std::string &varlist)
+      : RNTupleTreeWriter(name, dir)
+    {
+      const std::vector<std::string> names = split_varlist(varlist);
+      // sized once, the columns point into it
+      m_buffer.resize(names.size());
+      for (size_t i = 0; i < names.size(); i++)
+      {
+        AddColumn({names[i], "", FLOAT, &m_buffer[i]});
+      }
+    }
+    // the entry has to go before the writer, destroying the writer commits the RNTuple
+    ~RNTupleTreeWriter() override
+    {
+      m_entry.reset();
+      m_writer.reset();
+    }
+
+    void Fill() override
+    {
+      if (!m_writer && !Open())
+      {
+        return;
+      }
+      m_writer->Fill(*m_entry);
+      m_nentries++;
+    }
+    void Fill(const float *values) override
+    {
+      std::copy(values, values + m_buffer.size(), m_buffer.begin());
+      Fill();
+    }
+    void Write() override
+    {
+      if (!m_writer && !Open())
+      {
+        return;
+      }
+      m_entry.reset();
+      m_writer.reset();
+      m_written = true;
+    }
+    long long GetEntries() const override { return m_nentries; }
+    Format GetFormat() const override { return RNTUPLE; }
+
+   protected:
+    void AddColumn(const Column &column) override
+    {
+      if (!m_model)
+      {
+        std::cout << PHWHERE << " " << m_name << ": columns have to be added before the first Fill(), ignoring "
+                  << column.name << std::endl;
+        return;
+      }
+      m_model->AddField(MakeField(column));
+      m_columns.push_back(column);
+    }
+
+   private:
+    static std::unique_ptr<RNT::RFieldBase> MakeField(const Column &column)
+    {
+      switch (column.type)
+      {
+      case INT:
+        return std::make_unique<RNT::RField<int>>(column.name);
+      case UINT:
+        return std::make_unique<RNT::RField<unsigned int>>(column.name);
+      case FLOAT:
+        return std::make_unique<RNT::RField<float>>(column.name);
+      case DOUBLE:
+        return std::make_unique<RNT::RField<double>>(column.name);
+      case ULONG:
+        return std::make_unique<RNT::RField<uint64_t>>(column.name);
+      case VINT:
+        return std::make_unique<RNT::RField<std::vector<int>>>(column.name);
+      case VUINT:
+        return std::make_unique<RNT::RField<std::vector<unsigned int>>>(column.name);
+      case VFLOAT:
+        return std::make_unique<RNT::RField<std::vector<float>>>(column.name);
+      case VDOUBLE:
+        return std::make_unique<RNT::RField<std::vector<double>>>(column.name);
+      case VULONG:
+        return std::make_unique<RNT::RField<std::vector<uint64_t>>>(column.name);
+      }
+      return nullptr;
+    }
+
+    void Bind(const Column &column)
+    {
+      switch (column.type)
+      {
+      case INT:
+        m_entry->BindRawPtr(column.name, static_cast<int *>(column.address));
+        break;
+      case UINT:
+        m_entry->BindRawPtr(column.name, static_cast<unsigned int *>(column.address));
+        break;
+      case FLOAT:
+        m_entry->BindRawPtr(column.name, static_cast<float *>(column.address));
+        break;
+      case DOUBLE:
+        m_entry->BindRawPtr(column.name, static_cast<double *>(column.address));
+        break;
+      case ULONG:
+        m_entry->BindRawPtr(column.name, static_cast<uint64_t *>(column.address));
+        break;
+      case VINT:
+        m_entry->BindRawPtr(column.name, static_cast<std::vector<int> *>(column.address));
+        break;
+      case VUINT:
+        m_entry->BindRawPtr(column.name, static_cast<std::vector<unsigned int> *>(column.address));
+        break;
+      case VFLOAT:
+        m_entry->BindRawPtr(column.name, static_cast<std::vector<float> *>(column.address));
+        break;
+      case VDOUBLE:
+        m_entry->BindRawPtr(column.name, static_cast<std::vector<double> *>(column.address));
+        break;
+      case VULONG:
+        m_entry->BindRawPtr(column.name, static_cast<std::vector<uint64_t> *>(column.address));
+        break;
+      }
+    }
+
+    // the model is frozen here, the entry is bound once to the members
+    bool Open()
+    {
+      if (m_written)
+      {
+        std::cout << PHWHERE << " " << m_name << " was already written" << std::endl;
+        return false;
+      }
+      RNT::RNTupleWriteOptions options;
+      options.SetUseImplicitMT(parallel_compression ? RNT::RNTupleWriteOptions::EImplicitMT::kDefault : RNT::RNTupleWriteOptions::EImplicitMT::kOff);
+      if (m_dir->GetFile())
+      {
+        options.SetCompression(m_dir->GetFile()->GetCompressionSettings());
+      }
+      m_writer = RNT::RNTupleWriter::Append(std::move(m_model), m_name, *m_dir, options);
+      m_entry = m_writer->CreateEntry();
+      for (const auto &column : m_columns)
+      {
+        Bind(column);
+      }
+      return true;
+    }
+
+    std::string m_name;
+    TDirectory *m_dir{nullptr};
+    std::unique_ptr<RNT::RNTupleModel> m_model;
+    std::unique_ptr<RNT::RNTupleWriter> m_writer;
+    std::unique_ptr<RNT::REntry> m_entry;
+    std::vector<Column> m_columns;
+    std::vector<float> m_buffer;
+    long long m_nentries{0};
+    bool m_written{false};
+  };
+#endif
+
+  bool use_rntuple(const DiagnosticTreeWriter::Format format)
+  {
+    if (format != DiagnosticTreeWriter::RNTUPLE)
+    {
+      return false;
+    }
+#ifdef DIAGNOSTICTREEWRITER_RNTUPLE
+    return true;
+#else
+    static bool printed = false;
+    if (!printed)
+    {
+      std::cout << PHWHERE << " RNTuple output needs ROOT 6.34 or newer, writing TTrees" << std::endl;
+      printed = true;
+    }
+    return false;
+#endif
+  }
+}  // namespace
+
+//____________________________________________________________________________..
+DiagnosticTreeWriter *DiagnosticTreeWriter::Create(const Format format, const std::string &name, const std::string &title)
+{
+#ifdef DIAGNOSTICTREEWRITER_RNTUPLE
+  if (use_rntuple(format))
+  {
+    return new RNTupleTreeWriter(name, gDirectory);
+  }
+#else
+  use_rntuple(format);
+#endif
+  return new TTreeWriter(name, title);
+}
+
+DiagnosticTreeWriter *DiagnosticTreeWriter::CreateNtuple(const Format format, const std::string &name, const std::string &title, const std::string &varlist)
+{
+#ifdef DIAGNOSTICTREEWRITER_RNTUPLE
+  if (use_rntuple(format))
+  {
+    return new RNTupleTreeWriter(name, gDirectory, varlist);
+  }
+#else
+  use_rntuple(format);
+#endif
+  return new TTreeWriter(name, title, varlist);
+}
+
+void DiagnosticTreeWriter::EnableParallelCompression(const unsigned int nthreads)
+{
+  if (nthreads == 0)
+  {
+    return;
+  }
+  parallel_compression = true;
+  if (ROOT::IsImplicitMTEnabled())
+  {
+    std::cout << PHWHERE << " ROOT implicit MT is already enabled with " << ROOT::GetThreadPoolSize()
+              << " threads, using it instead of " << nthreads << " threads" << std::endl;
+    return;
+  }
+  ROOT::EnableImplicitMT(nthreads);
+}
@@ -0,0 +1,101 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef TRACKINGDIAGNOSTICS_DIAGNOSTICTREEWRITER_H
+#define TRACKINGDIAGNOSTICS_DIAGNOSTICTREEWRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Output of the diagnostic trees/ntuples with a choice of backend.
+// Columns are bound to the addresses of the module's members like TTree branches,
+// Fill() writes the current values:
+//
+//   DiagnosticTreeWriter *tree = DiagnosticTreeWriter::Create(DiagnosticTreeWriter::RNTUPLE, "residualtree", "");
+//   tree->Branch("pt", &m_pt, "m_pt/F");
+//   tree->Branch("gx", &m_clusgx);   // std::vector<float>
+//   ... tree->Fill() per track, tree->Write() and delete before the file is closed
+//
+// TTREE writes exactly what the modules wrote before. RNTUPLE (ROOT >= 6.34,
+// otherwise it falls back to TTREE) writes the same columns as an RNTuple with
+// the same name into the current directory. The entry is bound once to the
+// members, Fill() does not copy the values, the pages of each column are
+// buffered and compressed/written per cluster. The RNTuple pages are compressed
+// serially unless EnableParallelCompression() was called.
+class DiagnosticTreeWriter
+{
+ public:
+  enum Format
+  {
+    TTREE = 0,
+    RNTUPLE = 1
+  };
+
+  virtual ~DiagnosticTreeWriter() = default;
+
+  //! writer for bound columns (TTree::Branch like), created in the current directory
+  static DiagnosticTreeWriter *Create(const Format format, const std::string &name, const std::string &title);
+  //! writer for an all float ntuple (TNtuple like, "a:b:c"), filled with Fill(const float *)
+  static DiagnosticTreeWriter *CreateNtuple(const Format format, const std::string &name, const std::string &title, const std::string &varlist);
+
+  //! compress the RNTuple pages of the writers opened afterwards on nthreads threads.
+  //! This enables the ROOT implicit MT, which is global: it stays on for the
+  //! whole process and is used by every ROOT component which supports it (TTree
+  //! basket compression and reading, RDataFrame, ...). It is never called by the
+  //! modules, call it explicitly from the macro before the first event if wanted.
+  static void EnableParallelCompression(const unsigned int nthreads);
+
+  //! the leaflist is only used by the TTree backend, the column type follows from the address
+  template <class T>
+  void Branch(const std::string &name, T *address, const std::string &leaflist = "")
+  {
+    AddColumn({name, leaflist, columnType(address), address});
+  }
+
+  virtual void Fill() = 0;
+  virtual void Fill(const float *values) = 0;
+  //! write to the directory the writer was created in (commits the RNTuple)
+  virtual void Write() = 0;
+  virtual long long GetEntries() const = 0;
+  virtual Format GetFormat() const = 0;
+
+ protected:
+  enum ColumnType
+  {
+    INT,
+    UINT,
+    FLOAT,
+    DOUBLE,
+    ULONG,
+    VINT,
+    VUINT,
+    VFLOAT,
+    VDOUBLE,
+    VULONG
+  };
+
+  struct Column
+  {
+    std::string name;
+    std::string leaflist;
+    ColumnType type;
+    void *address;
+  };
+
+  DiagnosticTreeWriter() = default;
+  virtual void AddColumn(const Column &column) = 0;
+
+ private:
+  static ColumnType columnType(const int * /*unused*/) { return INT; }
+  static ColumnType columnType(const unsigned int * /*unused*/) { return UINT; }
+  static ColumnType columnType(const float * /*unused*/) { return FLOAT; }
+  static ColumnType columnType(const double * /*unused*/) { return DOUBLE; }
+  static ColumnType columnType(const uint64_t * /*unused*/) { return ULONG; }
+  static ColumnType columnType(const std::vector<int> * /*unused*/) { return VINT; }
+  static ColumnType columnType(const std::vector<unsigned int> * /*unused*/) { return VUINT; }
+  static ColumnType columnType(const std::vector<float> * /*unused*/) { return VFLOAT; }
+  static ColumnType columnType(const std::vector<double> * /*unused*/) { return VDOUBLE; }
+  static ColumnType columnType(const std::vector<uint64_t> * /*unused*/) { return VULONG; }
+};
+
+#endif  // TRACKINGDIAGNOSTICS_DIAGNOSTICTREEWRITER_H
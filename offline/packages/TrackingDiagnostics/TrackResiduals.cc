@@ -756,6 +756,12 @@ int TrackResiduals::End(PHCompositeNode* /*unused*/)
   {
     m_eventtree->Write();
   }
+  // the RNTuple writers have to be gone before the file is closed
+  for (auto *tree : {m_tree, m_clustree, m_hittree, m_vertextree, m_failedfits, m_eventtree})
+  {
+    delete tree;
+  }
+  m_tree = m_clustree = m_hittree = m_vertextree = m_failedfits = m_eventtree = nullptr;
   m_outfile->Close();
 
   return Fun4AllReturnCodes::EVENT_OK;
@@ -1546,7 +1552,7 @@ void TrackResiduals::createBranches()
 {
   if (m_doEventTree)
   {
-    m_eventtree = new TTree("eventtree", "A tree with all hits");
+    m_eventtree = DiagnosticTreeWriter::Create(m_outputFormat, "eventtree", "A tree with all hits");
     m_eventtree->Branch("run", &m_runnumber, "m_runnumber/I");
     m_eventtree->Branch("segment", &m_segment, "m_segment/I");
     m_eventtree->Branch("job", &m_job, "m_job/I");
@@ -1564,7 +1570,7 @@ void TrackResiduals::createBranches()
     m_eventtree->Branch("ntracks", &m_ntracks_all, "m_ntracks_all/I");
   }
 
-  m_failedfits = new TTree("failedfits", "tree with seeds from failed Acts fits");
+  m_failedfits = DiagnosticTreeWriter::Create(m_outputFormat, "failedfits", "tree with seeds from failed Acts fits");
   m_failedfits->Branch("run", &m_runnumber, "m_runnumber/I");
   m_failedfits->Branch("segment", &m_segment, "m_segment/I");
   m_failedfits->Branch("job", &m_job, "m_job/I");
@@ -1592,7 +1598,7 @@ void TrackResiduals::createBranches()
   m_failedfits->Branch("lx", &m_cluslx);
   m_failedfits->Branch("lz", &m_cluslz);
 
-  m_vertextree = new TTree("vertextree", "tree with vertices");
+  m_vertextree = DiagnosticTreeWriter::Create(m_outputFormat, "vertextree", "tree with vertices");
   m_vertextree->Branch("run", &m_runnumber, "m_runnumber/I");
   m_vertextree->Branch("segment", &m_segment, "m_segment/I");
   m_vertextree->Branch("job", &m_job, "m_job/I");
@@ -1613,7 +1619,7 @@ void TrackResiduals::createBranches()
   m_vertextree->Branch("gz", &m_clusgz);
   m_vertextree->Branch("gr", &m_clusgr);
 
-  m_hittree = new TTree("hittree", "A tree with all hits");
+  m_hittree = DiagnosticTreeWriter::Create(m_outputFormat, "hittree", "A tree with all hits");
   m_hittree->Branch("run", &m_runnumber, "m_runnumber/I");
   m_hittree->Branch("segment", &m_segment, "m_segment/I");
   m_hittree->Branch("job", &m_job, "m_job/I");
@@ -1643,7 +1649,7 @@ void TrackResiduals::createBranches()
   m_hittree->Branch("adc", &m_adc, "m_adc/F");
   m_hittree->Branch("zdriftlength", &m_zdriftlength, "m_zdriftlength/F");
 
-  m_clustree = new TTree("clustertree", "A tree with all clusters");
+  m_clustree = DiagnosticTreeWriter::Create(m_outputFormat, "clustertree", "A tree with all clusters");
   m_clustree->Branch("run", &m_runnumber, "m_runnumber/I");
   m_clustree->Branch("segment", &m_segment, "m_segment/I");
   m_clustree->Branch("job", &m_job, "m_job/I");
@@ -1676,7 +1682,7 @@ void TrackResiduals::createBranches()
   m_clustree->Branch("segtype", &m_segtype, "m_segtype/I");
   m_clustree->Branch("tile", &m_tileid, "m_tileid/I");
 
-  m_tree = new TTree("residualtree", "A tree with track, cluster, and state info");
+  m_tree = DiagnosticTreeWriter::Create(m_outputFormat, "residualtree", "A tree with track, cluster, and state info");
   m_tree->Branch("run", &m_runnumber, "m_runnumber/I");
   m_tree->Branch("segment", &m_segment, "m_segment/I");
   m_tree->Branch("job", &m_job, "m_job/I");
@@ -3,6 +3,8 @@
 #ifndef TRACKRESIDUALS_H
 #define TRACKRESIDUALS_H
 
+#include "DiagnosticTreeWriter.h"
+
 #include <tpc/TpcClusterMover.h>
 #include <tpc/TpcGlobalPositionWrapper.h>
 
@@ -13,7 +15,6 @@
 
 #include <TFile.h>
 #include <TH1.h>
-#include <TTree.h>
 
 #include <cmath>
 #include <iostream>
@@ -60,6 +61,8 @@ class TrackResiduals : public SubsysReco
   void setClusterMinSize(unsigned int size) { m_min_cluster_size = size; }
   void failedTree() { m_doFailedSeeds = true; }
   void setSegment(const int segment) { m_segment = segment; }
+  //! TTREE (default) or RNTUPLE output
+  void outputFormat(DiagnosticTreeWriter::Format format) { m_outputFormat = format; }
 
   void set_doMicromegasOnly( bool value ) { m_doMicromegasOnly = value; }
   void setTrkrClusterContainerName(std::string &name){ m_clusterContainerName = name; }
@@ -93,12 +96,13 @@ class TrackResiduals : public SubsysReco
 
   std::string m_outfileName = "";
   TFile *m_outfile = nullptr;
-  TTree *m_tree = nullptr;
-  TTree *m_clustree = nullptr;
-  TTree *m_eventtree = nullptr;
-  TTree *m_hittree = nullptr;
-  TTree *m_vertextree = nullptr;
-  TTree *m_failedfits = nullptr;
+  DiagnosticTreeWriter::Format m_outputFormat = DiagnosticTreeWriter::TTREE;
+  DiagnosticTreeWriter *m_tree = nullptr;
+  DiagnosticTreeWriter *m_clustree = nullptr;
+  DiagnosticTreeWriter *m_eventtree = nullptr;
+  DiagnosticTreeWriter *m_hittree = nullptr;
+  DiagnosticTreeWriter *m_vertextree = nullptr;
+  DiagnosticTreeWriter *m_failedfits = nullptr;
 
   bool m_doClusters = false;
   bool m_doHits = false;
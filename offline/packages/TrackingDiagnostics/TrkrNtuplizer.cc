@@ -45,7 +45,6 @@
 #include <phool/recoConsts.h>
 
 #include <TFile.h>
-#include <TNtuple.h>
 #include <TVector3.h>
 
 #include <cmath>
@@ -286,47 +285,47 @@ int TrkrNtuplizer::Init(PHCompositeNode* topNode)
   if (_do_info_eval)
   {
     string ntp_varlist_info = str_event + ":" + str_info;
-    _ntp_info = new TNtuple("ntp_info", "event info", ntp_varlist_info.c_str());
+    _ntp_info = DiagnosticTreeWriter::CreateNtuple(m_outputFormat, "ntp_info", "event info", ntp_varlist_info);
   }
 
   if (_do_vertex_eval)
   {
     string ntp_varlist_vtx = str_event + ":" + str_vertex + ":" + str_info;
-    _ntp_vertex = new TNtuple("ntp_vertex", "vertex => max truth", ntp_varlist_vtx.c_str());
+    _ntp_vertex = DiagnosticTreeWriter::CreateNtuple(m_outputFormat, "ntp_vertex", "vertex => max truth", ntp_varlist_vtx);
   }
 
   if (_do_hit_eval)
   {
     string ntp_varlist_ev = str_event + ":" + str_hit + ":" + str_info;
-    _ntp_hit = new TNtuple("ntp_hit", "svtxhit => max truth", ntp_varlist_ev.c_str());
+    _ntp_hit = DiagnosticTreeWriter::CreateNtuple(m_outputFormat, "ntp_hit", "svtxhit => max truth", ntp_varlist_ev);
   }
 
   if (_do_cluster_eval)
   {
     string ntp_varlist_clu = str_event + ":" + str_cluster + ":" + str_info;
-    _ntp_cluster = new TNtuple("ntp_cluster", "svtxcluster => max truth", ntp_varlist_clu.c_str());
+    _ntp_cluster = DiagnosticTreeWriter::CreateNtuple(m_outputFormat, "ntp_cluster", "svtxcluster => max truth", ntp_varlist_clu);
   }
   if (_do_clus_trk_eval)
   {
     string ntp_varlist_clut = str_event + ":" + str_cluster + ":" + str_residual + ":" + str_seed + ":" + str_info;
-    _ntp_clus_trk = new TNtuple("ntp_clus_trk", "cluster on track", ntp_varlist_clut.c_str());
+    _ntp_clus_trk = DiagnosticTreeWriter::CreateNtuple(m_outputFormat, "ntp_clus_trk", "cluster on track", ntp_varlist_clut);
   }
 
   if (_do_track_eval)
   {
     string ntp_varlist_trk = str_event + ":" + str_track + ":" + str_info;
-    _ntp_track = new TNtuple("ntp_track", "svtxtrack => max truth", ntp_varlist_trk.c_str());
+    _ntp_track = DiagnosticTreeWriter::CreateNtuple(m_outputFormat, "ntp_track", "svtxtrack => max truth", ntp_varlist_trk);
   }
 
   if (_do_tpcseed_eval)
   {
     string ntp_varlist_tsee = str_event + ":" + str_seed + ":" + str_info;
-    _ntp_tpcseed = new TNtuple("ntp_tpcseed", "seeds from truth", ntp_varlist_tsee.c_str());
+    _ntp_tpcseed = DiagnosticTreeWriter::CreateNtuple(m_outputFormat, "ntp_tpcseed", "seeds from truth", ntp_varlist_tsee);
   }
   if (_do_siseed_eval)
   {
     string ntp_varlist_ssee = str_event + ":" + str_seed + ":" + str_info;
-    _ntp_siseed = new TNtuple("ntp_siseed", "seeds from truth", ntp_varlist_ssee.c_str());
+    _ntp_siseed = DiagnosticTreeWriter::CreateNtuple(m_outputFormat, "ntp_siseed", "seeds from truth", ntp_varlist_ssee);
   }
   _timer = new PHTimer("_eval_timer");
   _timer->stop();
@@ -457,6 +456,13 @@ int TrkrNtuplizer::End(PHCompositeNode* /*topNode*/)
     _ntp_siseed->Write();
   }
 
+  // the RNTuple writers have to be gone before the file is closed
+  for (auto *ntp : {_ntp_info, _ntp_vertex, _ntp_hit, _ntp_cluster, _ntp_clus_trk, _ntp_track, _ntp_tpcseed, _ntp_siseed})
+  {
+    delete ntp;
+  }
+  _ntp_info = _ntp_vertex = _ntp_hit = _ntp_cluster = _ntp_clus_trk = _ntp_track = _ntp_tpcseed = _ntp_siseed = nullptr;
+
   _tfile->Close();
 
   delete _tfile;
@@ -7,6 +7,8 @@
 /// \author Michael P. McCumber (revised SVTX version)
 //===============================================
 
+#include "DiagnosticTreeWriter.h"
+
 #include <fun4all/SubsysReco.h>
 #include <trackbase/ClusterErrorPara.h>
 #include <trackbase/TrkrDefs.h>
@@ -24,7 +26,6 @@ class PHCompositeNode;
 class PHTimer;
 class TrkrCluster;
 class TFile;
-class TNtuple;
 class SvtxTrack;
 class TrackSeed;
 class SvtxTrackMap;
@@ -83,6 +84,8 @@ class TrkrNtuplizer : public SubsysReco
   void segment(const int seg) { m_segment = seg; }
   void runnumber(const int run) { m_runnumber = run; }
   void job(const int job) { m_job = job; }
+  //! TTREE (default) or RNTUPLE output
+  void outputFormat(DiagnosticTreeWriter::Format format) { m_outputFormat = format; }
 
  private:
   int m_segment = 0;
@@ -122,14 +125,16 @@ class TrkrNtuplizer : public SubsysReco
   unsigned int _nlayers_tpc{48};
   unsigned int _nlayers_mms{2};
 
-  TNtuple *_ntp_info{nullptr};
-  TNtuple *_ntp_vertex{nullptr};
-  TNtuple *_ntp_hit{nullptr};
-  TNtuple *_ntp_cluster{nullptr};
-  TNtuple *_ntp_clus_trk{nullptr};
-  TNtuple *_ntp_track{nullptr};
-  TNtuple *_ntp_tpcseed{nullptr};
-  TNtuple *_ntp_siseed{nullptr};
+  DiagnosticTreeWriter::Format m_outputFormat{DiagnosticTreeWriter::TTREE};
+
+  DiagnosticTreeWriter *_ntp_info{nullptr};
+  DiagnosticTreeWriter *_ntp_vertex{nullptr};
+  DiagnosticTreeWriter *_ntp_hit{nullptr};
+  DiagnosticTreeWriter *_ntp_cluster{nullptr};
+  DiagnosticTreeWriter *_ntp_clus_trk{nullptr};
+  DiagnosticTreeWriter *_ntp_track{nullptr};
+  DiagnosticTreeWriter *_ntp_tpcseed{nullptr};
+  DiagnosticTreeWriter *_ntp_siseed{nullptr};
 
   // evaluator output file
   std::string _filename;
@@ -3,6 +3,7 @@
 
 #include <trackbase/InttDefs.h>
 #include <trackbase/TrkrClusterContainerv4.h>
+#include <trackbase/TrkrClusterContainerv5.h>
 #include <trackbase/TrkrClusterCrossingAssocv1.h>
 #include <trackbase/TrkrClusterHitAssocv3.h>
 #include <trackbase/TrkrClusterv5.h>
@@ -27,6 +28,7 @@
 #include <phool/PHNodeIterator.h>
 #include <phool/PHObject.h>  // for PHObject
 #include <phool/getClass.h>
+#include <phool/recoConsts.h>
 #include <phool/phool.h>
 
 #include <boost/graph/adjacency_list.hpp>
@@ -144,12 +146,26 @@ int InttClusterizer::InitRun(PHCompositeNode* topNode)
       dstNode->addNode(DetNode);
     }
 
-    trkrclusters = new TrkrClusterContainerv4;
+    // compressed cluster output, see TrkrClusterContainerv5
+    if (recoConsts::instance()->get_IntFlag("TRKR_CLUSTER_COMPRESSION", 0))
+    {
+      trkrclusters = new TrkrClusterContainerv5;
+    }
+    else
+    {
+      trkrclusters = new TrkrClusterContainerv4;
+    }
     PHIODataNode<PHObject>* TrkrClusterContainerNode =
         new PHIODataNode<PHObject>(trkrclusters, "TRKR_CLUSTER", "PHObject");
     DetNode->addNode(TrkrClusterContainerNode);
   }
 
+  // the error dictionaries of the compressed output are trained once per run
+  if (auto compressed = dynamic_cast<TrkrClusterContainerv5 *>(trkrclusters))
+  {
+    compressed->resetDictionaries();
+  }
+
   auto clusterhitassoc = findNode::getClass<TrkrClusterHitAssoc>(topNode, "TRKR_CLUSTERHITASSOC");
   if (!clusterhitassoc)
   {
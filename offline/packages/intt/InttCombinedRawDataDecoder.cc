@@ -25,10 +25,12 @@
 
 #include <TSystem.h>
 
+#include <algorithm>   // for stable_sort
 #include <cstdlib>     // for exit
 #include <filesystem>  // for filesystem::exist
 #include <iostream>    // for operator<<, endl, bas...
 #include <map>         // for _Rb_tree_iterator
+#include <tuple>       // for tie
 
 InttCombinedRawDataDecoder::InttCombinedRawDataDecoder(std::string const& name)
   : SubsysReco(name)
@@ -231,8 +233,11 @@ int InttCombinedRawDataDecoder::process_event(PHCompositeNode* topNode)
 
   TrkrDefs::hitsetkey hit_set_key = 0;
   TrkrDefs::hitkey hit_key = 0;
-  TrkrHitSetContainer::Iterator hit_set_container_itr;
-  TrkrHit* hit = nullptr;
+
+  // first pass: hot channel and bco filtering. The surviving hits are sorted
+  // afterwards so that each hitset is looked up once and filled in one go
+  m_HitKeys.clear();
+  m_HitKeys.reserve(inttcont->get_nhits());
 
   InttNameSpace::RawData_s raw;
   InttNameSpace::Offline_s ofl;
@@ -253,7 +258,7 @@ int InttCombinedRawDataDecoder::process_event(PHCompositeNode* topNode)
 
     ////////////////////////
     // bad channel filter
-    if (m_HotChannelSet.find(raw) != m_HotChannelSet.end())
+    if (IsHotChannel(raw))
     {
       // std::cout<<"hotchan removed : "<<raw.felix_server<<" "<<raw.felix_channel<<" "<<raw.chip<<" "<<raw.channel<<std::endl;
       continue;
@@ -261,7 +266,7 @@ int InttCombinedRawDataDecoder::process_event(PHCompositeNode* topNode)
 
     ////////////////////////
     // bco filter
-    if (m_bcomap.IsBad(raw, bco_full, bco) && m_bcoFilter)
+    if (m_bcoFilter && m_bcomap.IsBad(raw, bco_full, bco))
     {
       // std::cout<<"bad bco removed : "<<raw.felix_server<<" "<<raw.felix_channel<<" "<<raw.chip<<" "<<raw.channel<<std::endl;
       continue;
@@ -288,8 +293,6 @@ int InttCombinedRawDataDecoder::process_event(PHCompositeNode* topNode)
 	  }
       }
     hit_set_key = InttDefs::genHitSetKey(ofl.layer, ofl.ladder_z, ofl.ladder_phi, time_bucket);
-    hit_set_container_itr = trkr_hit_set_container->findOrAddHitSet(hit_set_key);
-    hit = hit_set_container_itr->second->getHit(hit_key);
 
     if(m_outputBcoDiff)
       {
@@ -312,24 +315,63 @@ int InttCombinedRawDataDecoder::process_event(PHCompositeNode* topNode)
 		  << std::endl;
       }
 
-    if (hit)
+    m_HitKeys.push_back({hit_set_key, hit_key, raw, adc});
+  }
+
+  // stable, the first of duplicated hits is kept
+  std::stable_sort(m_HitKeys.begin(), m_HitKeys.end(),
+                   [](const HitKeys_s& lhs, const HitKeys_s& rhs)
+                   { return std::tie(lhs.hitsetkey, lhs.hitkey) < std::tie(rhs.hitsetkey, rhs.hitkey); });
+
+  // second pass: one hitset lookup and one insertion per hitset
+  TrkrHitSet::HitList hits;
+  for (auto iter = m_HitKeys.begin(); iter != m_HitKeys.end();)
+  {
+    hit_set_key = iter->hitsetkey;
+    TrkrHitSet* hitset = trkr_hit_set_container->findOrAddHitSet(hit_set_key)->second;
+
+    // hits already in the hitset have to be checked one by one
+    const bool check_existing = hitset->size() > 0;
+
+    hits.clear();
+    for (; iter != m_HitKeys.end() && iter->hitsetkey == hit_set_key; ++iter)
     {
-      continue;
-    }
+      hit_key = iter->hitkey;
+      if ((!hits.empty() && hits.back().first == hit_key) || (check_existing && hitset->getHit(hit_key)))
+      {
+        continue;
+      }
 
-    ////////////////////////
-    // dac conversion
-    int dac = m_dacmap.GetDAC(raw, adc);
+      ////////////////////////
+      // dac conversion
+      int dac = m_dacmap.GetDAC(iter->raw, iter->adc);
 
-    hit = new TrkrHitv2;
-    //--hit->setAdc(adc);
-    hit->setAdc(dac);
-    hit_set_container_itr->second->addHitSpecificKey(hit_key, hit);
+      TrkrHit* hit = new TrkrHitv2;
+      //--hit->setAdc(adc);
+      hit->setAdc(dac);
+      hits.emplace_back(hit_key, hit);
+    }
+    hitset->addHitsSpecificKey(hits);
   }
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void InttCombinedRawDataDecoder::FillHotChannelMask()
+{
+  m_HotChannelMask.assign(kFelixServers * kFelixChannels * kChips * kChannels, false);
+  for (const auto& raw : m_HotChannelSet)
+  {
+    if (0 <= raw.felix_server && raw.felix_server < kFelixServers &&
+        0 <= raw.felix_channel && raw.felix_channel < kFelixChannels &&
+        0 <= raw.chip && raw.chip < kChips &&
+        0 <= raw.channel && raw.channel < kChannels)
+    {
+      m_HotChannelMask[HotChannelIndex(raw)] = true;
+    }
+  }
+}
+
 int InttCombinedRawDataDecoder::LoadHotChannelMapLocal(std::string const& filename)
 {
   if (filename.empty())
@@ -370,6 +412,7 @@ int InttCombinedRawDataDecoder::LoadHotChannelMapLocal(std::string const& filena
     //           << "\t" << cdbttree.GetIntValue(n, "chip")
     //           << "\t" << cdbttree.GetIntValue(n, "channel") << std::endl;
   }
+  FillHotChannelMask();
 
   return 0;
 }
@@ -405,6 +448,7 @@ int InttCombinedRawDataDecoder::LoadHotChannelMapRemote(std::string const& name)
         .chip = cdbttree.GetIntValue(n, "chip"),
         .channel = cdbttree.GetIntValue(n, "channel")});
   }
+  FillHotChannelMask();
 
   return 0;
 }
@@ -9,8 +9,11 @@
 #include <ffamodules/CDBInterface.h>
 #include <fun4all/SubsysReco.h>
 
+#include <trackbase/TrkrDefs.h>
+
 #include <set>
 #include <string>
+#include <vector>
 
 class PHCompositeNode;
 class InttEventInfo;
@@ -55,6 +58,43 @@ class InttCombinedRawDataDecoder : public SubsysReco
   std::string m_InttRawNodeName = "INTTRAWHIT";
   typedef std::set<InttNameSpace::RawData_s, InttNameSpace::RawDataComparator> Set_t;
   Set_t m_HotChannelSet;
+
+  //! one bit per channel, filled from m_HotChannelSet
+  static constexpr int kFelixServers = 8;
+  static constexpr int kFelixChannels = 14;
+  static constexpr int kChips = 26;
+  static constexpr int kChannels = 128;
+  std::vector<bool> m_HotChannelMask;
+
+  void FillHotChannelMask();
+
+  static int HotChannelIndex(InttNameSpace::RawData_s const& raw)
+  {
+    return ((raw.felix_server * kFelixChannels + raw.felix_channel) * kChips + raw.chip) * kChannels + raw.channel;
+  }
+
+  bool IsHotChannel(InttNameSpace::RawData_s const& raw) const
+  {
+    if (m_HotChannelMask.empty() ||
+        raw.felix_server < 0 || raw.felix_server >= kFelixServers ||
+        raw.felix_channel < 0 || raw.felix_channel >= kFelixChannels ||
+        raw.chip < 0 || raw.chip >= kChips ||
+        raw.channel < 0 || raw.channel >= kChannels)
+    {
+      return false;
+    }
+    return m_HotChannelMask[HotChannelIndex(raw)];
+  }
+
+  //! hits passing the filters, kept to avoid reallocation
+  struct HitKeys_s
+  {
+    TrkrDefs::hitsetkey hitsetkey = 0;
+    TrkrDefs::hitkey hitkey = 0;
+    InttNameSpace::RawData_s raw;
+    int adc = 0;
+  };
+  std::vector<HitKeys_s> m_HitKeys;
   bool m_runStandAlone = false;
   bool m_writeInttEventHeader = false;
   bool m_bcoFilter = false;
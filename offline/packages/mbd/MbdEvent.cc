@@ -46,6 +46,12 @@ MbdEvent::MbdEvent(const int cal_pass) :
   {
     do_templatefit = 1;
   }
+
+  // 0 = ROOT fits (default), 1 = native fits, 2 = native fits checked against ROOT
+  if (rc->FlagExist("MBD_FITMETHOD"))
+  {
+    _fitmethod = rc->get_IntFlag("MBD_FITMETHOD");
+  }
 #else
   do_templatefit = 0;
   _is_online = 1;
@@ -148,6 +154,7 @@ int MbdEvent::InitRun()
   for (int ifeech = 0; ifeech < MbdDefs::BBC_N_FEECH; ifeech++)
   {
     _mbdsig[ifeech].SetCalib(_mbdcal);
+    _mbdsig[ifeech].SetFitMethod(_fitmethod);
 
     // Do evt-by-evt pedestal using sample range below
     if ( _calpass==1 || _is_online || _no_sampmax>0 )
@@ -316,9 +323,58 @@ int MbdEvent::End()
     orig_dir->cd();
   }
 
+  if ( _fitmethod == 2 )
+  {
+    PrintFitMethodCheck();
+  }
+
   return 1;
 }
 
+void MbdEvent::PrintFitMethodCheck()
+{
+  // summary of the native vs ROOT fit comparison, see MbdSig::SetFitMethod()
+  unsigned int nped = 0;
+  unsigned int nped_bad = 0;
+  unsigned int ntemplate = 0;
+  unsigned int ntemplate_bad = 0;
+  double native_time = 0.;
+  double root_time = 0.;
+  for (const auto &sig : _mbdsig)
+  {
+    native_time += sig.GetNativeFitTime();
+    root_time += sig.GetRootFitTime();
+    nped += sig.GetNPedFitChecks();
+    nped_bad += sig.GetNPedFitMismatches();
+    ntemplate += sig.GetNTemplateFitChecks();
+    ntemplate_bad += sig.GetNTemplateFitMismatches();
+  }
+
+  std::cout << "MbdEvent::End() native/ROOT fit check" << std::endl;
+  std::cout << "  pedestal fits: " << nped_bad << " mismatches in " << nped << std::endl;
+  std::cout << "  template fits: " << ntemplate_bad << " mismatches in " << ntemplate << std::endl;
+  std::cout << "  fit time: native " << native_time << " s, ROOT " << root_time << " s";
+  if ( native_time > 0. )
+  {
+    std::cout << ", ROOT/native " << root_time / native_time;
+  }
+  std::cout << std::endl;
+  for (size_t ifeech = 0; ifeech < _mbdsig.size(); ifeech++)
+  {
+    const auto &sig = _mbdsig[ifeech];
+    if ( sig.GetNPedFitMismatches() == 0 && sig.GetNTemplateFitMismatches() == 0 )
+    {
+      continue;
+    }
+    std::cout << "  ch " << ifeech
+              << "\tped " << sig.GetNPedFitMismatches() << "/" << sig.GetNPedFitChecks()
+              << " max dped " << sig.GetMaxPedFitResidual()
+              << "\ttemplate " << sig.GetNTemplateFitMismatches() << "/" << sig.GetNTemplateFitChecks()
+              << " max dampl " << sig.GetMaxAmplFitResidual()
+              << " max dtime " << sig.GetMaxTimeFitResidual() << std::endl;
+  }
+}
+
 ///
 void MbdEvent::Clear()
 {
@@ -43,6 +43,7 @@ class MbdEvent
   void Clear();
 
   void SetSim(const int s) { _simflag = s; }
+  void SetFitMethod(const int m) { _fitmethod = m; }  // see MbdSig::SetFitMethod(), before InitRun()
 
   float get_bbcz() { return m_bbcz; }
   float get_bbczerr() { return m_bbczerr; }
@@ -124,6 +125,7 @@ class MbdEvent
   Float_t m_pmttq[MbdDefs::MBD_N_PMT]{};  // time in each arm
 
   int do_templatefit{1};
+  int _fitmethod{0};  // see MbdSig::SetFitMethod()
 
   // output data
   Short_t m_bbcn[2]{};                                            // num hits for each arm (north and south)
@@ -161,6 +163,9 @@ class MbdEvent
   // pedestals (hists are in MbdSig)
   int CalcPedCalib();
 
+  // summary of the native/ROOT fit comparison (fit method 2)
+  void PrintFitMethodCheck();
+
   //
   void ClusterEarliest(std::vector<float> &times, double& mean, double& rms, double& rmin, double& rmax);
  
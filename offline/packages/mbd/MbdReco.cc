@@ -42,6 +42,10 @@ int MbdReco::Init(PHCompositeNode *topNode)
   m_gaussian->FixParameter(2, m_tres);
 
   m_mbdevent = std::make_unique<MbdEvent>(_calpass);
+  if (_fitmethod >= 0)
+  {
+    m_mbdevent->SetFitMethod(_fitmethod);
+  }
 
   if (createNodes(topNode) == Fun4AllReturnCodes::ABORTEVENT)
   {
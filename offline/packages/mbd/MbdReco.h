@@ -32,6 +32,11 @@ class MbdReco : public SubsysReco
 
   void SetCalPass(const int calpass) { _calpass = calpass; }
   void SetMbdTrigOnly(const int m) { _mbdonly = m; }
+  // fit backend of the waveform fits, see MbdSig::SetFitMethod(). The
+  // calibration passes opt in to the native fits with SetFitMethod(1), or
+  // SetFitMethod(2) to time and compare them against ROOT. The default (-1)
+  // takes the MBD_FITMETHOD recoConsts flag, ROOT fits if it is not set
+  void SetFitMethod(const int m) { _fitmethod = m; }
 
  private:
   int createNodes(PHCompositeNode *topNode);
@@ -39,6 +44,7 @@ class MbdReco : public SubsysReco
   int _simflag{0};
   int _calpass{0};
   int _mbdonly{0};  // only use mbd triggers
+  int _fitmethod{-1};
 
   float m_tres = 0.05;
   std::unique_ptr<TF1> m_gaussian = nullptr;
@@ -13,6 +13,8 @@
 #include <TSpline.h>
 #include <TTree.h>
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <limits>
@@ -486,30 +488,66 @@ void MbdSig::CalcEventPed0_PreSamp(const int presample, const int nsamps)
   {
     std::cout << PHWHERE << " gRawPulse 0" << std::endl;
   }
-  if ( _verbose )
+  double chi2 = 0.;
+  double ndf = 0.;
+  double pedfit = 0.;
+  // the fits are timed, with fit method 2 both backends run on the same waveforms
+  auto fit_start = std::chrono::steady_clock::now();
+  if ( _fitmethod > 0 && _verbose == 0 )
   {
-    gRawPulse->Fit( ped_fcn, "RQ" );
+    Int_t native_ndf = 0;
+    FitPedNative( minsamp-0.1, maxsamp+0.1, pedfit, chi2, native_ndf );
+    ndf = native_ndf;
+  }
+  auto fit_end = std::chrono::steady_clock::now();
+  _native_fit_time += std::chrono::duration<double>(fit_end - fit_start).count();
 
-    double chi2ndf = ped_fcn->GetChisquare()/ped_fcn->GetNDF();
-    if ( chi2ndf > 4.0 )
+  if ( _fitmethod != 1 || _verbose )
+  {
+    fit_start = fit_end;
+    if ( _verbose )
     {
-      gRawPulse->Draw("ap");
-      ped_fcn->Draw("same");
-      PadUpdate();
+      gRawPulse->Fit( ped_fcn, "RQ" );
+
+      double chi2ndf = ped_fcn->GetChisquare()/ped_fcn->GetNDF();
+      if ( chi2ndf > 4.0 )
+      {
+        gRawPulse->Draw("ap");
+        ped_fcn->Draw("same");
+        PadUpdate();
+      }
     }
-  }
-  else
-  {
-    //std::cout << PHWHERE << std::endl;
-    gRawPulse->Fit( ped_fcn, "RNQ" );
-  }
+    else
+    {
+      //std::cout << PHWHERE << std::endl;
+      gRawPulse->Fit( ped_fcn, "RNQ" );
+    }
+    _root_fit_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - fit_start).count();
 
-  double chi2 = ped_fcn->GetChisquare();
-  double ndf = ped_fcn->GetNDF();
+    if ( _fitmethod == 2 && _verbose == 0 )
+    {
+      const double dped = fabs(pedfit - ped_fcn->GetParameter(0));
+      _nped_fit_checks++;
+      _max_ped_fit_residual = std::max(_max_ped_fit_residual, dped);
+      if ( dped > 0.01 )
+      {
+        // only the first mismatch of each channel is printed, the rest is summarized at End
+        if ( _nped_fit_mismatches == 0 )
+        {
+          std::cout << PHWHERE << " native/ROOT ped fit mismatch, ch " << _ch << "\t" << pedfit << "\t" << ped_fcn->GetParameter(0) << std::endl;
+        }
+        _nped_fit_mismatches++;
+      }
+    }
+
+    chi2 = ped_fcn->GetChisquare();
+    ndf = ped_fcn->GetNDF();
+    pedfit = ped_fcn->GetParameter(0);
+  }
 
   if ( chi2/ndf < 4.0 )
   {
-    mean = ped_fcn->GetParameter(0);
+    mean = pedfit;
 
     Double_t x, y;
 
@@ -1029,6 +1067,30 @@ int MbdSig::FitTemplate( const Int_t sampmax )
     return 1;
   }
 
+  Double_t native_ampl = ymax;
+  Double_t native_time = x_at_max;
+  auto fit_start = std::chrono::steady_clock::now();
+  if ( _fitmethod > 0 && _verbose == 0 )
+  {
+    // same two step fit as below, first over the full range, then up to just after the peak
+    FitTemplateNative( 0., (nsaturated<=3 ? _nsamples : _nsamples-3.5), native_ampl, native_time );
+    if ( native_time<0. || native_time>_nsamples )
+    {
+      native_time = _nsamples*0.5;  // bad fit last time
+    }
+    FitTemplateNative( 0., native_time + (nsaturated<=3 ? 4.0 : 4.8), native_ampl, native_time );
+    const auto fit_end = std::chrono::steady_clock::now();
+    _native_fit_time += std::chrono::duration<double>(fit_end - fit_start).count();
+    fit_start = fit_end;
+
+    if ( _fitmethod == 1 )
+    {
+      f_ampl = native_ampl;
+      f_time = native_time;
+      return 1;
+    }
+  }
+
   template_fcn->SetParameters(ymax, x_at_max);
   // template_fcn->SetParLimits(1, fit_min_time, fit_max_time);
   // template_fcn->SetParLimits(1, 3, 15);
@@ -1115,6 +1177,26 @@ int MbdSig::FitTemplate( const Int_t sampmax )
 
   f_ampl = template_fcn->GetParameter(0);
   f_time = template_fcn->GetParameter(1);
+  _root_fit_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - fit_start).count();
+
+  if ( _fitmethod == 2 )
+  {
+    const double dampl = fabs(native_ampl - f_ampl);
+    const double dtime = fabs(native_time - f_time);
+    _ntemplate_fit_checks++;
+    _max_ampl_fit_residual = std::max(_max_ampl_fit_residual, dampl);
+    _max_time_fit_residual = std::max(_max_time_fit_residual, dtime);
+    if ( dampl > 0.01*fabs(f_ampl) + 0.5 || dtime > 0.02 )
+    {
+      // only the first mismatch of each channel is printed, the rest is summarized at End
+      if ( _ntemplate_fit_mismatches == 0 )
+      {
+        std::cout << PHWHERE << " native/ROOT template fit mismatch, ch " << _ch << "\t"
+                  << native_ampl << "\t" << f_ampl << "\t" << native_time << "\t" << f_time << std::endl;
+      }
+      _ntemplate_fit_mismatches++;
+    }
+  }
 
   if (_verbose > 0 && fabs(f_ampl) > 0.)
   //if ( f_time<0 || f_time>30 )
@@ -1172,5 +1254,205 @@ int MbdSig::SetTemplate(const std::vector<float>& shape, const std::vector<float
     }
   }
 
+  // slope of each segment of the linear interpolation, for the native fit
+  template_dydx.assign(template_npointsx, 0.);
+  Double_t step = (template_endtime - template_begintime) / (template_npointsx - 1);
+  for (int i = 0; i < template_npointsx - 1; i++)
+  {
+    template_dydx[i] = (template_y[i + 1] - template_y[i]) / step;
+  }
+
   return 1;
 }
+
+bool MbdSig::TemplateLookup(const Double_t xx, Double_t& y, Double_t& dydx) const
+{
+  y = 0.;
+  dydx = 0.;
+
+  // same linear interpolation and point rejection as TemplateFcn()
+  if (xx < template_begintime || xx > template_endtime || std::isnan(xx) || template_dydx.empty())
+  {
+    return false;
+  }
+
+  Double_t step = (template_endtime - template_begintime) / (template_npointsx - 1);
+  Double_t index = (xx - template_begintime) / step;
+
+  int ilow = TMath::FloorNint(index);
+  int ihigh = TMath::CeilNint(index);
+  if (ilow < 0)
+  {
+    ilow = 0;
+  }
+  else if (ihigh >= template_npointsx)
+  {
+    ihigh = template_npointsx - 1;
+  }
+
+  dydx = template_dydx[std::min(ilow, template_npointsx - 2)];
+  if (ilow == ihigh)
+  {
+    y = template_y[ilow];
+  }
+  else
+  {
+    y = template_y[ilow] + template_dydx[ilow] * (xx - (template_begintime + ilow * step));
+  }
+
+  // reject points with very bad rms in shape
+  return template_yrms[ilow] < 1.0 && template_yrms[ihigh] < 1.0;
+}
+
+// chi2 fit of a constant to the raw samples in [xmin,xmax]
+Int_t MbdSig::FitPedNative(const Double_t xmin, const Double_t xmax, Double_t& mean, Double_t& chi2, Int_t& ndf)
+{
+  const Int_t npts = gRawPulse->GetN();
+  const Double_t *x = gRawPulse->GetX();
+  const Double_t *y = gRawPulse->GetY();
+  const Double_t *ey = gRawPulse->GetEY();
+
+  Double_t sumw = 0.;
+  Double_t sumwy = 0.;
+  Int_t nused = 0;
+  for (int i = 0; i < npts; i++)
+  {
+    if (x[i] < xmin || x[i] > xmax)
+    {
+      continue;
+    }
+    Double_t w = (ey != nullptr && ey[i] > 0.) ? 1.0 / (ey[i] * ey[i]) : 1.0;
+    sumw += w;
+    sumwy += w * y[i];
+    nused++;
+  }
+
+  chi2 = 0.;
+  ndf = nused - 1;
+  if (nused == 0)
+  {
+    mean = 0.;
+    return -1;
+  }
+
+  mean = sumwy / sumw;
+  for (int i = 0; i < npts; i++)
+  {
+    if (x[i] < xmin || x[i] > xmax)
+    {
+      continue;
+    }
+    Double_t w = (ey != nullptr && ey[i] > 0.) ? 1.0 / (ey[i] * ey[i]) : 1.0;
+    chi2 += w * (y[i] - mean) * (y[i] - mean);
+  }
+
+  return 0;
+}
+
+// Levenberg-Marquardt fit of ampl*template(x-time) to the subtracted samples in [xmin,xmax],
+// with the analytic gradient from the template slope table
+Int_t MbdSig::FitTemplateNative(const Double_t xmin, const Double_t xmax, Double_t& ampl, Double_t& time)
+{
+  const Int_t npts = gSubPulse->GetN();
+  const Double_t *x = gSubPulse->GetX();
+  const Double_t *y = gSubPulse->GetY();
+  const Double_t *ey = gSubPulse->GetEY();
+  const Int_t nraw = gRawPulse->GetN();
+  const Double_t *rawy = gRawPulse->GetY();
+
+  // chi2, gradient (J^T r) and approximate hessian (J^T J) at (a,t)
+  Double_t g[2];
+  Double_t h[3];
+  auto evaluate = [&](const Double_t a, const Double_t t, Double_t *grad, Double_t *hess, Int_t &nused)
+  {
+    Double_t chi2 = 0.;
+    grad[0] = grad[1] = 0.;
+    hess[0] = hess[1] = hess[2] = 0.;
+    nused = 0;
+    for (int i = 0; i < npts; i++)
+    {
+      if (x[i] < xmin || x[i] > xmax)
+      {
+        continue;
+      }
+
+      // Reject points where ADC saturates
+      int samp_point = static_cast<int>(x[i]);
+      if (samp_point >= 0 && samp_point < nraw && rawy[samp_point] > 16370)
+      {
+        continue;
+      }
+
+      Double_t ty{0.};
+      Double_t tdydx{0.};
+      if (!TemplateLookup(x[i] - t, ty, tdydx))
+      {
+        continue;
+      }
+
+      Double_t w = (ey != nullptr && ey[i] > 0.) ? 1.0 / (ey[i] * ey[i]) : 1.0;
+      Double_t r = y[i] - a * ty;
+      Double_t dfda = ty;
+      Double_t dfdt = -a * tdydx;
+      chi2 += w * r * r;
+      grad[0] += w * r * dfda;
+      grad[1] += w * r * dfdt;
+      hess[0] += w * dfda * dfda;
+      hess[1] += w * dfda * dfdt;
+      hess[2] += w * dfdt * dfdt;
+      nused++;
+    }
+    return chi2;
+  };
+
+  Int_t nused = 0;
+  Double_t chi2 = evaluate(ampl, time, g, h, nused);
+  if (nused < 2)
+  {
+    return -1;
+  }
+
+  Double_t lambda = 0.001;
+  for (int iter = 0; iter < 100; iter++)
+  {
+    Double_t a00 = h[0] * (1.0 + lambda);
+    Double_t a11 = h[2] * (1.0 + lambda);
+    Double_t a01 = h[1];
+    Double_t det = a00 * a11 - a01 * a01;
+    if (!(det > 0.))
+    {
+      return -2;
+    }
+    Double_t da = (a11 * g[0] - a01 * g[1]) / det;
+    Double_t dt = (a00 * g[1] - a01 * g[0]) / det;
+
+    Double_t gtrial[2];
+    Double_t htrial[3];
+    Int_t ntrial = 0;
+    Double_t chi2trial = evaluate(ampl + da, time + dt, gtrial, htrial, ntrial);
+    if (ntrial >= 2 && chi2trial <= chi2)
+    {
+      ampl += da;
+      time += dt;
+      bool converged = (chi2 - chi2trial) <= 1e-7 * chi2 + 1e-12 && fabs(dt) < 1e-5;
+      chi2 = chi2trial;
+      std::copy(gtrial, gtrial + 2, g);
+      std::copy(htrial, htrial + 3, h);
+      lambda = std::max(lambda * 0.1, 1e-9);
+      if (converged)
+      {
+        return 0;
+      }
+    }
+    else
+    {
+      lambda *= 10.;
+      if (lambda > 1e9)
+      {
+        return 0;  // no further improvement possible
+      }
+    }
+  }
+
+  return 4;  // call limit, like Minuit
+}
@@ -115,6 +115,26 @@ class MbdSig
   TF1 *GetTemplateFcn() { return template_fcn; }
   void SetMinMaxFitTime(const Double_t mintime, const Double_t maxtime);
 
+  /** Fit backend for the pedestal and template fits
+   *  0 = ROOT fits of the TGraphErrors
+   *  1 = native Levenberg-Marquardt fits on the sample arrays
+   *  2 = native fits, cross checked against the ROOT fits (ROOT result is kept) */
+  void SetFitMethod(const int m) { _fitmethod = m; }
+  int GetFitMethod() const { return _fitmethod; }
+
+  /** native vs ROOT fit comparison for fit method 2 */
+  unsigned int GetNPedFitChecks() const { return _nped_fit_checks; }
+  unsigned int GetNPedFitMismatches() const { return _nped_fit_mismatches; }
+  unsigned int GetNTemplateFitChecks() const { return _ntemplate_fit_checks; }
+  unsigned int GetNTemplateFitMismatches() const { return _ntemplate_fit_mismatches; }
+  double GetMaxPedFitResidual() const { return _max_ped_fit_residual; }
+  double GetMaxAmplFitResidual() const { return _max_ampl_fit_residual; }
+  double GetMaxTimeFitResidual() const { return _max_time_fit_residual; }
+  /** seconds spent in the native and in the ROOT pedestal and template fits,
+   *  fit method 2 runs both on the same waveforms */
+  double GetNativeFitTime() const { return _native_fit_time; }
+  double GetRootFitTime() const { return _root_fit_time; }
+
   void WritePedHist();
 
   void PadUpdate();
@@ -124,6 +144,12 @@ class MbdSig
  private:
   void Init();
 
+  /** native fits, return 0 on success like TGraph::Fit */
+  Int_t FitPedNative(const Double_t xmin, const Double_t xmax, Double_t &mean, Double_t &chi2, Int_t &ndf);
+  Int_t FitTemplateNative(const Double_t xmin, const Double_t xmax, Double_t &ampl, Double_t &time);
+  /** template value and slope at xx (time relative to the pulse start), false if the point is rejected */
+  bool TemplateLookup(const Double_t xx, Double_t &y, Double_t &dydx) const;
+
   int _ch;
   int _nsamples;
   int _status{0};
@@ -184,10 +210,24 @@ class MbdSig
   // Double_t template_max_xrange{0.};             //! for template, in original units of waveform data
   std::vector<float> template_y;
   std::vector<float> template_yrms;
+  std::vector<float> template_dydx;  //! slope of each template segment, for the native fit
   TF1 *template_fcn{nullptr};
   Double_t fit_min_time{};  //! min time for fit, in original units of waveform data
   Double_t fit_max_time{};  //! max time for fit, in original units of waveform data
 
+  int _fitmethod{0};  //! see SetFitMethod()
+
+  // native vs ROOT fit comparison, filled for fit method 2
+  unsigned int _nped_fit_checks{0};
+  unsigned int _nped_fit_mismatches{0};
+  unsigned int _ntemplate_fit_checks{0};
+  unsigned int _ntemplate_fit_mismatches{0};
+  double _max_ped_fit_residual{0.};
+  double _max_ampl_fit_residual{0.};
+  double _max_time_fit_residual{0.};
+  double _native_fit_time{0.};
+  double _root_fit_time{0.};
+
   int _verbose{0};
 };
 
@@ -12,6 +12,7 @@
 
 #include <trackbase/ActsGeometry.h>
 #include <trackbase/TrkrClusterContainerv4.h>        // for TrkrCluster
+#include <trackbase/TrkrClusterContainerv5.h>
 #include <trackbase/TrkrClusterv5.h>
 #include <trackbase/TrkrDefs.h>
 #include <trackbase/TrkrHitSet.h>
@@ -26,6 +27,7 @@
 #include <fun4all/SubsysReco.h>                     // for SubsysReco
 
 #include <phool/getClass.h>
+#include <phool/recoConsts.h>
 #include <phool/PHCompositeNode.h>
 #include <phool/PHIODataNode.h>                     // for PHIODataNode
 #include <phool/PHNode.h>                           // for PHNode
@@ -126,11 +128,25 @@ int MicromegasClusterizer::InitRun(PHCompositeNode *topNode)
       dstNode->addNode(trkrNode);
     }
 
-    trkrClusterContainer = new TrkrClusterContainerv4;
+    // compressed cluster output, see TrkrClusterContainerv5
+    if (recoConsts::instance()->get_IntFlag("TRKR_CLUSTER_COMPRESSION", 0))
+    {
+      trkrClusterContainer = new TrkrClusterContainerv5;
+    }
+    else
+    {
+      trkrClusterContainer = new TrkrClusterContainerv4;
+    }
     auto TrkrClusterContainerNode = new PHIODataNode<PHObject>(trkrClusterContainer, "TRKR_CLUSTER", "PHObject");
     trkrNode->addNode(TrkrClusterContainerNode);
   }
 
+  // the error dictionaries of the compressed output are trained once per run
+  if (auto compressed = dynamic_cast<TrkrClusterContainerv5 *>(trkrClusterContainer))
+  {
+    compressed->resetDictionaries();
+  }
+
   // create cluster to hit association node, if missing
   auto trkrClusterHitAssoc = findNode::getClass<TrkrClusterHitAssoc>(topNode,"TRKR_CLUSTERHITASSOC");
   if(!trkrClusterHitAssoc)
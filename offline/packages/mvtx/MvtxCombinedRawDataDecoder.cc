@@ -217,6 +217,13 @@ int MvtxCombinedRawDataDecoder::process_event(PHCompositeNode *topNode)
     assert(mvtx_event_header);
   }
 
+  // first pass: strobe index, range and mask filtering. The surviving keys are
+  // sorted afterwards so that each hitset is looked up once and filled in one go
+  m_hitkeys.clear();
+  m_hitkeys.reserve(mvtx_hit_container->get_nhits());
+  uint64_t last_strobe = 0;
+  int index = 0;
+  bool first = true;
   for (unsigned int i = 0; i < mvtx_hit_container->get_nhits(); i++)
   {
     mvtx_hit = mvtx_hit_container->get_hit(i);
@@ -227,9 +234,15 @@ int MvtxCombinedRawDataDecoder::process_event(PHCompositeNode *topNode)
     row = mvtx_hit->get_row();
     col = mvtx_hit->get_col();
 
-    int bcodiff = gl1 ? strobe - gl1bco : 0;
-    double timeElapsed = bcodiff * 0.1065;  // 106 ns rhic clock
-    int index = m_mvtx_is_triggered ? 0 : std::ceil(timeElapsed / m_strobeWidth);
+    // hits come grouped by strobe, only recalculate the index when it changes
+    if (first || strobe != last_strobe)
+    {
+      int bcodiff = gl1 ? strobe - gl1bco : 0;
+      double timeElapsed = bcodiff * 0.1065;  // 106 ns rhic clock
+      index = m_mvtx_is_triggered ? 0 : std::ceil(timeElapsed / m_strobeWidth);
+      last_strobe = strobe;
+      first = false;
+    }
 
     if (index < -16 || index > 15)
     {
@@ -241,6 +254,13 @@ int MvtxCombinedRawDataDecoder::process_event(PHCompositeNode *topNode)
       mvtx_hit->identify();
     }
 
+    // Check if the pixel is masked, chips without hot pixels are skipped by the first test
+    if (m_doOfflineMasking && m_hot_pixel_mask->has_masked_pixels(layer, stave, chip) &&
+        m_hot_pixel_mask->is_masked(layer, stave, chip, row, col))
+    {
+      continue;
+    }
+
     const TrkrDefs::hitsetkey hitsetkey =
         MvtxDefs::genHitSetKey(layer, stave, chip, index);
     if (!hitsetkey)
@@ -248,39 +268,39 @@ int MvtxCombinedRawDataDecoder::process_event(PHCompositeNode *topNode)
       continue;
     }
 
-    // get matching hitset
+    m_hitkeys.emplace_back(hitsetkey, MvtxDefs::genHitKey(col, row));
+  }
+
+  std::sort(m_hitkeys.begin(), m_hitkeys.end());
+
+  // second pass: one hitset lookup and one insertion per hitset
+  TrkrHitSet::HitList hits;
+  for (auto iter = m_hitkeys.begin(); iter != m_hitkeys.end();)
+  {
+    const TrkrDefs::hitsetkey hitsetkey = iter->first;
     const auto hitset_it = hit_set_container->findOrAddHitSet(hitsetkey);
+    TrkrHitSet* hitset = hitset_it->second;
 
-    // generate hit key
-    const TrkrDefs::hitkey hitkey = MvtxDefs::genHitKey(col, row);
+    // hits already in the hitset have to be checked one by one
+    const bool check_existing = hitset->size() > 0;
 
-    // find existing hit, or create
-    auto hit = hitset_it->second->getHit(hitkey);
-    if (hit)
+    hits.clear();
+    for (; iter != m_hitkeys.end() && iter->first == hitsetkey; ++iter)
     {
-      if(Verbosity() > 1)
+      const TrkrDefs::hitkey hitkey = iter->second;
+      if ((!hits.empty() && hits.back().first == hitkey) || (check_existing && hitset->getHit(hitkey)))
       {
-        std::cout << PHWHERE << "::" << __func__
-                  << " - duplicated hit, hitsetkey: " << hitsetkey
-                  << " hitkey: " << hitkey << std::endl;
+        if (Verbosity() > 1)
+        {
+          std::cout << PHWHERE << "::" << __func__
+                    << " - duplicated hit, hitsetkey: " << hitsetkey
+                    << " hitkey: " << hitkey << std::endl;
+        }
+        continue;
       }
-      continue;
+      hits.emplace_back(hitkey, new TrkrHitv2);
     }
-
-    if(m_doOfflineMasking)
-    {
-      if (!m_hot_pixel_mask->is_masked(mvtx_hit))
-      { // Check if the pixel is masked
-        hit = new TrkrHitv2;
-        hitset_it->second->addHitSpecificKey(hitkey, hit);
-      }
-    }
-    else
-    {
-      hit = new TrkrHitv2;
-      hitset_it->second->addHitSpecificKey(hitkey, hit);
-    }
-
+    hitset->addHitsSpecificKey(hits);
   }
 
   mvtx_event_header->set_strobe_BCO(strobe);
@@ -81,6 +81,9 @@ class MvtxCombinedRawDataDecoder : public SubsysReco
   bool m_doOfflineMasking{false};
   MvtxPixelMask * m_hot_pixel_mask{nullptr};
 
+  //! hitset and hit keys of the hits passing the filters, kept to avoid reallocation
+  std::vector<std::pair<TrkrDefs::hitsetkey, TrkrDefs::hitkey>> m_hitkeys;
+
   bool m_mvtx_is_triggered{false};
 };
 
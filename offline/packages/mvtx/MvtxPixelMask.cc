@@ -48,6 +48,7 @@ void MvtxPixelMask::load_from_CDB()
   for (unsigned long masked_pixel : masked_pixels)
   {
     m_hot_pixel_map.push_back(masked_pixel);
+    set_bit(masked_pixel, true);
   }
 
   return;
@@ -58,6 +59,7 @@ void MvtxPixelMask::add_pixel(MvtxPixelDefs::pixelkey key)
   if (std::find(m_hot_pixel_map.begin(), m_hot_pixel_map.end(), key) == m_hot_pixel_map.end())
   {
     m_hot_pixel_map.push_back(key);
+    set_bit(key, true);
   }
 
   return;
@@ -69,6 +71,7 @@ void MvtxPixelMask::remove_pixel(MvtxPixelDefs::pixelkey key)
   if (it != m_hot_pixel_map.end())
   {
     m_hot_pixel_map.erase(it);
+    set_bit(key, false);
   }
 
   return;
@@ -77,21 +80,52 @@ void MvtxPixelMask::remove_pixel(MvtxPixelDefs::pixelkey key)
 void MvtxPixelMask::clear()
 {
   m_hot_pixel_map.clear();
+  for (auto& bitmap : m_chip_bitmap)
+  {
+    bitmap.clear();
+  }
   return;
 }
 
+void MvtxPixelMask::set_bit(MvtxPixelDefs::pixelkey key, bool value)
+{
+  const int index = chip_index(MvtxPixelDefs::get_layer(key), MvtxPixelDefs::get_stave(key), MvtxPixelDefs::get_chip(key));
+  const unsigned int row = MvtxPixelDefs::get_row(key);
+  const unsigned int col = MvtxPixelDefs::get_col(key);
+  if (index < 0 || row >= n_rows || col >= n_cols)
+  {
+    return;
+  }
+
+  auto& bitmap = m_chip_bitmap[index];
+  if (bitmap.empty())
+  {
+    if (!value)
+    {
+      return;
+    }
+    bitmap.assign(n_rows * n_cols / 64, 0);
+  }
+
+  const unsigned int bit = row * n_cols + col;
+  if (value)
+  {
+    bitmap[bit >> 6U] |= (uint64_t(1) << (bit & 63U));
+  }
+  else
+  {
+    bitmap[bit >> 6U] &= ~(uint64_t(1) << (bit & 63U));
+
+    // release chips without masked pixels, so that they are skipped as a whole
+    if (std::all_of(bitmap.begin(), bitmap.end(), [](uint64_t word)
+                    { return word == 0; }))
+    {
+      bitmap.clear();
+    }
+  }
+}
+
 bool MvtxPixelMask::is_masked(MvtxRawHit* hit) const
 {
-  uint8_t layer = hit->get_layer_id();
-  uint8_t stave = hit->get_stave_id();
-  uint8_t chip = hit->get_chip_id();
-  uint16_t row = hit->get_row();
-  uint16_t col = hit->get_col();
-
-  // generate hit key and hitset key
-  const TrkrDefs::hitkey this_pixel_hitkey = MvtxDefs::genHitKey(col, row);
-  const TrkrDefs::hitsetkey this_pixel_hitsetkey = MvtxDefs::genHitSetKey(layer, stave, chip, 0);
-  MvtxPixelDefs::pixelkey this_pixel_key = MvtxPixelDefs::gen_pixelkey(this_pixel_hitsetkey, this_pixel_hitkey);
-
-  return std::find(m_hot_pixel_map.begin(), m_hot_pixel_map.end(), this_pixel_key) != m_hot_pixel_map.end();
+  return is_masked(hit->get_layer_id(), hit->get_stave_id(), hit->get_chip_id(), hit->get_row(), hit->get_col());
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "MvtxPixelDefs.h"
 
 #include <climits>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -26,10 +27,58 @@ class MvtxPixelMask
 
   bool is_masked(MvtxRawHit* hit) const;
 
+  //! bitmap lookup, no key generation
+  bool is_masked(const uint8_t layer, const uint8_t stave, const uint8_t chip, const uint16_t row, const uint16_t col) const
+  {
+    const int index = chip_index(layer, stave, chip);
+    if (index < 0 || row >= n_rows || col >= n_cols)
+    {
+      return false;
+    }
+    const auto& bitmap = m_chip_bitmap[index];
+    if (bitmap.empty())
+    {
+      return false;
+    }
+    const unsigned int bit = row * n_cols + col;
+    return (bitmap[bit >> 6U] >> (bit & 63U)) & 1U;
+  }
+
+  //! true if at least one pixel of the chip is masked
+  bool has_masked_pixels(const uint8_t layer, const uint8_t stave, const uint8_t chip) const
+  {
+    const int index = chip_index(layer, stave, chip);
+    return index >= 0 && !m_chip_bitmap[index].empty();
+  }
+
   hot_pixel_map_t get_hot_pixel_map() const { return m_hot_pixel_map; }
 
  private:
+  static constexpr unsigned int n_layers = 3;
+  static constexpr unsigned int n_chips = 9;
+  static constexpr unsigned int n_rows = 512;
+  static constexpr unsigned int n_cols = 1024;
+  static constexpr unsigned int n_staves[n_layers] = {12, 16, 20};
+  static constexpr unsigned int first_stave[n_layers] = {0, 12, 28};
+  static constexpr unsigned int n_staves_total = 48;
+
+  //! position of the chip in m_chip_bitmap, -1 if out of range
+  static int chip_index(const uint8_t layer, const uint8_t stave, const uint8_t chip)
+  {
+    if (layer >= n_layers || stave >= n_staves[layer] || chip >= n_chips)
+    {
+      return -1;
+    }
+    return (first_stave[layer] + stave) * n_chips + chip;
+  }
+
+  //! set or clear the bit of a pixel in the chip bitmaps
+  void set_bit(MvtxPixelDefs::pixelkey key, bool value);
+
   hot_pixel_map_t m_hot_pixel_map{};
+
+  //! one bit per pixel, row major, allocated only for chips with masked pixels
+  std::vector<std::vector<uint64_t>> m_chip_bitmap{std::vector<std::vector<uint64_t>>(n_staves_total * n_chips)};
 };
 
 #endif  // MVTX_MVTXPIXELMASK_H
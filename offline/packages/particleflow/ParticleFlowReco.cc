@@ -20,6 +20,7 @@
 
 #include <phool/PHCompositeNode.h>
 #include <phool/PHRandomSeed.h>
+#include <phool/PHTimer.h>
 #include <phool/getClass.h>
 
 #include <TLorentzVector.h>
@@ -27,8 +28,14 @@
 #include <gsl/gsl_randist.h>
 #include <gsl/gsl_rng.h>  // for gsl_rng_uniform_pos
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <thread>
 
 // examine second value of std::pair, sort by smallest
 bool sort_by_pair_second_lowest(const std::pair<int, float> &a, const std::pair<int, float> &b)
@@ -362,286 +369,13 @@ int ParticleFlowReco::process_event(PHCompositeNode *topNode)
 
   // BEGIN LINKING STEP
 
-  // Link TRK -> EM (best match, but keep reserve of others), and TRK -> HAD (best match)
-  if (Verbosity() > 2)
-  {
-    std::cout << "ParticleFlowReco::process_event : TRK -> EM and TRK -> HAD linking " << std::endl;
-  }
-
-  for (unsigned int trk = 0; trk < _pflow_TRK_p.size(); trk++)
+  if (_benchmark_matching)
   {
-    if (Verbosity() > 10)
-    {
-      std::cout << " TRK " << trk << " with p / eta / phi = " << _pflow_TRK_p[trk] << " / " << _pflow_TRK_eta[trk] << " / " << _pflow_TRK_phi[trk] << std::endl;
-    }
-
-    // TRK -> EM link
-    float min_em_dR = 0.2;
-    int min_em_index = -1;
-
-    for (unsigned int em = 0; em < _pflow_EM_E.size(); em++)
-    {
-      float dR = calculate_dR(_pflow_TRK_EMproj_eta[trk], _pflow_EM_eta[em], _pflow_TRK_EMproj_phi[trk], _pflow_EM_phi[em]);
-
-      if (dR > 0.2)
-      {
-        continue;
-      }
-
-      bool has_overlap = false;
-
-      for (unsigned int tow = 0; tow < _pflow_EM_tower_eta.at(em).size(); tow++)
-      {
-        float tower_eta = _pflow_EM_tower_eta.at(em).at(tow);
-        float tower_phi = _pflow_EM_tower_phi.at(em).at(tow);
-
-        float deta = tower_eta - _pflow_TRK_EMproj_eta[trk];
-        float dphi = tower_phi - _pflow_TRK_EMproj_phi[trk];
-        if (dphi > M_PI)
-        {
-          dphi -= 2 * M_PI;
-        }
-        if (dphi < -M_PI)
-        {
-          dphi += 2 * M_PI;
-        }
-
-        if (fabs(deta) < 0.025 * 2.5 && fabs(dphi) < 0.025 * 2.5)
-        {
-          has_overlap = true;
-          break;
-        }
-      }
-
-      if (has_overlap)
-      {
-        if (Verbosity() > 5)
-        {
-          std::cout << " -> possible match to EM " << em << " with dR = " << dR << std::endl;
-        }
-
-        _pflow_TRK_addtl_match_EM.at(trk).push_back(std::pair<int, float>(em, dR));
-      }
-      else
-      {
-        if (Verbosity() > 5)
-        {
-          std::cout << " -> no match to EM " << em << " (even though dR = " << dR << " )" << std::endl;
-        }
-      }
-    }
-
-    // sort possible matches
-
-    std::sort(_pflow_TRK_addtl_match_EM.at(trk).begin(), _pflow_TRK_addtl_match_EM.at(trk).end(), sort_by_pair_second_lowest);
-    if (Verbosity() > 10)
-    {
-      for (auto &n : _pflow_TRK_addtl_match_EM.at(trk))
-      {
-        std::cout << " -> sorted list of matches, EM / dR = " << n.first << " / " << n.second << std::endl;
-      }
-    }
-
-    if (_pflow_TRK_addtl_match_EM.at(trk).size() > 0)
-    {
-      min_em_index = _pflow_TRK_addtl_match_EM.at(trk).at(0).first;
-      min_em_dR = _pflow_TRK_addtl_match_EM.at(trk).at(0).second;
-      // delete best matched element
-      _pflow_TRK_addtl_match_EM.at(trk).erase(_pflow_TRK_addtl_match_EM.at(trk).begin());
-    }
-
-    if (min_em_index > -1)
-    {
-      _pflow_EM_match_TRK.at(min_em_index).push_back(trk);
-      _pflow_TRK_match_EM.at(trk).push_back(min_em_index);
-
-      if (Verbosity() > 5)
-      {
-        std::cout << " -> matched EM " << min_em_index << " with pt / eta / phi = " << _pflow_EM_E.at(min_em_index) << " / " << _pflow_EM_eta.at(min_em_index) << " / " << _pflow_EM_phi.at(min_em_index) << ", dR = " << min_em_dR;
-        std::cout << " ( " << _pflow_TRK_addtl_match_EM.at(trk).size() << " other possible matches ) " << std::endl;
-      }
-    }
-    else
-    {
-      if (Verbosity() > 5)
-      {
-        std::cout << " -> no EM match! ( best dR = " << min_em_dR << " ) " << std::endl;
-      }
-    }
-
-    // TRK -> HAD link
-    float min_had_dR = 0.2;
-    int min_had_index = -1;
-    float max_had_pt = 0;
-
-    // TODO: sequential linking should better happen here -- i.e. allow EM-matched HAD's into the possible pool
-    for (unsigned int had = 0; had < _pflow_HAD_E.size(); had++)
-    {
-      float dR = calculate_dR(_pflow_TRK_HADproj_eta[trk], _pflow_HAD_eta[had], _pflow_TRK_HADproj_phi[trk], _pflow_HAD_phi[had]);
-
-      if (dR > 0.5)
-      {
-        continue;
-      }
-
-      bool has_overlap = false;
-
-      for (unsigned int tow = 0; tow < _pflow_HAD_tower_eta.at(had).size(); tow++)
-      {
-        float tower_eta = _pflow_HAD_tower_eta.at(had).at(tow);
-        float tower_phi = _pflow_HAD_tower_phi.at(had).at(tow);
-
-        float deta = tower_eta - _pflow_TRK_HADproj_eta[trk];
-        float dphi = tower_phi - _pflow_TRK_HADproj_phi[trk];
-        if (dphi > M_PI)
-        {
-          dphi -= 2 * M_PI;
-        }
-        if (dphi < -M_PI)
-        {
-          dphi += 2 * M_PI;
-        }
-
-        if (fabs(deta) < 0.1 * 1.5 && fabs(dphi) < 0.1 * 1.5)
-        {
-          has_overlap = true;
-          break;
-        }
-      }
-
-      if (has_overlap)
-      {
-        if (Verbosity() > 5)
-        {
-          std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
-        }
-
-        if (_pflow_HAD_E.at(had) > max_had_pt)
-        {
-          max_had_pt = _pflow_HAD_E.at(had);
-          min_had_index = had;
-          min_had_dR = dR;
-        }
-      }
-      else
-      {
-        if (Verbosity() > 5)
-        {
-          std::cout << " -> no match to HAD " << had << " (even though dR = " << dR << " )" << std::endl;
-        }
-      }
-    }
-
-    if (min_had_index > -1)
-    {
-      _pflow_HAD_match_TRK.at(min_had_index).push_back(trk);
-      _pflow_TRK_match_HAD.at(trk).push_back(min_had_index);
-
-      if (Verbosity() > 5)
-      {
-        std::cout << " -> matched HAD " << min_had_index << " with pt / eta / phi = " << _pflow_HAD_E.at(min_had_index) << " / " << _pflow_HAD_eta.at(min_had_index) << " / " << _pflow_HAD_phi.at(min_had_index) << ", dR = " << min_had_dR << std::endl;
-      }
-    }
-    else
-    {
-      if (Verbosity() > 5)
-      {
-        std::cout << " -> no HAD match! ( best dR = " << min_had_dR << " ) " << std::endl;
-      }
-    }
-  }
-
-  // EM->HAD linking
-  if (Verbosity() > 2)
-  {
-    std::cout << "ParticleFlowReco::process_event : EM -> HAD linking " << std::endl;
+    BenchmarkMatching();
   }
-
-  for (unsigned int em = 0; em < _pflow_EM_E.size(); em++)
+  else
   {
-    if (Verbosity() > 10)
-    {
-      std::cout << " EM with E / eta / phi = " << _pflow_EM_E[em] << " / " << _pflow_EM_eta[em] << " / " << _pflow_EM_phi[em] << std::endl;
-    }
-
-    // TRK -> HAD link
-    float min_had_dR = 0.2;
-    int min_had_index = -1;
-    float max_had_pt = 0;
-
-    for (unsigned int had = 0; had < _pflow_HAD_E.size(); had++)
-    {
-      float dR = calculate_dR(_pflow_EM_eta[em], _pflow_HAD_eta[had], _pflow_EM_phi[em], _pflow_HAD_phi[had]);
-      if (dR > 0.5)
-      {
-        continue;
-      }
-
-      bool has_overlap = false;
-
-      for (unsigned int tow = 0; tow < _pflow_HAD_tower_eta.at(had).size(); tow++)
-      {
-        float tower_eta = _pflow_HAD_tower_eta.at(had).at(tow);
-        float tower_phi = _pflow_HAD_tower_phi.at(had).at(tow);
-
-        float deta = tower_eta - _pflow_EM_eta[em];
-        float dphi = tower_phi - _pflow_EM_phi[em];
-        if (dphi > M_PI)
-        {
-          dphi -= 2 * M_PI;
-        }
-        if (dphi < -M_PI)
-        {
-          dphi += 2 * M_PI;
-        }
-
-        if (fabs(deta) < 0.1 * 1.5 && fabs(dphi) < 0.1 * 1.5)
-        {
-          has_overlap = true;
-          break;
-        }
-      }
-
-      if (has_overlap)
-      {
-        if (Verbosity() > 5)
-        {
-          std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
-        }
-
-        if (_pflow_HAD_E.at(had) > max_had_pt)
-        {
-          max_had_pt = _pflow_HAD_E.at(had);
-          min_had_index = had;
-          min_had_dR = dR;
-        }
-      }
-      else
-      {
-        if (Verbosity() > 5)
-        {
-          std::cout << " -> no match to HAD " << had << " (even though dR = " << dR << " )" << std::endl;
-        }
-      }
-    }
-
-    if (min_had_index > -1)
-    {
-      _pflow_HAD_match_EM.at(min_had_index).push_back(em);
-      _pflow_EM_match_HAD.at(em).push_back(min_had_index);
-
-      if (Verbosity() > 5)
-      {
-        std::cout << " -> matched HAD with E / eta / phi = " << _pflow_HAD_E.at(min_had_index) << " / " << _pflow_HAD_eta.at(min_had_index) << " / " << _pflow_HAD_phi.at(min_had_index) << ", dR = " << min_had_dR << std::endl;
-      }
-    }
-    else
-    {
-      if (Verbosity() > 5)
-      {
-        std::cout << " -> no HAD match! ( best dR = " << min_had_dR << " ) " << std::endl;
-      }
-    }
+    link_TRK_EM_HAD(_use_cluster_index, _nthreads);
   }
 
   // SEQUENTIAL MATCHING: if TRK -> EM and EM -> HAD, ensure that TRK -> HAD
@@ -1230,3 +964,599 @@ int ParticleFlowReco::CreateNode(PHCompositeNode *topNode)
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
+
+//____________________________________________________________________________..
+int ParticleFlowReco::End(PHCompositeNode * /*topNode*/)
+{
+  if (_benchmark_matching && !_bench_bins.empty())
+  {
+    std::cout << "ParticleFlowReco::End(): TRK -> EM, TRK -> HAD and EM -> HAD linking benchmark vs. number of TRK + EM + HAD objects" << std::endl;
+    for (const auto &[low, bin] : _bench_bins)
+    {
+      std::cout << "  " << low << " - " << low + _bench_bin_width - 1 << " objects, " << bin.nevents << " events: "
+                << "all pairs " << bin.time_all_pairs / bin.nevents << " ms/event, "
+                << "cluster index " << bin.time_cluster_index / bin.nevents << " ms/event, "
+                << bin.nmismatch << " events with different links" << std::endl;
+    }
+  }
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+namespace
+{
+  // phi in [0, 2pi)
+  float wrap_phi(float phi)
+  {
+    double wrapped = phi - 2 * M_PI * std::floor(phi / (2 * M_PI));
+    return (wrapped >= 0 && wrapped < 2 * M_PI) ? wrapped : 0;
+  }
+
+  // calls func(ithread, ijob) for ijob = 0 ... njobs-1, the jobs are handed out to the threads one by one
+  void run_jobs(const unsigned int nthreads, const unsigned int njobs, const std::function<void(unsigned int, unsigned int)> &func)
+  {
+    std::atomic<unsigned int> next{0};
+    auto worker = [&](const unsigned int ithread)
+    {
+      for (unsigned int i = next++; i < njobs; i = next++)
+      {
+        func(ithread, i);
+      }
+    };
+    const unsigned int nworkers = std::min(nthreads, njobs);
+    if (nworkers <= 1)
+    {
+      worker(0);
+      return;
+    }
+    std::vector<std::thread> threads;
+    threads.reserve(nworkers - 1);
+    for (unsigned int i = 1; i < nworkers; i++)
+    {
+      threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+  }
+}  // namespace
+
+void ParticleFlowReco::ClusterIndex::build(const std::vector<float> &eta, const std::vector<float> &phi, float radius, bool use_cells)
+{
+  binned = use_cells;
+  nclusters = eta.size();
+  neta = 0;
+  nphi = 0;
+  cell_offset.clear();
+  cell_clusters.clear();
+  unbinned.clear();
+  if (!binned)
+  {
+    return;
+  }
+
+  float min_eta = std::numeric_limits<float>::max();
+  float max_eta = std::numeric_limits<float>::lowest();
+  for (int i = 0; i < nclusters; i++)
+  {
+    if (std::isfinite(eta[i]) && std::isfinite(phi[i]))
+    {
+      min_eta = std::min(min_eta, eta[i]);
+      max_eta = std::max(max_eta, eta[i]);
+    }
+  }
+
+  // cells are made a bit wider than the radius, rounding can then never put a cluster within
+  // the radius more than one cell away. At most 1000 cells in eta, wider cells only give more candidates
+  const float width = radius * 1.01;
+  if (min_eta <= max_eta)
+  {
+    eta_min = min_eta;
+    eta_width = std::max(width, (max_eta - min_eta) / 1000);
+    neta = std::floor((max_eta - min_eta) / eta_width) + 1;
+    nphi = std::max(1, static_cast<int>(std::floor(2 * M_PI / width)));
+    phi_width = 2 * M_PI / nphi;
+  }
+
+  cluster_cell.assign(nclusters, -1);
+  cell_offset.assign(neta * nphi + 1, 0);
+  for (int i = 0; i < nclusters; i++)
+  {
+    if (!std::isfinite(eta[i]) || !std::isfinite(phi[i]))
+    {
+      // not matched through the cells, these are candidates for every query
+      unbinned.push_back(i);
+      continue;
+    }
+    int ieta = std::min(neta - 1, std::max(0, static_cast<int>(std::floor((eta[i] - eta_min) / eta_width))));
+    int iphi = std::min(nphi - 1, static_cast<int>(wrap_phi(phi[i]) / phi_width));
+    cluster_cell[i] = ieta * nphi + iphi;
+    cell_offset[cluster_cell[i] + 1]++;
+  }
+  for (unsigned int cell = 1; cell < cell_offset.size(); cell++)
+  {
+    cell_offset[cell] += cell_offset[cell - 1];
+  }
+
+  // clusters are filled in index order, the list of each cell is sorted
+  cell_clusters.resize(cell_offset.back());
+  std::vector<int> fill(cell_offset.begin(), cell_offset.end() - 1);
+  for (int i = 0; i < nclusters; i++)
+  {
+    if (cluster_cell[i] >= 0)
+    {
+      cell_clusters[fill[cluster_cell[i]]++] = i;
+    }
+  }
+}
+
+void ParticleFlowReco::ClusterIndex::candidates(float eta, float phi, std::vector<int> &cand) const
+{
+  cand.clear();
+  if (!binned || !std::isfinite(eta) || !std::isfinite(phi))
+  {
+    cand.resize(nclusters);
+    std::iota(cand.begin(), cand.end(), 0);
+    return;
+  }
+
+  cand.insert(cand.end(), unbinned.begin(), unbinned.end());
+  // 3x3 cells around the point, phi wraps around
+  const float eta_cell = std::floor((eta - eta_min) / eta_width);
+  if (neta > 0 && eta_cell >= -1 && eta_cell <= neta)
+  {
+    const int iphi = std::min(nphi - 1, static_cast<int>(wrap_phi(phi) / phi_width));
+    const int ieta_first = std::max(0, static_cast<int>(eta_cell) - 1);
+    const int ieta_last = std::min(neta - 1, static_cast<int>(eta_cell) + 1);
+    for (int ieta = ieta_first; ieta <= ieta_last; ieta++)
+    {
+      for (int i = 0; i < std::min(nphi, 3); i++)
+      {
+        int cell = ieta * nphi + ((nphi < 3) ? i : (iphi + i - 1 + nphi) % nphi);
+        cand.insert(cand.end(), cell_clusters.begin() + cell_offset[cell], cell_clusters.begin() + cell_offset[cell + 1]);
+      }
+    }
+  }
+
+  // same order as a loop over all clusters
+  std::sort(cand.begin(), cand.end());
+}
+
+void ParticleFlowReco::link_TRK_EM_HAD(bool use_index, unsigned int nthreads)
+{
+  // reset all links, BenchmarkMatching() links every event twice
+  for (auto &v : _pflow_TRK_match_EM)
+  {
+    v.clear();
+  }
+  for (auto &v : _pflow_TRK_match_HAD)
+  {
+    v.clear();
+  }
+  for (auto &v : _pflow_TRK_addtl_match_EM)
+  {
+    v.clear();
+  }
+  for (auto &v : _pflow_EM_match_TRK)
+  {
+    v.clear();
+  }
+  for (auto &v : _pflow_EM_match_HAD)
+  {
+    v.clear();
+  }
+  for (auto &v : _pflow_HAD_match_EM)
+  {
+    v.clear();
+  }
+  for (auto &v : _pflow_HAD_match_TRK)
+  {
+    v.clear();
+  }
+
+  _pflow_EM_index.build(_pflow_EM_eta, _pflow_EM_phi, 0.2, use_index);
+  _pflow_HAD_index.build(_pflow_HAD_eta, _pflow_HAD_phi, 0.5, use_index);
+
+  _pflow_TRK_best_EM.assign(_pflow_TRK_p.size(), -1);
+  _pflow_TRK_best_EM_dR.assign(_pflow_TRK_p.size(), 0.2);
+  _pflow_TRK_best_HAD.assign(_pflow_TRK_p.size(), -1);
+  _pflow_TRK_best_HAD_dR.assign(_pflow_TRK_p.size(), 0.2);
+  _pflow_EM_best_HAD.assign(_pflow_EM_E.size(), -1);
+  _pflow_EM_best_HAD_dR.assign(_pflow_EM_E.size(), 0.2);
+
+  if (nthreads == 0)
+  {
+    nthreads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  // the printout of the matching is only readable in the serial order
+  if (Verbosity() > 5)
+  {
+    nthreads = 1;
+  }
+  if (_candidates.size() < nthreads)
+  {
+    _candidates.resize(nthreads);
+  }
+
+  // Link TRK -> EM (best match, but keep reserve of others), and TRK -> HAD (best match)
+  if (Verbosity() > 2)
+  {
+    std::cout << "ParticleFlowReco::process_event : TRK -> EM and TRK -> HAD linking " << std::endl;
+  }
+
+  if (nthreads == 1)
+  {
+    for (unsigned int trk = 0; trk < _pflow_TRK_p.size(); trk++)
+    {
+      if (Verbosity() > 10)
+      {
+        std::cout << " TRK " << trk << " with p / eta / phi = " << _pflow_TRK_p[trk] << " / " << _pflow_TRK_eta[trk] << " / " << _pflow_TRK_phi[trk] << std::endl;
+      }
+      find_TRK_EM_match(trk, _candidates[0]);
+      link_TRK_EM(trk);
+      find_TRK_HAD_match(trk, _candidates[0]);
+      link_TRK_HAD(trk);
+    }
+  }
+  else
+  {
+    // the matches of the tracks are independent, the links are filled afterwards in track order
+    run_jobs(nthreads, _pflow_TRK_p.size(), [&](unsigned int ithread, unsigned int trk)
+             {
+               find_TRK_EM_match(trk, _candidates[ithread]);
+               find_TRK_HAD_match(trk, _candidates[ithread]); });
+    for (unsigned int trk = 0; trk < _pflow_TRK_p.size(); trk++)
+    {
+      link_TRK_EM(trk);
+      link_TRK_HAD(trk);
+    }
+  }
+
+  // EM->HAD linking
+  if (Verbosity() > 2)
+  {
+    std::cout << "ParticleFlowReco::process_event : EM -> HAD linking " << std::endl;
+  }
+
+  if (nthreads == 1)
+  {
+    for (unsigned int em = 0; em < _pflow_EM_E.size(); em++)
+    {
+      if (Verbosity() > 10)
+      {
+        std::cout << " EM with E / eta / phi = " << _pflow_EM_E[em] << " / " << _pflow_EM_eta[em] << " / " << _pflow_EM_phi[em] << std::endl;
+      }
+      find_EM_HAD_match(em, _candidates[0]);
+      link_EM_HAD(em);
+    }
+  }
+  else
+  {
+    run_jobs(nthreads, _pflow_EM_E.size(), [&](unsigned int ithread, unsigned int em)
+             { find_EM_HAD_match(em, _candidates[ithread]); });
+    for (unsigned int em = 0; em < _pflow_EM_E.size(); em++)
+    {
+      link_EM_HAD(em);
+    }
+  }
+}
+
+void ParticleFlowReco::find_TRK_EM_match(unsigned int trk, std::vector<int> &candidates)
+{
+  _pflow_EM_index.candidates(_pflow_TRK_EMproj_eta[trk], _pflow_TRK_EMproj_phi[trk], candidates);
+
+  for (int em : candidates)
+  {
+    float dR = calculate_dR(_pflow_TRK_EMproj_eta[trk], _pflow_EM_eta[em], _pflow_TRK_EMproj_phi[trk], _pflow_EM_phi[em]);
+
+    if (dR > 0.2)
+    {
+      continue;
+    }
+
+    bool has_overlap = false;
+
+    for (unsigned int tow = 0; tow < _pflow_EM_tower_eta.at(em).size(); tow++)
+    {
+      float tower_eta = _pflow_EM_tower_eta.at(em).at(tow);
+      float tower_phi = _pflow_EM_tower_phi.at(em).at(tow);
+
+      float deta = tower_eta - _pflow_TRK_EMproj_eta[trk];
+      float dphi = tower_phi - _pflow_TRK_EMproj_phi[trk];
+      if (dphi > M_PI)
+      {
+        dphi -= 2 * M_PI;
+      }
+      if (dphi < -M_PI)
+      {
+        dphi += 2 * M_PI;
+      }
+
+      if (fabs(deta) < 0.025 * 2.5 && fabs(dphi) < 0.025 * 2.5)
+      {
+        has_overlap = true;
+        break;
+      }
+    }
+
+    if (has_overlap)
+    {
+      if (Verbosity() > 5)
+      {
+        std::cout << " -> possible match to EM " << em << " with dR = " << dR << std::endl;
+      }
+
+      _pflow_TRK_addtl_match_EM.at(trk).push_back(std::pair<int, float>(em, dR));
+    }
+    else
+    {
+      if (Verbosity() > 5)
+      {
+        std::cout << " -> no match to EM " << em << " (even though dR = " << dR << " )" << std::endl;
+      }
+    }
+  }
+
+  // sort possible matches
+
+  std::sort(_pflow_TRK_addtl_match_EM.at(trk).begin(), _pflow_TRK_addtl_match_EM.at(trk).end(), sort_by_pair_second_lowest);
+  if (Verbosity() > 10)
+  {
+    for (auto &n : _pflow_TRK_addtl_match_EM.at(trk))
+    {
+      std::cout << " -> sorted list of matches, EM / dR = " << n.first << " / " << n.second << std::endl;
+    }
+  }
+
+  if (_pflow_TRK_addtl_match_EM.at(trk).size() > 0)
+  {
+    _pflow_TRK_best_EM[trk] = _pflow_TRK_addtl_match_EM.at(trk).at(0).first;
+    _pflow_TRK_best_EM_dR[trk] = _pflow_TRK_addtl_match_EM.at(trk).at(0).second;
+    // delete best matched element
+    _pflow_TRK_addtl_match_EM.at(trk).erase(_pflow_TRK_addtl_match_EM.at(trk).begin());
+  }
+}
+
+void ParticleFlowReco::link_TRK_EM(unsigned int trk)
+{
+  int min_em_index = _pflow_TRK_best_EM[trk];
+  float min_em_dR = _pflow_TRK_best_EM_dR[trk];
+
+  if (min_em_index > -1)
+  {
+    _pflow_EM_match_TRK.at(min_em_index).push_back(trk);
+    _pflow_TRK_match_EM.at(trk).push_back(min_em_index);
+
+    if (Verbosity() > 5)
+    {
+      std::cout << " -> matched EM " << min_em_index << " with pt / eta / phi = " << _pflow_EM_E.at(min_em_index) << " / " << _pflow_EM_eta.at(min_em_index) << " / " << _pflow_EM_phi.at(min_em_index) << ", dR = " << min_em_dR;
+      std::cout << " ( " << _pflow_TRK_addtl_match_EM.at(trk).size() << " other possible matches ) " << std::endl;
+    }
+  }
+  else
+  {
+    if (Verbosity() > 5)
+    {
+      std::cout << " -> no EM match! ( best dR = " << min_em_dR << " ) " << std::endl;
+    }
+  }
+}
+
+void ParticleFlowReco::find_TRK_HAD_match(unsigned int trk, std::vector<int> &candidates)
+{
+  float max_had_pt = 0;
+
+  // TODO: sequential linking should better happen here -- i.e. allow EM-matched HAD's into the possible pool
+  _pflow_HAD_index.candidates(_pflow_TRK_HADproj_eta[trk], _pflow_TRK_HADproj_phi[trk], candidates);
+
+  for (int had : candidates)
+  {
+    float dR = calculate_dR(_pflow_TRK_HADproj_eta[trk], _pflow_HAD_eta[had], _pflow_TRK_HADproj_phi[trk], _pflow_HAD_phi[had]);
+
+    if (dR > 0.5)
+    {
+      continue;
+    }
+
+    bool has_overlap = false;
+
+    for (unsigned int tow = 0; tow < _pflow_HAD_tower_eta.at(had).size(); tow++)
+    {
+      float tower_eta = _pflow_HAD_tower_eta.at(had).at(tow);
+      float tower_phi = _pflow_HAD_tower_phi.at(had).at(tow);
+
+      float deta = tower_eta - _pflow_TRK_HADproj_eta[trk];
+      float dphi = tower_phi - _pflow_TRK_HADproj_phi[trk];
+      if (dphi > M_PI)
+      {
+        dphi -= 2 * M_PI;
+      }
+      if (dphi < -M_PI)
+      {
+        dphi += 2 * M_PI;
+      }
+
+      if (fabs(deta) < 0.1 * 1.5 && fabs(dphi) < 0.1 * 1.5)
+      {
+        has_overlap = true;
+        break;
+      }
+    }
+
+    if (has_overlap)
+    {
+      if (Verbosity() > 5)
+      {
+        std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
+      }
+
+      if (_pflow_HAD_E.at(had) > max_had_pt)
+      {
+        max_had_pt = _pflow_HAD_E.at(had);
+        _pflow_TRK_best_HAD[trk] = had;
+        _pflow_TRK_best_HAD_dR[trk] = dR;
+      }
+    }
+    else
+    {
+      if (Verbosity() > 5)
+      {
+        std::cout << " -> no match to HAD " << had << " (even though dR = " << dR << " )" << std::endl;
+      }
+    }
+  }
+}
+
+void ParticleFlowReco::link_TRK_HAD(unsigned int trk)
+{
+  int min_had_index = _pflow_TRK_best_HAD[trk];
+  float min_had_dR = _pflow_TRK_best_HAD_dR[trk];
+
+  if (min_had_index > -1)
+  {
+    _pflow_HAD_match_TRK.at(min_had_index).push_back(trk);
+    _pflow_TRK_match_HAD.at(trk).push_back(min_had_index);
+
+    if (Verbosity() > 5)
+    {
+      std::cout << " -> matched HAD " << min_had_index << " with pt / eta / phi = " << _pflow_HAD_E.at(min_had_index) << " / " << _pflow_HAD_eta.at(min_had_index) << " / " << _pflow_HAD_phi.at(min_had_index) << ", dR = " << min_had_dR << std::endl;
+    }
+  }
+  else
+  {
+    if (Verbosity() > 5)
+    {
+      std::cout << " -> no HAD match! ( best dR = " << min_had_dR << " ) " << std::endl;
+    }
+  }
+}
+
+void ParticleFlowReco::find_EM_HAD_match(unsigned int em, std::vector<int> &candidates)
+{
+  float max_had_pt = 0;
+
+  _pflow_HAD_index.candidates(_pflow_EM_eta[em], _pflow_EM_phi[em], candidates);
+
+  for (int had : candidates)
+  {
+    float dR = calculate_dR(_pflow_EM_eta[em], _pflow_HAD_eta[had], _pflow_EM_phi[em], _pflow_HAD_phi[had]);
+    if (dR > 0.5)
+    {
+      continue;
+    }
+
+    bool has_overlap = false;
+
+    for (unsigned int tow = 0; tow < _pflow_HAD_tower_eta.at(had).size(); tow++)
+    {
+      float tower_eta = _pflow_HAD_tower_eta.at(had).at(tow);
+      float tower_phi = _pflow_HAD_tower_phi.at(had).at(tow);
+
+      float deta = tower_eta - _pflow_EM_eta[em];
+      float dphi = tower_phi - _pflow_EM_phi[em];
+      if (dphi > M_PI)
+      {
+        dphi -= 2 * M_PI;
+      }
+      if (dphi < -M_PI)
+      {
+        dphi += 2 * M_PI;
+      }
+
+      if (fabs(deta) < 0.1 * 1.5 && fabs(dphi) < 0.1 * 1.5)
+      {
+        has_overlap = true;
+        break;
+      }
+    }
+
+    if (has_overlap)
+    {
+      if (Verbosity() > 5)
+      {
+        std::cout << " -> possible match to HAD " << had << " with dR = " << dR << std::endl;
+      }
+
+      if (_pflow_HAD_E.at(had) > max_had_pt)
+      {
+        max_had_pt = _pflow_HAD_E.at(had);
+        _pflow_EM_best_HAD[em] = had;
+        _pflow_EM_best_HAD_dR[em] = dR;
+      }
+    }
+    else
+    {
+      if (Verbosity() > 5)
+      {
+        std::cout << " -> no match to HAD " << had << " (even though dR = " << dR << " )" << std::endl;
+      }
+    }
+  }
+}
+
+void ParticleFlowReco::link_EM_HAD(unsigned int em)
+{
+  int min_had_index = _pflow_EM_best_HAD[em];
+  float min_had_dR = _pflow_EM_best_HAD_dR[em];
+
+  if (min_had_index > -1)
+  {
+    _pflow_HAD_match_EM.at(min_had_index).push_back(em);
+    _pflow_EM_match_HAD.at(em).push_back(min_had_index);
+
+    if (Verbosity() > 5)
+    {
+      std::cout << " -> matched HAD with E / eta / phi = " << _pflow_HAD_E.at(min_had_index) << " / " << _pflow_HAD_eta.at(min_had_index) << " / " << _pflow_HAD_phi.at(min_had_index) << ", dR = " << min_had_dR << std::endl;
+    }
+  }
+  else
+  {
+    if (Verbosity() > 5)
+    {
+      std::cout << " -> no HAD match! ( best dR = " << min_had_dR << " ) " << std::endl;
+    }
+  }
+}
+
+void ParticleFlowReco::BenchmarkMatching()
+{
+  PHTimer timer("MatchingTimer");
+
+  timer.restart();
+  link_TRK_EM_HAD(false, 1);
+  timer.stop();
+  const double time_all_pairs = timer.elapsed();
+
+  const std::vector<std::vector<int> > trk_match_em = _pflow_TRK_match_EM;
+  const std::vector<std::vector<int> > trk_match_had = _pflow_TRK_match_HAD;
+  const std::vector<std::vector<std::pair<int, float> > > trk_addtl_match_em = _pflow_TRK_addtl_match_EM;
+  const std::vector<std::vector<int> > em_match_trk = _pflow_EM_match_TRK;
+  const std::vector<std::vector<int> > em_match_had = _pflow_EM_match_HAD;
+  const std::vector<std::vector<int> > had_match_em = _pflow_HAD_match_EM;
+  const std::vector<std::vector<int> > had_match_trk = _pflow_HAD_match_TRK;
+
+  // the links of this one are kept for the event
+  timer.restart();
+  link_TRK_EM_HAD(true, _nthreads);
+  timer.stop();
+
+  const unsigned int multiplicity = _pflow_TRK_p.size() + _pflow_EM_E.size() + _pflow_HAD_E.size();
+  BenchmarkBin &bin = _bench_bins[multiplicity / _bench_bin_width * _bench_bin_width];
+  bin.nevents++;
+  bin.time_all_pairs += time_all_pairs;
+  bin.time_cluster_index += timer.elapsed();
+
+  if (trk_match_em != _pflow_TRK_match_EM || trk_match_had != _pflow_TRK_match_HAD ||
+      trk_addtl_match_em != _pflow_TRK_addtl_match_EM || em_match_trk != _pflow_EM_match_TRK ||
+      em_match_had != _pflow_EM_match_HAD || had_match_em != _pflow_HAD_match_EM ||
+      had_match_trk != _pflow_HAD_match_TRK)
+  {
+    bin.nmismatch++;
+    if (Verbosity() > 0)
+    {
+      std::cout << "ParticleFlowReco::BenchmarkMatching(): links with the cluster index differ from the ones of all TRK/EM/HAD pairs, "
+                << multiplicity << " TRK + EM + HAD objects" << std::endl;
+    }
+  }
+}
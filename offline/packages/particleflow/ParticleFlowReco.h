@@ -11,7 +11,9 @@
 
 #include <gsl/gsl_rng.h>
 
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 class PHCompositeNode;
@@ -29,18 +31,74 @@ class ParticleFlowReco : public SubsysReco
 
   int process_event(PHCompositeNode *topNode) override;
 
+  int End(PHCompositeNode *topNode) override;
+
   void set_energy_match_Nsigma(float Nsigma)
   {
     _energy_match_Nsigma = Nsigma;
   }
   void set_track_map_name(std::string &name) { _track_map_name = name; }
 
+  // look up the TRK -> EM/HAD and EM -> HAD match candidates in an (eta, phi) index
+  // of the clusters instead of testing all pairs, the links are the same
+  void set_use_cluster_index(bool b) { _use_cluster_index = b; }
+
+  // number of threads for the TRK -> EM/HAD and EM -> HAD matching, 0 = all cores
+  void set_nthreads(unsigned int n) { _nthreads = n; }
+
+  // link every event with all pairs and with the cluster index, compare the links
+  // and print the timing vs. the number of TRK + EM + HAD objects at End()
+  void set_benchmark_matching(bool b) { _benchmark_matching = b; }
+
  private:
+  // clusters sorted into (eta, phi) cells which are at least as wide as the matching radius,
+  // all clusters within the radius of a point are in the 3x3 cells around it
+  struct ClusterIndex
+  {
+    void build(const std::vector<float> &eta, const std::vector<float> &phi, float radius, bool use_cells);
+    // candidate clusters for a point in ascending index order, all clusters if not binned
+    void candidates(float eta, float phi, std::vector<int> &cand) const;
+
+    bool binned{true};
+    int nclusters{0};
+    int neta{0};
+    int nphi{0};
+    float eta_min{0};
+    float eta_width{1};
+    float phi_width{1};
+    std::vector<int> cluster_cell;
+    // clusters of cell ieta * nphi + iphi are cell_clusters[cell_offset[cell]] ... cell_clusters[cell_offset[cell + 1] - 1]
+    std::vector<int> cell_offset;
+    std::vector<int> cell_clusters;
+    // clusters with a non-finite position, candidates for every point
+    std::vector<int> unbinned;
+  };
+
+  struct BenchmarkBin
+  {
+    unsigned int nevents{0};
+    unsigned int nmismatch{0};
+    double time_all_pairs{0};      // ms
+    double time_cluster_index{0};  // ms
+  };
+
   int CreateNode(PHCompositeNode *topNode);
 
   float calculate_dR(float, float, float, float);
   std::pair<float, float> get_expected_signature(int);
 
+  // fills the TRK -> EM, TRK -> HAD and EM -> HAD links
+  void link_TRK_EM_HAD(bool use_index, unsigned int nthreads);
+  // find_* only write the entries of their own TRK or EM and run in parallel,
+  // link_* fill the links and run serially in TRK / EM order
+  void find_TRK_EM_match(unsigned int trk, std::vector<int> &candidates);
+  void find_TRK_HAD_match(unsigned int trk, std::vector<int> &candidates);
+  void find_EM_HAD_match(unsigned int em, std::vector<int> &candidates);
+  void link_TRK_EM(unsigned int trk);
+  void link_TRK_HAD(unsigned int trk);
+  void link_EM_HAD(unsigned int em);
+  void BenchmarkMatching();
+
   float _energy_match_Nsigma;
 
   std::vector<float> _pflow_TRK_p;
@@ -76,6 +134,25 @@ class ParticleFlowReco : public SubsysReco
   std::vector<std::vector<int> > _pflow_HAD_match_TRK;
 
   std::string _track_map_name = "SvtxTrackMap";
+
+  bool _use_cluster_index = true;
+  unsigned int _nthreads = 1;
+  ClusterIndex _pflow_EM_index;
+  ClusterIndex _pflow_HAD_index;
+  // match tables, one entry per TRK / EM, reused every event
+  std::vector<int> _pflow_TRK_best_EM;
+  std::vector<float> _pflow_TRK_best_EM_dR;
+  std::vector<int> _pflow_TRK_best_HAD;
+  std::vector<float> _pflow_TRK_best_HAD_dR;
+  std::vector<int> _pflow_EM_best_HAD;
+  std::vector<float> _pflow_EM_best_HAD_dR;
+  // candidate list per thread
+  std::vector<std::vector<int> > _candidates;
+
+  bool _benchmark_matching = false;
+  unsigned int _bench_bin_width = 100;
+  // lower edge of the TRK + EM + HAD multiplicity bin -> timing
+  std::map<unsigned int, BenchmarkBin> _bench_bins;
 };
 
 #endif  // PARTICLEFLOWRECO_H
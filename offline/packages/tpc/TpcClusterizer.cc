@@ -12,6 +12,7 @@
 #include <trackbase/ClusHitsVerbosev1.h>
 #include <trackbase/TpcDefs.h>
 #include <trackbase/TrkrClusterContainerv4.h>
+#include <trackbase/TrkrClusterContainerv5.h>
 #include <trackbase/TrkrClusterHitAssocv3.h>
 #include <trackbase/TrkrClusterv3.h>
 #include <trackbase/TrkrClusterv4.h>
@@ -42,6 +43,7 @@
 #include <phool/PHNodeIterator.h>
 #include <phool/PHObject.h>  // for PHObject
 #include <phool/getClass.h>
+#include <phool/recoConsts.h>
 #include <phool/phool.h>  // for PHWHERE
 
 #include <TMatrixFfwd.h>    // for TMatrixF
@@ -1145,12 +1147,26 @@ int TpcClusterizer::InitRun(PHCompositeNode *topNode)
       dstNode->addNode(DetNode);
     }
 
-    trkrclusters = new TrkrClusterContainerv4;
+    // compressed cluster output, see TrkrClusterContainerv5
+    if (recoConsts::instance()->get_IntFlag("TRKR_CLUSTER_COMPRESSION", 0))
+    {
+      trkrclusters = new TrkrClusterContainerv5;
+    }
+    else
+    {
+      trkrclusters = new TrkrClusterContainerv4;
+    }
     PHIODataNode<PHObject> *TrkrClusterContainerNode =
         new PHIODataNode<PHObject>(trkrclusters, "TRKR_CLUSTER", "PHObject");
     DetNode->addNode(TrkrClusterContainerNode);
   }
 
+  // the error dictionaries of the compressed output are trained once per run
+  if (auto compressed = dynamic_cast<TrkrClusterContainerv5 *>(trkrclusters))
+  {
+    compressed->resetDictionaries();
+  }
+
   auto clusterhitassoc = findNode::getClass<TrkrClusterHitAssoc>(topNode, "TRKR_CLUSTERHITASSOC");
   if (!clusterhitassoc)
   {
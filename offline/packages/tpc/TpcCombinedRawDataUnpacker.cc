@@ -29,11 +29,10 @@
 #include <phool/phool.h>  // for PHWHERE
 
 #include <TFile.h>
-#include <TH1.h>
-#include <TH2.h>
 #include <TNtuple.h>
 #include <TSystem.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>   // for exit
 #include <cstdlib>   // for exit
@@ -290,7 +289,7 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
     {
       std::cout << "TpcCombinedRawDataUnpacker:: do zero suppression" << std::endl;
     }
-    TH2C* feehist = nullptr;
+    fee_adc_hist* feehist = nullptr;
     hpedestal = 60;
     hpedwidth = m_zs_threshold;
 
@@ -312,25 +311,23 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
     }
     int rx = get_rx(layer);
     unsigned int fee_key = create_fee_key(side, mc_sectors[sector % 12], rx, fee);
-    // find or insert TH2C;
-    std::map<unsigned int, TH2C*>::iterator fee_map_it;
-
-
-    fee_map_it = feeadc_map.find(fee_key);
-    if (fee_map_it != feeadc_map.end())
-    {
-      feehist = (*fee_map_it).second;
-    }
-    else
+    // the adc occupancy is only used for the baseline correction
+    if (m_do_baseline_corr)
     {
-      std::string histname = "h" + std::to_string(fee_key);
-      feehist = new TH2C(histname.c_str(), "histname", max_time_range + 1, -0.5, max_time_range + 0.5, 501, -0.5, 1000.5);
-      feeadc_map.insert(std::make_pair(fee_key, feehist));
-      std::vector<int> feeentries(feehist->GetNbinsX(), 0);
-      feeentries_map.insert(std::make_pair(fee_key, feeentries));
+      // find or insert the fee histogram, the time binning is fixed when it is created
+      auto fee_map_it = feeadc_map.find(fee_key);
+      if (fee_map_it == feeadc_map.end())
+      {
+        fee_map_it = feeadc_map.insert(std::make_pair(fee_key, fee_adc_hist())).first;
+        fee_adc_hist& newhist = fee_map_it->second;
+        newhist.ntbins = max_time_range + 1;
+        newhist.counts.assign(newhist.ntbins * fee_adc_hist::nadcbins, 0);
+        newhist.entries.assign(newhist.ntbins, 0);
+        newhist.maxcount.assign(newhist.ntbins, 0);
+        newhist.maxbin.assign(newhist.ntbins, 0);
+      }
+      feehist = &fee_map_it->second;
     }
-    auto fee_entries_it = feeentries_map.find(fee_key);
-    std::vector<int>& fee_entries_vec = (*fee_entries_it).second;
 
     float threshold_cut = m_zs_threshold;
 
@@ -351,11 +348,7 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
         {
           if ((float(adc) - hpedestal) > threshold_cut)
           {
-            feehist->Fill(t, adc - hpedestal);
-            if(t < (int)fee_entries_vec.size())
-            {
-              fee_entries_vec[t]++;
-            }
+            fill_fee_adc(*feehist, t, adc - hpedestal);
           }
         }
       }
@@ -407,87 +400,47 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
     int nhisttotal = 0;
     for (auto& hiter : feeadc_map)
     {
-      if (hiter.second != nullptr)
+      unsigned int fee_key = hiter.first;
+      unsigned int side;
+      unsigned int sector;
+      unsigned int rx;
+      unsigned int fee;
+      unpack_fee_key(side, sector, rx, fee, fee_key);
+      const fee_adc_hist& feehist = hiter.second;
+
+      std::vector<float>& pedvec = feebaseline_map[fee_key];
+      pedvec.assign(feehist.ntbins, 0);
+      // the last time bin is not used (as before with the TH2C binning)
+      for (int timebin = 0; timebin < feehist.ntbins - 1; timebin++)
       {
-        unsigned int fee_key = hiter.first;
-        unsigned int side;
-        unsigned int sector;
-        unsigned int rx;
-        unsigned int fee;
-        unpack_fee_key(side, sector, rx, fee, fee_key);
-        TH2C* hist2d = hiter.second;
-        std::map<unsigned int, std::vector<int>>::iterator fee_entries_it = feeentries_map.find(fee_key);
-        if (fee_entries_it == feeentries_map.end())
+        nhisttotal++;
+        float local_ped = 0;
+        float local_width = 0;
+        float entries = feehist.entries[timebin];
+        if (feehist.entries[timebin] > 100)
         {
-          continue;
-          //	  fee_entries_vec_it = (*fee_entries_it).second.begin();
+          nhistfilled++;
+          fee_adc_peak(feehist, timebin, local_ped, local_width);
         }
-        std::vector<int>::iterator fee_entries_vec_it = (*fee_entries_it).second.begin();
+        pedvec[timebin] = local_ped + m_baseline_nsigma * local_width;
 
-        std::vector<float> pedvec(hist2d->GetNbinsX(), 0);
-        feebaseline_map.insert(std::make_pair(hiter.first, pedvec));
-        std::map<unsigned int, std::vector<float>>::iterator fee_blm_it = feebaseline_map.find(hiter.first);
-        (*fee_blm_it).second.resize(hist2d->GetNbinsX(), 0);
-        for (int binx = 1; binx < hist2d->GetNbinsX(); binx++)
+        if (m_writeTree)
         {
-          double timebin = ((TAxis*) hist2d->GetXaxis())->GetBinCenter(binx);
-          std::string histname1d = "h" + std::to_string(hiter.first) + "_" + std::to_string((int) timebin);
-          nhisttotal++;
-          float local_ped = 0;
-          float local_width = 0;
-          float entries = fee_entries_vec_it[timebin];
-          if (fee_entries_vec_it[timebin] > 100)
-          {
-            nhistfilled++;
-
-            TH1D* hist1d = hist2d->ProjectionY(histname1d.c_str(), binx, binx);
-            if (hist1d->GetEntries() != fee_entries_vec_it[timebin])
-            {
-              std::cout << " vec " << fee_entries_vec_it[timebin]
-                        << " hist " << hist1d->GetEntries()
-                        << std::endl;
-            }
-            if (hist1d->GetEntries() > 10)
-            {
-              int maxbin = hist1d->GetMaximumBin();
-              // calc peak position
-              double hadc_sum = 0.0;
-              double hibin_sum = 0.0;
-              double hibin2_sum = 0.0;
-
-              for (int isum = -3; isum <= 3; isum++)
-              {
-                float val = hist1d->GetBinContent(maxbin + isum);
-                float center = hist1d->GetBinCenter(maxbin + isum);
-                hibin_sum += center * val;
-                hibin2_sum += center * center * val;
-                hadc_sum += val;
-              }
-              local_ped = hibin_sum / hadc_sum;
-              local_width = sqrt(hibin2_sum / hadc_sum - (local_ped * local_ped));
-            }
-            delete hist1d;
-          }
-          (*fee_blm_it).second[(int) timebin] = local_ped + m_baseline_nsigma * local_width;
-
-          if (m_writeTree)
-          {
-            float fXh[11];
-            int nh = 0;
+          float fXh[11];
+          int nh = 0;
 
-            fXh[nh++] = _ievent - 1;
-            fXh[nh++] = 0;                        // gtm_bco;
-            fXh[nh++] = 0;                        // packet_id;
-            fXh[nh++] = 0;                        // ep;
-            fXh[nh++] = mc_sectors[sector % 12];  // Sector;
-            fXh[nh++] = side;
-            fXh[nh++] = fee;
-            fXh[nh++] = rx;
-            fXh[nh++] = entries;
-            fXh[nh++] = local_ped;
-            fXh[nh++] = local_width;
-            m_ntup->Fill(fXh);
-          }
+          fXh[nh++] = _ievent - 1;
+          fXh[nh++] = 0;                        // gtm_bco;
+          fXh[nh++] = 0;                        // packet_id;
+          fXh[nh++] = 0;                        // ep;
+          fXh[nh++] = mc_sectors[sector % 12];  // Sector;
+          fXh[nh++] = side;
+          fXh[nh++] = fee;
+          fXh[nh++] = rx;
+          fXh[nh++] = entries;
+          fXh[nh++] = local_ped;
+          fXh[nh++] = local_width;
+          m_ntup->Fill(fXh);
         }
       }
     }
@@ -587,16 +540,9 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
   // reset histogramms
   for (auto& hiter2 : feeadc_map)
   {
-    if (hiter2.second != nullptr)
-    {
-      hiter2.second->Reset();
-    }
+    reset_fee_adc(hiter2.second);
   }
   feebaseline_map.clear();
-  for (auto& hiter_entries : feeentries_map)
-  {
-    hiter_entries.second.assign(hiter_entries.second.size(), 0);
-  }
 
   if (Verbosity())
   {
@@ -607,6 +553,82 @@ int TpcCombinedRawDataUnpacker::process_event(PHCompositeNode* topNode)
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void TpcCombinedRawDataUnpacker::fill_fee_adc(fee_adc_hist& feehist, const int t, const double adcval)
+{
+  // time bins beyond the histogram range went to the TH2C overflow and were never used
+  if (t >= feehist.ntbins)
+  {
+    return;
+  }
+  feehist.entries[t]++;
+  if (adcval < fee_adc_hist::adcmin || adcval >= fee_adc_hist::adcmax)
+  {
+    return;
+  }
+  // same bin finding as TAxis::FindBin for fixed bins (0 based here)
+  const int adcbin = int(fee_adc_hist::nadcbins * (adcval - fee_adc_hist::adcmin) / (fee_adc_hist::adcmax - fee_adc_hist::adcmin));
+  uint8_t& count = feehist.counts[t * fee_adc_hist::nadcbins + adcbin];
+  // TH2C saturates at 127
+  if (count >= 127)
+  {
+    return;
+  }
+  count++;
+  // keep track of the first maximum bin like TH1::GetMaximumBin
+  if (count > feehist.maxcount[t] || (count == feehist.maxcount[t] && adcbin < feehist.maxbin[t]))
+  {
+    feehist.maxcount[t] = count;
+    feehist.maxbin[t] = adcbin;
+  }
+}
+
+void TpcCombinedRawDataUnpacker::reset_fee_adc(fee_adc_hist& feehist)
+{
+  // only time bins which were filled need to be cleared
+  for (int t = 0; t < feehist.ntbins; t++)
+  {
+    if (feehist.entries[t] > 0)
+    {
+      std::fill_n(feehist.counts.begin() + t * fee_adc_hist::nadcbins, fee_adc_hist::nadcbins, 0);
+      feehist.entries[t] = 0;
+      feehist.maxcount[t] = 0;
+      feehist.maxbin[t] = 0;
+    }
+  }
+}
+
+bool TpcCombinedRawDataUnpacker::fee_adc_peak(const fee_adc_hist& feehist, const int t, float& local_ped, float& local_width) const
+{
+  // sum of the adc bin contents, this is what the projection entries were
+  int nentries = 0;
+  const uint8_t* row = &feehist.counts[t * fee_adc_hist::nadcbins];
+  for (int ibin = 0; ibin < fee_adc_hist::nadcbins; ibin++)
+  {
+    nentries += row[ibin];
+  }
+  if (nentries <= 10)
+  {
+    return false;
+  }
+  // calc peak position from +-3 bins around the maximum
+  const double binwidth = (fee_adc_hist::adcmax - fee_adc_hist::adcmin) / fee_adc_hist::nadcbins;
+  double hadc_sum = 0.0;
+  double hibin_sum = 0.0;
+  double hibin2_sum = 0.0;
+  for (int isum = -3; isum <= 3; isum++)
+  {
+    const int ibin = feehist.maxbin[t] + isum;
+    float val = (ibin >= 0 && ibin < fee_adc_hist::nadcbins) ? row[ibin] : 0;
+    float center = fee_adc_hist::adcmin + ibin * binwidth + binwidth / 2;
+    hibin_sum += center * val;
+    hibin2_sum += center * center * val;
+    hadc_sum += val;
+  }
+  local_ped = hibin_sum / hadc_sum;
+  local_width = sqrt(hibin2_sum / hadc_sum - (local_ped * local_ped));
+  return true;
+}
+
 int TpcCombinedRawDataUnpacker::End(PHCompositeNode* /*topNode*/)
 {
   if (m_writeTree)
@@ -5,6 +5,7 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <string>
@@ -14,7 +15,6 @@ class PHCompositeNode;
 class CDBTTree;
 class CDBInterface;
 class TH2I;
-class TH2C;
 class TFile;
 class TNtuple;
 
@@ -116,8 +116,27 @@ class TpcCombinedRawDataUnpacker : public SubsysReco
   std::string m_TpcRawNodeName{"TPCRAWHIT"};
   std::string outfile_name;
   std::map<unsigned int, chan_info> chan_map;                  // stays in place
-  std::map<unsigned int, TH2C *> feeadc_map;                   // histos reset after each event
-  std::map<unsigned int, std::vector<int>> feeentries_map;     // cleared after each event
+
+  // (time bin x adc) occupancy of one fee used for the common mode baseline.
+  // Same binning and 8 bit saturation as the TH2C it replaces (501 adc bins
+  // on [-0.5, 1000.5]), but kept in a flat array which is reused across events.
+  // The most populated adc bin of each time bin is tracked while filling.
+  struct fee_adc_hist
+  {
+    static constexpr int nadcbins = 501;
+    static constexpr double adcmin = -0.5;
+    static constexpr double adcmax = 1000.5;
+    int ntbins = 0;
+    std::vector<uint8_t> counts;    // ntbins * nadcbins, time bin major
+    std::vector<int> entries;       // fills per time bin
+    std::vector<uint8_t> maxcount;  // content of the most populated adc bin per time bin
+    std::vector<int> maxbin;        // first adc bin (0 based) with maxcount
+  };
+  void fill_fee_adc(fee_adc_hist &feehist, const int t, const double adcval);
+  void reset_fee_adc(fee_adc_hist &feehist);
+  bool fee_adc_peak(const fee_adc_hist &feehist, const int t, float &local_ped, float &local_width) const;
+
+  std::map<unsigned int, fee_adc_hist> feeadc_map;             // reset after each event
   std::map<unsigned int, std::vector<float>> feebaseline_map;  // cleared after each event
 };
 
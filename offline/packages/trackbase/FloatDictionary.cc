@@ -0,0 +1,227 @@
+#include "FloatDictionary.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  // upper limit of the training histogram size
+  constexpr size_t max_bins = 1U << 22U;
+
+  // bins per dictionary entry when training for a given number of entries
+  constexpr size_t bins_per_entry = 64;
+
+  struct Segment
+  {
+    size_t first{0};
+    size_t last{0};
+    float lo{0};
+    float hi{0};
+    uint32_t count{0};
+  };
+
+  // greedily merge adjacent occupied bins as long as the values they hold span at most 2*max_error
+  template <class Hist>
+  std::vector<Segment> make_segments(const Hist& hist, float max_error)
+  {
+    std::vector<Segment> segments;
+    for (size_t bin = 0; bin < hist.count.size(); ++bin)
+    {
+      if (hist.count[bin] == 0)
+      {
+        continue;
+      }
+      if (segments.empty() || hist.hi[bin] - segments.back().lo > 2 * max_error)
+      {
+        segments.push_back({bin, bin, hist.lo[bin], hist.hi[bin], 0});
+      }
+      auto& segment = segments.back();
+      segment.last = bin;
+      segment.hi = hist.hi[bin];
+      segment.count += hist.count[bin];
+    }
+    return segments;
+  }
+}  // namespace
+
+void FloatDictionary::clear()
+{
+  m_entries.clear();
+  m_bincode.clear();
+  m_max_error = 0;
+}
+
+void FloatDictionary::fill(Histogram& hist, const std::vector<float>& values, size_t nbins)
+{
+  float xmin = std::numeric_limits<float>::max();
+  float xmax = std::numeric_limits<float>::lowest();
+  for (const auto value : values)
+  {
+    if (std::isfinite(value))
+    {
+      xmin = std::min(xmin, value);
+      xmax = std::max(xmax, value);
+    }
+  }
+  hist.count.clear();
+  hist.lo.clear();
+  hist.hi.clear();
+  if (xmin > xmax)
+  {
+    return;
+  }
+  nbins = std::clamp<size_t>(nbins, 1, max_bins);
+  hist.xmin = xmin;
+  hist.width = (xmax > xmin) ? (xmax - xmin) / nbins : 1;
+  hist.count.assign(nbins, 0);
+  hist.lo.assign(nbins, std::numeric_limits<float>::max());
+  hist.hi.assign(nbins, std::numeric_limits<float>::lowest());
+  for (const auto value : values)
+  {
+    if (!std::isfinite(value))
+    {
+      continue;
+    }
+    const size_t bin = std::min<size_t>((value - xmin) / hist.width, nbins - 1);
+    ++hist.count[bin];
+    hist.lo[bin] = std::min(hist.lo[bin], value);
+    hist.hi[bin] = std::max(hist.hi[bin], value);
+  }
+}
+
+size_t FloatDictionary::count_entries(const Histogram& hist, float max_error)
+{
+  return make_segments(hist, max_error).size();
+}
+
+void FloatDictionary::build(const Histogram& hist, float max_error, size_t max_entries)
+{
+  clear();
+  m_max_error = max_error;
+  m_xmin = hist.xmin;
+  m_width = hist.width;
+  auto segments = make_segments(hist, max_error);
+  max_entries = std::min<size_t>(max_entries, escape);
+  if (segments.size() > max_entries)
+  {
+    // keep the most populated entries, values of the others end up escaped
+    std::nth_element(segments.begin(), segments.begin() + max_entries, segments.end(),
+                     [](const Segment& a, const Segment& b)
+                     { return a.count > b.count; });
+    segments.resize(max_entries);
+    std::sort(segments.begin(), segments.end(),
+              [](const Segment& a, const Segment& b)
+              { return a.lo < b.lo; });
+  }
+  m_entries.reserve(segments.size());
+  m_bincode.assign(hist.count.size(), escape);
+  for (const auto& segment : segments)
+  {
+    const auto code = static_cast<uint16_t>(m_entries.size());
+    m_entries.push_back((segment.lo + segment.hi) / 2);
+    std::fill(m_bincode.begin() + segment.first, m_bincode.begin() + segment.last + 1, code);
+  }
+}
+
+void FloatDictionary::train(const std::vector<float>& values, float max_error, size_t max_entries)
+{
+  Histogram hist;
+  size_t nbins = max_bins;
+  if (max_error > 0)
+  {
+    float xmin = std::numeric_limits<float>::max();
+    float xmax = std::numeric_limits<float>::lowest();
+    for (const auto value : values)
+    {
+      if (std::isfinite(value))
+      {
+        xmin = std::min(xmin, value);
+        xmax = std::max(xmax, value);
+      }
+    }
+    if (xmax > xmin)
+    {
+      nbins = std::min<double>(std::ceil((xmax - xmin) / max_error), max_bins);
+    }
+  }
+  fill(hist, values, nbins);
+  build(hist, max_error, max_entries);
+}
+
+void FloatDictionary::train_entries(const std::vector<float>& values, size_t max_entries)
+{
+  max_entries = std::clamp<size_t>(max_entries, 1, escape);
+  Histogram hist;
+  fill(hist, values, bins_per_entry * max_entries);
+  if (hist.count.empty())
+  {
+    clear();
+    return;
+  }
+
+  // bisect the smallest error for which max_entries entries are enough,
+  // a single entry always is
+  float error_lo = 0;
+  float error_hi = hist.width * hist.count.size();
+  for (int i = 0; i < 40 && error_hi - error_lo > std::numeric_limits<float>::epsilon() * error_hi; ++i)
+  {
+    const float error = (error_lo + error_hi) / 2;
+    if (count_entries(hist, error) <= max_entries)
+    {
+      error_hi = error;
+    }
+    else
+    {
+      error_lo = error;
+    }
+  }
+  build(hist, error_hi, max_entries);
+}
+
+uint16_t FloatDictionary::encode_nearest(float value) const
+{
+  if (m_entries.empty() || std::isnan(value))
+  {
+    return escape;
+  }
+  const auto iter = std::lower_bound(m_entries.begin(), m_entries.end(), value);
+  if (iter == m_entries.begin())
+  {
+    return 0;
+  }
+  if (iter == m_entries.end() || value - *(iter - 1) < *iter - value)
+  {
+    return iter - m_entries.begin() - 1;
+  }
+  return iter - m_entries.begin();
+}
+
+uint16_t FloatDictionary::encode(float value) const
+{
+  if (!std::isfinite(value))
+  {
+    return escape;
+  }
+
+  // fast path through the training histogram
+  if (!m_bincode.empty() && value >= m_xmin)
+  {
+    const size_t bin = (value - m_xmin) / m_width;
+    if (bin < m_bincode.size())
+    {
+      const uint16_t code = m_bincode[bin];
+      if (code != escape && std::abs(m_entries[code] - value) <= m_max_error)
+      {
+        return code;
+      }
+    }
+  }
+
+  const uint16_t code = encode_nearest(value);
+  if (code != escape && std::abs(m_entries[code] - value) <= m_max_error)
+  {
+    return code;
+  }
+  return escape;
+}
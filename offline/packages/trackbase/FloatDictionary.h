@@ -0,0 +1,82 @@
+#ifndef TRACKBASE_FLOATDICTIONARY_H
+#define TRACKBASE_FLOATDICTIONARY_H
+
+/**
+ * Dictionary approximation of float columns by 16-bit codes.
+ *
+ * The dictionary is trained in linear time: the values are filled in a
+ * histogram (one pass), adjacent occupied bins are then merged greedily into
+ * entries spanning at most twice the allowed error. Each entry is the center
+ * of the values it covers, so every trained value is within the error of its
+ * entry. Values which cannot be represented (outside the trained range, or
+ * dropped because there were more entries than codes) are encoded as
+ * FloatDictionary::escape and have to be stored by the caller.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class FloatDictionary
+{
+ public:
+  static constexpr uint16_t escape = 0xFFFF;
+
+  FloatDictionary() = default;
+  //! dictionary with given entries, e.g. read back from file (decoding only)
+  explicit FloatDictionary(const std::vector<float>& entries)
+    : m_entries(entries)
+  {
+  }
+
+  //! train with a maximum absolute error, keeps the max_entries most populated entries
+  void train(const std::vector<float>& values, float max_error, size_t max_entries = escape);
+
+  //! train with a given number of entries, minimizing the maximum error (no escape)
+  void train_entries(const std::vector<float>& values, size_t max_entries);
+
+  //! code of the entry within max_error of value, escape if there is none
+  uint16_t encode(float value) const;
+
+  //! code of the closest entry
+  uint16_t encode_nearest(float value) const;
+
+  float decode(uint16_t code) const { return m_entries[code]; }
+
+  const std::vector<float>& entries() const { return m_entries; }
+  size_t size() const { return m_entries.size(); }
+  bool empty() const { return m_entries.empty(); }
+  float max_error() const { return m_max_error; }
+
+  void clear();
+
+ private:
+  struct Histogram
+  {
+    float xmin{0};
+    float width{1};
+    std::vector<uint32_t> count;
+    std::vector<float> lo;
+    std::vector<float> hi;
+  };
+
+  static void fill(Histogram& hist, const std::vector<float>& values, size_t nbins);
+
+  // number of entries needed for the given error
+  static size_t count_entries(const Histogram& hist, float max_error);
+
+  void build(const Histogram& hist, float max_error, size_t max_entries);
+
+  //! sorted entries, the code is the index
+  std::vector<float> m_entries;
+
+  //! maximum absolute error the dictionary was trained for
+  float m_max_error{0};
+
+  //! code lookup by histogram bin, for encoding
+  float m_xmin{0};
+  float m_width{1};
+  std::vector<uint16_t> m_bincode;
+};
+
+#endif
@@ -0,0 +1,277 @@
+/**
+ * @file trackbase/TrkrClusterContainerv5.cc
+ * @brief Implementation of TrkrClusterContainerv5
+ */
+#include "TrkrClusterContainerv5.h"
+#include "TrkrCluster.h"
+#include "TrkrClusterv5.h"
+#include "TrkrDefs.h"
+
+#include <TBuffer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  // nan is stored as the lowest integer
+  int32_t quantize(float value, float max_error)
+  {
+    if (std::isnan(value))
+    {
+      return std::numeric_limits<int32_t>::min();
+    }
+    const double scaled = std::round(value / (2. * max_error));
+    return std::clamp<double>(scaled, std::numeric_limits<int32_t>::min() + 1, std::numeric_limits<int32_t>::max());
+  }
+
+  float dequantize(int32_t value, float max_error)
+  {
+    if (value == std::numeric_limits<int32_t>::min())
+    {
+      return std::numeric_limits<float>::quiet_NaN();
+    }
+    return value * (2. * max_error);
+  }
+}  // namespace
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::Reset()
+{
+  m_clusters.Reset();
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::identify(std::ostream& os) const
+{
+  os << "-----TrkrClusterContainerv5-----" << std::endl;
+  os << "Number of clusters: " << size() << std::endl;
+  for (unsigned int i = 0; i < NDETECTORS; ++i)
+  {
+    os << TrkrDefs::TrkrNames.at(static_cast<TrkrDefs::TrkrId>(i))
+       << " max error position: " << m_PositionMaxError[i]
+       << " error: " << m_ErrorMaxError[i]
+       << " dictionary entries rphi: " << m_RPhiErrorDict[i].size()
+       << " z: " << m_ZErrorDict[i].size() << std::endl;
+  }
+  os << "------------------------------" << std::endl;
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::setMaxError(TrkrDefs::TrkrId trackerid, float position, float error)
+{
+  m_PositionMaxError[trackerid] = position;
+  m_ErrorMaxError[trackerid] = error;
+  m_Retrain[trackerid] = true;
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::resetDictionaries()
+{
+  m_Retrain.fill(true);
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::train()
+{
+  for (unsigned int det = 0; det < NDETECTORS; ++det)
+  {
+    if (!m_Retrain[det])
+    {
+      continue;
+    }
+    std::vector<float> rphi_errors;
+    std::vector<float> z_errors;
+    for (const auto& hitsetkey : m_clusters.getHitSetKeys(static_cast<TrkrDefs::TrkrId>(det)))
+    {
+      const auto range = m_clusters.getClusters(hitsetkey);
+      for (auto iter = range.first; iter != range.second; ++iter)
+      {
+        rphi_errors.push_back(iter->second->getRPhiError());
+        z_errors.push_back(iter->second->getZError());
+      }
+    }
+
+    // keep on trying with the next event if there is nothing to train on
+    if (rphi_errors.empty())
+    {
+      continue;
+    }
+    m_RPhiErrorDict[det].train(rphi_errors, m_ErrorMaxError[det]);
+    m_ZErrorDict[det].train(z_errors, m_ErrorMaxError[det]);
+    m_Retrain[det] = false;
+  }
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::pack()
+{
+  if (std::find(m_Retrain.begin(), m_Retrain.end(), true) != m_Retrain.end())
+  {
+    train();
+  }
+
+  m_DictEntries.clear();
+  m_DictSize.clear();
+  for (unsigned int det = 0; det < NDETECTORS; ++det)
+  {
+    for (const auto* dict : {&m_RPhiErrorDict[det], &m_ZErrorDict[det]})
+    {
+      m_DictEntries.insert(m_DictEntries.end(), dict->entries().begin(), dict->entries().end());
+      m_DictSize.push_back(dict->size());
+    }
+  }
+
+  m_HitSetKeys.clear();
+  m_NClusters.clear();
+  m_IndexGap.clear();
+  m_LocalX.clear();
+  m_LocalY.clear();
+  m_RPhiErrorCode.clear();
+  m_ZErrorCode.clear();
+  m_SubSurfKey.clear();
+  m_Adc.clear();
+  m_MaxAdc.clear();
+  m_PhiSize.clear();
+  m_ZSize.clear();
+  m_Overlap.clear();
+  m_Edge.clear();
+  m_EscapedErrors.clear();
+
+  std::array<unsigned int, NDETECTORS> nclusters{};
+  std::array<unsigned int, NDETECTORS> nescaped{};
+  for (const auto& hitsetkey : m_clusters.getHitSetKeys())
+  {
+    // unknown detectors use the settings of the last one
+    const unsigned int det = std::min<unsigned int>(TrkrDefs::getTrkrId(hitsetkey), NDETECTORS - 1);
+    const auto range = m_clusters.getClusters(hitsetkey);
+    if (range.first == range.second)
+    {
+      continue;
+    }
+
+    uint32_t count = 0;
+    int64_t previous = -1;
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+      const TrkrCluster* cluster = iter->second;
+      const int64_t index = TrkrDefs::getClusIndex(iter->first);
+      m_IndexGap.push_back(index - previous - 1);
+      previous = index;
+
+      m_LocalX.push_back(quantize(cluster->getLocalX(), m_PositionMaxError[det]));
+      m_LocalY.push_back(quantize(cluster->getLocalY(), m_PositionMaxError[det]));
+
+      const float rphi_error = cluster->getRPhiError();
+      const uint16_t rphi_code = m_RPhiErrorDict[det].encode(rphi_error);
+      m_RPhiErrorCode.push_back(rphi_code);
+      const float z_error = cluster->getZError();
+      const uint16_t z_code = m_ZErrorDict[det].encode(z_error);
+      m_ZErrorCode.push_back(z_code);
+      if (rphi_code == FloatDictionary::escape)
+      {
+        m_EscapedErrors.push_back(rphi_error);
+      }
+      if (z_code == FloatDictionary::escape)
+      {
+        m_EscapedErrors.push_back(z_error);
+      }
+      if (rphi_code == FloatDictionary::escape || z_code == FloatDictionary::escape)
+      {
+        ++nescaped[det];
+      }
+
+      m_SubSurfKey.push_back(cluster->getSubSurfKey());
+      m_Adc.push_back(static_cast<uint16_t>(cluster->getAdc()));
+      m_MaxAdc.push_back(static_cast<uint16_t>(cluster->getMaxAdc()));
+      m_PhiSize.push_back(static_cast<char>(cluster->getPhiSize()));
+      m_ZSize.push_back(static_cast<char>(cluster->getZSize()));
+      m_Overlap.push_back(cluster->getOverlap());
+      m_Edge.push_back(cluster->getEdge());
+      ++count;
+    }
+    m_HitSetKeys.push_back(hitsetkey);
+    m_NClusters.push_back(count);
+    nclusters[det] += count;
+  }
+
+  // the dictionaries no longer describe the data, train new ones with the next event
+  for (unsigned int det = 0; det < NDETECTORS; ++det)
+  {
+    if (nescaped[det] > m_RetrainFraction * nclusters[det])
+    {
+      m_Retrain[det] = true;
+    }
+  }
+}
+
+//_________________________________________________________________
+void TrkrClusterContainerv5::unpack()
+{
+  m_clusters.Reset();
+
+  // dictionary offsets in m_DictEntries, rphi and z per detector
+  std::vector<size_t> offsets(m_DictSize.size() + 1, 0);
+  for (size_t i = 0; i < m_DictSize.size(); ++i)
+  {
+    offsets[i + 1] = offsets[i] + m_DictSize[i];
+  }
+
+  size_t icluster = 0;
+  size_t iescaped = 0;
+  auto decode = [&](uint16_t code, size_t dict)
+  {
+    if (code == FloatDictionary::escape)
+    {
+      return m_EscapedErrors[iescaped++];
+    }
+    return m_DictEntries[offsets[dict] + code];
+  };
+
+  for (size_t ihitset = 0; ihitset < m_HitSetKeys.size(); ++ihitset)
+  {
+    const auto hitsetkey = m_HitSetKeys[ihitset];
+    const unsigned int det = std::min<unsigned int>(TrkrDefs::getTrkrId(hitsetkey), NDETECTORS - 1);
+    int64_t previous = -1;
+    for (uint32_t i = 0; i < m_NClusters[ihitset]; ++i, ++icluster)
+    {
+      const int64_t index = previous + 1 + m_IndexGap[icluster];
+      previous = index;
+
+      auto* cluster = new TrkrClusterv5;
+      cluster->setLocalX(dequantize(m_LocalX[icluster], m_PositionMaxError[det]));
+      cluster->setLocalY(dequantize(m_LocalY[icluster], m_PositionMaxError[det]));
+      cluster->setPhiError(decode(m_RPhiErrorCode[icluster], 2 * det));
+      cluster->setZError(decode(m_ZErrorCode[icluster], 2 * det + 1));
+      cluster->setSubSurfKey(m_SubSurfKey[icluster]);
+      cluster->setAdc(m_Adc[icluster]);
+      cluster->setMaxAdc(m_MaxAdc[icluster]);
+      cluster->setPhiSize(m_PhiSize[icluster]);
+      cluster->setZSize(m_ZSize[icluster]);
+      cluster->setOverlap(m_Overlap[icluster]);
+      cluster->setEdge(m_Edge[icluster]);
+      m_clusters.addClusterSpecifyKey(TrkrDefs::genClusKey(hitsetkey, index), cluster);
+    }
+  }
+}
+
+//_________________________________________________________________
+/*
+ * the columns are filled from the clusters right before writing and the
+ * clusters are created from the columns right after reading, otherwise this
+ * is the standard streamer (schema evolution keeps working)
+ */
+void TrkrClusterContainerv5::Streamer(TBuffer& R__b)
+{
+  if (R__b.IsReading())
+  {
+    R__b.ReadClassBuffer(TrkrClusterContainerv5::Class(), this);
+    unpack();
+  }
+  else
+  {
+    pack();
+    R__b.WriteClassBuffer(TrkrClusterContainerv5::Class(), this);
+  }
+}
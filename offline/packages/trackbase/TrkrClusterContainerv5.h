@@ -0,0 +1,137 @@
+#ifndef TRACKBASE_TRKRCLUSTERCONTAINERV5_H
+#define TRACKBASE_TRKRCLUSTERCONTAINERV5_H
+
+/**
+ * @file trackbase/TrkrClusterContainerv5.h
+ * @brief Cluster container with lossy compressed output
+ */
+
+#include "TrkrClusterContainer.h"
+#include "TrkrClusterContainerv4.h"
+
+#include "FloatDictionary.h"
+
+#include <phool/PHObject.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class TBuffer;
+class TrkrCluster;
+
+/**
+ * @brief Cluster container with lossy compressed output
+ *
+ * In memory the clusters are held in a TrkrClusterContainerv4. On output
+ * they are written as columns instead of TrkrCluster objects:
+ * - local positions are quantized on a grid with a per detector maximum error
+ * - rphi and z errors are encoded as 16 bit codes of per detector
+ *   FloatDictionary's, trained on the first event of each run (the
+ *   clusterizers call resetDictionaries() from InitRun) and kept for the
+ *   rest of the run. Errors which cannot be
+ *   encoded within the maximum error are written as floats, the dictionaries
+ *   are retrained if this happens for too many clusters.
+ * The clusters are read back as TrkrClusterv5
+ */
+class TrkrClusterContainerv5 : public TrkrClusterContainer
+{
+ public:
+  TrkrClusterContainerv5() = default;
+
+  void Reset() override;
+
+  void identify(std::ostream& os = std::cout) const override;
+
+  void addClusterSpecifyKey(const TrkrDefs::cluskey key, TrkrCluster* newclus) override
+  {
+    m_clusters.addClusterSpecifyKey(key, newclus);
+  }
+
+  void removeCluster(TrkrDefs::cluskey key) override { m_clusters.removeCluster(key); }
+
+  ConstRange getClusters() const override { return m_clusters.getClusters(); }  // deprecated
+
+  ConstRange getClusters(TrkrDefs::hitsetkey hitsetkey) override { return m_clusters.getClusters(hitsetkey); }
+
+  TrkrCluster* findCluster(TrkrDefs::cluskey key) const override { return m_clusters.findCluster(key); }
+
+  HitSetKeyList getHitSetKeys() const override { return m_clusters.getHitSetKeys(); }
+
+  HitSetKeyList getHitSetKeys(const TrkrDefs::TrkrId trackerid) const override { return m_clusters.getHitSetKeys(trackerid); }
+
+  HitSetKeyList getHitSetKeys(const TrkrDefs::TrkrId trackerid, const uint8_t layer) const override { return m_clusters.getHitSetKeys(trackerid, layer); }
+
+  unsigned int size() const override { return m_clusters.size(); }
+
+  //! maximum absolute error [cm] on the local positions and on the cluster errors of a given detector
+  void setMaxError(TrkrDefs::TrkrId trackerid, float position, float error);
+
+  //! fraction of clusters with errors outside of the dictionaries which triggers retraining
+  void setRetrainFraction(float value) { m_RetrainFraction = value; }
+
+  //! retrain the dictionaries with the next event written, called at each run boundary
+  void resetDictionaries();
+
+ private:
+  static constexpr unsigned int NDETECTORS = TrkrDefs::micromegasId + 1;
+
+  //! fill the persistent columns from the clusters
+  void pack();
+
+  //! create the clusters from the persistent columns
+  void unpack();
+
+  //! train the dictionaries of the detectors which need it on the current clusters
+  void train();
+
+  //!@name compression parameters, per detector
+  //@{
+  float m_PositionMaxError[NDETECTORS] = {5e-5, 5e-5, 5e-4, 5e-4};
+  float m_ErrorMaxError[NDETECTORS] = {5e-5, 5e-5, 5e-4, 5e-4};
+  //@}
+
+  //!@name error dictionaries, rphi and z per detector, concatenated
+  //@{
+  std::vector<float> m_DictEntries;
+  std::vector<uint32_t> m_DictSize;
+  //@}
+
+  //!@name one entry per hitset
+  //@{
+  std::vector<TrkrDefs::hitsetkey> m_HitSetKeys;
+  std::vector<uint32_t> m_NClusters;
+  //@}
+
+  //!@name one entry per cluster
+  //@{
+  std::vector<uint32_t> m_IndexGap;  //< cluster index - previous cluster index - 1
+  std::vector<int32_t> m_LocalX;
+  std::vector<int32_t> m_LocalY;
+  std::vector<uint16_t> m_RPhiErrorCode;
+  std::vector<uint16_t> m_ZErrorCode;
+  std::vector<TrkrDefs::subsurfkey> m_SubSurfKey;
+  std::vector<uint16_t> m_Adc;
+  std::vector<uint16_t> m_MaxAdc;
+  std::vector<char> m_PhiSize;
+  std::vector<char> m_ZSize;
+  std::vector<char> m_Overlap;
+  std::vector<char> m_Edge;
+  //@}
+
+  //! errors which could not be encoded, in cluster order
+  std::vector<float> m_EscapedErrors;
+
+  //! the clusters
+  TrkrClusterContainerv4 m_clusters;  //!
+
+  //! dictionaries used for writing
+  std::array<FloatDictionary, NDETECTORS> m_RPhiErrorDict;  //!
+  std::array<FloatDictionary, NDETECTORS> m_ZErrorDict;     //!
+  std::array<bool, NDETECTORS> m_Retrain{true, true, true, true};  //!
+  float m_RetrainFraction{0.01};  //!
+
+  ClassDefOverride(TrkrClusterContainerv5, 1)
+};
+
+#endif  // TRACKBASE_TRKRCLUSTERCONTAINERV5_H
@@ -0,0 +1,6 @@
+#ifdef __CINT__
+
+// custom streamer, writes the clusters as compressed columns
+#pragma link C++ class TrkrClusterContainerv5 - ;
+
+#endif /* __CINT__ */
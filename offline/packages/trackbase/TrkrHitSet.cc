@@ -17,6 +17,14 @@ TrkrHitSet::addHitSpecificKey(const TrkrDefs::hitkey /*unused*/, TrkrHit* /*unus
   return dummy_map.cbegin();
 }
 
+void TrkrHitSet::addHitsSpecificKey(const HitList& hits)
+{
+  for (const auto& [key, hit] : hits)
+  {
+    addHitSpecificKey(key, hit);
+  }
+}
+
 TrkrHitSet::ConstRange
 TrkrHitSet::getHits() const
 {
@@ -14,6 +14,7 @@
 #include <iostream>
 #include <map>
 #include <utility>  // for pair
+#include <vector>
 
 //! forward declaration
 class TrkrHit;
@@ -33,6 +34,7 @@ class TrkrHitSet : public PHObject
   using Map = std::map<TrkrDefs::hitkey, TrkrHit*>;
   using ConstIterator = Map::const_iterator;
   using ConstRange = std::pair<ConstIterator, ConstIterator>;
+  using HitList = std::vector<std::pair<TrkrDefs::hitkey, TrkrHit*>>;
 
   //! TObject functions
   void identify(std::ostream& /*os*/ = std::cout) const override
@@ -70,6 +72,15 @@ class TrkrHitSet : public PHObject
    */
   virtual ConstIterator addHitSpecificKey(const TrkrDefs::hitkey, TrkrHit*);
 
+  /**
+   * @brief Add several hits at once
+   * @param[in] hits pairs of hit key and hit, best sorted by key and without duplicates
+   *
+   * Same ownership and duplicate key handling as addHitSpecificKey.
+   * Sorted input is appended in a single pass.
+   */
+  virtual void addHitsSpecificKey(const HitList&);
+
   /**
    * @brief Remove a hit using its key
    * @param[in] key to be removed
@@ -73,6 +73,21 @@ TrkrHitSetv1::addHitSpecificKey(const TrkrDefs::hitkey key, TrkrHit* hit)
   }
 }
 
+void TrkrHitSetv1::addHitsSpecificKey(const HitList& hits)
+{
+  for (const auto& [key, hit] : hits)
+  {
+    // constant time insertion when the keys are sorted and above the existing ones
+    const auto size = m_hits.size();
+    m_hits.emplace_hint(m_hits.end(), key, hit);
+    if (m_hits.size() == size)
+    {
+      std::cout << "TrkrHitSetv1::AddHitsSpecificKey: duplicate key: " << key << " exiting now" << std::endl;
+      exit(1);
+    }
+  }
+}
+
 TrkrHit*
 TrkrHitSetv1::getHit(const TrkrDefs::hitkey key) const
 {
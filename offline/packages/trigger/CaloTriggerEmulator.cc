@@ -37,13 +37,37 @@
 #include <TNtuple.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 
+namespace
+{
+  // samples [0, wave.size()) of a packet channel
+  template <class PacketType>
+  void read_waveform(PacketType *packet, int channel, std::vector<int> &wave)
+  {
+    for (size_t i = 0; i < wave.size(); i++)
+    {
+      wave[i] = packet->iValue(i, channel);
+    }
+  }
+
+  void read_waveform(TowerInfo *tower, std::vector<int> &wave)
+  {
+    for (size_t i = 0; i < wave.size(); i++)
+    {
+      wave[i] = tower->get_waveform_value(i);
+    }
+  }
+}  // namespace
+
 // constructor
 CaloTriggerEmulator::CaloTriggerEmulator(const std::string &name)
   : SubsysReco(name)
@@ -528,6 +552,9 @@ int CaloTriggerEmulator::Download_Calibrations()
       }
     }
   }
+
+  BuildLookupTables();
+
   return 0;
 }
 // process event procedure
@@ -580,22 +607,12 @@ int CaloTriggerEmulator::process_event(PHCompositeNode *topNode)
 // RESET event procedure that takes all variables to 0 and clears the primitives.
 int CaloTriggerEmulator::ResetEvent(PHCompositeNode * /*topNode*/)
 {
-  // here, the peak minus pedestal map is cleanly disposed of
-  m_peak_sub_ped_emcal.clear();
-  m_peak_sub_ped_hcalin.clear();
-  m_peak_sub_ped_hcalout.clear();
-
+  // the peak minus pedestal arrays are reset when the waveforms are processed
   return 0;
 }
 int CaloTriggerEmulator::process_offline()
 {
-  int sample_start = 1;
-  int sample_end = m_nsamples;
-  if (m_trig_sample > 0)
-  {
-    sample_start = m_trig_sample;
-    sample_end = m_trig_sample + 1;
-  }
+  ResetPeakSubPed();
 
   if (m_do_emcal)
   {
@@ -627,68 +644,20 @@ int CaloTriggerEmulator::process_offline()
             unsigned int adcboard = (unsigned int) channel / 64;
             if ((adc_skip_mask >> adcboard) & 0x1U)
             {
-              for (int iskip = 0; iskip < 64; iskip++)
-              {
-                std::vector<unsigned int> v_peak_sub_ped;
-                for (int i = sample_start; i < sample_end; i++)
-                {
-                  v_peak_sub_ped.push_back(0);
-                }
-                unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-                m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
-                iwave++;
-              }
+              // channels of skipped boards stay at 0
+              iwave += 64;
             }
           }
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          if (!packet->iValue(channel, "SUPPRESSED"))
           {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              v_peak_sub_ped.push_back(0);
-            }
+            read_waveform(packet, channel, m_wave);
+            StorePeakSubPed(m_peak_sub_ped_emcal, iwave);
           }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
-            }
-          }
-          unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-          m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
           iwave++;
         }
         if (nchannels < 192 && !(adc_skip_mask < 4))
         {
-          for (int iskip = 0; iskip < 192 - nchannels; iskip++)
-          {
-            std::vector<unsigned int> v_peak_sub_ped;
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              v_peak_sub_ped.push_back(0);
-            }
-            unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-            m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
-            iwave++;
-          }
+          iwave += 192 - nchannels;
         }
       }
     }
@@ -715,40 +684,11 @@ int CaloTriggerEmulator::process_offline()
 
         for (int channel = 0; channel < nchannels; channel++)
         {
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          if (!packet->iValue(channel, "SUPPRESSED"))
           {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              v_peak_sub_ped.push_back(0);
-            }
-          }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
-            }
+            read_waveform(packet, channel, m_wave);
+            StorePeakSubPed(m_peak_sub_ped_hcalout, iwave);
           }
-          unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-          m_peak_sub_ped_hcalout[key] = v_peak_sub_ped;
           iwave++;
         }
       }
@@ -774,40 +714,11 @@ int CaloTriggerEmulator::process_offline()
 
         for (int channel = 0; channel < nchannels; channel++)
         {
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          if (!packet->iValue(channel, "SUPPRESSED"))
           {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              v_peak_sub_ped.push_back(0);
-            }
-          }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
-            }
+            read_waveform(packet, channel, m_wave);
+            StorePeakSubPed(m_peak_sub_ped_hcalin, iwave);
           }
-          unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-          m_peak_sub_ped_hcalin[key] = v_peak_sub_ped;
           iwave++;
         }
       }
@@ -844,13 +755,7 @@ int CaloTriggerEmulator::process_waveforms()
     std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing waveforms" << std::endl;
   }
 
-  int sample_start = 1;
-  int sample_end = m_nsamples;
-  if (m_trig_sample > 0)
-  {
-    sample_start = m_trig_sample;
-    sample_end = m_trig_sample + 1;
-  }
+  ResetPeakSubPed();
 
   if (m_do_emcal)
   {
@@ -876,54 +781,16 @@ int CaloTriggerEmulator::process_waveforms()
             unsigned int adcboard = (unsigned int) channel / 64;
             if ((adc_skip_mask >> adcboard) & 0x1U)
             {
-              for (int iskip = 0; iskip < 64; iskip++)
-              {
-                std::vector<unsigned int> v_peak_sub_ped;
-                for (int i = sample_start; i < sample_end; i++)
-                {
-                  v_peak_sub_ped.push_back(0);
-                }
-                unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-                m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
-                iwave++;
-              }
+              // channels of skipped boards stay at 0
+              iwave += 64;
               continue;
             }
           }
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          if (!packet->iValue(channel, "SUPPRESSED"))
           {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              v_peak_sub_ped.push_back(0);
-            }
+            read_waveform(packet, channel, m_wave);
+            StorePeakSubPed(m_peak_sub_ped_emcal, iwave);
           }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
-            }
-          }
-          unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-          m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
           iwave++;
         }
       }
@@ -947,40 +814,11 @@ int CaloTriggerEmulator::process_waveforms()
 
         for (int channel = 0; channel < nchannels; channel++)
         {
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          if (!packet->iValue(channel, "SUPPRESSED"))
           {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              v_peak_sub_ped.push_back(0);
-            }
+            read_waveform(packet, channel, m_wave);
+            StorePeakSubPed(m_peak_sub_ped_hcalout, iwave);
           }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
-            }
-          }
-          unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-          m_peak_sub_ped_hcalout[key] = v_peak_sub_ped;
           iwave++;
         }
       }
@@ -1004,40 +842,11 @@ int CaloTriggerEmulator::process_waveforms()
 
         for (int channel = 0; channel < nchannels; channel++)
         {
-          std::vector<unsigned int> v_peak_sub_ped;
-          if (packet->iValue(channel, "SUPPRESSED"))
+          if (!packet->iValue(channel, "SUPPRESSED"))
           {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              v_peak_sub_ped.push_back(0);
-            }
+            read_waveform(packet, channel, m_wave);
+            StorePeakSubPed(m_peak_sub_ped_hcalin, iwave);
           }
-          else
-          {
-            for (int i = sample_start; i < sample_end; i++)
-            {
-              int16_t maxim = (packet->iValue(i, channel) > packet->iValue(i + 1, channel) ? packet->iValue(i, channel) : packet->iValue(i + 1, channel));
-              maxim = (maxim > packet->iValue(i + 2, channel) ? maxim : packet->iValue(i + 2, channel));
-              uint16_t sam = 0;
-              if (i >= m_trig_sub_delay)
-              {
-                sam = i - m_trig_sub_delay;
-              }
-              else
-              {
-                sam = 0;
-              }
-              unsigned int sub = 0;
-              if (maxim > packet->iValue(sam, channel))
-              {
-                sub = (((uint16_t) (maxim - packet->iValue(sam, channel))) & 0x3fffU);
-              }
-
-              v_peak_sub_ped.push_back(sub);
-            }
-          }
-          unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-          m_peak_sub_ped_hcalin[key] = v_peak_sub_ped;
           iwave++;
         }
       }
@@ -1048,6 +857,7 @@ int CaloTriggerEmulator::process_waveforms()
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+// process event procedure
 int CaloTriggerEmulator::process_sim()
 {
   // Get range of waveforms
@@ -1056,13 +866,7 @@ int CaloTriggerEmulator::process_sim()
     std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing waveforms" << std::endl;
   }
 
-  int sample_start = 1;
-  int sample_end = m_nsamples;
-  if (m_trig_sample > 0)
-  {
-    sample_start = m_trig_sample;
-    sample_end = m_trig_sample + 1;
-  }
+  ResetPeakSubPed();
 
   if (m_do_emcal)
   {
@@ -1077,42 +881,12 @@ int CaloTriggerEmulator::process_sim()
     // for each waveform, clauclate the peak - pedestal given the sub-delay setting
     for (unsigned int iwave = 0; iwave < (unsigned int) m_waveforms_emcal->size(); iwave++)
     {
-      std::vector<unsigned int> v_peak_sub_ped;
       TowerInfo *tower = m_waveforms_emcal->get_tower_at_channel(iwave);
-      unsigned int key = TowerInfoDefs::encode_emcal(iwave);
-      if (tower->get_isZS())
-      {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          v_peak_sub_ped.push_back(0);
-        }
-      }
-      else
+      if (!tower->get_isZS())
       {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          int16_t maxim = (tower->get_waveform_value(i) > tower->get_waveform_value(i + 1) ? tower->get_waveform_value(i) : tower->get_waveform_value(i + 1));
-          maxim = (maxim > tower->get_waveform_value(i + 2) ? maxim : tower->get_waveform_value(i + 2));
-          uint16_t sam = 0;
-          if (i >= m_trig_sub_delay)
-          {
-            sam = i - m_trig_sub_delay;
-          }
-          else
-          {
-            sam = 0;
-          }
-          unsigned int sub = 0;
-          if (maxim > tower->get_waveform_value(sam))
-          {
-            sub = (((uint16_t) (maxim - tower->get_waveform_value(sam))) & 0x3fffU);
-          }
-
-          v_peak_sub_ped.push_back(sub);
-        }
+        read_waveform(tower, m_wave);
+        StorePeakSubPed(m_peak_sub_ped_emcal, iwave);
       }
-      // save in global.
-      m_peak_sub_ped_emcal[key] = v_peak_sub_ped;
     }
   }
   if (m_do_hcalout)
@@ -1122,7 +896,6 @@ int CaloTriggerEmulator::process_sim()
       std::cout << __FILE__ << "::" << __FUNCTION__ << ":: ohcal" << std::endl;
     }
 
-    std::vector<int> wave;
     // for each waveform, clauclate the peak - pedestal given the sub-delay setting
     if (!m_waveforms_hcalout->size())
     {
@@ -1131,42 +904,12 @@ int CaloTriggerEmulator::process_sim()
 
     for (unsigned int iwave = 0; iwave < (unsigned int) m_waveforms_hcalout->size(); iwave++)
     {
-      std::vector<unsigned int> v_peak_sub_ped;
       TowerInfo *tower = m_waveforms_hcalout->get_tower_at_channel(iwave);
-      unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-      if (tower->get_isZS())
+      if (!tower->get_isZS())
       {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          v_peak_sub_ped.push_back(0);
-        }
+        read_waveform(tower, m_wave);
+        StorePeakSubPed(m_peak_sub_ped_hcalout, iwave);
       }
-      else
-      {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          int16_t maxim = (tower->get_waveform_value(i) > tower->get_waveform_value(i + 1) ? tower->get_waveform_value(i) : tower->get_waveform_value(i + 1));
-          maxim = (maxim > tower->get_waveform_value(i + 2) ? maxim : tower->get_waveform_value(i + 2));
-          uint16_t sam = 0;
-          if (i >= m_trig_sub_delay)
-          {
-            sam = i - m_trig_sub_delay;
-          }
-          else
-          {
-            sam = 0;
-          }
-          unsigned int sub = 0;
-          if (maxim > tower->get_waveform_value(sam))
-          {
-            sub = (((uint16_t) (maxim - tower->get_waveform_value(sam))) & 0x3fffU);
-          }
-
-          v_peak_sub_ped.push_back(sub);
-        }
-      }
-      // save in global.
-      m_peak_sub_ped_hcalout[key] = v_peak_sub_ped;
     }
   }
   if (m_do_hcalin)
@@ -1179,75 +922,89 @@ int CaloTriggerEmulator::process_sim()
     {
       return Fun4AllReturnCodes::EVENT_OK;
     }
-    if (Verbosity())
-    {
-      std::cout << __FILE__ << "::" << __FUNCTION__ << ":: ihcal" << std::endl;
-    }
-
-    std::vector<unsigned int> wave;
 
     // for each waveform, clauclate the peak - pedestal given the sub-delay setting
     for (unsigned int iwave = 0; iwave < (unsigned int) m_waveforms_hcalin->size(); iwave++)
     {
-      std::vector<unsigned int> v_peak_sub_ped;
       TowerInfo *tower = m_waveforms_hcalin->get_tower_at_channel(iwave);
-      unsigned int key = TowerInfoDefs::encode_hcal(iwave);
-      if (tower->get_isZS())
+      if (!tower->get_isZS())
       {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          v_peak_sub_ped.push_back(0);
-        }
-      }
-      else
-      {
-        for (int i = sample_start; i < sample_end; i++)
-        {
-          int16_t maxim = (tower->get_waveform_value(i) > tower->get_waveform_value(i + 1) ? tower->get_waveform_value(i) : tower->get_waveform_value(i + 1));
-          maxim = (maxim > tower->get_waveform_value(i + 2) ? maxim : tower->get_waveform_value(i + 2));
-          uint16_t sam = 0;
-          if (i >= m_trig_sub_delay)
-          {
-            sam = i - m_trig_sub_delay;
-          }
-          else
-          {
-            sam = 0;
-          }
-          unsigned int sub = 0;
-          if (maxim > tower->get_waveform_value(sam))
-          {
-            sub = (((uint16_t) (maxim - tower->get_waveform_value(sam))) & 0x3fffU);
-          }
-
-          v_peak_sub_ped.push_back(sub);
-        }
+        read_waveform(tower, m_wave);
+        StorePeakSubPed(m_peak_sub_ped_hcalin, iwave);
       }
-      // save in global.
-      m_peak_sub_ped_hcalin[key] = v_peak_sub_ped;
     }
   }
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+void CaloTriggerEmulator::ResetPeakSubPed()
+{
+  m_sample_start = 1;
+  m_sample_end = m_nsamples;
+  if (m_trig_sample > 0)
+  {
+    m_sample_start = m_trig_sample;
+    m_sample_end = m_trig_sample + 1;
+  }
+  m_n_peak_samples = std::max(m_sample_end - m_sample_start, 0);
+
+  // the peak uses the two samples after the last one, the pedestal m_trig_sub_delay samples before
+  m_wave.assign(std::max(m_sample_end + 2, m_sample_end - m_trig_sub_delay), 0);
+
+  m_peak_sub_ped_emcal.assign(m_do_emcal ? m_n_channels_emcal * m_n_peak_samples : 0, 0);
+  m_peak_sub_ped_hcalin.assign(m_do_hcalin ? m_n_channels_hcal * m_n_peak_samples : 0, 0);
+  m_peak_sub_ped_hcalout.assign(m_do_hcalout ? m_n_channels_hcal * m_n_peak_samples : 0, 0);
+}
+
+void CaloTriggerEmulator::StorePeakSubPed(std::vector<unsigned int> &peak_sub_ped, unsigned int iwave)
+{
+  const size_t offset = static_cast<size_t>(iwave) * m_n_peak_samples;
+  if (offset >= peak_sub_ped.size())
+  {
+    return;
+  }
+
+  unsigned int *output = &peak_sub_ped[offset];
+  for (int i = m_sample_start; i < m_sample_end; i++)
+  {
+    int16_t maxim = (m_wave[i] > m_wave[i + 1] ? m_wave[i] : m_wave[i + 1]);
+    maxim = (maxim > m_wave[i + 2] ? maxim : m_wave[i + 2]);
+    uint16_t sam = 0;
+    if (i >= m_trig_sub_delay)
+    {
+      sam = i - m_trig_sub_delay;
+    }
+    else
+    {
+      sam = 0;
+    }
+    unsigned int sub = 0;
+    if (maxim > m_wave[sam])
+    {
+      sub = (((uint16_t) (maxim - m_wave[sam])) & 0x3fffU);
+    }
+
+    *output++ = sub;
+  }
+}
+
 // procedure to process the peak - pedestal into primitives.
 int CaloTriggerEmulator::process_primitives()
 {
   int ip;
   int i;
   bool mask;
-  int nsample = m_nsamples - 1;
-  if (m_trig_sample > 0)
-  {
-    nsample = 1;
-  }
 
   if (Verbosity())
   {
     std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing primitives" << std::endl;
   }
 
+  // the output sums and their masks are collected first, the LUT stage and
+  // the 2x2 sums then run over the flat arrays, in parallel if requested
+  std::vector<std::function<void()>> tasks;
+
   if (m_do_emcal)
   {
     if (Verbosity())
@@ -1259,18 +1016,17 @@ int CaloTriggerEmulator::process_primitives()
 
     // get the number of primitives needed to process
     m_n_primitives = m_prim_map[TriggerDefs::DetectorId::emcalDId];
+    m_sums_emcal.clear();
     for (i = 0; i < m_n_primitives; i++, ip++)
     {
       if (Verbosity())
       {
         std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing primitives:: adding " << i << std::endl;
       }
-      unsigned int tmp = 0;
       // get the primitive key of what we are making, in order of the packet ID and channel number
       TriggerDefs::TriggerPrimKey primkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("EMCAL"), ip);
 
       TriggerPrimitive *primitive = m_primitives_emcal->get_primitive_at_key(primkey);
-      unsigned int sum = 0;
       // check if masked Fiber;
       mask = CheckFiberMasks(primkey);
 
@@ -1285,46 +1041,19 @@ int CaloTriggerEmulator::process_primitives()
         t_sum->clear();
 
         // check to mask channel (if fiber masked, automatically mask the channel)
-        bool mask_channel = mask || CheckChannelMasks(sumkey);
-        for (int is = 0; is < nsample; is++)
-        {
-          sum = 0;
-          unsigned int temp_sum = 0;
-
-          // if masked, just fill with 0s
-          if (!mask_channel)
-          {
-            for (int j = 0; j < 4; j++)
-            {
-              // unsigned int iwave = 64*ip + isum*4 + j;
-              unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::GetDetectorId("EMCAL"), ip, isum, j);
-              unsigned int lut_input = (m_peak_sub_ped_emcal[key].at(is) >> 4U) & 0x3ffU;
-              if (m_default_lut_emcal)
-              {
-                tmp = (m_l1_adc_table[lut_input] >> 2U);
-              }
-              else
-              {
-                unsigned int lut_output = ((unsigned int) h_emcal_lut[key]->GetBinContent(lut_input + 1)) & 0x3ffU;
-                tmp = (lut_output >> 2U);
-              }
-              temp_sum += (tmp & 0xffU);
-            }
-            sum = ((temp_sum & 0x3ffU) >> 2U) & 0xffU;
-            if (Verbosity() >= 10 && sum >= 1)
-            {
-              std::cout << __FILE__ << "::" << __FUNCTION__ << ":: emcal sum " << sumkey << " = " << sum << std::endl;
-            }
-          }
-          if (Verbosity())
-          {
-            std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing primitives:: adding" << std::endl;
-          }
-
-          t_sum->push_back(sum);
-        }
+        m_sums_emcal.push_back({t_sum, sumkey, mask || CheckChannelMasks(sumkey)});
       }
     }
+
+    // the emcal dominates, it is split in blocks of primitives
+    const size_t nblocks = std::max(m_nthreads, 1U);
+    const size_t block_size = ((m_sums_emcal.size() / m_n_sums + nblocks - 1) / nblocks) * m_n_sums;
+    for (size_t begin = 0; begin < m_sums_emcal.size(); begin += block_size)
+    {
+      const size_t end = std::min(begin + block_size, m_sums_emcal.size());
+      tasks.emplace_back([this, begin, end]()
+                         { MakeSums(m_sums_emcal, begin, end, m_sum_channels_emcal, m_peak_sub_ped_emcal, m_lut_emcal, "emcal"); });
+    }
   }
   if (m_do_hcalout)
   {
@@ -1336,50 +1065,22 @@ int CaloTriggerEmulator::process_primitives()
     ip = 0;
 
     m_n_primitives = m_prim_map[TriggerDefs::DetectorId::hcaloutDId];
-
+    m_sums_hcalout.clear();
     for (i = 0; i < m_n_primitives; i++, ip++)
     {
       TriggerDefs::TriggerPrimKey primkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("HCALOUT"), TriggerDefs::GetPrimitiveId("HCALOUT"), ip);
       TriggerPrimitive *primitive = m_primitives_hcalout->get_primitive_at_key(primkey);
-      unsigned int sum;
       mask = CheckFiberMasks(primkey);
       for (int isum = 0; isum < m_n_sums; isum++)
       {
         TriggerDefs::TriggerSumKey sumkey = TriggerDefs::getTriggerSumKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("HCALOUT"), TriggerDefs::GetPrimitiveId("HCALOUT"), ip, isum);
         std::vector<unsigned int> *t_sum = primitive->get_sum_at_key(sumkey);
         mask |= CheckChannelMasks(sumkey);
-        for (int is = 0; is < nsample; is++)
-        {
-          sum = 0;
-          unsigned int temp_sum = 0;
-          if (!mask)
-          {
-            for (int j = 0; j < 4; j++)
-            {
-              unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::GetDetectorId("HCAL"), ip, isum, j);
-              unsigned int lut_input = (m_peak_sub_ped_hcalout[key].at(is) >> 4U) & 0x3ffU;
-              unsigned int tmp = 0;
-              if (m_default_lut_hcalout)
-              {
-                tmp = (m_l1_adc_table[lut_input] >> 2U);
-              }
-              else
-              {
-                unsigned int lut_output = ((unsigned int) h_hcalout_lut[key]->GetBinContent(lut_input + 1)) & 0x3ffU;
-                tmp = (lut_output >> 2U);
-              }
-              temp_sum += (tmp & 0xffU);
-            }
-            sum = ((temp_sum & 0x3ffU) >> 2U) & 0xffU;
-            if (Verbosity() >= 10 && sum >= 1)
-            {
-              std::cout << __FILE__ << "::" << __FUNCTION__ << ":: hcalout sum " << sumkey << " = " << sum << std::endl;
-            }
-          }
-          t_sum->push_back(sum);
-        }
+        m_sums_hcalout.push_back({t_sum, sumkey, mask});
       }
     }
+    tasks.emplace_back([this]()
+                       { MakeSums(m_sums_hcalout, 0, m_sums_hcalout.size(), m_sum_channels_hcal, m_peak_sub_ped_hcalout, m_lut_hcalout, "hcalout"); });
   }
   if (m_do_hcalin)
   {
@@ -1391,378 +1092,387 @@ int CaloTriggerEmulator::process_primitives()
     }
 
     m_n_primitives = m_prim_map[TriggerDefs::DetectorId::hcalinDId];
-
+    m_sums_hcalin.clear();
     for (i = 0; i < m_n_primitives; i++, ip++)
     {
       TriggerDefs::TriggerPrimKey primkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("HCALIN"), TriggerDefs::GetPrimitiveId("HCALIN"), ip);
       TriggerPrimitive *primitive = m_primitives_hcalin->get_primitive_at_key(primkey);
-      unsigned int sum;
       mask = CheckFiberMasks(primkey);
       for (int isum = 0; isum < m_n_sums; isum++)
       {
         TriggerDefs::TriggerSumKey sumkey = TriggerDefs::getTriggerSumKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("HCALIN"), TriggerDefs::GetPrimitiveId("HCALIN"), ip, isum);
         std::vector<unsigned int> *t_sum = primitive->get_sum_at_key(sumkey);
         mask |= CheckChannelMasks(sumkey);
-        for (int is = 0; is < nsample; is++)
-        {
-          sum = 0;
-          unsigned int temp_sum = 0;
-          if (!mask)
-          {
-            for (int j = 0; j < 4; j++)
-            {
-              unsigned int key = TriggerDefs::GetTowerInfoKey(TriggerDefs::GetDetectorId("HCAL"), ip, isum, j);
-              unsigned int lut_input = (m_peak_sub_ped_hcalin[key].at(is) >> 4U) & 0x3ffU;
-              unsigned int tmp = 0;
-              if (m_default_lut_hcalin)
-              {
-                tmp = (m_l1_adc_table[lut_input] >> 2U);
-              }
-              else
-              {
-                unsigned int lut_output = ((unsigned int) h_hcalin_lut[key]->GetBinContent(lut_input + 1)) & 0x3ffU;
-                tmp = (lut_output >> 2U);
-              }
-              temp_sum += (tmp & 0x3ffU);
-            }
-            sum = ((temp_sum & 0xfffU) >> 2U) & 0xffU;
-            if (Verbosity() >= 10 && sum >= 1)
-            {
-              std::cout << __FILE__ << "::" << __FUNCTION__ << ":: hcalin sum " << sumkey << " = " << sum << std::endl;
-            }
-          }
-          t_sum->push_back(sum);
-        }
+        m_sums_hcalin.push_back({t_sum, sumkey, mask});
       }
     }
+    tasks.emplace_back([this]()
+                       { MakeSums(m_sums_hcalin, 0, m_sums_hcalin.size(), m_sum_channels_hcal, m_peak_sub_ped_hcalin, m_lut_hcalin, "hcalin"); });
   }
 
-  return Fun4AllReturnCodes::EVENT_OK;
-}
-
-// Unless this is the MBD or HCAL Cosmics trigger, EMCAL and HCAL will go through here.
-// This creates the 8x8 non-overlapping sum and the 4x4 overlapping sum.
-
-int CaloTriggerEmulator::process_organizer()
-{
-  TriggerPrimitiveContainer::Range range;
-  if (Verbosity())
-  {
-    std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing organizer" << std::endl;
-  }
-
-  int nsample = m_nsamples - 1;
-  // bits are to say whether the trigger has fired. this is what is sent to the GL1
-  if (m_trig_sample > 0)
+  if (m_nthreads <= 1 || tasks.size() <= 1)
   {
-    nsample = 1;
+    for (auto &task : tasks)
+    {
+      task();
+    }
   }
-  // 8x8 non-overlapping sums in the EMCAL
-  // create the 8x8 non-overlapping sum
+  else
   {
-    if (Verbosity() >= 2)
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> threads;
+    for (size_t ithread = 0; ithread < std::min<size_t>(m_nthreads, tasks.size()); ithread++)
     {
-      std::cout << __FUNCTION__ << " " << __LINE__ << " processing 8x8 non-overlapping sums" << std::endl;
+      threads.emplace_back([&tasks, &next]()
+                         {
+                           for (size_t itask = next++; itask < tasks.size(); itask = next++)
+                           {
+                             tasks[itask]();
+                           }
+                         });
     }
-
-    m_triggerid = TriggerDefs::TriggerId::jetTId;
-
-    if (!m_primitives_emcal)
+    for (auto &thread : threads)
     {
-      std::cout << "There is no primitive container" << std::endl;
-      return Fun4AllReturnCodes::EVENT_OK;
+      thread.join();
     }
+  }
 
-    range = m_primitives_emcal_ll1->getTriggerPrimitives();
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+  return Fun4AllReturnCodes::EVENT_OK;
+}
+
+// LUT stage and 2x2 sums for the trigger sums [begin, end) of one detector.
+// Sum k is made of the towers m_sum_channels_*[4k, 4k+4).
+void CaloTriggerEmulator::MakeSums(const std::vector<TriggerSum> &sums, size_t begin, size_t end,
+                                   const std::vector<unsigned int> &channels,
+                                   const std::vector<unsigned int> &peak_sub_ped,
+                                   const std::vector<uint8_t> &lut, const std::string &name) const
+{
+  // the default LUT is shared by all channels
+  const size_t lut_stride = (lut.size() > 1024) ? 1024 : 0;
+  for (size_t k = begin; k < end; k++)
+  {
+    const TriggerSum &trigger_sum = sums[k];
+    const unsigned int *towers = &channels[4 * k];
+    for (int is = 0; is < m_n_peak_samples; is++)
     {
-      TriggerPrimitivev1::Range sumrange = iter->second->getSums();
-      for (TriggerPrimitivev1::Iter siter = sumrange.first; siter != sumrange.second; ++siter)
+      unsigned int sum = 0;
+      unsigned int temp_sum = 0;
+
+      // if masked, just fill with 0s
+      if (!trigger_sum.masked)
       {
-        for (int is = 0; is < nsample; is++)
+        for (int j = 0; j < 4; j++)
+        {
+          unsigned int lut_input = (peak_sub_ped[towers[j] * m_n_peak_samples + is] >> 4U) & 0x3ffU;
+          temp_sum += lut[towers[j] * lut_stride + lut_input];
+        }
+        sum = ((temp_sum & 0x3ffU) >> 2U) & 0xffU;
+        if (Verbosity() >= 10 && sum >= 1)
         {
-          siter->second->push_back(0);
+          std::cout << __FILE__ << "::" << __FUNCTION__ << ":: " << name << " sum " << trigger_sum.sumkey << " = " << sum << std::endl;
         }
       }
+      trigger_sum.sum->push_back(sum);
     }
+  }
+}
 
-    if (Verbosity())
+// Flat versions of the LUTs and of the tower to trigger sum mapping.
+// The LUT tables hold the LUT output >> 2, which is what enters the 2x2 sums.
+void CaloTriggerEmulator::BuildLookupTables()
+{
+  auto fill_lut = [this](std::vector<uint8_t> &lut, bool use_default, const std::map<unsigned int, TH1 *> &histos, bool emcal)
+  {
+    const unsigned int nchannels = emcal ? m_n_channels_emcal : m_n_channels_hcal;
+    if (use_default)
     {
-      std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing getting emcal prims" << std::endl;
+      lut.resize(1024);
+      for (unsigned int lut_input = 0; lut_input < 1024; lut_input++)
+      {
+        lut[lut_input] = (m_l1_adc_table[lut_input] >> 2U);
+      }
+      return;
     }
-
-    // iterate through emcal primitives and organize into the 16 jet primitives each with the 8x8 nonoverlapping sum
-    range = m_primitives_emcal->getTriggerPrimitives();
-
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+    lut.resize(nchannels * 1024);
+    for (unsigned int ichannel = 0; ichannel < nchannels; ichannel++)
     {
-      // get key and see if masked
-      TriggerDefs::TriggerPrimKey key = (*iter).first;
-      if (CheckFiberMasks(key))
+      unsigned int key = emcal ? TowerInfoDefs::encode_emcal(ichannel) : TowerInfoDefs::encode_hcal(ichannel);
+      auto histo = histos.find(key);
+      if (histo == histos.end() || !histo->second)
       {
-        continue;
+        std::cout << PHWHERE << " no LUT histogram for " << (emcal ? "emcal" : "hcal") << " channel " << ichannel << " - Fatal Error" << std::endl;
+        exit(1);
       }
-
-      uint16_t sumphi = TriggerDefs::getPrimitivePhiId_from_TriggerPrimKey(key);
-      uint16_t sumeta = TriggerDefs::getPrimitiveEtaId_from_TriggerPrimKey(key);
-
-      // based on where the primitive is in the detector, the location of the jet primitive is determined, 0 through 15 in phi.
-      uint16_t iprim = sumphi / 2;
-      // eta determines the location of the sum within the jet primitive.
-      uint16_t isum = (sumeta + (sumphi % 2) * 12);
-
-      TriggerDefs::TriggerPrimKey jet_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim);
-
-      TriggerDefs::TriggerPrimKey jet_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim, isum);
-
-      // add to primitive previously made the sum of the 8x8 non-overlapping sum.
-      std::vector<unsigned int> *t_sum = m_primitives_emcal_ll1->get_primitive_at_key(jet_prim_key)->get_sum_at_key(jet_sum_key);
-
-      // get the primitive (16 2x2 sums)
-      TriggerPrimitive *primitive = (*iter).second;
-      TriggerPrimitivev1::Range sumrange = primitive->getSums();
-
-      // iterate through all 16 sums and add together
-      for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
+      for (unsigned int lut_input = 0; lut_input < 1024; lut_input++)
       {
-        if (CheckChannelMasks(iter_sum->first))
-        {
-          continue;
-        }
-        int i = 0;
-        for (unsigned int &it_s : *(*iter_sum).second)
-        {
-          t_sum->at(i) += (it_s & 0xffU);
-          i++;
-        }
-      }
-
-      // bit shift by 16 (divide by the 16 towers) to get an 8 bit energy sum.
-      for (unsigned int &it_s : *t_sum)
-      {
-        // unsigned int sumshift = ((it_s >> 0x2U) & 0x3ffU);
-        // unsigned int sum_lower = ( sumshift & 0x7fU );
-        // unsigned int sum_higher = ( ( sumshift >> 0x7U ) > 0 ? 0x1U : 0x0U );
-        // it_s = m_l1_8x8_table[sumshift];
-        if (it_s > 0xffU)
-        {
-          it_s = 0xffU;
-        }
+        unsigned int lut_output = ((unsigned int) histo->second->GetBinContent(lut_input + 1)) & 0x3ffU;
+        lut[ichannel * 1024 + lut_input] = (lut_output >> 2U);
       }
     }
-  }
+  };
+
+  // channel index of the 4 towers of each sum, in primitive and sum order
+  auto fill_channels = [this](std::vector<unsigned int> &channels, TriggerDefs::DetectorId detid)
   {
-    if (Verbosity())
+    const bool emcal = (detid == TriggerDefs::DetectorId::emcalDId);
+    const unsigned int nchannels = emcal ? m_n_channels_emcal : m_n_channels_hcal;
+    std::map<unsigned int, unsigned int> index;
+    for (unsigned int ichannel = 0; ichannel < nchannels; ichannel++)
     {
-      std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing HCAL" << std::endl;
+      index[emcal ? TowerInfoDefs::encode_emcal(ichannel) : TowerInfoDefs::encode_hcal(ichannel)] = ichannel;
     }
-
-    range = m_primitives_hcal_ll1->getTriggerPrimitives();
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+    channels.clear();
+    for (int ip = 0; ip < m_prim_map[detid]; ip++)
     {
-      TriggerPrimitivev1::Range sumrange = iter->second->getSums();
-      for (TriggerPrimitivev1::Iter siter = sumrange.first; siter != sumrange.second; ++siter)
+      for (int isum = 0; isum < m_n_sums; isum++)
       {
-        for (int is = 0; is < nsample; is++)
+        for (int j = 0; j < 4; j++)
         {
-          siter->second->push_back(0);
+          channels.push_back(index.at(TriggerDefs::GetTowerInfoKey(detid, ip, isum, j)));
         }
       }
     }
+  };
 
-    if (m_primitives_hcalin)
-    {
-      if (Verbosity())
-      {
-        std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing organizer" << std::endl;
-      }
+  if (m_do_emcal)
+  {
+    fill_lut(m_lut_emcal, m_default_lut_emcal, h_emcal_lut, true);
+    fill_channels(m_sum_channels_emcal, TriggerDefs::DetectorId::emcalDId);
+  }
+  if (m_do_hcalin)
+  {
+    fill_lut(m_lut_hcalin, m_default_lut_hcalin, h_hcalin_lut, false);
+  }
+  if (m_do_hcalout)
+  {
+    fill_lut(m_lut_hcalout, m_default_lut_hcalout, h_hcalout_lut, false);
+  }
+  if (m_do_hcalin || m_do_hcalout)
+  {
+    fill_channels(m_sum_channels_hcal, TriggerDefs::DetectorId::hcalDId);
+  }
 
-      // iterate through emcal primitives and organize into the 16 jet primitives each with the 8x8 nonoverlapping sum
-      range = m_primitives_hcalin->getTriggerPrimitives();
+  // the 8x8 and jet patch tables depend on the masks, they are rebuilt with the next event
+  m_organizer_emcal = SumTable();
+  m_organizer_hcal = SumTable();
+}
 
-      // for hcalin: there are
-      for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+// Zero filled output sums of a LL1 primitive container, in container order.
+void CaloTriggerEmulator::ResolveOrganizerSums(TriggerPrimitiveContainer *primitives, int nsample, std::vector<TriggerSum> &sums)
+{
+  sums.clear();
+  TriggerPrimitiveContainer::Range range = primitives->getTriggerPrimitives();
+  for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+  {
+    TriggerPrimitivev1::Range sumrange = iter->second->getSums();
+    for (TriggerPrimitivev1::Iter siter = sumrange.first; siter != sumrange.second; ++siter)
+    {
+      for (int is = 0; is < nsample; is++)
       {
-        // get key and see if masked
-        TriggerDefs::TriggerPrimKey key = (*iter).first;
-        if (CheckFiberMasks(key))
-        {
-          continue;
-        }
-
-        // get the primitive (16 2x2 sums)
-        TriggerPrimitive *primitive = (*iter).second;
-        TriggerPrimitivev1::Range sumrange = primitive->getSums();
-
-        for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
-        {
-          TriggerDefs::TriggerSumKey sumkey = (*iter_sum).first;
-          uint16_t sumphi = TriggerDefs::getPrimitivePhiId_from_TriggerSumKey(sumkey) * 4 + TriggerDefs::getSumPhiId(sumkey);
-          uint16_t sumeta = TriggerDefs::getPrimitiveEtaId_from_TriggerSumKey(sumkey) * 4 + TriggerDefs::getSumEtaId(sumkey);
-
-          int i = 0;
-          if (CheckChannelMasks(sumkey))
-          {
-            continue;
-          }
-          // based on where the primitive is in the detector, the location of the jet primitive is determined, 0 through 15 in phi.
-          uint16_t iprim = sumphi / 2;
-          // eta determines the location of the sum within the jet primitive.
-          uint16_t isum = (sumeta + (sumphi % 2) * 12);
+        siter->second->push_back(0);
+      }
+      sums.push_back({siter->second, siter->first, false});
+    }
+  }
+}
 
-          TriggerDefs::TriggerPrimKey jet_prim_key = TriggerDefs::getTriggerPrimKey(m_triggerid, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim);
+// Which 2x2 sums add up into which 8x8 sum, and which 8x8 sums make each jet
+// patch sum. Built from the sum keys of the first event of a run, masked 2x2
+// sums are left out.
+void CaloTriggerEmulator::BuildOrganizerTables()
+{
+  auto index_sums = [](const std::vector<TriggerSum> &sums)
+  {
+    std::map<TriggerDefs::TriggerSumKey, unsigned int> index;
+    for (unsigned int k = 0; k < sums.size(); k++)
+    {
+      index[sums[k].sumkey] = k;
+    }
+    return index;
+  };
 
-          TriggerDefs::TriggerPrimKey jet_sum_key = TriggerDefs::getTriggerSumKey(m_triggerid, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim, isum);
+  // sources of each output sum, stored as consecutive ranges
+  auto flatten = [](const std::vector<std::vector<unsigned int>> &sources, SumTable &table)
+  {
+    table.offset.assign(1, 0);
+    table.source.clear();
+    for (const auto &list : sources)
+    {
+      table.source.insert(table.source.end(), list.begin(), list.end());
+      table.offset.push_back(table.source.size());
+    }
+  };
 
-          // add to primitive previously made the sum of the 8x8 non-overlapping sum.
-          std::vector<unsigned int> *t_sum = m_primitives_hcal_ll1->get_primitive_at_key(jet_prim_key)->get_sum_at_key(jet_sum_key);
+  // location of a 2x2 sum in the 8x8 sums, from its phi and eta in units of 2x2 sums
+  auto jet_sum_key = [](TriggerDefs::DetectorId detid, uint16_t sumphi, uint16_t sumeta)
+  {
+    // based on where the primitive is in the detector, the location of the jet primitive is determined, 0 through 15 in phi.
+    uint16_t iprim = sumphi / 2;
+    // eta determines the location of the sum within the jet primitive.
+    uint16_t isum = sumeta + (sumphi % 2) * 12;
+    return TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::jetTId, detid, TriggerDefs::GetPrimitiveId("JET"), iprim, isum);
+  };
 
-          for (unsigned int &it_s : *(*iter_sum).second)
-          {
-            t_sum->at(i) += (it_s & 0xffU);
-            i++;
-          }
-        }
+  {
+    // each emcal primitive (16 2x2 sums) makes one 8x8 sum
+    const std::map<TriggerDefs::TriggerSumKey, unsigned int> index = index_sums(m_ll1_sums_emcal);
+    std::vector<std::vector<unsigned int>> sources(m_ll1_sums_emcal.size());
+    for (unsigned int k = 0; k < m_sums_emcal.size(); k++)
+    {
+      TriggerDefs::TriggerPrimKey primkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::GetTriggerId("NONE"), TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("EMCAL"), k / m_n_sums);
+      if (CheckFiberMasks(primkey) || CheckChannelMasks(m_sums_emcal[k].sumkey))
+      {
+        continue;
       }
+      uint16_t sumphi = TriggerDefs::getPrimitivePhiId_from_TriggerPrimKey(primkey);
+      uint16_t sumeta = TriggerDefs::getPrimitiveEtaId_from_TriggerPrimKey(primkey);
+      sources[index.at(jet_sum_key(TriggerDefs::GetDetectorId("EMCAL"), sumphi, sumeta))].push_back(k);
     }
+    flatten(sources, m_organizer_emcal);
+  }
 
-    if (m_primitives_hcalout)
+  {
+    // every hcalin and hcalout 2x2 sum adds to one 8x8 sum, the hcalout sums are indexed after the hcalin ones
+    const std::map<TriggerDefs::TriggerSumKey, unsigned int> index = index_sums(m_ll1_sums_hcal);
+    std::vector<std::vector<unsigned int>> sources(m_ll1_sums_hcal.size());
+    unsigned int offset = 0;
+    for (auto [primitives, sums] : {std::make_pair(m_primitives_hcalin, &m_sums_hcalin), std::make_pair(m_primitives_hcalout, &m_sums_hcalout)})
     {
-      if (Verbosity())
+      if (!primitives)
       {
-        std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing organizer" << std::endl;
+        continue;
       }
-
-      // iterate through emcal primitives and organize into the 16 jet primitives each with the 8x8 nonoverlapping sum
-      range = m_primitives_hcalout->getTriggerPrimitives();
-
-      // for hcalin: there are
-      for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+      for (unsigned int k = 0; k < sums->size(); k++)
       {
-        // get key and see if masked
-        TriggerDefs::TriggerPrimKey key = (*iter).first;
-        if (CheckFiberMasks(key))
+        TriggerDefs::TriggerSumKey sumkey = (*sums)[k].sumkey;
+        TriggerDefs::TriggerPrimKey primkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::getTriggerId_from_TriggerSumKey(sumkey), TriggerDefs::getDetectorId_from_TriggerSumKey(sumkey), TriggerDefs::getPrimitiveId_from_TriggerSumKey(sumkey), TriggerDefs::getPrimitiveLocId_from_TriggerSumKey(sumkey));
+        if (CheckFiberMasks(primkey) || CheckChannelMasks(sumkey))
         {
           continue;
         }
+        uint16_t sumphi = TriggerDefs::getPrimitivePhiId_from_TriggerSumKey(sumkey) * 4 + TriggerDefs::getSumPhiId(sumkey);
+        uint16_t sumeta = TriggerDefs::getPrimitiveEtaId_from_TriggerSumKey(sumkey) * 4 + TriggerDefs::getSumEtaId(sumkey);
+        sources[index.at(jet_sum_key(TriggerDefs::GetDetectorId("HCAL"), sumphi, sumeta))].push_back(offset + k);
+      }
+      offset += sums->size();
+    }
+    flatten(sources, m_organizer_hcal);
+  }
 
-        // get the primitive (16 2x2 sums)
-        TriggerPrimitive *primitive = (*iter).second;
-        TriggerPrimitivev1::Range sumrange = primitive->getSums();
+  {
+    // each jet patch sum adds the emcal and hcal 8x8 sums at the same location
+    const std::map<TriggerDefs::TriggerSumKey, unsigned int> index_emcal = index_sums(m_ll1_sums_emcal);
+    const std::map<TriggerDefs::TriggerSumKey, unsigned int> index_hcal = index_sums(m_ll1_sums_hcal);
+    m_organizer_jet_emcal.clear();
+    m_organizer_jet_hcal.clear();
+    for (const TriggerSum &jet_sum : m_ll1_sums_jet)
+    {
+      uint16_t iprim = TriggerDefs::getPrimitiveLocId_from_TriggerSumKey(jet_sum.sumkey);
+      uint16_t isum = TriggerDefs::getSumLocId(jet_sum.sumkey);
+      m_organizer_jet_hcal.push_back(index_hcal.at(TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim, isum)));
+      m_organizer_jet_emcal.push_back(index_emcal.at(TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim, isum)));
+    }
+  }
+}
 
-        for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
-        {
-          TriggerDefs::TriggerSumKey sumkey = (*iter_sum).first;
-          uint16_t sumphi = TriggerDefs::getPrimitivePhiId_from_TriggerSumKey(sumkey) * 4 + TriggerDefs::getSumPhiId(sumkey);
-          //		      uint16_t sumeta = TriggerDefs::getPrimitiveEtaId_from_TriggerSumKey(sumkey)*4 + TriggerDefs::getSumEtaId(sumkey);
-          uint16_t sumeta = TriggerDefs::getPrimitiveEtaId_from_TriggerSumKey(sumkey) * 4 + TriggerDefs::getSumEtaId(sumkey);
+// Unless this is the MBD or HCAL Cosmics trigger, EMCAL and HCAL will go through here.
+// This creates the 8x8 non-overlapping sum and the 4x4 overlapping sum.
+// The 2x2 sums are added up through the tables of BuildOrganizerTables, the
+// output sums are resolved once per event in container order.
+int CaloTriggerEmulator::process_organizer()
+{
+  if (Verbosity())
+  {
+    std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing organizer" << std::endl;
+  }
 
-          int i = 0;
+  int nsample = m_nsamples - 1;
+  // bits are to say whether the trigger has fired. this is what is sent to the GL1
+  if (m_trig_sample > 0)
+  {
+    nsample = 1;
+  }
 
-          if (CheckChannelMasks(sumkey))
-          {
-            continue;
-          }
-          // based on where the primitive is in the detector, the location of the jet primitive is determined, 0 through 15 in phi.
-          uint16_t iprim = sumphi / 2;
-          // eta determines the location of the sum within the jet primitive.
-          uint16_t isum = sumeta + (sumphi % 2) * 12;
-          TriggerDefs::TriggerPrimKey jet_prim_key = TriggerDefs::getTriggerPrimKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim);
-
-          TriggerDefs::TriggerPrimKey jet_sum_key = TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), iprim, isum);
-          if (Verbosity())
-          {
-            std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
-          }
+  m_triggerid = TriggerDefs::TriggerId::jetTId;
 
-          std::vector<unsigned int> *t_sum = m_primitives_hcal_ll1->get_primitive_at_key(jet_prim_key)->get_sum_at_key(jet_sum_key);
-          for (unsigned int &it_s : *(*iter_sum).second)
-          {
-            t_sum->at(i) += ((it_s) &0xffU);
-            i++;
-          }
-        }
-      }
-    }
+  if (!m_primitives_emcal)
+  {
+    std::cout << "There is no primitive container" << std::endl;
+    return Fun4AllReturnCodes::EVENT_OK;
+  }
 
-    // iterate through emcal primitives and organize into the 16 jet primitives each with the 8x8 nonoverlapping sum
-    if (Verbosity())
+  ResolveOrganizerSums(m_primitives_emcal_ll1, nsample, m_ll1_sums_emcal);
+  ResolveOrganizerSums(m_primitives_hcal_ll1, nsample, m_ll1_sums_hcal);
+  ResolveOrganizerSums(m_primitives_jet, nsample, m_ll1_sums_jet);
+  if (m_organizer_emcal.offset.empty())
+  {
+    BuildOrganizerTables();
+  }
+
+  // 8x8 non-overlapping sums in the EMCAL
+  if (Verbosity() >= 2)
+  {
+    std::cout << __FUNCTION__ << " " << __LINE__ << " processing 8x8 non-overlapping sums" << std::endl;
+  }
+  for (size_t k = 0; k < m_ll1_sums_emcal.size(); k++)
+  {
+    std::vector<unsigned int> &t_sum = *m_ll1_sums_emcal[k].sum;
+    for (unsigned int isource = m_organizer_emcal.offset[k]; isource < m_organizer_emcal.offset[k + 1]; isource++)
     {
-      std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
+      const std::vector<unsigned int> &source = *m_sums_emcal[m_organizer_emcal.source[isource]].sum;
+      for (size_t i = 0; i < source.size(); i++)
+      {
+        t_sum.at(i) += (source[i] & 0xffU);
+      }
     }
-    range = m_primitives_hcal_ll1->getTriggerPrimitives();
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+    // the 16 sums of a single primitive make this sum, it is capped at 8 bits
+    for (unsigned int &it_s : t_sum)
     {
-      TriggerPrimitive *primitive = (*iter).second;
-      TriggerPrimitivev1::Range sumrange = primitive->getSums();
-
-      for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
+      if (it_s > 0xffU)
       {
-        for (unsigned int &it_s : *(*iter_sum).second)
-        {
-          it_s = (it_s >> 1U) & 0xffU;
-        }
+        it_s = 0xffU;
       }
     }
+  }
 
+  // 8x8 non-overlapping sums of hcalin + hcalout
+  if (Verbosity())
+  {
+    std::cout << __FILE__ << "::" << __FUNCTION__ << ":: Processing HCAL" << std::endl;
+  }
+  const size_t n_hcalin = m_primitives_hcalin ? m_sums_hcalin.size() : 0;
+  for (size_t k = 0; k < m_ll1_sums_hcal.size(); k++)
+  {
+    std::vector<unsigned int> &t_sum = *m_ll1_sums_hcal[k].sum;
+    for (unsigned int isource = m_organizer_hcal.offset[k]; isource < m_organizer_hcal.offset[k + 1]; isource++)
     {
-      range = m_primitives_jet->getTriggerPrimitives();
-      for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
+      const unsigned int index = m_organizer_hcal.source[isource];
+      const std::vector<unsigned int> &source = (index < n_hcalin) ? *m_sums_hcalin[index].sum : *m_sums_hcalout[index - n_hcalin].sum;
+      for (size_t i = 0; i < source.size(); i++)
       {
-        TriggerPrimitivev1::Range sumrange = iter->second->getSums();
-        for (TriggerPrimitivev1::Iter siter = sumrange.first; siter != sumrange.second; ++siter)
-        {
-          for (int is = 0; is < nsample; is++)
-          {
-            siter->second->push_back(0);
-          }
-        }
+        t_sum.at(i) += (source[i] & 0xffU);
       }
     }
-    if (Verbosity())
+    for (unsigned int &it_s : t_sum)
     {
-      std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
+      it_s = (it_s >> 1U) & 0xffU;
     }
-    // get jet primitives (after EMCAL and HCAL sum)
-    range = m_primitives_jet->getTriggerPrimitives();
-    for (TriggerPrimitiveContainerv1::Iter iter = range.first; iter != range.second; ++iter)
-    {
-      if (Verbosity())
-      {
-        std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
-      }
-
-      TriggerDefs::TriggerPrimKey jet_pkey = (*iter).first;
-      TriggerDefs::TriggerPrimKey hcal_pkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), TriggerDefs::getPrimitiveLocId_from_TriggerPrimKey(jet_pkey));
-      TriggerDefs::TriggerPrimKey emcal_pkey = TriggerDefs::getTriggerPrimKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("JET"), TriggerDefs::getPrimitiveLocId_from_TriggerPrimKey(jet_pkey));
-      TriggerPrimitive *primitive = (*iter).second;
-      TriggerPrimitivev1::Range sumrange = primitive->getSums();
-      for (TriggerPrimitivev1::Iter iter_sum = sumrange.first; iter_sum != sumrange.second; ++iter_sum)
-      {
-        if (Verbosity())
-        {
-          std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
-        }
-
-        TriggerDefs::TriggerSumKey jet_skey = (*iter_sum).first;
-
-        TriggerDefs::TriggerSumKey hcal_skey = TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("HCAL"), TriggerDefs::GetPrimitiveId("JET"), TriggerDefs::getPrimitiveLocId_from_TriggerPrimKey(jet_pkey), TriggerDefs::getSumLocId(jet_skey));
-        TriggerDefs::TriggerSumKey emcal_skey = TriggerDefs::getTriggerSumKey(TriggerDefs::TriggerId::jetTId, TriggerDefs::GetDetectorId("EMCAL"), TriggerDefs::GetPrimitiveId("JET"), TriggerDefs::getPrimitiveLocId_from_TriggerPrimKey(jet_pkey), TriggerDefs::getSumLocId(jet_skey));
-
-        int i = 0;
-        if (Verbosity())
-        {
-          std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
-        }
+  }
 
-        for (unsigned int &it_s : *(iter_sum->second))
-        {
-          unsigned int sum_hcal = m_primitives_hcal_ll1->get_primitive_at_key(hcal_pkey)->get_sum_at_key(hcal_skey)->at(i);
-          unsigned int sum_emcal = m_primitives_emcal_ll1->get_primitive_at_key(emcal_pkey)->get_sum_at_key(emcal_skey)->at(i);
-          it_s = ((sum_hcal >> 1U) + (sum_emcal >> 1U)) & 0xffU;
-          i++;
-        }
-      }
+  // jet patch sums (after EMCAL and HCAL sum)
+  if (Verbosity())
+  {
+    std::cout << __FILE__ << "::" << __FUNCTION__ << "::" << __LINE__ << ":: Processing organizer" << std::endl;
+  }
+  for (size_t k = 0; k < m_ll1_sums_jet.size(); k++)
+  {
+    const std::vector<unsigned int> &sum_hcal = *m_ll1_sums_hcal[m_organizer_jet_hcal[k]].sum;
+    const std::vector<unsigned int> &sum_emcal = *m_ll1_sums_emcal[m_organizer_jet_emcal[k]].sum;
+    int i = 0;
+    for (unsigned int &it_s : *m_ll1_sums_jet[k].sum)
+    {
+      it_s = ((sum_hcal.at(i) >> 1U) + (sum_emcal.at(i) >> 1U)) & 0xffU;
+      i++;
     }
   }
 
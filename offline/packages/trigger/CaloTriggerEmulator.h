@@ -5,6 +5,7 @@
 
 #include <fun4all/SubsysReco.h>
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -82,6 +83,9 @@ class CaloTriggerEmulator : public SubsysReco
   void useHCALINDefaultLUT(bool def) { m_default_lut_hcalin = def; }
   void useHCALOUTDefaultLUT(bool def) { m_default_lut_hcalout = def; }
 
+  //! number of threads used for the LUT stage and the trigger sums
+  void setNThreads(unsigned int n) { m_nthreads = n; }
+
   void setTriggerSample(int s) { m_trig_sample = s; }
   void setTriggerDelay(int d) { m_trig_sub_delay = d + 1; }
 
@@ -126,6 +130,42 @@ class CaloTriggerEmulator : public SubsysReco
   void identify();
 
  private:
+  //! one trigger sum, the output vector of its primitive and whether it is masked
+  struct TriggerSum
+  {
+    std::vector<unsigned int> *sum{nullptr};
+    TriggerDefs::TriggerSumKey sumkey{0};
+    bool masked{false};
+  };
+
+  //! sizes the peak minus pedestal arrays for this event and zeroes them
+  void ResetPeakSubPed();
+
+  //! peak minus pedestal of the waveform in m_wave, saved for channel iwave
+  void StorePeakSubPed(std::vector<unsigned int> &peak_sub_ped, unsigned int iwave);
+
+  //! LUT stage and 2x2 sums for the trigger sums [begin, end)
+  void MakeSums(const std::vector<TriggerSum> &sums, size_t begin, size_t end,
+                const std::vector<unsigned int> &channels,
+                const std::vector<unsigned int> &peak_sub_ped,
+                const std::vector<uint8_t> &lut, const std::string &name) const;
+
+  //! source sums of each output sum, output sum k adds up the sources [offset[k], offset[k+1])
+  struct SumTable
+  {
+    std::vector<unsigned int> offset;
+    std::vector<unsigned int> source;
+  };
+
+  //! flat LUTs and tower to trigger sum maps
+  void BuildLookupTables();
+
+  //! zero filled output sums of a LL1 primitive container, in container order
+  void ResolveOrganizerSums(TriggerPrimitiveContainer *primitives, int nsample, std::vector<TriggerSum> &sums);
+
+  //! 2x2 to 8x8 and 8x8 to jet patch sum tables
+  void BuildOrganizerTables();
+
   std::string m_ll1_nodename;
   std::string m_prim_nodename;
   std::string m_waveform_nodename;
@@ -207,9 +247,46 @@ class CaloTriggerEmulator : public SubsysReco
   CDBHistos *cdbttree_hcalin{nullptr};
   CDBHistos *cdbttree_hcalout{nullptr};
 
-  std::map<unsigned int, std::vector<unsigned int> > m_peak_sub_ped_emcal{};
-  std::map<unsigned int, std::vector<unsigned int> > m_peak_sub_ped_hcalin{};
-  std::map<unsigned int, std::vector<unsigned int> > m_peak_sub_ped_hcalout{};
+  //! peak minus pedestal per channel index and sample
+  std::vector<unsigned int> m_peak_sub_ped_emcal{};
+  std::vector<unsigned int> m_peak_sub_ped_hcalin{};
+  std::vector<unsigned int> m_peak_sub_ped_hcalout{};
+
+  //! LUT output >> 2 per channel index and LUT input, a single table if the default LUT is used
+  std::vector<uint8_t> m_lut_emcal{};
+  std::vector<uint8_t> m_lut_hcalin{};
+  std::vector<uint8_t> m_lut_hcalout{};
+
+  //! channel index of the 4 towers of each trigger sum
+  std::vector<unsigned int> m_sum_channels_emcal{};
+  std::vector<unsigned int> m_sum_channels_hcal{};
+
+  std::vector<TriggerSum> m_sums_emcal{};
+  std::vector<TriggerSum> m_sums_hcalin{};
+  std::vector<TriggerSum> m_sums_hcalout{};
+
+  //! 8x8 and jet patch sums of the current event
+  std::vector<TriggerSum> m_ll1_sums_emcal{};
+  std::vector<TriggerSum> m_ll1_sums_hcal{};
+  std::vector<TriggerSum> m_ll1_sums_jet{};
+
+  //! 2x2 sums making each 8x8 sum, the hcal sources index the hcalin sums then the hcalout sums
+  SumTable m_organizer_emcal{};
+  SumTable m_organizer_hcal{};
+
+  //! 8x8 sums making each jet patch sum
+  std::vector<unsigned int> m_organizer_jet_emcal{};
+  std::vector<unsigned int> m_organizer_jet_hcal{};
+
+  //! current waveform
+  std::vector<int> m_wave{};
+
+  unsigned int m_n_channels_emcal{24576};
+  unsigned int m_n_channels_hcal{1536};
+  int m_sample_start{1};
+  int m_sample_end{0};
+  int m_n_peak_samples{0};
+  unsigned int m_nthreads{1};
 
   //! Verbosity.
   int m_nevent;
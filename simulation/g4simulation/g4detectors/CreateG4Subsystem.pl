@@ -209,7 +209,6 @@ sub CreateSteppingActionImplementation()
 
     print F "#include <g4main/PHG4Hit.h>\n";
     print F "#include <g4main/PHG4HitContainer.h>\n";
-    print F "#include <g4main/PHG4Hitv1.h>\n";
     print F "#include <g4main/PHG4Shower.h>\n";
     print F "#include <g4main/PHG4SteppingAction.h>\n";
     print F "#include <g4main/PHG4TrackUserInfoV1.h>\n";
@@ -374,7 +373,7 @@ sub CreateSteppingActionImplementation()
     print F "  case fUndefined:\n";
     print F "    if (!m_Hit)\n";
     print F "    {\n";
-    print F "      m_Hit = new PHG4Hitv1();\n";
+    print F "      m_Hit = PHG4HitContainer::NewHit();\n";
     print F "    }\n";
     print F "    m_Hit->set_layer(detector_id);\n";
     print F "    // here we set the entrance values in cm\n";
@@ -7,7 +7,6 @@
 
 #include <g4main/PHG4Hit.h>
 #include <g4main/PHG4HitContainer.h>
-#include <g4main/PHG4Hitv1.h>
 #include <g4main/PHG4Shower.h>
 #include <g4main/PHG4SteppingAction.h>  // for PHG4SteppingAction
 #include <g4main/PHG4TrackUserInfoV1.h>
@@ -132,7 +131,7 @@ bool PHG4BlockSteppingAction::UserSteppingAction(const G4Step* aStep, bool /*was
       }
       if (!m_Hit)
       {
-        m_Hit = new PHG4Hitv1();
+        m_Hit = PHG4HitContainer::NewHit();
       }
       m_Hit->set_layer(layer_id);
       // here we set the entrance values in cm
@@ -3,7 +3,6 @@
 
 #include <g4main/PHG4Hit.h>
 #include <g4main/PHG4HitContainer.h>
-#include <g4main/PHG4Hitv1.h>
 #include <g4main/PHG4Shower.h>
 #include <g4main/PHG4SteppingAction.h>  // for PHG4SteppingAction
 #include <g4main/PHG4TrackUserInfoV1.h>
@@ -85,7 +84,7 @@ bool PHG4ConeSteppingAction::UserSteppingAction(const G4Step* aStep, bool /*was_
     case fUndefined:
       if (!hit)
       {
-        hit = new PHG4Hitv1();
+        hit = PHG4HitContainer::NewHit();
       }
       // here we set the entrance values in cm
       hit->set_x(0, prePoint->GetPosition().x() / cm);
@@ -8,7 +8,6 @@
 
 #include <g4main/PHG4Hit.h>
 #include <g4main/PHG4HitContainer.h>
-#include <g4main/PHG4Hitv1.h>
 #include <g4main/PHG4Shower.h>
 #include <g4main/PHG4SteppingAction.h>  // for PHG4SteppingAction
 
@@ -158,7 +157,7 @@ bool PHG4CylinderSteppingAction::UserSteppingAction(const G4Step* aStep, bool /*
 
       if (!m_Hit)
       {
-        m_Hit = new PHG4Hitv1();
+        m_Hit = PHG4HitContainer::NewHit();
       }
 
       m_Hit->set_layer((unsigned int) layer_id);
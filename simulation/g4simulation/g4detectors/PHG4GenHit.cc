@@ -4,7 +4,6 @@
 
 #include <g4main/PHG4Hit.h>
 #include <g4main/PHG4HitContainer.h>
-#include <g4main/PHG4Hitv1.h>
 
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <fun4all/SubsysReco.h>  // for SubsysReco
@@ -40,7 +39,7 @@ int PHG4GenHit::process_event(PHCompositeNode *topNode)
   PHG4CylinderGeom *mygeom = geo->GetLayerGeom(layer);
   double inner_radius = mygeom->get_radius();
   double outer_radius = inner_radius + mygeom->get_thickness();
-  PHG4Hit *hit = new PHG4Hitv1();
+  PHG4Hit *hit = PHG4HitContainer::NewHit();
   hit->set_layer((unsigned int) layer);
   double x0 = inner_radius * cos(phi * M_PI / 180.);
   double y0 = inner_radius * sin(phi * M_PI / 180.);
@@ -3,7 +3,6 @@
 
 #include <g4main/PHG4Hit.h>
 #include <g4main/PHG4HitContainer.h>
-#include <g4main/PHG4Hitv1.h>
 #include <g4main/PHG4Shower.h>
 #include <g4main/PHG4SteppingAction.h>  // for PHG4SteppingAction
 
@@ -89,7 +88,7 @@ bool PHG4HcalSteppingAction::UserSteppingAction(const G4Step* aStep, bool /*was_
 
       if (!m_Hit)
       {
-        m_Hit = new PHG4Hitv1();
+        m_Hit = PHG4HitContainer::NewHit();
       }
       m_Hit->set_layer((unsigned int) layer_id);
       m_Hit->set_scint_id(isactive);  // isactive contains the scintillator slat id
@@ -25,7 +25,6 @@
 
 #include <g4main/PHG4Hit.h>  // for PHG4Hit
 #include <g4main/PHG4HitContainer.h>
-#include <g4main/PHG4Hitv1.h>
 #include <g4main/PHG4Shower.h>
 #include <g4main/PHG4SteppingAction.h>  // for PHG4SteppingAction
 #include <g4main/PHG4TrackUserInfoV1.h>
@@ -424,7 +423,7 @@ bool PHG4SpacalSteppingAction::UserSteppingAction(const G4Step *aStep, bool /*wa
       // and we have to make a new one
       if (!m_Hit)
       {
-        m_Hit = new PHG4Hitv1();
+        m_Hit = PHG4HitContainer::NewHit();
       }
       m_Hit->set_layer((unsigned int) layer_id);
       m_Hit->set_scint_id(scint_id);  // isactive contains the scintillator slat id
@@ -7,7 +7,6 @@
 
 #include <g4main/PHG4Hit.h>
 #include <g4main/PHG4HitContainer.h>
-#include <g4main/PHG4Hitv1.h>
 #include <g4main/PHG4Shower.h>
 #include <g4main/PHG4SteppingAction.h>  // for PHG4SteppingAction
 #include <g4main/PHG4TrackUserInfoV1.h>
@@ -187,7 +186,7 @@ bool PHG4InttSteppingAction::UserSteppingAction(const G4Step* aStep, bool /*was_
     // and we have to make a new one
     if (!m_Hit)
     {
-      m_Hit = new PHG4Hitv1();
+      m_Hit = PHG4HitContainer::NewHit();
     }
 
     // set the index values needed to locate the sensor strip
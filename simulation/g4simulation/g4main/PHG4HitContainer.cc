@@ -8,9 +8,13 @@
 #include <TSystem.h>
 
 #include <cstdlib>
+#include <typeinfo>
 
 using namespace std;
 
+std::vector<PHG4Hit *> PHG4HitContainer::m_HitPool;
+size_t PHG4HitContainer::m_HitPoolAllocated = 0;
+
 PHG4HitContainer::PHG4HitContainer()
   : id(-1)
   , hitmap()
@@ -27,11 +31,11 @@ PHG4HitContainer::PHG4HitContainer(const std::string &nodename)
 
 void PHG4HitContainer::Reset()
 {
-  while (hitmap.begin() != hitmap.end())
+  for (auto &iter : hitmap)
   {
-    delete hitmap.begin()->second;
-    hitmap.erase(hitmap.begin());
+    RecycleHit(iter.second);
   }
+  hitmap.clear();
   return;
 }
 
@@ -155,7 +159,7 @@ PHG4HitContainer::Iterator PHG4HitContainer::findOrAddHit(PHG4HitDefs::keytype k
   PHG4HitContainer::Iterator it = hitmap.find(key);
   if (it == hitmap.end())
   {
-    hitmap[key] = new PHG4Hitv1();
+    hitmap[key] = NewHit();
     it = hitmap.find(key);
     PHG4Hit *mhit = it->second;
     mhit->set_hit_id(key);
@@ -186,7 +190,7 @@ void PHG4HitContainer::RemoveZeroEDep()
     PHG4Hit *hit = itr->second;
     if (hit->get_edep() == 0)
     {
-      delete hit;
+      RecycleHit(hit);
       hitmap.erase(itr++);
     }
     else
@@ -199,3 +203,45 @@ void PHG4HitContainer::RemoveZeroEDep()
   //        << ", hits after: " << hitsafter << endl;
   return;
 }
+
+PHG4Hit *PHG4HitContainer::NewHit()
+{
+  if (m_HitPool.empty())
+  {
+    m_HitPoolAllocated++;
+    return new PHG4Hitv1();
+  }
+  PHG4Hit *hit = m_HitPool.back();
+  m_HitPool.pop_back();
+  return hit;
+}
+
+PHG4Hit *PHG4HitContainer::NewHit(const PHG4Hit *source)
+{
+  PHG4Hit *hit = NewHit();
+  hit->CopyFrom(source);
+  return hit;
+}
+
+void PHG4HitContainer::RecycleHit(PHG4Hit *hit)
+{
+  // only plain PHG4Hitv1 can be handed out again, derived classes
+  // (PHG4HitEval) and hits beyond what the pool allocated are deleted
+  if (!hit || typeid(*hit) != typeid(PHG4Hitv1) || m_HitPool.size() >= m_HitPoolAllocated)
+  {
+    delete hit;
+    return;
+  }
+  hit->Reset();
+  m_HitPool.push_back(hit);
+}
+
+void PHG4HitContainer::ClearHitPool()
+{
+  for (auto *hit : m_HitPool)
+  {
+    delete hit;
+  }
+  m_HitPool.clear();
+  m_HitPoolAllocated = 0;
+}
@@ -12,6 +12,7 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 class PHG4Hit;
 
@@ -70,11 +71,32 @@ class PHG4HitContainer : public PHObject
   void RemoveZeroEDep();
   PHG4HitDefs::keytype getmaxkey(const unsigned int detid);
 
+  //! hand out a PHG4Hitv1 for the stepping actions, objects released by
+  //! Reset()/RemoveZeroEDep() are reused instead of going back to the heap
+  static PHG4Hit *NewHit();
+  //! same, filled with a copy of source
+  static PHG4Hit *NewHit(const PHG4Hit *source);
+  //! return a hit to the pool, hits which cannot be reused are deleted
+  static void RecycleHit(PHG4Hit *hit);
+  //! release all pooled hits (e.g. at the end of the job)
+  static void ClearHitPool();
+  static unsigned int HitPoolSize() { return m_HitPool.size(); }
+  static unsigned int HitPoolAllocated() { return m_HitPoolAllocated; }
+
  protected:
   int id;  //< unique identifier from hash of node name. Defined following PHG4HitDefs::get_volume_id
   Map hitmap;
   std::set<unsigned int> layers;  // layers is not reset since layers must not change event by event
 
+ private:
+  // the pool is shared by all hit containers since a stepping action does not know
+  // which container (active/absorber) a hit will end up in when it creates it.
+  // G4 runs single threaded in our setup so this does not need locking.
+  // The pool never holds more hits than NewHit() allocated, hits read back
+  // from a DST are deleted as before
+  static std::vector<PHG4Hit *> m_HitPool;
+  static size_t m_HitPoolAllocated;
+
   ClassDefOverride(PHG4HitContainer, 1)
 };
 
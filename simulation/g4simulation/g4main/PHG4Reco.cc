@@ -3,6 +3,7 @@
 #include "Fun4AllMessenger.h"
 #include "G4TBMagneticFieldSetup.hh"
 #include "PHG4DisplayAction.h"
+#include "PHG4HitContainer.h"
 #include "PHG4InEvent.h"
 #include "PHG4PhenixDetector.h"
 #include "PHG4PhenixDisplayAction.h"
@@ -32,6 +33,7 @@
 
 #include <ffamodules/CDBInterface.h>
 
+#include <fun4all/Fun4AllMemoryTracker.h>
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <fun4all/Fun4AllServer.h>
 #include <fun4all/SubsysReco.h>  // for SubsysReco
@@ -726,6 +728,18 @@ int PHG4Reco::ResetEvent(PHCompositeNode *topNode)
   return 0;
 }
 
+int PHG4Reco::End(PHCompositeNode * /*topNode*/)
+{
+  if (Verbosity() > 0)
+  {
+    std::cout << "PHG4Reco::End - " << PHG4HitContainer::HitPoolAllocated() << " PHG4Hits allocated by the hit pool, "
+              << PHG4HitContainer::HitPoolSize() << " free, RSS " << Fun4AllMemoryTracker::GetRSSMemory() / 1024 << " MB" << std::endl;
+  }
+  // the pool is static, without this it stays allocated until the process exits
+  PHG4HitContainer::ClearHitPool();
+  return 0;
+}
+
 void PHG4Reco::Print(const std::string &what) const
 {
   for (SubsysReco *reco : m_SubsystemList)
@@ -62,6 +62,9 @@ class PHG4Reco : public SubsysReco
   //! Clean up after each event.
   int ResetEvent(PHCompositeNode *) override;
 
+  //! end of job, releases the pooled hits
+  int End(PHCompositeNode *) override;
+
   //! print info
   void Print(const std::string &what = std::string()) const override;
 
@@ -13,7 +13,6 @@
 
 #include <g4main/PHG4Hit.h>
 #include <g4main/PHG4HitContainer.h>
-#include <g4main/PHG4Hitv1.h>
 #include <g4main/PHG4Shower.h>
 #include <g4main/PHG4SteppingAction.h>
 #include <g4main/PHG4TrackUserInfoV1.h>
@@ -126,7 +125,7 @@ bool PHG4MicromegasSteppingAction::UserSteppingAction(const G4Step *aStep, bool
   {
     if (!m_hit)
     {
-      m_hit.reset(new PHG4Hitv1());
+      m_hit.reset(PHG4HitContainer::NewHit());
     }
 
     if (whichactive > 0)
@@ -5,7 +5,6 @@
 #include <g4main/PHG4Hit.h>
 #include <g4main/PHG4HitContainer.h>
 #include <g4main/PHG4HitDefs.h>  // for get_volume_id
-#include <g4main/PHG4Hitv1.h>
 
 #include <fun4all/Fun4AllReturnCodes.h>
 #include <fun4all/SubsysReco.h>  // for SubsysReco
@@ -120,7 +119,7 @@ int PHG4TpcCentralMembrane::InitRun(PHCompositeNode* /* topNode */)
 
     // clone
     // assign to negative side and insert in list
-    auto copy = new PHG4Hitv1(source);
+    auto copy = PHG4HitContainer::NewHit(source);
     copy->set_z(0, -1.);
     copy->set_z(1, -1.);
     PHG4Hits.push_back(copy);
@@ -187,7 +186,7 @@ int PHG4TpcCentralMembrane::process_event(PHCompositeNode* topNode)
   // copy all hits from G4hits vector into container
   for (const auto& hit : PHG4Hits)
   {
-    auto copy = new PHG4Hitv1(hit);
+    auto copy = PHG4HitContainer::NewHit(hit);
     g4hitcontainer->AddHit(detId, copy);
   }
 
@@ -469,7 +468,7 @@ PHG4Hit* PHG4TpcCentralMembrane::GetPHG4HitFromStripe(int petalID, int moduleID,
   // radiusID ranges 0-7
 
   // from phg4tpcsteppingaction.cc
-  hit = new PHG4Hitv1();
+  hit = PHG4HitContainer::NewHit();
   hit->set_layer(-1);  // dummy number
   // here we set the entrance values in cm
   if (moduleID == 0)
@@ -702,6 +702,7 @@ int PHG4TpcElectronDrift::process_event(PHCompositeNode *topNode)
                               temp_hitsetcontainer.get(), hittruthassoc, x_final, y_final, t_final,
                               side, hiter, ntpad, nthit);
     }  // end loop over electrons for this g4hit
+    padplane->FlushPadPlane(truth_clusterer, single_hitsetcontainer.get(), temp_hitsetcontainer.get());
 
     if (do_ElectronDriftQAHistos)
     {
@@ -29,6 +29,7 @@
 #include <TFile.h>
 #include <TH2.h>
 #include <TF1.h>
+#include <TMath.h>
 #include <TSystem.h>
 
 #include <gsl/gsl_randist.h>
@@ -36,8 +37,10 @@
 
 #include <boost/format.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>  // for getenv
+#include <functional>
 #include <iostream>
 #include <map>      // for _Rb_tree_cons...
 #include <utility>  // for pair
@@ -67,8 +70,21 @@ namespace
     return std::exp(-square(x / sigma) / 2) / (sigma * std::sqrt(2 * M_PI));
   }
 
+  //! fraction of a gaussian charge cloud of width sigma, centered at x_loc from the pad center, collected by a zigzag pad
+  /*!
+  this corresponds to integrating the charge distribution Gaussian function (centered on rphi and of width cloud_sig_rp),
+  convoluted with a strip response function, which is triangular from -pitch to +pitch, with a maximum of 1. at stript center
+  */
+  inline double pad_overlap(const double x_loc, const double pitch, const double sigma)
+  {
+    return (pitch - x_loc) * (std::erf(x_loc / (M_SQRT2 * sigma)) - std::erf((x_loc - pitch) / (M_SQRT2 * sigma))) / (pitch * 2) + (pitch + x_loc) * (std::erf((x_loc + pitch) / (M_SQRT2 * sigma)) - std::erf(x_loc / (M_SQRT2 * sigma))) / (pitch * 2) + (gaus(x_loc - pitch, sigma) - gaus(x_loc, sigma)) * square(sigma) / pitch + (gaus(x_loc + pitch, sigma) - gaus(x_loc, sigma)) * square(sigma) / pitch;
+  }
+
   static constexpr unsigned int print_layer = 18;
 
+  // largest pad tile, in cells, before it is written out and restarted
+  static constexpr int max_tile_cells = 1 << 18;
+
 }  // namespace
 
 PHG4TpcPadPlaneReadout::PHG4TpcPadPlaneReadout(const std::string &name)
@@ -105,6 +121,8 @@ int PHG4TpcPadPlaneReadout::InitRun(PHCompositeNode *topNode)
   const std::string seggeonodename = "CYLINDERCELLGEOM_SVTX";
   GeomContainer = findNode::getClass<PHG4TpcCylinderGeomContainer>(topNode, seggeonodename);
   assert(GeomContainer);
+  buildPadCenterTables();
+  buildPadResponseTables();
   if(m_use_module_gain_weights)
     {
       int side, region, sector;
@@ -191,11 +209,206 @@ int PHG4TpcPadPlaneReadout::InitRun(PHCompositeNode *topNode)
 	}
     } 
 
-  
+  if (m_useGainTables)
+  {
+    buildGainTables();
+    if (m_validateGainTables)
+    {
+      validateGainTables();
+    }
+  }
 
   return Fun4AllReturnCodes::EVENT_OK;
 }
 
+//_________________________________________________________
+void PHG4TpcPadPlaneReadout::buildPadCenterTables()
+{
+  m_pad_phicenter.clear();
+  PHG4TpcCylinderGeomContainer::ConstRange layerrange = GeomContainer->get_begin_end();
+  for (auto layeriter = layerrange.first; layeriter != layerrange.second; ++layeriter)
+  {
+    const auto layergeom = layeriter->second;
+    const unsigned int layer = layergeom->get_layer();
+    if (layer >= m_pad_phicenter.size())
+    {
+      m_pad_phicenter.resize(layer + 1);
+    }
+    auto &centers = m_pad_phicenter[layer];
+    centers.resize(layergeom->get_phibins());
+    for (int ipad = 0; ipad < layergeom->get_phibins(); ++ipad)
+    {
+      centers[ipad] = layergeom->get_phicenter(ipad);
+    }
+  }
+}
+
+//_________________________________________________________
+void PHG4TpcPadPlaneReadout::buildPadResponseTables()
+{
+  // linear interpolation with sigma/256 steps, the difference to the analytic integral is below 1e-6
+  static constexpr double steps_per_sigma = 256;
+  m_pad_response.clear();
+  if (!m_usePadResponseTables)
+  {
+    return;
+  }
+  PHG4TpcCylinderGeomContainer::ConstRange layerrange = GeomContainer->get_begin_end();
+  for (auto layeriter = layerrange.first; layeriter != layerrange.second; ++layeriter)
+  {
+    const auto layergeom = layeriter->second;
+    const unsigned int layer = layergeom->get_layer();
+    if (layer >= m_pad_response.size())
+    {
+      m_pad_response.resize(layer + 1);
+    }
+    // same pitch as in populate_zigzag_phibins
+    const double pad_rphi = 2.0 * layergeom->get_phistep() * layergeom->get_radius();
+    auto &table = m_pad_response[layer];
+    table.pitch = pad_rphi / 2.0;
+    table.sigma = sigmaT;
+    // covers all pads selected in populate_zigzag_phibins, anything further out uses the analytic integral
+    table.xmax = _nsigmas * table.sigma + 3 * table.pitch;
+    table.step = table.sigma / steps_per_sigma;
+    const int nvalues = (int) std::ceil(2 * table.xmax / table.step) + 1;
+    table.values.resize(nvalues);
+    for (int i = 0; i < nvalues; ++i)
+    {
+      table.values[i] = pad_overlap(-table.xmax + i * table.step, table.pitch, table.sigma);
+    }
+  }
+}
+
+//_________________________________________________________
+double PHG4TpcPadPlaneReadout::padResponse(const unsigned int layernum, const double x_loc, const double pitch, const double sigma) const
+{
+  if (layernum < m_pad_response.size())
+  {
+    const auto &table = m_pad_response[layernum];
+    if (!table.values.empty() && pitch == table.pitch && sigma == table.sigma)
+    {
+      const double u = (x_loc + table.xmax) / table.step;
+      if (u >= 0 && u < table.values.size() - 1)
+      {
+        const unsigned int i = (unsigned int) u;
+        const double frac = u - i;
+        return table.values[i] + frac * (table.values[i + 1] - table.values[i]);
+      }
+    }
+  }
+  return pad_overlap(x_loc, pitch, sigma);
+}
+
+//_________________________________________________________
+void PHG4TpcPadPlaneReadout::buildGainTables()
+{
+  // same range as the accept/reject sampling and TF1::GetRandom(0,5000)
+  static constexpr double xmax = 5000;
+  if (m_usePolya)
+  {
+    const double theta = polyaTheta;
+    auto polya = [theta](const double q_bar)
+    {
+      return [theta, q_bar](const double x)
+      { return std::pow((1 + theta) * (x / q_bar), theta) * std::exp(-(1 + theta) * (x / q_bar)); };
+    };
+    m_polya_sampler.build(polya(averageGEMGain), 0, xmax);
+    if (m_use_module_gain_weights)
+    {
+      for (int side = 0; side < NSides; ++side)
+      {
+        for (int region = 0; region < NRSectors; ++region)
+        {
+          for (int sector = 0; sector < NSectors; ++sector)
+          {
+            m_polya_module_sampler[side][region][sector].build(polya(averageGEMGain * m_module_gain_weight[side][region][sector]), 0, xmax);
+          }
+        }
+      }
+    }
+  }
+  if (m_useLangau)
+  {
+    for (int side = 0; side < NSides; ++side)
+    {
+      for (int region = 0; region < NRSectors; ++region)
+      {
+        for (int sector = 0; sector < NSectors; ++sector)
+        {
+          TF1 *f = flangau[side][region][sector];
+          if (f)
+          {
+            m_langau_sampler[side][region][sector].build([f](const double x)
+                                                         { return f->Eval(x); },
+                                                         0, xmax);
+          }
+        }
+      }
+    }
+  }
+}
+
+//_________________________________________________________
+void PHG4TpcPadPlaneReadout::validateGainTables()
+{
+  // two sample Kolmogorov test between the original sampling and the table
+  static constexpr int nsamples = 100000;
+  std::vector<double> ref_samples(nsamples);
+  std::vector<double> table_samples(nsamples);
+  auto kstest = [&](const std::string &label, const std::function<double()> &reference, const TpcGEMGainSampler &sampler)
+  {
+    for (int i = 0; i < nsamples; ++i)
+    {
+      ref_samples[i] = reference();
+      table_samples[i] = sampler.sample(RandomGenerator);
+    }
+    std::sort(ref_samples.begin(), ref_samples.end());
+    std::sort(table_samples.begin(), table_samples.end());
+    const double prob = TMath::KolmogorovTest(nsamples, ref_samples.data(), nsamples, table_samples.data(), "");
+    std::cout << "PHG4TpcPadPlaneReadout::validateGainTables - " << label
+              << " reference mean " << TMath::Mean(nsamples, ref_samples.data())
+              << " table mean " << TMath::Mean(nsamples, table_samples.data())
+              << " KS prob " << prob << std::endl;
+  };
+
+  // polya against the accept/reject sampling
+  if (m_usePolya && !m_polya_sampler.empty())
+  {
+    kstest("polya", [this]()
+           { return getSingleEGEMAmplification(1.0); },
+           m_polya_sampler);
+  }
+
+  for (int side = 0; side < NSides; ++side)
+  {
+    for (int region = 0; region < NRSectors; ++region)
+    {
+      for (int sector = 0; sector < NSectors; ++sector)
+      {
+        const std::string label = (boost::format("side %d region %d sector %d") % side % region % sector).str();
+        const auto &polya_sampler = m_polya_module_sampler[side][region][sector];
+        if (m_usePolya && !polya_sampler.empty())
+        {
+          const double weight = m_module_gain_weight[side][region][sector];
+          kstest("polya " + label, [this, weight]()
+                 { return getSingleEGEMAmplification(weight); },
+                 polya_sampler);
+        }
+
+        // langau against TF1::GetRandom
+        TF1 *f = flangau[side][region][sector];
+        const auto &langau_sampler = m_langau_sampler[side][region][sector];
+        if (f && !langau_sampler.empty())
+        {
+          kstest("langau " + label, [this, f]()
+                 { return getSingleEGEMAmplification(f); },
+                 langau_sampler);
+        }
+      }
+    }
+  }
+}
+
 //_________________________________________________________
 double PHG4TpcPadPlaneReadout::getSingleEGEMAmplification()
 {
@@ -207,6 +420,10 @@ double PHG4TpcPadPlaneReadout::getSingleEGEMAmplification()
   // Bob A.: I like Tom's suggestion to use the exponential distribution as a first approximation
   //         for the single electron gain distribution -
   //         and yes, the parameter you're looking for is of course the slope, which is the inverse gain.
+  if (m_usePolya && !m_polya_sampler.empty())
+  {
+    return m_polya_sampler.sample(RandomGenerator);
+  }
   double nelec = gsl_ran_exponential(RandomGenerator, averageGEMGain);
   if (m_usePolya)
   { 
@@ -373,7 +590,13 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
   // amplify the single electron in the gem stack
   //===============================
 
-  double nelec = getSingleEGEMAmplification();
+  // with the gain tables, module weights and langau regenerate the gain below, do not waste a sample here
+  // without them keep the original random number sequence
+  double nelec = 0;
+  if (!m_useGainTables || (!m_use_module_gain_weights && !m_useLangau))
+  {
+    nelec = getSingleEGEMAmplification();
+  }
   // Applying weight with respect to the rad_gem and phi after electrons are redistributed
   double phi_gain = phi;
   if (phi < 0)
@@ -415,7 +638,14 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
 	}
       // regenerate nelec with the new distribution
       //    double original_nelec = nelec; 
-      nelec = getSingleEGEMAmplification(gain_weight);
+      if (m_usePolya && this_region > -1 && !m_polya_module_sampler[side][this_region][sector].empty())
+      {
+        nelec = m_polya_module_sampler[side][this_region][sector].sample(RandomGenerator);
+      }
+      else
+      {
+        nelec = getSingleEGEMAmplification(gain_weight);
+      }
       //  std::cout << " side " << side << " this_region " << this_region 
       //	<<  " sector " << sector << " original nelec " 
       //	<< original_nelec << " new nelec " << nelec << std::endl;
@@ -445,7 +675,8 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
     }
     if(this_region > -1) 
     {
-      nelec = getSingleEGEMAmplification(flangau[side][this_region][sector]);
+      const auto &sampler = m_langau_sampler[side][this_region][sector];
+      nelec = sampler.empty() ? getSingleEGEMAmplification(flangau[side][this_region][sector]) : sampler.sample(RandomGenerator);
     }
     else 
     {
@@ -469,8 +700,10 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
               << std::endl;
   }
 
-  std::vector<int> pad_phibin;
-  std::vector<double> pad_phibin_share;
+  auto &pad_phibin = m_pad_phibin;
+  auto &pad_phibin_share = m_pad_phibin_share;
+  pad_phibin.clear();
+  pad_phibin_share.clear();
 
   populate_zigzag_phibins(side, layernum, phi, sigmaT, pad_phibin, pad_phibin_share);
   /* if (pad_phibin.size() == 0) { */
@@ -499,8 +732,10 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
               << " with t_gem " << t_gem << " sigmaL[0] " << sigmaL[0] << " sigmaL[1] " << sigmaL[1] << std::endl;
   }
 
-  std::vector<int> adc_tbin;
-  std::vector<double> adc_tbin_share;
+  auto &adc_tbin = m_adc_tbin;
+  auto &adc_tbin_share = m_adc_tbin_share;
+  adc_tbin.clear();
+  adc_tbin_share.clear();
   populate_tbins(t_gem, sigmaL, adc_tbin, adc_tbin_share);
   /* if (adc_tbin.size() == 0)  { */
   /* pass_data.neff_electrons = 0; */
@@ -527,6 +762,23 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
   double t_integral = 0.0;
   double weight = 0.0;
 
+  const auto &pad_phicenter = m_pad_phicenter[layernum];
+  // get the Tpc readout sector - there are 12 sectors with how many pads each?
+  const unsigned int pads_per_sector = phibins / 12;
+
+  // tile covering all (pad, tbin) of this electron
+  PadTile *tile = nullptr;
+  int tile_pad_offset = 0;
+  if (m_batchReadout && !pad_phibin.empty() && !adc_tbin.empty())
+  {
+    // the pads are consecutive, possibly wrapping around phi bin 0
+    const int pad_first = pad_phibin.front();
+    const int pad_back = pad_first + (int) pad_phibin.size() - 1;
+    tile = &getPadTile(tpc_truth_clusterer, single_hitsetcontainer, hitsetcontainer, layernum, side, phibins, pad_first, pad_back, adc_tbin.front(), adc_tbin.back());
+    // position of the first pad in the tile
+    tile_pad_offset = ((pad_first - tile->pad_lo) % phibins + phibins) % phibins;
+  }
+
   for (unsigned int ipad = 0; ipad < pad_phibin.size(); ++ipad)
   {
     int pad_num = pad_phibin[ipad];
@@ -557,7 +809,7 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
       // is also useful for comparison with PHG4TpcClusterizer result when running single track events.
       // The only information written to the cell other than neffelectrons is tbin and pad number, so get those from geometry
       double tcenter = LayerGeom->get_zcenter(tbin_num);
-      double phicenter = LayerGeom->get_phicenter(pad_num);
+      double phicenter = pad_phicenter[pad_num];
       phi_integral += phicenter * neffelectrons;
       t_integral += tcenter * neffelectrons;
       weight += neffelectrons;
@@ -575,8 +827,18 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
 
       // The side is an input parameter
 
-      // get the Tpc readout sector - there are 12 sectors with how many pads each?
-      unsigned int pads_per_sector = phibins / 12;
+      if (tile)
+      {
+        // written to the hitsets in FlushPadPlane once all electrons of this g4hit are in.
+        // TrkrHitv2::addEnergy truncates every contribution to an integer adc and saturates the sum,
+        // the tile keeps the truncated sum so that the hits end up with the same adc
+        const double ein = neffelectrons * TrkrDefs::EdepScaleFactor;
+        const int adc = (ein < USHRT_MAX) ? (int) ein : USHRT_MAX;
+        int &cell = tile->adc[(tile_pad_offset + ipad) * tile->ntbins + (tbin_num - tile->tbin_lo)];
+        cell = std::min(std::max(cell, 0) + adc, (int) USHRT_MAX);
+        continue;
+      }
+
       unsigned int sector = pad_num / pads_per_sector;
       TrkrDefs::hitsetkey hitsetkey = TpcDefs::genHitSetKey(layernum, sector, side);
       // Use existing hitset or add new one if needed
@@ -655,6 +917,169 @@ void PHG4TpcPadPlaneReadout::MapToPadPlane(
   m_NHits++;
   /* return pass_data; */
 }
+
+//_________________________________________________________
+void PHG4TpcPadPlaneReadout::FlushPadPlane(TpcClusterBuilder &tpc_truth_clusterer, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer)
+{
+  for (unsigned int itile = 0; itile < m_npad_tiles; ++itile)
+  {
+    flushPadTile(m_pad_tiles[itile], tpc_truth_clusterer, single_hitsetcontainer, hitsetcontainer);
+  }
+  m_npad_tiles = 0;
+}
+
+//_________________________________________________________
+PHG4TpcPadPlaneReadout::PadTile &PHG4TpcPadPlaneReadout::getPadTile(
+    TpcClusterBuilder &tpc_truth_clusterer, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer,
+    const unsigned int layer, const unsigned int side, const int phibins, const int pad_lo, const int pad_hi, const int tbin_lo, const int tbin_hi)
+{
+  // margins added when a tile is created or grown, to limit the number of reallocations
+  static constexpr int pad_margin = 4;
+  static constexpr int tbin_margin = 8;
+
+  // a g4hit only touches a few layers, a linear search is enough
+  PadTile *tile = nullptr;
+  for (unsigned int itile = 0; itile < m_npad_tiles; ++itile)
+  {
+    if (m_pad_tiles[itile].layer == layer && m_pad_tiles[itile].side == side)
+    {
+      tile = &m_pad_tiles[itile];
+      break;
+    }
+  }
+  if (!tile)
+  {
+    if (m_npad_tiles == m_pad_tiles.size())
+    {
+      m_pad_tiles.emplace_back();
+    }
+    tile = &m_pad_tiles[m_npad_tiles++];
+    tile->layer = layer;
+    tile->side = side;
+    tile->phibins = phibins;
+    tile->npads = 0;
+    tile->ntbins = 0;
+  }
+
+  // requested pads relative to the tile origin, unwrapped to the side closest to it
+  int new_pad_lo = pad_lo;
+  int new_pad_hi = pad_hi;
+  if (tile->npads > 0)
+  {
+    int shift = 0;
+    if (pad_lo - tile->pad_lo > phibins / 2)
+    {
+      shift = -phibins;
+    }
+    else if (tile->pad_lo - pad_lo > phibins / 2)
+    {
+      shift = phibins;
+    }
+    new_pad_lo += shift;
+    new_pad_hi += shift;
+    if (new_pad_lo >= tile->pad_lo && new_pad_hi < tile->pad_lo + tile->npads &&
+        tbin_lo >= tile->tbin_lo && tbin_hi < tile->tbin_lo + tile->ntbins)
+    {
+      // already covered
+      return *tile;
+    }
+
+    // grow to the union of the current and requested ranges
+    const int union_pad_lo = std::min(new_pad_lo, tile->pad_lo);
+    const int union_pad_hi = std::max(new_pad_hi, tile->pad_lo + tile->npads - 1);
+    const int union_tbin_lo = std::min(tbin_lo, tile->tbin_lo);
+    const int union_tbin_hi = std::max(tbin_hi, tile->tbin_lo + tile->ntbins - 1);
+    const int union_npads = union_pad_hi - union_pad_lo + 1 + 2 * pad_margin;
+    const int union_ntbins = union_tbin_hi - union_tbin_lo + 1 + 2 * tbin_margin;
+    if (union_npads < phibins && union_npads * union_ntbins <= max_tile_cells)
+    {
+      // copy the content into the larger tile
+      std::vector<int> adc(union_npads * union_ntbins, -1);
+      const int pad_offset = tile->pad_lo - (union_pad_lo - pad_margin);
+      const int tbin_offset = tile->tbin_lo - (union_tbin_lo - tbin_margin);
+      for (int ipad = 0; ipad < tile->npads; ++ipad)
+      {
+        std::copy_n(tile->adc.begin() + ipad * tile->ntbins, tile->ntbins, adc.begin() + (ipad + pad_offset) * union_ntbins + tbin_offset);
+      }
+      tile->adc.swap(adc);
+      tile->pad_lo = union_pad_lo - pad_margin;
+      tile->tbin_lo = union_tbin_lo - tbin_margin;
+      tile->npads = union_npads;
+      tile->ntbins = union_ntbins;
+      return *tile;
+    }
+
+    // too large, write out what is there and restart the tile on the requested range
+    flushPadTile(*tile, tpc_truth_clusterer, single_hitsetcontainer, hitsetcontainer);
+    new_pad_lo = pad_lo;
+    new_pad_hi = pad_hi;
+  }
+
+  tile->pad_lo = new_pad_lo - pad_margin;
+  tile->tbin_lo = tbin_lo - tbin_margin;
+  tile->npads = new_pad_hi - new_pad_lo + 1 + 2 * pad_margin;
+  tile->ntbins = tbin_hi - tbin_lo + 1 + 2 * tbin_margin;
+  tile->adc.assign(tile->npads * tile->ntbins, -1);
+  return *tile;
+}
+
+//_________________________________________________________
+void PHG4TpcPadPlaneReadout::flushPadTile(PadTile &tile, TpcClusterBuilder &tpc_truth_clusterer, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer)
+{
+  const int pads_per_sector = tile.phibins / 12;
+  TrkrDefs::hitsetkey current_hitsetkey = TrkrDefs::HITSETKEYMAX;
+  TrkrHitSet *hitset = nullptr;
+  TrkrHitSet *single_hitset = nullptr;
+  for (int ipad = 0; ipad < tile.npads; ++ipad)
+  {
+    const int *cells = &tile.adc[ipad * tile.ntbins];
+    int pad_num = (tile.pad_lo + ipad) % tile.phibins;
+    if (pad_num < 0)
+    {
+      pad_num += tile.phibins;
+    }
+    for (int it = 0; it < tile.ntbins; ++it)
+    {
+      if (cells[it] < 0)
+      {
+        continue;
+      }
+
+      const unsigned int sector = pad_num / pads_per_sector;
+      const TrkrDefs::hitsetkey hitsetkey = TpcDefs::genHitSetKey(tile.layer, sector, tile.side);
+      if (hitsetkey != current_hitsetkey)
+      {
+        current_hitsetkey = hitsetkey;
+        hitset = hitsetcontainer->findOrAddHitSet(hitsetkey)->second;
+        single_hitset = single_hitsetcontainer->findOrAddHitSet(hitsetkey)->second;
+      }
+      const TrkrDefs::hitkey hitkey = TpcDefs::genHitKey((unsigned int) pad_num, (unsigned int) (tile.tbin_lo + it));
+
+      TrkrHit *hit = hitset->getHit(hitkey);
+      if (!hit)
+      {
+        hit = new TrkrHitv2();
+        hitset->addHitSpecificKey(hitkey, hit);
+      }
+      TrkrHit *single_hit = single_hitset->getHit(hitkey);
+      if (!single_hit)
+      {
+        single_hit = new TrkrHitv2();
+        single_hitset->addHitSpecificKey(hitkey, single_hit);
+      }
+
+      // the cell holds an integer adc, EdepScaleFactor is a power of two so dividing and
+      // scaling back in addEnergy is exact
+      const double neffelectrons = cells[it] / TrkrDefs::EdepScaleFactor;
+      hit->addEnergy(neffelectrons);
+      single_hit->addEnergy(neffelectrons);
+      tpc_truth_clusterer.addhitset(hitsetkey, hitkey, neffelectrons);
+    }
+  }
+  tile.npads = 0;
+  tile.ntbins = 0;
+}
+
 double PHG4TpcPadPlaneReadout::check_phi(const unsigned int side, const double phi, const double radius)
 {
   double new_phi = phi;
@@ -767,7 +1192,7 @@ void PHG4TpcPadPlaneReadout::populate_zigzag_phibins(const unsigned int side, co
     {
       pad_now -= phibins;
     }
-    pads_phi[ipad] = LayerGeom->get_phicenter(pad_now);
+    pads_phi[ipad] = m_pad_phicenter[layernum][pad_now];
     sum_of_pads_phi += pads_phi[ipad];
     sum_of_pads_absphi += fabs(pads_phi[ipad]);
   }
@@ -830,13 +1255,8 @@ void PHG4TpcPadPlaneReadout::populate_zigzag_phibins(const unsigned int side, co
     }
 
     const double x_loc = x_loc_tmp;
-    // calculate fraction of the total charge on this strip
-    /*
-    this corresponds to integrating the charge distribution Gaussian function (centered on rphi and of width cloud_sig_rp),
-    convoluted with a strip response function, which is triangular from -pitch to +pitch, with a maximum of 1. at stript center
-    */
-    overlap[ipad] =
-        (pitch - x_loc) * (std::erf(x_loc / (M_SQRT2 * sigma)) - std::erf((x_loc - pitch) / (M_SQRT2 * sigma))) / (pitch * 2) + (pitch + x_loc) * (std::erf((x_loc + pitch) / (M_SQRT2 * sigma)) - std::erf(x_loc / (M_SQRT2 * sigma))) / (pitch * 2) + (gaus(x_loc - pitch, sigma) - gaus(x_loc, sigma)) * square(sigma) / pitch + (gaus(x_loc + pitch, sigma) - gaus(x_loc, sigma)) * square(sigma) / pitch;
+    // calculate fraction of the total charge on this strip, see pad_overlap
+    overlap[ipad] = padResponse(layernum, x_loc, pitch, sigma);
   }
 
   // now we have the overlap for each pad
@@ -892,103 +1312,62 @@ void PHG4TpcPadPlaneReadout::populate_tbins(const double t, const std::array<dou
   {
     std::cout << " n_zz " << n_zz << " cloud_sigzz[0] " << cloud_sig_tt[0] << " cloud_sig_tt[1] " << cloud_sig_tt[1] << std::endl;
   }
-  for (int it = -n_zz; it != n_zz + 1; ++it)
+  // only the bins within the readout window are filled
+  const int it_min = std::max(-n_zz, min_cell_tbin - tbin);
+  const int it_max = std::min(n_zz, max_cell_tbin - tbin);
+  if (it_min > it_max)
   {
-    int cur_t_bin = tbin + it;
-    if ((cur_t_bin < min_cell_tbin) || (cur_t_bin > max_cell_tbin))
-    {
-      continue;
-    }
+    return;
+  }
 
-    if (Verbosity() > 1000)
-    {
-      std::cout << " it " << it << " cur_t_bin " << cur_t_bin << " min_cell_tbin " << min_cell_tbin << " max_cell_tbin " << max_cell_tbin << std::endl;
-    }
+  // erf at the bin edges, neighboring bins share an edge so each value is computed once.
+  // Edges up to the lower edge of the central bin use the shaping width on the low side of the membrane,
+  // the other ones the width on the high side. Edge ie is the lower edge of bin it_min + ie
+  const int index_low = (zsect == -1) ? 0 : 1;
+  const int index_high = (zsect == -1) ? 1 : 0;
+  const int nedges = it_max - it_min + 2;
+  auto &edge_erf = m_tbin_edge_erf;
+  edge_erf.resize(nedges);
+  for (int ie = 0; ie < nedges; ++ie)
+  {
+    const int it = it_min + ie;
+    const double sig_inv = (it <= 0) ? cloud_sig_tt_inv[index_low] : cloud_sig_tt_inv[index_high];
+    edge_erf[ie] = 0.5 * M_SQRT2 * ((it - 0.5) * tstepsize - tdisp) * sig_inv;
+  }
+  // separate loop over the contiguous arguments, so that it can be vectorized
+  for (int ie = 0; ie < nedges; ++ie)
+  {
+    edge_erf[ie] = std::erf(edge_erf[ie]);
+  }
+
+  for (int it = it_min; it <= it_max; ++it)
+  {
+    const int cur_t_bin = tbin + it;
+    const double erf_low = edge_erf[it - it_min];
+    const double erf_high = edge_erf[it - it_min + 1];
 
+    // 1/2 * the erf is the integral probability from the argument Z value to zero, so this is the integral probability between the Z limits
     double t_integral = 0.0;
     if (it == 0)
     {
       // the crossover between lead and tail shaping occurs in this bin
-      int index1 = -1;
-      int index2 = -1;
-      if (zsect == -1)
-      {
-        index1 = 0;
-        index2 = 1;
-      }
-      else
-      {
-        index1 = 1;
-        index2 = 0;
-      }
-
-      double tLim1 = 0.0;
-      double tLim2 = 0.5 * M_SQRT2 * (-0.5 * tstepsize - tdisp) * cloud_sig_tt_inv[index1];
-      // 1/2 * the erf is the integral probability from the argument Z value to zero, so this is the integral probability between the Z limits
-      double t_integral1 = 0.5 * (erf(tLim1) - erf(tLim2));
-
-      if (Verbosity() > 1000)
-      {
-        if (LayerGeom->get_layer() == print_layer)
-        {
-          std::cout << "   populate_tbins:  cur_t_bin " << cur_t_bin << "  center t " << LayerGeom->get_zcenter(cur_t_bin)
-                    << " index1 " << index1 << "  tLim1 " << tLim1 << " tLim2 " << tLim2 << " t_integral1 " << t_integral1 << std::endl;
-        }
-      }
-
-      tLim2 = 0.0;
-      tLim1 = 0.5 * M_SQRT2 * (0.5 * tstepsize - tdisp) * cloud_sig_tt_inv[index2];
-      double t_integral2 = 0.5 * (erf(tLim1) - erf(tLim2));
-
-      if (Verbosity() > 1000)
-      {
-        if (LayerGeom->get_layer() == print_layer)
-        {
-          std::cout << "   populate_tbins:  cur_t_bin " << cur_t_bin << "  center t " << LayerGeom->get_zcenter(cur_t_bin)
-                    << " index2 " << index2 << "  tLim1 " << tLim1 << " tLim2 " << tLim2 << " t_integral2 " << t_integral2 << std::endl;
-        }
-      }
-
+      const double t_integral1 = 0.5 * (0.0 - erf_low);
+      const double t_integral2 = 0.5 * (erf_high - 0.0);
       t_integral = t_integral1 + t_integral2;
     }
     else
     {
       // The non zero bins are entirely in the lead or tail region
       // lead or tail depends on which side of the membrane
-      int index = 0;
-      if (it < 0)
-      {
-        if (zsect == -1)
-        {
-          index = 0;
-        }
-        else
-        {
-          index = 1;
-        }
-      }
-      else
-      {
-        if (zsect == -1)
-        {
-          index = 1;
-        }
-        else
-        {
-          index = 0;
-        }
-      }
-      double tLim1 = 0.5 * M_SQRT2 * ((it + 0.5) * tstepsize - tdisp) * cloud_sig_tt_inv[index];
-      double tLim2 = 0.5 * M_SQRT2 * ((it - 0.5) * tstepsize - tdisp) * cloud_sig_tt_inv[index];
-      t_integral = 0.5 * (erf(tLim1) - erf(tLim2));
+      t_integral = 0.5 * (erf_high - erf_low);
+    }
 
-      if (Verbosity() > 1000)
+    if (Verbosity() > 1000)
+    {
+      if (LayerGeom->get_layer() == print_layer)
       {
-        if (LayerGeom->get_layer() == print_layer)
-        {
-          std::cout << "   populate_tbins:  t_bin " << cur_t_bin << "  center t " << LayerGeom->get_zcenter(cur_t_bin)
-                    << " index " << index << "  tLim1 " << tLim1 << " tLim2 " << tLim2 << " t_integral " << t_integral << std::endl;
-        }
+        std::cout << "   populate_tbins:  t_bin " << cur_t_bin << "  center t " << LayerGeom->get_zcenter(cur_t_bin)
+                  << " erf_low " << erf_low << " erf_high " << erf_high << " t_integral " << t_integral << std::endl;
       }
     }
 
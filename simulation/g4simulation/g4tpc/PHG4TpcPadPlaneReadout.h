@@ -3,6 +3,7 @@
 
 #include "PHG4TpcPadPlane.h"
 #include "TpcClusterBuilder.h"
+#include "TpcGEMGainSampler.h"
 
 #include <g4main/PHG4HitContainer.h>
 
@@ -39,6 +40,11 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
   void SetUsePolyaGEMGain(const int flagPolya) {m_usePolya = flagPolya;}
   void SetUseLangauGEMGain(const int flagLangau) {m_useLangau = flagLangau;}
   void SetLangauParsFileName(const std::string &name) {m_tpc_langau_pars_file = name;}
+  //! sample the Polya/Langau GEM gain from inverse CDF tables built at InitRun (default off)
+  //! the tables draw from the module gsl rng, so the gain sequence differs from TF1::GetRandom (gRandom)
+  void SetUseGEMGainTables(const bool flag) {m_useGainTables = flag;}
+  //! compare the tabulated Polya/Langau gain against the original sampling at InitRun
+  void SetValidateGEMGainTables(const bool flag) {m_validateGainTables = flag;}
 
   void SetDriftVelocity(double vd) override { drift_velocity = vd; }
   void SetReadoutTime(float t) override { extended_readout_time = t; }
@@ -47,6 +53,13 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
 
   void MapToPadPlane(TpcClusterBuilder &tpc_clustbuilder, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer, TrkrHitTruthAssoc * /*hittruthassoc*/, const double x_gem, const double y_gem, const double t_gem, const unsigned int side, PHG4HitContainer::ConstIterator hiter, TNtuple * /*ntpad*/, TNtuple * /*nthit*/) override;
 
+  void FlushPadPlane(TpcClusterBuilder &tpc_clustbuilder, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer) override;
+
+  //! collect the charge of all electrons from one g4hit in a (pad x tbin) tile and write it to the hitsets once per g4hit (default on)
+  void SetBatchReadout(const bool flag) { m_batchReadout = flag; }
+  //! use the per-layer tabulated pad response instead of the analytic integral (default on)
+  void SetUsePadResponseTables(const bool flag) { m_usePadResponseTables = flag; }
+
   void SetDefaultParameters() override;
   void UpdateInternalParameters() override;
 
@@ -57,6 +70,55 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
 
   double check_phi(const unsigned int side, const double phi, const double radius);
 
+  // pad centers in phi for each layer, filled at InitRun to avoid the sector lookup in get_phicenter per electron
+  void buildPadCenterTables();
+  std::vector<std::vector<double>> m_pad_phicenter;
+
+  // charge sharing of the current electron, kept as members so the buffers are reused
+  std::vector<int> m_pad_phibin;
+  std::vector<double> m_pad_phibin_share;
+  std::vector<int> m_adc_tbin;
+  std::vector<double> m_adc_tbin_share;
+
+  // pad response of one layer, the charge fraction on a pad as a function of the pad to cloud distance
+  // tabulated at InitRun for the gem cloud width, replaces the erf evaluation per pad and electron
+  struct PadResponseTable
+  {
+    double pitch = 0;
+    double sigma = 0;
+    double xmax = 0;
+    double step = 0;
+    std::vector<double> values;
+  };
+  void buildPadResponseTables();
+  double padResponse(const unsigned int layernum, const double x_loc, const double pitch, const double sigma) const;
+  std::vector<PadResponseTable> m_pad_response;
+  bool m_usePadResponseTables = true;
+
+  // erf at the time bin edges of the current electron
+  std::vector<double> m_tbin_edge_erf;
+
+  // dense (pad x tbin) tile for one layer and side, collects all electrons of the current g4hit
+  // pads are unwrapped around the pad origin, so the tile can straddle phi bin 0
+  struct PadTile
+  {
+    unsigned int layer = 0;
+    unsigned int side = 0;
+    int phibins = 0;
+    int pad_lo = 0;
+    int tbin_lo = 0;
+    int npads = 0;
+    int ntbins = 0;
+    // truncated adc summed per cell, -1 for cells without a contribution
+    std::vector<int> adc;
+  };
+  PadTile &getPadTile(TpcClusterBuilder &tpc_truth_clusterer, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer,
+                      const unsigned int layer, const unsigned int side, const int phibins, const int pad_lo, const int pad_hi, const int tbin_lo, const int tbin_hi);
+  void flushPadTile(PadTile &tile, TpcClusterBuilder &tpc_truth_clusterer, TrkrHitSetContainer *single_hitsetcontainer, TrkrHitSetContainer *hitsetcontainer);
+  std::vector<PadTile> m_pad_tiles;
+  unsigned int m_npad_tiles = 0;
+  bool m_batchReadout = true;
+
   PHG4TpcCylinderGeomContainer *GeomContainer = nullptr;
   PHG4TpcCylinderGeom *LayerGeom = nullptr;
 
@@ -99,6 +161,12 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
   double getSingleEGEMAmplification(TF1 *f);
   bool m_usePolya = false;
 
+  // build the inverse CDF tables for the gain distributions in use
+  void buildGainTables();
+  void validateGainTables();
+  bool m_useGainTables = false;
+  bool m_validateGainTables = false;
+
   bool m_useLangau = false;
   std::string m_tpc_langau_pars_file = "";
 
@@ -117,6 +185,11 @@ class PHG4TpcPadPlaneReadout : public PHG4TpcPadPlane
 
   TF1 *flangau[2][3][12] = {{{nullptr}}};
 
+  // tabulated gain, polya uses the module weighted average gain
+  TpcGEMGainSampler m_polya_sampler;
+  TpcGEMGainSampler m_polya_module_sampler[2][3][12];
+  TpcGEMGainSampler m_langau_sampler[2][3][12];
+
   
 };
 
@@ -0,0 +1,74 @@
+#include "TpcGEMGainSampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+//_________________________________________________________
+void TpcGEMGainSampler::build(const std::function<double(double)> &pdf, const double xmin, const double xmax, const unsigned int nbins)
+{
+  m_xmin = xmin;
+  m_binwidth = (xmax - xmin) / nbins;
+  m_cdf.assign(nbins + 1, 0);
+
+  double flow = std::max(0., pdf(xmin));
+  for (unsigned int i = 0; i < nbins; ++i)
+  {
+    const double fup = std::max(0., pdf(xmin + (i + 1) * m_binwidth));
+    m_cdf[i + 1] = m_cdf[i] + 0.5 * (flow + fup) * m_binwidth;
+    flow = fup;
+  }
+
+  const double norm = m_cdf.back();
+  if (!(norm > 0) || !std::isfinite(norm))
+  {
+    std::cout << "TpcGEMGainSampler::build - pdf cannot be normalized, integral: " << norm << std::endl;
+    m_cdf.clear();
+    m_guide.clear();
+    return;
+  }
+  for (auto &val : m_cdf)
+  {
+    val /= norm;
+  }
+  m_cdf.back() = 1.;
+
+  // guide table so the lookup is O(1) on average instead of a full binary search
+  m_guide.resize(nbins);
+  unsigned int bin = 0;
+  for (unsigned int k = 0; k < nbins; ++k)
+  {
+    const double u = double(k) / nbins;
+    while (bin < nbins - 1 && m_cdf[bin + 1] <= u)
+    {
+      ++bin;
+    }
+    m_guide[k] = bin;
+  }
+}
+
+//_________________________________________________________
+double TpcGEMGainSampler::sample(gsl_rng *rng) const
+{
+  const double u = gsl_rng_uniform(rng);
+  const unsigned int nbins = m_guide.size();
+  unsigned int bin = m_guide[std::min<unsigned int>(u * nbins, nbins - 1)];
+  while (bin < nbins - 1 && m_cdf[bin + 1] <= u)
+  {
+    ++bin;
+  }
+  const double dcdf = m_cdf[bin + 1] - m_cdf[bin];
+  const double frac = dcdf > 0 ? (u - m_cdf[bin]) / dcdf : 0.5;
+  return m_xmin + (bin + frac) * m_binwidth;
+}
+
+//_________________________________________________________
+double TpcGEMGainSampler::mean() const
+{
+  double sum = 0;
+  for (unsigned int i = 0; i + 1 < m_cdf.size(); ++i)
+  {
+    sum += (m_cdf[i + 1] - m_cdf[i]) * (m_xmin + (i + 0.5) * m_binwidth);
+  }
+  return sum;
+}
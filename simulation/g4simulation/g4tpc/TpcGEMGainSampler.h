@@ -0,0 +1,45 @@
+// Tell emacs that this is a C++ source
+//  -*- C++ -*-.
+#ifndef G4TPC_TPCGEMGAINSAMPLER_H
+#define G4TPC_TPCGEMGAINSAMPLER_H
+
+// Tabulated inverse CDF for the single electron GEM gain.
+// The table is built once (InitRun) from an arbitrary pdf on [xmin, xmax]
+// and sampled with a single uniform from the caller's gsl rng.
+// Within a bin the pdf is taken as constant, so the CDF is piecewise linear
+// and the sampling is exact for the binned pdf.
+
+#include <gsl/gsl_rng.h>
+
+#include <functional>
+#include <vector>
+
+class TpcGEMGainSampler
+{
+ public:
+  TpcGEMGainSampler() = default;
+  ~TpcGEMGainSampler() = default;
+
+  //! tabulate pdf on [xmin, xmax] using nbins bins (trapezoidal integration)
+  void build(const std::function<double(double)> &pdf, const double xmin, const double xmax, const unsigned int nbins = 2000);
+
+  //! draw one value, consumes exactly one gsl_rng_uniform
+  double sample(gsl_rng *rng) const;
+
+  //! mean of the tabulated distribution
+  double mean() const;
+
+  bool empty() const { return m_cdf.empty(); }
+
+ private:
+  double m_xmin = 0;
+  double m_binwidth = 0;
+
+  //! normalized cdf at the bin edges, m_cdf.front() = 0, m_cdf.back() = 1
+  std::vector<double> m_cdf;
+
+  //! guide table, m_guide[k] is the first bin with cdf[bin+1] > k/nguide
+  std::vector<unsigned int> m_guide;
+};
+
+#endif
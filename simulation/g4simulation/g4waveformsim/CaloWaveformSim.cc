@@ -31,21 +31,17 @@
 #include <g4detectors/PHG4CylinderGeom_Spacalv1.h>  // for PHG4CylinderGeom_Spaca...
 #include <g4detectors/PHG4CylinderGeom_Spacalv3.h>
 
-#include <TF1.h>
 #include <TFile.h>
 #include <TProfile.h>
 #include <TSystem.h>
 #include <TTree.h>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
 #include <sstream>
 #include <string>
 
-double CaloWaveformSim::template_function(double *x, double *par)
-{
-  Double_t v1 = par[0] * h_template->Interpolate(x[0] - par[1]) + par[2];
-  return v1;
-}
-
 CaloWaveformSim::CaloWaveformSim(const std::string &name)
   : SubsysReco(name)
 {
@@ -75,6 +71,7 @@ int CaloWaveformSim::InitRun(PHCompositeNode *topNode)
   assert(ft);
   assert(ft->IsOpen());
   h_template = (TProfile *) ft->Get("hpwaveform");
+  build_template_table();
   
   // get the decalibration from the CDB
   PHNodeIterator nodeIter(topNode);
@@ -199,11 +196,7 @@ int CaloWaveformSim::InitRun(PHCompositeNode *topNode)
       exit(1);
     }
   }
-  m_waveforms.resize(m_nchannels);
-  for (auto &waveform : m_waveforms)
-  {
-    waveform.resize(m_nsamples);
-  }
+  m_waveforms.assign(m_nchannels * m_nsamples, 0.);
 
   CreateNodeTree(topNode);
   return Fun4AllReturnCodes::EVENT_OK;
@@ -244,23 +237,11 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
   }
 
   // initialize the waveform
-  for (auto &waveform : m_waveforms)
-  {
-    for (auto &sample : waveform)
-    {
-      sample = 0.;
-    }
-  }
-  // waveform TH1
-  TF1 *f_fit = new TF1(
-      "f_fit", [this](double *x, double *par)
-      { return this->template_function(x, par); },
-      0, m_nsamples, 3);
-  f_fit->SetParameter(0, 1.0);
+  std::fill(m_waveforms.begin(), m_waveforms.end(), 0.);
+
   float shift_of_shift = m_timeshiftwidth * gsl_rng_uniform(m_RandomGenerator);
 
-  float _shiftval = m_peakpos + shift_of_shift - f_fit->GetMaximumX();
-  f_fit->SetParameters(1, _shiftval, 0);
+  float _shiftval = m_peakpos + shift_of_shift - m_template_maxx;
 
   // get G4Hits
   std::string nodename = "G4HIT_" + m_detector;
@@ -273,6 +254,7 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
   }
 
   // loop over hits
+  m_pulses.clear();
   for (PHG4HitContainer::ConstIterator hititer = hits->getHits().first; hititer != hits->getHits().second; hititer++)
   {
     PHG4Hit *hit = hititer->second;
@@ -310,10 +292,28 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
     edepMap[hit->get_hit_id()] += hitEdep;
     showerMap[showerID] += hitEdep;
 
-    f_fit->SetParameters(ADC, _shiftval + t0, 0.);
+    // the pulse is linear in the amplitude, hits in the same tower and time bin
+    // (1/m_template_oversample of a sample) share one shaped pulse
+    int tbin = std::lround(t0 * m_template_oversample);
+    m_pulses.push_back({tower_index, tbin, ADC});
+  }
+
+  std::sort(m_pulses.begin(), m_pulses.end(), [](const TowerPulse &lhs, const TowerPulse &rhs)
+            { return lhs.channel < rhs.channel || (lhs.channel == rhs.channel && lhs.tbin < rhs.tbin); });
+  for (auto iter = m_pulses.begin(); iter != m_pulses.end();)
+  {
+    const unsigned int channel = iter->channel;
+    const int tbin = iter->tbin;
+    float amplitude = 0;
+    for (; iter != m_pulses.end() && iter->channel == channel && iter->tbin == tbin; ++iter)
+    {
+      amplitude += iter->amplitude;
+    }
+    const double shift = _shiftval + double(tbin) / m_template_oversample;
+    float *waveform = &m_waveforms[channel * m_nsamples];
     for (int i = 0; i < m_nsamples; i++)
     {
-      m_waveforms.at(tower_index).at(i) += f_fit->Eval(i);
+      waveform[i] += amplitude * template_value(i - shift);
     }
   }
 
@@ -332,58 +332,97 @@ int CaloWaveformSim::process_event(PHCompositeNode *topNode)
       }
     }
 
+    std::vector<float> m_waveform_pedestal(m_nsamples, 0.);
     for (int i = 0; i < m_nchannels; i++)
     {
-      std::vector<float> m_waveform_pedestal;
-      m_waveform_pedestal.resize(m_nsamples);
+      float *waveform = &m_waveforms[i * m_nsamples];
       if(m_noiseType == NoiseType::NOISE_TREE)
       {
         TowerInfo *pedestal_tower = m_PedestalContainer->get_tower_at_channel(i);
         float pedestal_mean = 0;
         for(int j = 0; j < m_nsamples; j++)
         {
-          m_waveform_pedestal.at(j) = (j < m_pedestalsamples) ? pedestal_tower->get_waveform_value(j) : pedestal_tower->get_waveform_value(m_pedestalsamples - 1);
-          pedestal_mean += m_waveform_pedestal.at(j);
+          m_waveform_pedestal[j] = (j < m_pedestalsamples) ? pedestal_tower->get_waveform_value(j) : pedestal_tower->get_waveform_value(m_pedestalsamples - 1);
+          pedestal_mean += m_waveform_pedestal[j];
         }
         pedestal_mean /= m_nsamples;
         for(int j = 0; j < m_nsamples; j++)
         {
-          m_waveform_pedestal.at(j)  = (m_waveform_pedestal.at(j) - pedestal_mean) * m_pedestal_scale + pedestal_mean;
+          waveform[j] += (m_waveform_pedestal[j] - pedestal_mean) * m_pedestal_scale + pedestal_mean;
         }
       }
-      for (int j = 0; j < m_nsamples; j++)
+      else if (m_noiseType == NoiseType::NOISE_GAUSSIAN)
       {
-        if (m_noiseType == NoiseType::NOISE_TREE)
-        {
-          //TowerInfo *pedestal_tower = m_PedestalContainer->get_tower_at_channel(i);
-          //m_waveforms.at(i).at(j) += (j < m_pedestalsamples) ? pedestal_tower->get_waveform_value(j) : pedestal_tower->get_waveform_value(m_pedestalsamples - 1);
-          m_waveforms.at(i).at(j) += m_waveform_pedestal.at(j);
-        }
-        if (m_noiseType == NoiseType::NOISE_GAUSSIAN)
+        for (int j = 0; j < m_nsamples; j++)
         {
-          m_waveforms.at(i).at(j) += gsl_ran_gaussian(m_RandomGenerator, m_gaussian_noise);
+          waveform[j] += gsl_ran_gaussian(m_RandomGenerator, m_gaussian_noise);
         }
-        if (m_noiseType == NoiseType::NOISE_NONE)
-        {
-          m_waveforms.at(i).at(j) += m_fixpedestal;
-        }
-        // saturate at 2^14 - 1
-        if(m_waveforms.at(i).at(j) > 16383)
+      }
+      else if (m_noiseType == NoiseType::NOISE_NONE)
+      {
+        for (int j = 0; j < m_nsamples; j++)
         {
-          m_waveforms.at(i).at(j) = 16383;
+          waveform[j] += m_fixpedestal;
         }
-        if(m_waveforms.at(i).at(j) < 0)
-	      {
-	        m_waveforms.at(i).at(j) = 0;
-	      }
-        
-        m_CaloWaveformContainer->get_tower_at_channel(i)->set_waveform_value(j, m_waveforms.at(i).at(j));
+      }
+      // saturate at 2^14 - 1
+      for (int j = 0; j < m_nsamples; j++)
+      {
+        waveform[j] = std::clamp(waveform[j], 0.F, 16383.F);
+      }
+      TowerInfo *tower = m_CaloWaveformContainer->get_tower_at_channel(i);
+      for (int j = 0; j < m_nsamples; j++)
+      {
+        tower->set_waveform_value(j, waveform[j]);
       }
     }
-    delete f_fit;
     return Fun4AllReturnCodes::EVENT_OK;
   }
 
+  void CaloWaveformSim::build_template_table()
+  {
+    // TH1::Interpolate interpolates linearly between bin centers and returns the
+    // first/last bin content outside of them, the table is clamped the same way
+    const int nbins = h_template->GetNbinsX();
+    m_template_xmin = h_template->GetBinCenter(1);
+    m_template_xmax = h_template->GetBinCenter(nbins);
+    const int npoints = std::ceil((m_template_xmax - m_template_xmin) * m_template_oversample) + 1;
+    m_template_table.resize(npoints);
+    for (int i = 0; i < npoints; i++)
+    {
+      m_template_table[i] = h_template->Interpolate(std::min(m_template_xmin + double(i) / m_template_oversample, m_template_xmax));
+    }
+
+    // peak position of the unshifted template within the readout window
+    float maxval = -std::numeric_limits<float>::max();
+    for (int i = 0; i <= m_nsamples * m_template_oversample; i++)
+    {
+      const double x = double(i) / m_template_oversample;
+      const float val = template_value(x);
+      if (val > maxval)
+      {
+        maxval = val;
+        m_template_maxx = x;
+      }
+    }
+  }
+
+  float CaloWaveformSim::template_value(double x) const
+  {
+    const double pos = (x - m_template_xmin) * m_template_oversample;
+    if (pos <= 0)
+    {
+      return m_template_table.front();
+    }
+    const int idx = pos;
+    if (idx >= (int) m_template_table.size() - 1)
+    {
+      return m_template_table.back();
+    }
+    const float frac = pos - idx;
+    return m_template_table[idx] + frac * (m_template_table[idx + 1] - m_template_table[idx]);
+  }
+
   void CaloWaveformSim::maphitetaphi(PHG4Hit * g4hit, unsigned short &etabin, unsigned short &phibin, float &correction)
   {
     if (m_dettype == CaloTowerDefs::CEMC)
@@ -142,6 +142,12 @@ class CaloWaveformSim : public SubsysReco
     m_pedestal_scale = _pedestal_scale;
     return;
   }
+  // number of template table points per sample, hit times are binned with the same granularity
+  void set_template_oversample(int _oversample)
+  {
+    m_template_oversample = _oversample;
+    return;
+  }
   // for CEMC light yield correction
   LightCollectionModel &get_light_collection_model() { return light_collection_model; }
 
@@ -158,7 +164,26 @@ class CaloWaveformSim : public SubsysReco
   TowerInfoContainer *m_CaloWaveformContainer{nullptr};
   TowerInfoContainer *m_PedestalContainer{nullptr};
 
-  std::vector<std::vector<float>> m_waveforms = {{}};
+  // channel major waveforms, m_waveforms[channel * m_nsamples + sample]
+  std::vector<float> m_waveforms;
+
+  // template sampled at m_template_oversample points per sample, linear interpolation in between
+  std::vector<float> m_template_table;
+  double m_template_xmin{0.};
+  double m_template_xmax{0.};
+  double m_template_maxx{0.};
+  int m_template_oversample{100};
+  void build_template_table();
+  float template_value(double x) const;
+
+  // hits summed per tower and binned hit time before the pulse is shaped
+  struct TowerPulse
+  {
+    unsigned int channel;
+    int tbin;
+    float amplitude;
+  };
+  std::vector<TowerPulse> m_pulses;
   int m_runNumber{0};
   int m_nsamples{31};
   int m_nchannels{24576};
@@ -180,7 +205,6 @@ class CaloWaveformSim : public SubsysReco
   void maphitetaphi(PHG4Hit *g4hit, unsigned short &etabin, unsigned short &phibin, float &correction);
   unsigned int (*encode_tower)(const unsigned int etabin, const unsigned int phibin){TowerInfoDefs::encode_emcal};
   unsigned int (*decode_tower)(const unsigned int tower_key){TowerInfoDefs::decode_emcal};
-  double template_function(double *x, double *par);
   void CreateNodeTree(PHCompositeNode *topNode);
 
   LightCollectionModel light_collection_model;